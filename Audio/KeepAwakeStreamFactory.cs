@@ -19,17 +19,17 @@ namespace NetKeyer.Audio
             {
                 try
                 {
-                    DebugLogger.Log("audio", $"Creating WASAPI keep-awake stream for device: {deviceId ?? "default"}");
+                    DebugLogger.Log(DebugCategory.Audio, $"Creating WASAPI keep-awake stream for device: {deviceId ?? "default"}");
                     return new WasapiKeepAwakeStream(deviceId);
                 }
                 catch (Exception ex)
                 {
-                    DebugLogger.Log("audio", $"WASAPI keep-awake failed, falling back to PortAudio: {ex.Message}");
+                    DebugLogger.Log(DebugCategory.Audio, $"WASAPI keep-awake failed, falling back to PortAudio: {ex.Message}");
                     return new PortAudioKeepAwakeStream(deviceId);
                 }
             }
 
-            DebugLogger.Log("audio", "Creating PortAudio keep-awake stream");
+            DebugLogger.Log(DebugCategory.Audio, "Creating PortAudio keep-awake stream");
             return new PortAudioKeepAwakeStream(deviceId);
         }
     }
@@ -41,7 +41,7 @@ namespace NetKeyer.Audio
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to initialize PortAudio keep-awake: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to initialize PortAudio keep-awake: {ex.Message}");
                 Dispose();
                 throw;
             }
@@ -71,7 +71,7 @@ namespace NetKeyer.Audio
                 userData: null
             );
 
-            DebugLogger.Log("audio", $"Keep-awake PortAudio initialized: device={deviceInfo.name}");
+            DebugLogger.Log(DebugCategory.Audio, $"Keep-awake PortAudio initialized: device={deviceInfo.name}");
         }
 
         private int FindPortAudioDeviceIndex(string deviceName)
@@ -87,7 +87,7 @@ namespace NetKeyer.Audio
                     return i;
             }
 
-            DebugLogger.Log("audio", $"Keep-awake: PortAudio device '{deviceName}' not found, using default");
+            DebugLogger.Log(DebugCategory.Audio, $"Keep-awake: PortAudio device '{deviceName}' not found, using default");
             return PortAudio.DefaultOutputDevice;
         }
 
@@ -122,7 +122,7 @@ namespace NetKeyer.Audio
                 }
                 catch (Exception ex)
                 {
-                    DebugLogger.Log("audio", $"Keep-awake PortAudio callback error: {ex.Message}");
+                    DebugLogger.Log(DebugCategory.Audio, $"Keep-awake PortAudio callback error: {ex.Message}");
                     return StreamCallbackResult.Abort;
                 }
             }
@@ -137,11 +137,11 @@ namespace NetKeyer.Audio
             {
                 _stream.Start();
                 _isPlaying = true;
-                DebugLogger.Log("audio", "Keep-awake stream started");
+                DebugLogger.Log(DebugCategory.Audio, "Keep-awake stream started");
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to start keep-awake stream: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to start keep-awake stream: {ex.Message}");
             }
         }
 
@@ -154,11 +154,11 @@ namespace NetKeyer.Audio
             {
                 _stream.Stop();
                 _isPlaying = false;
-                DebugLogger.Log("audio", "Keep-awake stream stopped");
+                DebugLogger.Log(DebugCategory.Audio, "Keep-awake stream stopped");
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to stop keep-awake stream: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to stop keep-awake stream: {ex.Message}");
             }
         }
 
@@ -182,7 +182,7 @@ namespace NetKeyer.Audio
                 }
                 catch (Exception ex)
                 {
-                    DebugLogger.Log("audio", $"Error disposing keep-awake PortAudio stream: {ex.Message}");
+                    DebugLogger.Log(DebugCategory.Audio, $"Error disposing keep-awake PortAudio stream: {ex.Message}");
                 }
                 _stream = null;
             }
@@ -55,7 +55,7 @@ namespace NetKeyer.Audio
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to initialize PortAudio: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to initialize PortAudio: {ex.Message}");
                 Dispose();
                 throw;
             }
@@ -90,8 +90,9 @@ namespace NetKeyer.Audio
 
             // Start the stream
             _stream.Start();
+            KeyingMetrics.SetAudioOutputLatency(deviceInfo.defaultLowOutputLatency * 1000);
 
-            DebugLogger.Log("audio", $"PortAudio initialized: device={deviceInfo.name}, " +
+            DebugLogger.Log(DebugCategory.Audio, $"PortAudio initialized: device={deviceInfo.name}, " +
                               $"latency={deviceInfo.defaultLowOutputLatency * 1000:F1}ms, bufferSize={BUFFER_SAMPLES}");
         }
 
@@ -111,7 +112,7 @@ namespace NetKeyer.Audio
             }
 
             // Device not found, fall back to default
-            DebugLogger.Log("audio", $"PortAudio device '{deviceName}' not found, using default");
+            DebugLogger.Log(DebugCategory.Audio, $"PortAudio device '{deviceName}' not found, using default");
             return PortAudio.DefaultOutputDevice;
         }
 
@@ -123,6 +124,10 @@ namespace NetKeyer.Audio
             StreamCallbackFlags statusFlags,
             IntPtr userData)
         {
+            using var trace = KeyingTrace.Span("audio callback", frameCount);
+            if ((statusFlags & StreamCallbackFlags.OutputUnderflow) != 0)
+                KeyingMetrics.RecordAudioXrun();
+
             lock (_lock)
             {
                 try
@@ -144,7 +149,7 @@ namespace NetKeyer.Audio
                 }
                 catch (Exception ex)
                 {
-                    DebugLogger.Log("audio", $"PortAudio callback error: {ex.Message}");
+                    DebugLogger.Log(DebugCategory.Audio, $"PortAudio callback error: {ex.Message}");
                     return StreamCallbackResult.Abort;
                 }
             }
@@ -216,7 +221,7 @@ namespace NetKeyer.Audio
                 }
                 catch (Exception ex)
                 {
-                    DebugLogger.Log("audio", $"Error disposing PortAudio stream: {ex.Message}");
+                    DebugLogger.Log(DebugCategory.Audio, $"Error disposing PortAudio stream: {ex.Message}");
                 }
                 _stream = null;
             }
@@ -23,19 +23,19 @@ namespace NetKeyer.Audio
             {
                 try
                 {
-                    DebugLogger.Log("audio", $"Initializing WASAPI sidetone generator with device: {deviceId ?? "default"}, aggressiveLowLatency={wasapiAggressiveLowLatency}");
+                    DebugLogger.Log(DebugCategory.Audio, $"Initializing WASAPI sidetone generator with device: {deviceId ?? "default"}, aggressiveLowLatency={wasapiAggressiveLowLatency}");
                     return new WasapiSidetoneGenerator(deviceId, wasapiAggressiveLowLatency);
                 }
                 catch (Exception ex)
                 {
-                    DebugLogger.Log("audio", $"WASAPI initialization failed, falling back to PortAudio: {ex.Message}");
+                    DebugLogger.Log(DebugCategory.Audio, $"WASAPI initialization failed, falling back to PortAudio: {ex.Message}");
                     // Fall back to PortAudio if WASAPI fails
                     return new SidetoneGenerator(deviceId);
                 }
             }
 
             // On Linux/macOS, use PortAudio
-            DebugLogger.Log("audio", "Initializing PortAudio sidetone generator");
+            DebugLogger.Log(DebugCategory.Audio, "Initializing PortAudio sidetone generator");
             return new SidetoneGenerator(deviceId);
         }
 
@@ -45,7 +45,7 @@ namespace NetKeyer.Audio
                 device = FindDeviceByName(_selectedDeviceId);
                 if (device == null)
                 {
-                    DebugLogger.Log("audio", $"Keep-awake: Device '{_selectedDeviceId}' not found, using default");
+                    DebugLogger.Log(DebugCategory.Audio, $"Keep-awake: Device '{_selectedDeviceId}' not found, using default");
                     device = _deviceEnumerator.GetDefaultAudioEndpoint(DataFlow.Render, Role.Multimedia);
                 }
             }
@@ -58,7 +58,7 @@ namespace NetKeyer.Audio
             );
 
             _wasapiOut.Init(_sampleProvider);
-            DebugLogger.Log("audio", $"Keep-awake WASAPI initialized: device={device.FriendlyName}");
+            DebugLogger.Log(DebugCategory.Audio, $"Keep-awake WASAPI initialized: device={device.FriendlyName}");
         }
 
         private MMDevice FindDeviceByName(string friendlyName)
@@ -81,11 +81,11 @@ namespace NetKeyer.Audio
             {
                 _wasapiOut.Play();
                 _isPlaying = true;
-                DebugLogger.Log("audio", "Keep-awake stream started");
+                DebugLogger.Log(DebugCategory.Audio, "Keep-awake stream started");
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to start keep-awake stream: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to start keep-awake stream: {ex.Message}");
             }
         }
 
@@ -98,11 +98,11 @@ namespace NetKeyer.Audio
             {
                 _wasapiOut.Stop();
                 _isPlaying = false;
-                DebugLogger.Log("audio", "Keep-awake stream stopped");
+                DebugLogger.Log(DebugCategory.Audio, "Keep-awake stream stopped");
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to stop keep-awake stream: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to stop keep-awake stream: {ex.Message}");
             }
         }
 
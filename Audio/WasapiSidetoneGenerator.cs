@@ -77,22 +77,22 @@ namespace NetKeyer.Audio
                     {
                         _wasapiOut.Play();
                         _isPlaying = true;
-                        DebugLogger.Log("audio", "WASAPI initialized in always-on mode (not aggressive low-latency)");
+                        DebugLogger.Log(DebugCategory.Audio, "WASAPI initialized in always-on mode (not aggressive low-latency)");
                     }
                     catch (Exception ex)
                     {
-                        DebugLogger.Log("audio", $"Failed to start always-on WASAPI stream: {ex.Message}");
+                        DebugLogger.Log(DebugCategory.Audio, $"Failed to start always-on WASAPI stream: {ex.Message}");
                     }
                 }
                 else
                 {
-                    DebugLogger.Log("audio", "WASAPI initialized in aggressive low-latency mode (on-demand)");
+                    DebugLogger.Log(DebugCategory.Audio, "WASAPI initialized in aggressive low-latency mode (on-demand)");
                 }
                 // Don't start the audio stream until needed - this reduces latency (only in aggressive mode)
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to initialize WASAPI audio: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to initialize WASAPI audio: {ex.Message}");
                 Dispose();
                 throw;
             }
@@ -113,7 +113,7 @@ namespace NetKeyer.Audio
                 device = FindDeviceByName(_selectedDeviceId);
                 if (device == null)
                 {
-                    DebugLogger.Log("audio", $"Device '{_selectedDeviceId}' not found, falling back to default");
+                    DebugLogger.Log(DebugCategory.Audio, $"Device '{_selectedDeviceId}' not found, falling back to default");
                     device = _deviceEnumerator.GetDefaultAudioEndpoint(DataFlow.Render, Role.Multimedia);
                     _selectedDeviceId = null; // Reset to default
                 }
@@ -167,7 +167,7 @@ namespace NetKeyer.Audio
                 }
                 catch (Exception ex)
                 {
-                    DebugLogger.Log("audio", $"Failed to stop WASAPI on idle: {ex.Message}");
+                    DebugLogger.Log(DebugCategory.Audio, $"Failed to stop WASAPI on idle: {ex.Message}");
                 }
             });
 
@@ -208,18 +208,18 @@ namespace NetKeyer.Audio
                     {
                         _wasapiOut.Play();
                         _isPlaying = true;
-                        DebugLogger.Log("audio", "WASAPI restarted in always-on mode after device change");
+                        DebugLogger.Log(DebugCategory.Audio, "WASAPI restarted in always-on mode after device change");
                     }
                     catch (Exception ex)
                     {
-                        DebugLogger.Log("audio", $"Failed to restart always-on WASAPI stream: {ex.Message}");
+                        DebugLogger.Log(DebugCategory.Audio, $"Failed to restart always-on WASAPI stream: {ex.Message}");
                     }
                 }
                 // Don't auto-start in aggressive mode - will be started when tone is needed
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to switch to new default audio device: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to switch to new default audio device: {ex.Message}");
             }
         }
 
@@ -233,7 +233,7 @@ namespace NetKeyer.Audio
             {
                 if (newState != DeviceState.Active)
                 {
-                    DebugLogger.Log("audio", $"Selected device '{_selectedDeviceId}' disconnected, falling back to default");
+                    DebugLogger.Log(DebugCategory.Audio, $"Selected device '{_selectedDeviceId}' disconnected, falling back to default");
                     _selectedDeviceId = null; // Fall back to default
                     OnDefaultDeviceChanged(); // Reinitialize with default device
                 }
@@ -292,7 +292,7 @@ namespace NetKeyer.Audio
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to start WASAPI sidetone: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to start WASAPI sidetone: {ex.Message}");
             }
         }
 
@@ -318,7 +318,7 @@ namespace NetKeyer.Audio
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to stop WASAPI sidetone: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to stop WASAPI sidetone: {ex.Message}");
             }
         }
 
@@ -345,7 +345,7 @@ namespace NetKeyer.Audio
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to start timed WASAPI sidetone: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to start timed WASAPI sidetone: {ex.Message}");
             }
         }
 
@@ -367,7 +367,7 @@ namespace NetKeyer.Audio
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to start silence+tone: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to start silence+tone: {ex.Message}");
             }
         }
 
@@ -382,7 +382,7 @@ namespace NetKeyer.Audio
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Failed to queue silence: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Failed to queue silence: {ex.Message}");
             }
         }
 
@@ -0,0 +1,108 @@
+using System;
+using System.IO;
+using System.Threading;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// Writes a file in the background once changes stop arriving. <see cref="MarkDirty"/> takes
+/// the finished contents, serialized by the caller on its own thread, and only re-arms a timer,
+/// so callers on the UI thread never touch the disk and the background never reads objects the
+/// UI is changing. The latest contents are written on a thread-pool thread after
+/// <c>idleDelayMs</c> without further changes, or at the latest <c>maxDelayMs</c> after the
+/// first unsaved change, so a long slider drag still gets saved. Writes go to a temporary file
+/// that is then renamed over the target, so a crash mid-write never leaves a truncated file
+/// behind.
+/// </summary>
+public sealed class DebouncedFileWriter : IDisposable
+{
+    private readonly string _path;
+    private readonly int _idleDelayMs;
+    private readonly int _maxDelayMs;
+    private readonly Timer _timer;
+    private readonly object _stateLock = new object();
+    private readonly object _writeLock = new object();
+    private byte[] _pendingContents;
+    private long _firstDirtyTimestamp;
+    private long _writes;
+
+    /// <param name="path">File to write.</param>
+    public DebouncedFileWriter(string path, int idleDelayMs = 500, int maxDelayMs = 2000)
+    {
+        _path = path;
+        _idleDelayMs = idleDelayMs;
+        _maxDelayMs = maxDelayMs;
+        _timer = new Timer(_ => WriteIfDirty());
+    }
+
+    /// <summary>
+    /// Number of times the file has been written.
+    /// </summary>
+    public long Writes => Interlocked.Read(ref _writes);
+
+    /// <summary>
+    /// Schedules <paramref name="contents"/> to be written, replacing any contents not yet
+    /// written. Cheap enough to call on every change. The array must not be modified afterwards.
+    /// </summary>
+    public void MarkDirty(byte[] contents)
+    {
+        ArgumentNullException.ThrowIfNull(contents);
+        lock (_stateLock)
+        {
+            long now = Timebase.Now;
+            if (_pendingContents == null)
+                _firstDirtyTimestamp = now;
+            _pendingContents = contents;
+
+            long untilMax = _maxDelayMs - Timebase.ToMillisecondsLong(now - _firstDirtyTimestamp);
+            _timer.Change(Math.Max(0, Math.Min(_idleDelayMs, untilMax)), Timeout.Infinite);
+        }
+    }
+
+    /// <summary>
+    /// Writes any pending change now, on the calling thread.
+    /// </summary>
+    public void Flush()
+    {
+        lock (_stateLock)
+            _timer.Change(Timeout.Infinite, Timeout.Infinite);
+        WriteIfDirty();
+    }
+
+    private void WriteIfDirty()
+    {
+        lock (_writeLock)
+        {
+            byte[] contents;
+            lock (_stateLock)
+            {
+                contents = _pendingContents;
+                if (contents == null)
+                    return;
+                _pendingContents = null;
+            }
+
+            try
+            {
+                string tempPath = _path + ".tmp";
+                using (var stream = new FileStream(tempPath, FileMode.Create, FileAccess.Write, FileShare.None))
+                {
+                    stream.Write(contents, 0, contents.Length);
+                    stream.Flush(flushToDisk: true);
+                }
+                File.Move(tempPath, _path, overwrite: true);
+                Interlocked.Increment(ref _writes);
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine($"Error saving {Path.GetFileName(_path)}: {ex.Message}");
+            }
+        }
+    }
+
+    public void Dispose()
+    {
+        Flush();
+        _timer.Dispose();
+    }
+}
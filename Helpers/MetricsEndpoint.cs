@@ -0,0 +1,266 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics.Metrics;
+using System.Globalization;
+using System.IO;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// Serves the <see cref="KeyingMetrics"/> instruments as Prometheus text at
+/// http://127.0.0.1:port/metrics, for stations run on a remote PC. It listens on the loopback
+/// interface only: scrape it from a local agent, or over an SSH tunnel or VPN.
+///
+/// Off unless NETKEYER_METRICS_PORT is set. Counters are totals since startup and histograms
+/// use fixed millisecond buckets.
+/// </summary>
+public sealed class MetricsEndpoint : IDisposable
+{
+    private static readonly double[] BUCKET_BOUNDS_MS = { 0.05, 0.1, 0.25, 0.5, 1, 2, 5, 10, 20, 50, 100, 250, 1000 };
+
+    private static MetricsEndpoint _instance;
+
+    private readonly MeterListener _listener = new MeterListener();
+    private readonly List<Series> _series = new List<Series>();
+    private readonly TcpListener _tcpListener;
+    private Thread _acceptThread;
+    private volatile bool _running;
+
+    public MetricsEndpoint(int port)
+    {
+        _tcpListener = new TcpListener(IPAddress.Loopback, port);
+
+        _listener.InstrumentPublished = (instrument, listener) =>
+        {
+            if (instrument.Meter.Name != KeyingMetrics.METER_NAME)
+                return;
+
+            var series = new Series(instrument);
+            lock (_series)
+                _series.Add(series);
+            listener.EnableMeasurementEvents(instrument, series);
+        };
+        _listener.SetMeasurementEventCallback<long>((_, value, _, state) => ((Series)state).Record(value));
+        _listener.SetMeasurementEventCallback<int>((_, value, _, state) => ((Series)state).Record(value));
+        _listener.SetMeasurementEventCallback<double>((_, value, _, state) => ((Series)state).Record(value));
+    }
+
+    public int Port => ((IPEndPoint)_tcpListener.LocalEndpoint).Port;
+
+    /// <summary>
+    /// Starts the endpoint if NETKEYER_METRICS_PORT is set to a port number.
+    /// </summary>
+    public static void StartFromEnvironment()
+    {
+        var value = Environment.GetEnvironmentVariable("NETKEYER_METRICS_PORT");
+        if (string.IsNullOrWhiteSpace(value))
+            return;
+
+        if (!int.TryParse(value, out int port) || port <= 0 || port > 65535)
+        {
+            Console.WriteLine($"Warning: Ignoring NETKEYER_METRICS_PORT={value}: not a port number");
+            return;
+        }
+
+        try
+        {
+            _instance = new MetricsEndpoint(port);
+            _instance.Start();
+            Console.WriteLine($"Metrics available at http://127.0.0.1:{port}/metrics");
+        }
+        catch (SocketException ex)
+        {
+            Console.WriteLine($"Warning: Failed to start metrics endpoint on port {port}: {ex.Message}");
+            _instance = null;
+        }
+    }
+
+    public void Start()
+    {
+        _tcpListener.Start();
+        _listener.Start();
+
+        _running = true;
+        _acceptThread = new Thread(AcceptLoop) { Name = "metrics endpoint", IsBackground = true };
+        _acceptThread.Start();
+    }
+
+    public void Dispose()
+    {
+        _running = false;
+        try { _tcpListener.Stop(); } catch { }
+        _acceptThread?.Join();
+        _listener.Dispose();
+    }
+
+    /// <summary>
+    /// Current values of all instruments in the Prometheus text exposition format.
+    /// </summary>
+    public string Render()
+    {
+        // Observable instruments report through the measurement callbacks
+        _listener.RecordObservableInstruments();
+
+        var text = new StringBuilder();
+        lock (_series)
+        {
+            foreach (var series in _series)
+                series.Render(text);
+        }
+        return text.ToString();
+    }
+
+    private void AcceptLoop()
+    {
+        while (_running)
+        {
+            TcpClient client;
+            try
+            {
+                client = _tcpListener.AcceptTcpClient();
+            }
+            catch (SocketException)
+            {
+                break;
+            }
+            catch (ObjectDisposedException)
+            {
+                break;
+            }
+
+            // Scrapes are rare and quick; serve them one at a time
+            using (client)
+            {
+                try
+                {
+                    Serve(client);
+                }
+                catch (IOException) { }
+                catch (SocketException) { }
+            }
+        }
+    }
+
+    private void Serve(TcpClient client)
+    {
+        client.ReceiveTimeout = 2000;
+        client.SendTimeout = 2000;
+        var stream = client.GetStream();
+        var reader = new StreamReader(stream, Encoding.ASCII);
+
+        string requestLine = reader.ReadLine() ?? "";
+        string line;
+        while (!string.IsNullOrEmpty(line = reader.ReadLine()))
+        {
+            // Headers aren't needed
+        }
+
+        var parts = requestLine.Split(' ');
+        bool found = parts.Length >= 2 && parts[0] == "GET" && (parts[1] == "/metrics" || parts[1] == "/");
+        string body = found ? Render() : "Not found\n";
+        byte[] bodyBytes = Encoding.UTF8.GetBytes(body);
+
+        string header = (found ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 404 Not Found\r\n") +
+                        (found ? "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n" : "Content-Type: text/plain\r\n") +
+                        $"Content-Length: {bodyBytes.Length}\r\n" +
+                        "Connection: close\r\n\r\n";
+        byte[] headerBytes = Encoding.ASCII.GetBytes(header);
+        stream.Write(headerBytes, 0, headerBytes.Length);
+        stream.Write(bodyBytes, 0, bodyBytes.Length);
+    }
+
+    /// <summary>
+    /// Aggregated values of one instrument. Record() runs on the thread that measured, so
+    /// it only updates counters atomically.
+    /// </summary>
+    private sealed class Series
+    {
+        private readonly string _name;
+        private readonly string _help;
+        private readonly string _type;
+        private readonly bool _additive;
+        private readonly long[] _buckets;
+        private long _count;
+        private double _value;
+
+        public Series(Instrument instrument)
+        {
+            var definition = instrument.GetType().GetGenericTypeDefinition();
+            _type = definition == typeof(Counter<>) || definition == typeof(ObservableCounter<>) ? "counter"
+                  : definition == typeof(Histogram<>) ? "histogram"
+                  : "gauge";
+            _additive = definition == typeof(Counter<>) || definition == typeof(Histogram<>);
+            if (_type == "histogram")
+                _buckets = new long[BUCKET_BOUNDS_MS.Length];
+
+            // Prometheus names: netkeyer.audio.callback.duration (ms) -> netkeyer_audio_callback_duration_milliseconds
+            _name = instrument.Name.Replace('.', '_');
+            if (instrument.Unit == "ms")
+                _name += "_milliseconds";
+            if (_type == "counter")
+                _name += "_total";
+            _help = instrument.Description;
+        }
+
+        public void Record(double value)
+        {
+            if (_buckets != null)
+            {
+                for (int i = 0; i < BUCKET_BOUNDS_MS.Length; i++)
+                {
+                    if (value <= BUCKET_BOUNDS_MS[i])
+                    {
+                        Interlocked.Increment(ref _buckets[i]);
+                        break;
+                    }
+                }
+                Interlocked.Increment(ref _count);
+            }
+
+            if (!_additive)
+            {
+                Interlocked.Exchange(ref _value, value);
+                return;
+            }
+
+            double current = Volatile.Read(ref _value);
+            while (true)
+            {
+                double seen = Interlocked.CompareExchange(ref _value, current + value, current);
+                if (seen == current)
+                    break;
+                current = seen;
+            }
+        }
+
+        public void Render(StringBuilder text)
+        {
+            string name = _name;
+            text.Append("# HELP ").Append(name).Append(' ').Append(_help).Append('\n');
+            text.Append("# TYPE ").Append(name).Append(' ').Append(_type).Append('\n');
+
+            if (_buckets == null)
+            {
+                text.Append(name).Append(' ').Append(Format(Volatile.Read(ref _value))).Append('\n');
+                return;
+            }
+
+            long cumulative = 0;
+            for (int i = 0; i < BUCKET_BOUNDS_MS.Length; i++)
+            {
+                cumulative += Interlocked.Read(ref _buckets[i]);
+                text.Append(name).Append("_bucket{le=\"").Append(Format(BUCKET_BOUNDS_MS[i])).Append("\"} ").Append(cumulative).Append('\n');
+            }
+            long count = Interlocked.Read(ref _count);
+            text.Append(name).Append("_bucket{le=\"+Inf\"} ").Append(count).Append('\n');
+            text.Append(name).Append("_sum ").Append(Format(Volatile.Read(ref _value))).Append('\n');
+            text.Append(name).Append("_count ").Append(count).Append('\n');
+        }
+
+        private static string Format(double value) => value.ToString("R", CultureInfo.InvariantCulture);
+    }
+}
@@ -0,0 +1,31 @@
+using System;
+using System.Diagnostics;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// Process-wide startup cost, measured the same way by the GUI and headless builds so they
+/// can be compared: wall time since the process started (runtime startup included) and the
+/// working set.
+/// </summary>
+public static class StartupStats
+{
+    /// <summary>
+    /// Milliseconds since the process started.
+    /// </summary>
+    public static double SinceProcessStartMs
+    {
+        get
+        {
+            using var process = Process.GetCurrentProcess();
+            return (DateTime.Now - process.StartTime).TotalMilliseconds;
+        }
+    }
+
+    /// <summary>
+    /// Resident memory in megabytes.
+    /// </summary>
+    public static double WorkingSetMb => Environment.WorkingSet / (1024.0 * 1024.0);
+
+    public static string Describe() => $"{SinceProcessStartMs:F0} ms after process start, working set {WorkingSetMb:F1} MB";
+}
@@ -5,6 +5,9 @@ using System.Linq;
 using System.Security.Cryptography;
 using System.Text;
 using System.Text.Json;
+using System.Text.Json.Serialization;
+using NetKeyer.Helpers;
+using NetKeyer.Keying;
 
 namespace NetKeyer.Models
 {
@@ -12,8 +15,17 @@ namespace NetKeyer.Models
     {
         public string SelectedRadioSerial { get; set; }
         public string SelectedGuiClientStation { get; set; }
+
+        // Last LAN radio's discovery details, so startup can connect to it directly without
+        // waiting for its discovery broadcast (address is empty for SmartLink radios)
+        public string SelectedRadioAddress { get; set; }
+        public string SelectedRadioModel { get; set; }
+        public string SelectedRadioNickname { get; set; }
+        public string SelectedRadioVersion { get; set; }
+
         public string SelectedSerialPort { get; set; }
         public string SelectedMidiDevice { get; set; }
+        public string SelectedEvdevDevice { get; set; }
         public string InputType { get; set; } = "Serial";
 
         // Audio output device selection (empty string = use system default)
@@ -28,6 +40,45 @@ namespace NetKeyer.Models
         // MIDI note mappings
         public List<MidiNoteMapping> MidiNoteMappings { get; set; }
 
+        // evdev (Linux) key code mappings
+        public List<EvdevKeyMapping> EvdevKeyMappings { get; set; }
+
+        // UDP port the network paddle input listens on
+        public int NetworkInputPort { get; set; } = 7373;
+
+        // Local address the network input listens on: loopback by default, so only this machine
+        // (or a tunnel ending on it) can key the radio. "0.0.0.0" listens on every interface
+        public string NetworkInputBindAddress { get; set; } = "127.0.0.1";
+
+        // Sender addresses the network input accepts (empty = any sender that can reach it)
+        public List<string> NetworkInputAllowedSenders { get; set; } = new List<string>();
+
+        // Forward local paddle input to a remote NetKeyer ("host:port", empty = off)
+        public string NetworkForwardTarget { get; set; } = "";
+
+        // Longest the radio may stay keyed before the watchdog forces key-up (0 = no limit)
+        public int MaxKeyDownMs { get; set; } = KeyerParameters.DEFAULT_MAX_KEY_DOWN_MS;
+
+        // PTT keying in non-CW modes: hold PTT this long before MOX goes on (a debounce, so
+        // shorter taps send nothing), and keep MOX on this long after it is released
+        public int PttDebounceMs { get; set; } = 0;
+        public int PttHangMs { get; set; } = 0;
+
+        // Earlier name for PttDebounceMs, read from older settings files and never written
+        [System.Text.Json.Serialization.JsonIgnore(Condition = System.Text.Json.Serialization.JsonIgnoreCondition.WhenWritingNull)]
+        public int? PttLeadMs
+        {
+            get => null;
+            set { if (value.HasValue) PttDebounceMs = value.Value; }
+        }
+
+        // Real-time profile for the audio, keying and input threads: pin them to
+        // RealtimeCores ("2-3", empty = last core) and raise their priority; optionally
+        // move every other thread off those cores
+        public bool RealtimeProfile { get; set; } = false;
+        public string RealtimeCores { get; set; } = "";
+        public bool RealtimeIsolateCores { get; set; } = false;
+
         // SmartLink settings
         public string SmartLinkClientId { get; set; }
         public bool RememberMeSmartLink { get; set; } = true;
@@ -58,6 +109,9 @@ namespace NetKeyer.Models
             }
         }
 
+        // Writes are debounced and happen off the UI thread; see Save()
+        private static readonly Lazy<DebouncedFileWriter> _writer = new(CreateWriter);
+
         private static string SettingsFilePath
         {
             get
@@ -202,8 +256,11 @@ namespace NetKeyer.Models
             {
                 if (File.Exists(SettingsFilePath))
                 {
-                    var json = File.ReadAllText(SettingsFilePath);
-                    var settings = JsonSerializer.Deserialize<UserSettings>(json) ?? new UserSettings();
+                    // A pending write would make the file stale
+                    Flush();
+
+                    var json = File.ReadAllBytes(SettingsFilePath);
+                    var settings = JsonSerializer.Deserialize(json, UserSettingsJsonContext.Default.UserSettings) ?? new UserSettings();
 
                     // Decrypt the refresh token if present
                     if (!string.IsNullOrEmpty(settings.SmartLinkRefreshTokenEncrypted))
@@ -217,6 +274,11 @@ namespace NetKeyer.Models
                         settings.MidiNoteMappings = MidiNoteMapping.GetDefaultMappings();
                     }
 
+                    if (settings.EvdevKeyMappings == null || settings.EvdevKeyMappings.Count == 0)
+                    {
+                        settings.EvdevKeyMappings = EvdevKeyMapping.GetDefaultMappings();
+                    }
+
                     return settings;
                 }
             }
@@ -227,20 +289,53 @@ namespace NetKeyer.Models
 
             var newSettings = new UserSettings();
             newSettings.MidiNoteMappings = MidiNoteMapping.GetDefaultMappings();
+            newSettings.EvdevKeyMappings = EvdevKeyMapping.GetDefaultMappings();
             return newSettings;
         }
 
+        /// <summary>
+        /// Schedules these settings to be written. They are serialized here, on the calling
+        /// thread, so later changes to this instance can't race with the write; only the file
+        /// I/O happens in the background. Changes are coalesced and written 500 ms after the last
+        /// one (at most 2 s after the first), and any pending write is flushed when the process
+        /// exits.
+        /// </summary>
         public void Save()
         {
             try
             {
-                var json = JsonSerializer.Serialize(this, new JsonSerializerOptions { WriteIndented = true });
-                File.WriteAllText(SettingsFilePath, json);
+                _writer.Value.MarkDirty(JsonSerializer.SerializeToUtf8Bytes(this, UserSettingsJsonContext.Default.UserSettings));
             }
             catch (Exception ex)
             {
                 Console.WriteLine($"Error saving settings: {ex.Message}");
             }
         }
+
+        /// <summary>
+        /// Writes any pending settings change now, on the calling thread.
+        /// </summary>
+        public static void Flush()
+        {
+            if (_writer.IsValueCreated)
+                _writer.Value.Flush();
+        }
+
+        private static DebouncedFileWriter CreateWriter()
+        {
+            var writer = new DebouncedFileWriter(SettingsFilePath);
+            AppDomain.CurrentDomain.ProcessExit += (_, _) => writer.Flush();
+            return writer;
+        }
+    }
+
+    /// <summary>
+    /// Compile-time generated serializer for settings.json, so loading and saving don't pay
+    /// for reflection.
+    /// </summary>
+    [JsonSourceGenerationOptions(WriteIndented = true)]
+    [JsonSerializable(typeof(UserSettings))]
+    internal partial class UserSettingsJsonContext : JsonSerializerContext
+    {
     }
 }
@@ -1,6 +1,7 @@
 using System;
 using NAudio.Wave;
 using NetKeyer.Helpers;
+using NetKeyer.Realtime;
 
 namespace NetKeyer.Audio
 {
@@ -32,12 +33,32 @@ namespace NetKeyer.Audio
 
         private readonly object _lockObject = new object();
 
-        // Cached once at startup — IsEnabled() is cheap but string interpolation before Log() is not.
-        // Using a cached bool ensures the hot path (Read()) pays zero allocation cost when disabled.
-        private static readonly bool _sidetoneDebug = DebugLogger.IsEnabled("sidetone");
+        // Audio render clock: frames produced so far, mapped onto the timebase from the
+        // time each Read() callback starts
+        private long _framesRendered = 0;
+        private readonly ClockMapper _renderClock = new ClockMapper();
+
+        // When a tone was requested from silence, until the Read() that starts rendering it
+        private long _toneRequestTimestamp = 0;
+
+        // Cached once at startup so the hot path (Read()) skips its debug bookkeeping entirely when disabled.
+        private static readonly bool _sidetoneDebug = DebugCategory.Sidetone.IsEnabled;
 
         public bool IsSilent => _state == PlaybackState.Silent || _state == PlaybackState.TimedSilence;
 
+        /// <summary>
+        /// Converts a position in the rendered stream (frames since the provider was created)
+        /// to a <see cref="Timebase"/> timestamp of when that frame was rendered. Output
+        /// latency of the device comes on top of this.
+        /// </summary>
+        public long GetFrameTimestamp(long frame)
+        {
+            lock (_lockObject)
+            {
+                return _renderClock.Map(Timebase.FramesToNanoseconds(frame, SAMPLE_RATE));
+            }
+        }
+
         // Event fired when a timed silence completes and no next tone was queued
         public event Action OnSilenceComplete;
 
@@ -122,7 +143,7 @@ namespace NetKeyer.Audio
                 // If we're in timed silence, queue the tone instead of starting immediately
                 if (_state == PlaybackState.TimedSilence)
                 {
-                    if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] StartTone called during silence, queuing tone: {durationMs}ms");
+                    if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] StartTone called during silence, queuing tone: {durationMs}ms");
                     _queuedToneDurationMs = durationMs;
                     return;
                 }
@@ -145,8 +166,9 @@ namespace NetKeyer.Audio
                 _indefiniteTone = false;
                 _patchPosition = 0;
                 _state = PlaybackState.RampUp;
+                _toneRequestTimestamp = Timebase.Now;
 
-                if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Starting timed tone: {durationMs}ms, totalSamples={totalSamples}, rampSamples={rampSamples}, sustainSamples={sustainSamples}, remainingCycles={_remainingCycles}");
+                if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Starting timed tone: {durationMs}ms, totalSamples={totalSamples}, rampSamples={rampSamples}, sustainSamples={sustainSamples}, remainingCycles={_remainingCycles}");
 
                 // Fire event synchronously from audio thread for deterministic timing.
                 // IambicKeyer handlers are designed to be fast (just state updates).
@@ -158,7 +180,7 @@ namespace NetKeyer.Audio
                     }
                     catch (Exception ex)
                     {
-                        if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Error in OnToneStart: {ex}");
+                        if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Error in OnToneStart: {ex}");
                     }
                 }
             }
@@ -180,7 +202,7 @@ namespace NetKeyer.Audio
                 _remainingSilenceSamples = (int)(silenceMs * SAMPLE_RATE / 1000.0);
                 _state = PlaybackState.TimedSilence;
 
-                if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Starting silence ({silenceMs}ms) then tone ({toneMs}ms)");
+                if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Starting silence ({silenceMs}ms) then tone ({toneMs}ms)");
             }
         }
 
@@ -196,12 +218,12 @@ namespace NetKeyer.Audio
                 _queuedSilenceDurationMs = silenceMs;
                 _queuedToneDurationMs = followingToneMs;
 
-                if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Queued silence: {silenceMs}ms, following tone: {followingToneMs?.ToString() ?? "none"}");
+                if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Queued silence: {silenceMs}ms, following tone: {followingToneMs?.ToString() ?? "none"}");
 
                 // If we're already silent (tone already completed), start the silence immediately
                 if (_state == PlaybackState.Silent)
                 {
-                    if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] Already silent, starting queued silence immediately");
+                    if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] Already silent, starting queued silence immediately");
                     _remainingSilenceSamples = (int)(silenceMs * SAMPLE_RATE / 1000.0);
                     _state = PlaybackState.TimedSilence;
                     _queuedSilenceDurationMs = null; // Clear the queue since we're starting it now
@@ -220,15 +242,16 @@ namespace NetKeyer.Audio
                 // If already playing or ramping up, ignore
                 if (_state == PlaybackState.RampUp || _state == PlaybackState.Sustain)
                 {
-                    if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] StartIndefiniteTone called but already playing (state={_state}), ignoring");
+                    if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] StartIndefiniteTone called but already playing (state={_state}), ignoring");
                     return;
                 }
 
                 // If in ramp-down or silent, start a new tone immediately
-                if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Starting indefinite tone (was {_state}), freq={_frequency}Hz vol={_volume} wpm={_wpm}");
+                if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Starting indefinite tone (was {_state}), freq={_frequency}Hz vol={_volume} wpm={_wpm}");
                 _indefiniteTone = true;
                 _patchPosition = 0;
                 _state = PlaybackState.RampUp;
+                _toneRequestTimestamp = Timebase.Now;
             }
         }
 
@@ -243,11 +266,11 @@ namespace NetKeyer.Audio
                 {
                     if (_state == PlaybackState.Silent)
                     {
-                        if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] Stop called but already silent");
+                        if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] Stop called but already silent");
                         return;
                     }
 
-                    if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] Stopping tone, transitioning to ramp-down");
+                    if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] Stopping tone, transitioning to ramp-down");
                     // Immediate transition to ramp-down
                     _state = PlaybackState.RampDown;
                     _patchPosition = 0;
@@ -255,7 +278,7 @@ namespace NetKeyer.Audio
                 {
                     if (_state == PlaybackState.TimedSilence)
                     {
-                        if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] Stopping a timed silence");
+                        if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] Stopping a timed silence");
                         _queuedToneDurationMs = null;
                     }
                 }
@@ -266,19 +289,30 @@ namespace NetKeyer.Audio
 
         public int Read(float[] buffer, int offset, int count)
         {
+            RealtimeProfile.EnterThread(RealtimeThreadRole.Audio);
+            using var trace = KeyingTrace.Span("sidetone render", count);
+            long readStart = Timebase.Now;
             lock (_lockObject)
             {
+                if (_toneRequestTimestamp != 0)
+                {
+                    KeyingMetrics.RecordSidetoneStart(readStart - _toneRequestTimestamp);
+                    _toneRequestTimestamp = 0;
+                }
+
+                _renderClock.Observe(Timebase.FramesToNanoseconds(_framesRendered, SAMPLE_RATE), Timebase.Now);
+
                 if (_sidetoneDebug)
                 {
                     _readCallCount++;
                     // Log EVERY call during RampUp/Sustain/RampDown, not just every 1000th
                     if (_state != PlaybackState.Silent && _state != PlaybackState.TimedSilence)
                     {
-                        DebugLogger.Log("sidetone", $"[SidetoneProvider] Read #{_readCallCount}: state={_state}, _patchPosition={_patchPosition}, _remainingCycles={_remainingCycles}, count={count}");
+                        DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Read #{_readCallCount}: state={_state}, _patchPosition={_patchPosition}, _remainingCycles={_remainingCycles}, count={count}");
                     }
                     else if (_readCallCount % 1000 == 0)
                     {
-                        DebugLogger.Log("sidetone", $"[SidetoneProvider] Read called {_readCallCount} times, state={_state}");
+                        DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Read called {_readCallCount} times, state={_state}");
                     }
                 }
 
@@ -298,7 +332,7 @@ namespace NetKeyer.Audio
                             samplesWritten += CopyFromPatch(_rampUpPatch, buffer, offset + samplesWritten, count - samplesWritten);
                             if (_patchPosition >= _rampUpPatch.Length)
                             {
-                                if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] RampUp complete, transitioning to Sustain");
+                                if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] RampUp complete, transitioning to Sustain");
                                 _state = PlaybackState.Sustain;
                                 _patchPosition = 0;
                             }
@@ -323,7 +357,7 @@ namespace NetKeyer.Audio
                                     _remainingCycles--;
                                     if (_remainingCycles == 0)
                                     {
-                                        if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] Sustain complete (all cycles done), transitioning to RampDown");
+                                        if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] Sustain complete (all cycles done), transitioning to RampDown");
                                         _state = PlaybackState.RampDown;
                                     }
                                 }
@@ -331,7 +365,7 @@ namespace NetKeyer.Audio
                             else
                             {
                                 // No more cycles to play, go to ramp-down
-                                if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] Sustain: no cycles to play, transitioning to RampDown");
+                                if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] Sustain: no cycles to play, transitioning to RampDown");
                                 _state = PlaybackState.RampDown;
                                 _patchPosition = 0;
                             }
@@ -344,7 +378,7 @@ namespace NetKeyer.Audio
                                 _patchPosition = 0;
 
                                 // Fire OnToneComplete event immediately
-                                if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] Ramp-down complete, firing OnToneComplete");
+                                if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] Ramp-down complete, firing OnToneComplete");
                                 if (OnToneComplete != null)
                                 {
                                     try
@@ -353,14 +387,14 @@ namespace NetKeyer.Audio
                                     }
                                     catch (Exception ex)
                                     {
-                                        if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Error in OnToneComplete: {ex}");
+                                        if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Error in OnToneComplete: {ex}");
                                     }
                                 }
 
                                 // Check if we have a queued silence
                                 if (_queuedSilenceDurationMs.HasValue)
                                 {
-                                    if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Ramp-down complete, starting queued silence: {_queuedSilenceDurationMs.Value}ms");
+                                    if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Ramp-down complete, starting queued silence: {_queuedSilenceDurationMs.Value}ms");
                                     _remainingSilenceSamples = (int)(_queuedSilenceDurationMs.Value * SAMPLE_RATE / 1000.0);
                                     _queuedSilenceDurationMs = null;
                                     _state = PlaybackState.TimedSilence;
@@ -385,7 +419,7 @@ namespace NetKeyer.Audio
                             // Check if silence period is complete
                             if (_remainingSilenceSamples <= 0)
                             {
-                                if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] Silence complete");
+                                if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] Silence complete");
 
                                 // Fire OnBeforeSilenceEnd immediately while holding lock
                                 // This allows keyer to start a tone that will begin in the same buffer
@@ -395,12 +429,12 @@ namespace NetKeyer.Audio
                                 {
                                     try
                                     {
-                                        if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] Firing OnBeforeSilenceEnd event (sync, in lock)");
+                                        if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] Firing OnBeforeSilenceEnd event (sync, in lock)");
                                         OnBeforeSilenceEnd.Invoke();
                                     }
                                     catch (Exception ex)
                                     {
-                                        if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Error in OnBeforeSilenceEnd: {ex}");
+                                        if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Error in OnBeforeSilenceEnd: {ex}");
                                     }
                                 }
 
@@ -408,13 +442,13 @@ namespace NetKeyer.Audio
                                 // If so, the while loop will continue and start filling the tone immediately
                                 if (_state == PlaybackState.RampUp)
                                 {
-                                    if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] Tone started by OnBeforeSilenceEnd handler, continuing with RampUp in same buffer");
+                                    if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] Tone started by OnBeforeSilenceEnd handler, continuing with RampUp in same buffer");
                                     // OnToneStart was already fired by StartTone(), just continue the while loop
                                 }
                                 // Check if we have a queued tone (old code path for compatibility)
                                 else if (_queuedToneDurationMs.HasValue)
                                 {
-                                    if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Starting queued tone: {_queuedToneDurationMs.Value}ms");
+                                    if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Starting queued tone: {_queuedToneDurationMs.Value}ms at frame {_framesRendered + samplesWritten} (t={Timebase.ToMilliseconds(_renderClock.Map(Timebase.FramesToNanoseconds(_framesRendered + samplesWritten, SAMPLE_RATE))):F3} ms)");
                                     int toneMs = _queuedToneDurationMs.Value;
                                     _queuedToneDurationMs = null;
 
@@ -436,14 +470,14 @@ namespace NetKeyer.Audio
                                         }
                                         catch (Exception ex)
                                         {
-                                            if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Error in OnToneStart: {ex}");
+                                            if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Error in OnToneStart: {ex}");
                                         }
                                     }
                                 }
                                 else
                                 {
                                     // No tone started, transition to Silent
-                                    if (_sidetoneDebug) DebugLogger.Log("sidetone", "[SidetoneProvider] No tone to start, transitioning to Silent");
+                                    if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, "[SidetoneProvider] No tone to start, transitioning to Silent");
                                     _state = PlaybackState.Silent;
 
                                     // Fire OnSilenceComplete event immediately
@@ -455,7 +489,7 @@ namespace NetKeyer.Audio
                                         }
                                         catch (Exception ex)
                                         {
-                                            if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Error in OnSilenceComplete: {ex}");
+                                            if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Error in OnSilenceComplete: {ex}");
                                         }
                                     }
 
@@ -468,7 +502,7 @@ namespace NetKeyer.Audio
                                         }
                                         catch (Exception ex)
                                         {
-                                            if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] Error in OnBecomeIdle: {ex}");
+                                            if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] Error in OnBecomeIdle: {ex}");
                                         }
                                     }
                                 }
@@ -476,6 +510,8 @@ namespace NetKeyer.Audio
                             break;
                     }
                 }
+                _framesRendered += count;
+                KeyingMetrics.RecordAudioCallback(readStart);
                 return count;
             } // End of lock
         }
@@ -515,7 +551,7 @@ namespace NetKeyer.Audio
             int rampCycles = Math.Max(1, (int)Math.Round((double)rampSamples / samplesPerCycle));
             int actualRampSamples = rampCycles * samplesPerCycle;
 
-            if (_sidetoneDebug) DebugLogger.Log("sidetone", $"[SidetoneProvider] RegeneratePatches: freq={_frequency}Hz->actual={actualFrequency:F1}Hz, vol={_volume}, wpm={_wpm}, samplesPerCycle={samplesPerCycle}, rampSamples={actualRampSamples}");
+            if (_sidetoneDebug) DebugLogger.Log(DebugCategory.Sidetone, $"[SidetoneProvider] RegeneratePatches: freq={_frequency}Hz->actual={actualFrequency:F1}Hz, vol={_volume}, wpm={_wpm}, samplesPerCycle={samplesPerCycle}, rampSamples={actualRampSamples}");
 
             // Generate single cycle patch
             _singleCyclePatch = new float[samplesPerCycle];
@@ -0,0 +1,345 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Runtime.InteropServices;
+using System.Threading;
+using NetKeyer.Helpers;
+using NetKeyer.Models;
+using NetKeyer.Realtime;
+
+namespace NetKeyer.Evdev
+{
+    /// <summary>
+    /// Reads keying inputs from a Linux evdev device (/dev/input/event*), such as USB keyer
+    /// adapters that enumerate as HID keyboards.  The device is grabbed exclusively so key
+    /// presses don't also reach the focused window, and each edge is stamped with the kernel's
+    /// input_event.time on CLOCK_MONOTONIC, the clock <see cref="Timebase"/> uses on Linux.
+    /// </summary>
+    public class EvdevPaddleInput : IDisposable
+    {
+        private const string SYSFS_INPUT_DIR = "/sys/class/input";
+        private const string DEV_INPUT_DIR = "/dev/input";
+        private const int POLL_TIMEOUT_MS = 100;
+        private const int EVENTS_PER_READ = 64;
+        private const int KEY_CODE_COUNT = 0x300; // KEY_MAX + 1
+        private const ushort SYN_DROPPED = 3;
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct InputEvent
+        {
+            public nint Seconds;
+            public nint Microseconds;
+            public ushort Type;
+            public ushort Code;
+            public int Value;
+        }
+
+        private int _fd = -1;
+        private Thread _readThread;
+        private volatile bool _running;
+        private bool _kernelTimestamps;
+        private string _devicePath;
+
+        // Current input state, packed with the PaddleState bit layout
+        private byte _stateBits;
+
+        // Key code -> mapped functions
+        private volatile MidiNoteFunction[] _keyFunctions;
+
+        private static readonly bool _evdevDebug = DebugCategory.Evdev.IsEnabled;
+
+        public event Action<PaddleState> PaddleStateChanged;
+
+        public static bool IsSupported => RuntimeInformation.IsOSPlatform(OSPlatform.Linux);
+
+        /// <summary>
+        /// Returns "Name (eventN)" for every input device that reports key events.
+        /// </summary>
+        public static List<string> GetAvailableDevices()
+        {
+            var devices = new List<string>();
+            if (!IsSupported || !Directory.Exists(SYSFS_INPUT_DIR))
+                return devices;
+
+            var nodes = new List<(int Number, string Node)>();
+            foreach (var dir in Directory.GetDirectories(SYSFS_INPUT_DIR, "event*"))
+            {
+                var node = Path.GetFileName(dir);
+                if (int.TryParse(node.AsSpan(5), out int number))
+                    nodes.Add((number, node));
+            }
+            nodes.Sort((a, b) => a.Number.CompareTo(b.Number));
+
+            foreach (var (_, node) in nodes)
+            {
+                try
+                {
+                    if (!HasKeyEvents(node))
+                        continue;
+
+                    var name = ReadDeviceName(node);
+                    if (_evdevDebug) DebugLogger.Log(DebugCategory.Evdev, $"[Evdev] {node}: \"{name}\"");
+                    devices.Add($"{name} ({node})");
+                }
+                catch (Exception ex)
+                {
+                    if (_evdevDebug) DebugLogger.Log(DebugCategory.Evdev, $"[Evdev] Skipping {node}: {ex.Message}");
+                }
+            }
+
+            return devices;
+        }
+
+        public void SetKeyMappings(List<EvdevKeyMapping> mappings)
+        {
+            mappings ??= EvdevKeyMapping.GetDefaultMappings();
+
+            var table = new MidiNoteFunction[KEY_CODE_COUNT];
+
+            // Walk backwards so the first mapping for a key wins
+            for (int i = mappings.Count - 1; i >= 0; i--)
+            {
+                var mapping = mappings[i];
+                if (mapping != null && mapping.KeyCode >= 0 && mapping.KeyCode < table.Length)
+                {
+                    table[mapping.KeyCode] = mapping.Functions;
+                }
+            }
+
+            _keyFunctions = table;
+        }
+
+        /// <summary>
+        /// Opens and exclusively grabs the device.  Accepts a name from
+        /// <see cref="GetAvailableDevices"/> or a /dev/input path.
+        /// Throws <see cref="InvalidOperationException"/> on failure.
+        /// </summary>
+        public void Open(string deviceName)
+        {
+            Close();
+
+            if (!IsSupported)
+                throw new InvalidOperationException("evdev input is only available on Linux");
+
+            if (_keyFunctions == null)
+                SetKeyMappings(null);
+
+            var path = ResolveDevicePath(deviceName)
+                ?? throw new InvalidOperationException($"Input device '{deviceName}' not found");
+
+            int fd = NativeMethods.open(path, NativeMethods.O_RDONLY | NativeMethods.O_NONBLOCK | NativeMethods.O_CLOEXEC);
+            if (fd < 0)
+            {
+                int errno = Marshal.GetLastWin32Error();
+                if (errno == NativeMethods.EACCES)
+                    throw new InvalidOperationException($"Permission denied opening {path}. Add your user to the 'input' group or install a udev rule for the device.");
+                throw new InvalidOperationException($"Failed to open {path} (errno {errno})");
+            }
+
+            // Ask for CLOCK_MONOTONIC event times so they line up with Timebase; fall back
+            // to stamping on arrival if the kernel refuses.
+            int clockId = NativeMethods.CLOCK_MONOTONIC;
+            _kernelTimestamps = NativeMethods.ioctl(fd, NativeMethods.EVIOCSCLOCKID, ref clockId) == 0;
+            if (!_kernelTimestamps)
+                Console.WriteLine($"evdev: kernel timestamps unavailable on {path} (errno {Marshal.GetLastWin32Error()}), using arrival time");
+
+            if (NativeMethods.ioctl(fd, NativeMethods.EVIOCGRAB, 1) != 0)
+            {
+                int errno = Marshal.GetLastWin32Error();
+                NativeMethods.close(fd);
+                throw new InvalidOperationException($"Failed to grab {path} (errno {errno}); is another program using it?");
+            }
+
+            _fd = fd;
+            _devicePath = path;
+            _stateBits = 0;
+            _running = true;
+            _readThread = new Thread(ReadLoop)
+            {
+                Name = "evdev input",
+                IsBackground = true,
+                Priority = ThreadPriority.Highest
+            };
+            _readThread.Start();
+
+            Console.WriteLine($"Opened evdev device: {deviceName} ({path})");
+        }
+
+        public void Close()
+        {
+            _running = false;
+
+            if (_readThread != null)
+            {
+                // The read loop polls with a short timeout, so this returns promptly
+                if (Thread.CurrentThread != _readThread)
+                    _readThread.Join();
+                _readThread = null;
+            }
+
+            if (_fd >= 0)
+            {
+                try
+                {
+                    NativeMethods.ioctl(_fd, NativeMethods.EVIOCGRAB, 0);
+                    NativeMethods.close(_fd);
+                }
+                catch (Exception ex)
+                {
+                    Console.WriteLine($"Error closing evdev device: {ex.Message}");
+                }
+                _fd = -1;
+            }
+
+            _devicePath = null;
+            _stateBits = 0;
+        }
+
+        public void Dispose()
+        {
+            Close();
+        }
+
+        // ---- private helpers ----
+
+        private unsafe void ReadLoop()
+        {
+            var events = stackalloc InputEvent[EVENTS_PER_READ];
+            var pfd = new NativeMethods.PollFd { fd = _fd, events = NativeMethods.POLLIN };
+
+            while (_running)
+            {
+                RealtimeProfile.EnterThread(RealtimeThreadRole.Input);
+                pfd.revents = 0;
+                int ready = NativeMethods.poll(&pfd, 1, POLL_TIMEOUT_MS);
+                if (ready == 0)
+                    continue;
+                if (ready < 0)
+                {
+                    if (Marshal.GetLastWin32Error() == NativeMethods.EINTR)
+                        continue;
+                    break;
+                }
+
+                if ((pfd.revents & (NativeMethods.POLLERR | NativeMethods.POLLHUP | NativeMethods.POLLNVAL)) != 0)
+                {
+                    Console.WriteLine($"evdev: device {_devicePath} went away");
+                    break;
+                }
+
+                nint bytes = NativeMethods.read(_fd, events, sizeof(InputEvent) * EVENTS_PER_READ);
+                if (bytes < 0)
+                {
+                    int errno = Marshal.GetLastWin32Error();
+                    if (errno == NativeMethods.EAGAIN || errno == NativeMethods.EINTR)
+                        continue;
+                    Console.WriteLine($"evdev: read from {_devicePath} failed (errno {errno})");
+                    break;
+                }
+
+                int count = (int)(bytes / sizeof(InputEvent));
+                for (int i = 0; i < count; i++)
+                {
+                    HandleEvent(in events[i]);
+                }
+            }
+
+            // Never leave a key stuck down if the device disappears mid-element
+            if (_stateBits != 0)
+            {
+                _stateBits = 0;
+                PaddleStateChanged?.Invoke(new PaddleState(0, Timebase.Now));
+            }
+        }
+
+        private void HandleEvent(in InputEvent ev)
+        {
+            if (ev.Type == NativeMethods.EV_SYN && ev.Code == SYN_DROPPED)
+            {
+                // The kernel buffer overflowed and we lost edges; release everything
+                // rather than guess, the next press re-establishes the state
+                if (_evdevDebug) DebugLogger.Log(DebugCategory.Evdev, "[Evdev] SYN_DROPPED - releasing all inputs");
+                if (_stateBits != 0)
+                {
+                    _stateBits = 0;
+                    PaddleStateChanged?.Invoke(new PaddleState(0, GetEventTimestamp(in ev)));
+                }
+                return;
+            }
+
+            // value: 0 = release, 1 = press, 2 = autorepeat (ignored)
+            if (ev.Type != NativeMethods.EV_KEY || ev.Value > 1)
+                return;
+
+            var keyFunctions = _keyFunctions;
+            var functions = ev.Code < keyFunctions.Length ? keyFunctions[ev.Code] : MidiNoteFunction.None;
+            if (_evdevDebug) DebugLogger.Log(DebugCategory.Evdev, $"[Evdev] Key {ev.Code} {(ev.Value != 0 ? "DOWN" : "UP")} -> {functions}");
+            if (functions == MidiNoteFunction.None)
+                return;
+
+            byte mask = (byte)functions;
+            byte newBits = ev.Value != 0 ? (byte)(_stateBits | mask) : (byte)(_stateBits & ~mask);
+            if (newBits != _stateBits)
+            {
+                _stateBits = newBits;
+                PaddleStateChanged?.Invoke(new PaddleState(newBits, GetEventTimestamp(in ev)));
+            }
+        }
+
+        private long GetEventTimestamp(in InputEvent ev)
+        {
+            if (!_kernelTimestamps)
+                return Timebase.Now;
+
+            // Timebase on Linux is CLOCK_MONOTONIC, so the kernel time maps across directly
+            return Timebase.FromMicroseconds(ev.Seconds * 1_000_000L + ev.Microseconds);
+        }
+
+        private static string ResolveDevicePath(string deviceName)
+        {
+            if (string.IsNullOrEmpty(deviceName))
+                return null;
+
+            if (deviceName.StartsWith(DEV_INPUT_DIR + "/", StringComparison.Ordinal))
+                return File.Exists(deviceName) ? deviceName : null;
+
+            // "Name (eventN)": prefer the remembered node, but event numbers are not stable
+            // across reboots or replugs, so fall back to the first device with the same name
+            string name = deviceName;
+            int open = deviceName.LastIndexOf(" (event", StringComparison.Ordinal);
+            if (open >= 0 && deviceName.EndsWith(')'))
+            {
+                name = deviceName[..open];
+                var node = deviceName[(open + 2)..^1];
+                try
+                {
+                    if (ReadDeviceName(node) == name)
+                        return Path.Combine(DEV_INPUT_DIR, node);
+                }
+                catch { }
+            }
+
+            foreach (var device in GetAvailableDevices())
+            {
+                int idx = device.LastIndexOf(" (event", StringComparison.Ordinal);
+                if (idx >= 0 && device[..idx] == name)
+                    return Path.Combine(DEV_INPUT_DIR, device[(idx + 2)..^1]);
+            }
+
+            return null;
+        }
+
+        private static string ReadDeviceName(string node)
+        {
+            return File.ReadAllText(Path.Combine(SYSFS_INPUT_DIR, node, "device", "name")).Trim();
+        }
+
+        private static bool HasKeyEvents(string node)
+        {
+            // capabilities/ev is a hex bitmask of supported event types
+            var ev = File.ReadAllText(Path.Combine(SYSFS_INPUT_DIR, node, "device", "capabilities", "ev")).Trim();
+            return ulong.TryParse(ev, System.Globalization.NumberStyles.HexNumber, null, out ulong mask)
+                && (mask & (1UL << NativeMethods.EV_KEY)) != 0;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace NetKeyer.Evdev
+{
+    /// <summary>
+    /// libc entry points and evdev ioctl numbers used to read /dev/input/event* directly.
+    /// Linux only.
+    /// </summary>
+    internal static partial class NativeMethods
+    {
+        const string Lib = "libc";
+
+        internal const int O_RDONLY = 0x0000;
+        internal const int O_NONBLOCK = 0x0800;
+        internal const int O_CLOEXEC = 0x80000;
+
+        internal const short POLLIN = 0x0001;
+        internal const short POLLERR = 0x0008;
+        internal const short POLLHUP = 0x0010;
+        internal const short POLLNVAL = 0x0020;
+
+        internal const int EINTR = 4;
+        internal const int EAGAIN = 11;
+        internal const int EACCES = 13;
+        internal const int ENODEV = 19;
+
+        internal const int CLOCK_MONOTONIC = 1;
+
+        // _IOW('E', 0x90, int): grab/release exclusive access to the device
+        internal const uint EVIOCGRAB = 0x40044590;
+
+        // _IOW('E', 0xa0, int): select the clock used for input_event.time
+        internal const uint EVIOCSCLOCKID = 0x400445a0;
+
+        internal const ushort EV_SYN = 0x00;
+        internal const ushort EV_KEY = 0x01;
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct PollFd
+        {
+            public int fd;
+            public short events;
+            public short revents;
+        }
+
+        [LibraryImport(Lib, SetLastError = true, StringMarshalling = StringMarshalling.Utf8)]
+        internal static partial int open(string pathname, int flags);
+
+        [LibraryImport(Lib, SetLastError = true)]
+        internal static partial int close(int fd);
+
+        [LibraryImport(Lib, SetLastError = true)]
+        internal static unsafe partial nint read(int fd, void* buf, nint count);
+
+        // ioctl is variadic; on the 64-bit Linux ABIs we support, the trailing
+        // argument is passed exactly like a fixed one.
+        [LibraryImport(Lib, SetLastError = true)]
+        internal static partial int ioctl(int fd, nuint request, nint arg);
+
+        [LibraryImport(Lib, SetLastError = true)]
+        internal static partial int ioctl(int fd, nuint request, ref int arg);
+
+        [LibraryImport(Lib, SetLastError = true)]
+        internal static unsafe partial int poll(PollFd* fds, nuint nfds, int timeout);
+    }
+}
@@ -0,0 +1,79 @@
+using System;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// Maps timestamps from another monotonic clock (a MIDI backend, the audio render position)
+/// onto <see cref="Timebase"/> ticks. Each observation pairs a foreign time with the local
+/// time it was seen at; the clock offset is the smallest difference seen recently, i.e. the
+/// observation that arrived with the least delay. Two alternating windows let the estimate
+/// follow slow drift between the clocks without being pulled up by one late arrival.
+/// Not thread-safe: observe and map from the thread that owns the foreign clock.
+/// </summary>
+public sealed class ClockMapper
+{
+    private readonly long _windowTicks;
+    private long _windowStart;
+    private long _currentWindowMin = long.MaxValue;
+    private long _previousWindowMin = long.MaxValue;
+    private long _offset = long.MaxValue;
+
+    public ClockMapper(int windowMs = 10_000)
+    {
+        _windowTicks = Timebase.FromMilliseconds(windowMs);
+    }
+
+    /// <summary>
+    /// True once at least one observation has been made.
+    /// </summary>
+    public bool IsSynchronized => _offset != long.MaxValue;
+
+    /// <summary>
+    /// Current estimate of (local ticks - foreign ticks).
+    /// </summary>
+    public long OffsetTicks => _offset;
+
+    /// <summary>
+    /// Records that the foreign clock read <paramref name="foreignNanoseconds"/> when it was
+    /// observed locally at <paramref name="arrivalTicks"/>, and returns the mapped timestamp,
+    /// which is never later than the arrival.
+    /// </summary>
+    public long Observe(long foreignNanoseconds, long arrivalTicks)
+    {
+        long foreignTicks = Timebase.FromNanoseconds(foreignNanoseconds);
+        long offset = arrivalTicks - foreignTicks;
+
+        if (arrivalTicks - _windowStart > _windowTicks)
+        {
+            _previousWindowMin = _currentWindowMin;
+            _currentWindowMin = long.MaxValue;
+            _windowStart = arrivalTicks;
+        }
+
+        if (offset < _currentWindowMin)
+            _currentWindowMin = offset;
+
+        _offset = Math.Min(_currentWindowMin, _previousWindowMin);
+        return foreignTicks + _offset;
+    }
+
+    /// <summary>
+    /// Maps a foreign time without recording an observation.
+    /// Returns <see cref="Timebase.Now"/> until synchronized.
+    /// </summary>
+    public long Map(long foreignNanoseconds)
+    {
+        if (!IsSynchronized)
+            return Timebase.Now;
+
+        return Timebase.FromNanoseconds(foreignNanoseconds) + _offset;
+    }
+
+    public void Reset()
+    {
+        _windowStart = 0;
+        _currentWindowMin = long.MaxValue;
+        _previousWindowMin = long.MaxValue;
+        _offset = long.MaxValue;
+    }
+}
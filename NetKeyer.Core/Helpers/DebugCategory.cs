@@ -0,0 +1,41 @@
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// A debug logging category with its NETKEYER_DEBUG setting resolved once, when the
+/// category is first used. <see cref="DebugLogger.Log(DebugCategory, ref DebugLogInterpolatedStringHandler)"/>
+/// takes one of these, so deciding whether to log is a field read rather than a lookup by
+/// name, and hot paths can test <see cref="IsEnabled"/> directly:
+///   if (DebugCategory.Sidetone.IsEnabled) { ... }
+/// </summary>
+public readonly struct DebugCategory
+{
+    public static readonly DebugCategory Audio = new("audio");
+    public static readonly DebugCategory Evdev = new("evdev");
+    public static readonly DebugCategory Input = new("input");
+    public static readonly DebugCategory Keyer = new("keyer");
+    public static readonly DebugCategory Midi = new("midi");
+    public static readonly DebugCategory Network = new("network");
+    public static readonly DebugCategory Ptt = new("ptt");
+    public static readonly DebugCategory RadioLatency = new("radio-latency");
+    public static readonly DebugCategory RadioSelect = new("radio-select");
+    public static readonly DebugCategory RadioSettings = new("radio-settings");
+    public static readonly DebugCategory Realtime = new("realtime");
+    public static readonly DebugCategory Sidetone = new("sidetone");
+    public static readonly DebugCategory Slice = new("slice");
+    public static readonly DebugCategory SmartLink = new("smartlink");
+    public static readonly DebugCategory Startup = new("startup");
+    public static readonly DebugCategory Update = new("update");
+
+    private DebugCategory(string name)
+    {
+        Name = name;
+        IsEnabled = DebugLogger.IsEnabled(name);
+    }
+
+    /// <summary>
+    /// The name used in NETKEYER_DEBUG and in log lines.
+    /// </summary>
+    public string Name { get; }
+
+    public bool IsEnabled { get; }
+}
@@ -0,0 +1,128 @@
+using System;
+using System.Runtime.CompilerServices;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// Builds the message for <see cref="DebugLogger.Log(DebugCategory, ref DebugLogInterpolatedStringHandler)"/>
+/// only when the category is enabled. The compiler checks the category's flag before evaluating
+/// any interpolation hole, so a disabled log call formats nothing and allocates nothing:
+///   DebugLogger.Log(DebugCategory.Input, $"Paddle state: L={left} R={right}");
+/// needs no IsEnabled guard.
+///
+/// When the category is enabled the holes are formatted straight into a character buffer
+/// kept per thread (values that can't format into a span fall back to ToString()), and the
+/// logger copies the characters into its queue. No string is made for the message on the
+/// logging thread; the writer thread builds the line.
+/// </summary>
+[InterpolatedStringHandler]
+public ref struct DebugLogInterpolatedStringHandler
+{
+    private const int INITIAL_CAPACITY = 256;
+    private const int MAX_CACHED_CAPACITY = 1024;
+
+    [ThreadStatic]
+    private static char[] t_cachedBuffer;
+
+    private char[] _buffer;
+    private int _length;
+
+    public DebugLogInterpolatedStringHandler(int literalLength, int formattedCount, DebugCategory category, out bool isEnabled)
+    {
+        isEnabled = category.IsEnabled;
+        if (isEnabled)
+        {
+            _buffer = t_cachedBuffer ?? new char[Math.Max(INITIAL_CAPACITY, literalLength + formattedCount * 8)];
+            t_cachedBuffer = null;
+        }
+    }
+
+    public bool IsEnabled => _buffer != null;
+
+    /// <summary>
+    /// The message formatted so far. Valid until <see cref="Clear"/>.
+    /// </summary>
+    internal ReadOnlySpan<char> Text => _buffer.AsSpan(0, _length);
+
+    public void AppendLiteral(string value) => AppendFormatted(value.AsSpan());
+
+    public void AppendFormatted<T>(T value) => AppendFormatted(value, 0, null);
+
+    public void AppendFormatted<T>(T value, string format) => AppendFormatted(value, 0, format);
+
+    public void AppendFormatted<T>(T value, int alignment) => AppendFormatted(value, alignment, null);
+
+    public void AppendFormatted<T>(T value, int alignment, string format)
+    {
+        int start = _length;
+        if (value is ISpanFormattable)
+        {
+            // The cast on a constrained T doesn't box value types
+            int written;
+            while (!((ISpanFormattable)value).TryFormat(_buffer.AsSpan(_length), out written, format, null))
+                Grow(_buffer.Length);
+            _length += written;
+        }
+        else if (value is IFormattable)
+        {
+            AppendFormatted(((IFormattable)value).ToString(format, null));
+        }
+        else
+        {
+            AppendFormatted(value?.ToString());
+        }
+
+        if (alignment != 0)
+            Pad(start, alignment);
+    }
+
+    public void AppendFormatted(ReadOnlySpan<char> value)
+    {
+        if (value.Length > _buffer.Length - _length)
+            Grow(value.Length);
+        value.CopyTo(_buffer.AsSpan(_length));
+        _length += value.Length;
+    }
+
+    public void AppendFormatted(string value) => AppendFormatted(value.AsSpan());
+
+    /// <summary>
+    /// Hands the buffer back to this thread's cache for the next message.
+    /// </summary>
+    internal void Clear()
+    {
+        if (_buffer.Length <= MAX_CACHED_CAPACITY)
+            t_cachedBuffer = _buffer;
+        _buffer = null;
+        _length = 0;
+    }
+
+    private void Pad(int start, int alignment)
+    {
+        int width = Math.Abs(alignment);
+        int padding = width - (_length - start);
+        if (padding <= 0)
+            return;
+
+        if (padding > _buffer.Length - _length)
+            Grow(padding);
+        if (alignment > 0)
+        {
+            // Right-aligned: move the value along and pad in front of it
+            _buffer.AsSpan(start, _length - start).CopyTo(_buffer.AsSpan(start + padding));
+            _buffer.AsSpan(start, padding).Fill(' ');
+        }
+        else
+        {
+            _buffer.AsSpan(_length, padding).Fill(' ');
+        }
+        _length += padding;
+    }
+
+    private void Grow(int additional)
+    {
+        var larger = new char[Math.Max(_buffer.Length * 2, _length + additional)];
+        _buffer.AsSpan(0, _length).CopyTo(larger);
+        _buffer = larger;
+    }
+}
@@ -0,0 +1,488 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Runtime.CompilerServices;
+using System.Threading;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// Centralized debug logging system controlled by the NETKEYER_DEBUG environment variable.
+/// Supports comma-separated categories, 'all' keyword, and wildcard matching.
+/// Logs to both console (where available) and a file in the NetKeyer application data directory.
+///
+/// Log() only stamps the message with the monotonic timebase and copies it into a slot of a
+/// preallocated lock-free ring; a background thread builds the lines and does the console and
+/// file I/O. Interpolated messages are formatted into a per-thread buffer and copied into the
+/// slot's own characters, so logging from the audio, MIDI or keying threads neither blocks
+/// on I/O nor allocates. When the ring is full the message is dropped and counted rather
+/// than waiting, and the writer reports how many were lost.
+///
+/// Examples:
+///   NETKEYER_DEBUG=all                     - Enable all categories
+///   NETKEYER_DEBUG=keyer,midi              - Enable specific categories
+///   NETKEYER_DEBUG=midi*                   - Enable all categories starting with 'midi'
+///   NETKEYER_DEBUG=keyer,midi*,sidetone    - Mixed specific and wildcard patterns
+///
+/// Log file location:
+///   Windows: %APPDATA%\NetKeyer\debug.log
+///   Linux/macOS: ~/.config/NetKeyer/debug.log
+/// </summary>
+public static class DebugLogger
+{
+    private const int QUEUE_CAPACITY = 4096;
+    private const int SLOT_CHARS = 256;
+    private const int WRITER_IDLE_MS = 20;
+
+    // Resolved once at startup: the environment variable doesn't change while we run
+    private static readonly DebugConfig _config = new();
+    private static readonly Lazy<FileLogger> _fileLogger = new(() => new FileLogger());
+    private static readonly Lazy<LogWriter> _writer = new(() => new LogWriter());
+    private static long _droppedRecords;
+
+    /// <summary>
+    /// Gets the path to the debug log file.
+    /// </summary>
+    public static string LogFilePath => _fileLogger.Value.LogFilePath;
+
+    /// <summary>
+    /// Messages lost because the writer fell behind and the queue was full.
+    /// </summary>
+    public static long DroppedRecords => Interlocked.Read(ref _droppedRecords);
+
+    /// <summary>
+    /// Returns true if the named category is enabled for logging, matching it against
+    /// NETKEYER_DEBUG. Each <see cref="DebugCategory"/> asks once, when it is created; logging
+    /// code tests <see cref="DebugCategory.IsEnabled"/> instead.
+    /// </summary>
+    public static bool IsEnabled(string category) => _config.IsEnabled(category);
+
+    /// <summary>
+    /// Log a debug message if the specified category is enabled. Never blocks: the message
+    /// is queued with the current timebase and written by a background thread.
+    /// </summary>
+    /// <param name="category">The debug category (e.g., DebugCategory.Keyer)</param>
+    /// <param name="message">The message to log</param>
+    public static void Log(DebugCategory category, string message)
+    {
+        if (category.IsEnabled)
+            Enqueue(category.Name, message, default);
+    }
+
+    /// <summary>
+    /// Log an interpolated message if the specified category is enabled. The message is only
+    /// formatted when it is, so disabled calls cost a flag test and no allocation; enabled
+    /// calls format into a reused buffer and make no string.
+    /// </summary>
+    /// <param name="category">The debug category (e.g., DebugCategory.Keyer)</param>
+    /// <param name="message">The message to log</param>
+    public static void Log(DebugCategory category, [InterpolatedStringHandlerArgument("category")] ref DebugLogInterpolatedStringHandler message)
+    {
+        if (message.IsEnabled)
+        {
+            Enqueue(category.Name, null, message.Text);
+            message.Clear();
+        }
+    }
+
+    /// <summary>
+    /// Queues either <paramref name="message"/> or, when that is null, a copy of
+    /// <paramref name="text"/>.
+    /// </summary>
+    private static void Enqueue(string category, string message, ReadOnlySpan<char> text)
+    {
+        if (!_writer.Value.Queue.TryEnqueue(Timebase.Now, category, message, text))
+            Interlocked.Increment(ref _droppedRecords);
+    }
+
+    /// <summary>
+    /// Writes everything logged so far before returning. Called at exit; also runs on
+    /// process exit in case nothing else does.
+    /// </summary>
+    public static void Flush()
+    {
+        if (_writer.IsValueCreated)
+            _writer.Value.Drain();
+    }
+
+    /// <summary>
+    /// The record queue: <see cref="MpscQueue{T}"/>'s algorithm, with <see cref="SLOT_CHARS"/>
+    /// characters preallocated for each cell so a message's text is copied in rather than
+    /// made into a string by the logging thread. A message that is already a string is queued
+    /// by reference; only text longer than a slot is turned into one.
+    /// </summary>
+    private sealed class LogRing
+    {
+        private struct Cell
+        {
+            public long Sequence;
+            public long Timestamp;
+            public string Category;
+            public string Message; // null when the text is in the cell's slot
+            public int Length;
+        }
+
+        private readonly Cell[] _cells;
+        private readonly char[] _text;
+        private readonly long _mask;
+        private long _enqueuePosition;
+        private long _dequeuePosition;
+
+        public LogRing(int capacity)
+        {
+            int size = 1;
+            while (size < capacity)
+                size <<= 1;
+
+            _cells = new Cell[size];
+            _text = new char[size * SLOT_CHARS];
+            _mask = size - 1;
+            for (int i = 0; i < size; i++)
+                _cells[i].Sequence = i;
+        }
+
+        public bool IsEmpty
+        {
+            get
+            {
+                long position = Volatile.Read(ref _dequeuePosition);
+                return Volatile.Read(ref _cells[position & _mask].Sequence) != position + 1;
+            }
+        }
+
+        /// <summary>
+        /// Adds a record. Safe to call from any number of threads concurrently.
+        /// </summary>
+        public bool TryEnqueue(long timestamp, string category, string message, ReadOnlySpan<char> text)
+        {
+            if (message == null && text.Length > SLOT_CHARS)
+                message = new string(text);
+
+            long position = Volatile.Read(ref _enqueuePosition);
+            while (true)
+            {
+                long index = position & _mask;
+                ref Cell cell = ref _cells[index];
+                long diff = Volatile.Read(ref cell.Sequence) - position;
+
+                if (diff == 0)
+                {
+                    if (Interlocked.CompareExchange(ref _enqueuePosition, position + 1, position) == position)
+                    {
+                        cell.Timestamp = timestamp;
+                        cell.Category = category;
+                        cell.Message = message;
+                        cell.Length = message == null ? text.Length : 0;
+                        if (message == null)
+                            text.CopyTo(_text.AsSpan((int)index * SLOT_CHARS, SLOT_CHARS));
+                        Volatile.Write(ref cell.Sequence, position + 1);
+                        return true;
+                    }
+                    position = Volatile.Read(ref _enqueuePosition);
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = Volatile.Read(ref _enqueuePosition);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Reads the oldest record without removing it; <paramref name="message"/> points into
+        /// the ring until <see cref="Advance"/>. Single consumer only.
+        /// </summary>
+        public bool TryPeek(out long timestamp, out string category, out ReadOnlySpan<char> message)
+        {
+            long position = _dequeuePosition;
+            long index = position & _mask;
+            ref Cell cell = ref _cells[index];
+            if (Volatile.Read(ref cell.Sequence) != position + 1)
+            {
+                timestamp = 0;
+                category = null;
+                message = default;
+                return false;
+            }
+
+            timestamp = cell.Timestamp;
+            category = cell.Category;
+            message = cell.Message != null ? cell.Message.AsSpan() : _text.AsSpan((int)index * SLOT_CHARS, cell.Length);
+            return true;
+        }
+
+        /// <summary>
+        /// Frees the record returned by the last <see cref="TryPeek"/>.
+        /// </summary>
+        public void Advance()
+        {
+            long position = _dequeuePosition;
+            ref Cell cell = ref _cells[position & _mask];
+            cell.Category = null;
+            cell.Message = null;
+            Volatile.Write(ref cell.Sequence, position + _mask + 1);
+            Volatile.Write(ref _dequeuePosition, position + 1);
+        }
+    }
+
+    /// <summary>
+    /// Owns the record queue and the thread that empties it.
+    /// </summary>
+    private class LogWriter
+    {
+        private readonly object _drainLock = new();
+        private readonly Thread _thread;
+
+        // Wall clock at a known timebase, so each line's wall time comes from its own
+        // monotonic stamp rather than from when the writer got to it
+        private readonly DateTime _wallClockOrigin = DateTime.Now;
+        private readonly long _timebaseOrigin = Timebase.Now;
+        private long _reportedDrops;
+        private bool _loggedStartupMessage;
+
+        public LogWriter()
+        {
+            _thread = new Thread(Run)
+            {
+                Name = "NetKeyer debug log writer",
+                IsBackground = true,
+                Priority = ThreadPriority.BelowNormal
+            };
+            _thread.Start();
+
+            AppDomain.CurrentDomain.ProcessExit += (_, _) => Drain();
+        }
+
+        public LogRing Queue { get; } = new LogRing(QUEUE_CAPACITY);
+
+        private void Run()
+        {
+            while (true)
+            {
+                Drain();
+                Thread.Sleep(WRITER_IDLE_MS);
+            }
+        }
+
+        public void Drain()
+        {
+            // The queue has a single consumer: the writer thread, or Flush() at exit
+            lock (_drainLock)
+            {
+                if (Queue.IsEmpty && DroppedRecords == _reportedDrops)
+                    return;
+
+                var file = _fileLogger.Value;
+                if (!_loggedStartupMessage)
+                {
+                    // Log the debug file location on first use
+                    _loggedStartupMessage = true;
+                    WriteLine(file, Format(Timebase.Now, "system", $"Debug logging enabled. Log file: {LogFilePath}"));
+                }
+
+                while (Queue.TryPeek(out long timestamp, out string category, out var message))
+                {
+                    string line = Format(timestamp, category, message);
+                    Queue.Advance();
+                    WriteLine(file, line);
+                }
+
+                long dropped = DroppedRecords;
+                if (dropped != _reportedDrops)
+                {
+                    WriteLine(file, Format(Timebase.Now, "system", $"{dropped - _reportedDrops} log messages dropped (queue full), {dropped} in total"));
+                    _reportedDrops = dropped;
+                }
+
+                file.Flush();
+            }
+        }
+
+        private static void WriteLine(FileLogger file, string line)
+        {
+            // Write to console (works on Linux/macOS, and in debuggers on Windows)
+            Console.WriteLine(line);
+
+            // Write to file (always works, especially important for Windows GUI apps)
+            file.Write(line);
+        }
+
+        private string Format(long timestamp, string category, ReadOnlySpan<char> message)
+        {
+            // Wall clock for humans, plus the monotonic timebase in milliseconds so log lines can
+            // be lined up against input edge and radio timestamps
+            var wallClock = _wallClockOrigin.AddTicks(Timebase.ToNanoseconds(timestamp - _timebaseOrigin) / 100);
+            return $"[{wallClock:yyyy-MM-dd HH:mm:ss.fff}] [{Timebase.ToMilliseconds(timestamp):F3}] [{category}] {message}";
+        }
+    }
+
+    private class DebugConfig
+    {
+        private readonly bool _allEnabled;
+        private readonly bool _anyEnabled;
+        private readonly HashSet<string> _exactCategories;
+        private readonly List<string> _wildcardPrefixes;
+
+        public DebugConfig()
+        {
+            _exactCategories = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+            _wildcardPrefixes = new List<string>();
+            _allEnabled = false;
+
+            var debugVar = Environment.GetEnvironmentVariable("NETKEYER_DEBUG");
+            if (string.IsNullOrWhiteSpace(debugVar))
+            {
+                return;
+            }
+
+            var categories = debugVar.Split(',', StringSplitOptions.RemoveEmptyEntries)
+                                     .Select(c => c.Trim())
+                                     .Where(c => !string.IsNullOrEmpty(c));
+
+            foreach (var category in categories)
+            {
+                if (category.Equals("all", StringComparison.OrdinalIgnoreCase))
+                {
+                    _allEnabled = _anyEnabled = true;
+                    return; // No need to process other categories if 'all' is enabled
+                }
+                else if (category.EndsWith('*'))
+                {
+                    // Wildcard pattern - store the prefix without the asterisk
+                    var prefix = category[..^1];
+                    if (!string.IsNullOrEmpty(prefix))
+                    {
+                        _wildcardPrefixes.Add(prefix);
+                    }
+                }
+                else
+                {
+                    // Exact category match
+                    _exactCategories.Add(category);
+                }
+            }
+
+            _anyEnabled = _exactCategories.Count > 0 || _wildcardPrefixes.Count > 0;
+        }
+
+        public bool IsEnabled(string category)
+        {
+            if (!_anyEnabled)
+            {
+                return false;
+            }
+
+            if (_allEnabled)
+            {
+                return true;
+            }
+
+            if (_exactCategories.Contains(category))
+            {
+                return true;
+            }
+
+            foreach (var prefix in _wildcardPrefixes)
+            {
+                if (category.StartsWith(prefix, StringComparison.OrdinalIgnoreCase))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    }
+
+    private class FileLogger
+    {
+        private readonly string _logFilePath;
+        private StreamWriter _writer;
+        private const long MaxLogFileSize = 10 * 1024 * 1024; // 10 MB
+
+        public string LogFilePath => _logFilePath;
+
+        public FileLogger()
+        {
+            try
+            {
+                var appDataPath = Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData);
+                var appFolder = Path.Combine(appDataPath, "NetKeyer");
+                Directory.CreateDirectory(appFolder);
+                _logFilePath = Path.Combine(appFolder, "debug.log");
+
+                // Rotate log file if it's too large
+                RotateLogIfNeeded();
+            }
+            catch (Exception ex)
+            {
+                // Fallback to temp directory if we can't access app data folder
+                var tempFolder = Path.GetTempPath();
+                var appFolder = Path.Combine(tempFolder, "NetKeyer");
+                Directory.CreateDirectory(appFolder);
+                _logFilePath = Path.Combine(appFolder, "debug.log");
+
+                Console.WriteLine($"Warning: Could not access application data folder, using temp directory for logs: {ex.Message}");
+            }
+        }
+
+        /// <summary>
+        /// Appends a line. Only the log writer thread calls this; lines reach the file on
+        /// <see cref="Flush"/>.
+        /// </summary>
+        public void Write(string message)
+        {
+            try
+            {
+                _writer ??= new StreamWriter(new FileStream(_logFilePath, FileMode.Append, FileAccess.Write, FileShare.ReadWrite));
+                _writer.WriteLine(message);
+            }
+            catch (Exception ex)
+            {
+                // If file logging fails, at least try to output to console
+                Console.WriteLine($"Warning: Failed to write to log file: {ex.Message}");
+            }
+        }
+
+        public void Flush()
+        {
+            try
+            {
+                _writer?.Flush();
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine($"Warning: Failed to write to log file: {ex.Message}");
+            }
+        }
+
+        private void RotateLogIfNeeded()
+        {
+            try
+            {
+                if (File.Exists(_logFilePath))
+                {
+                    var fileInfo = new FileInfo(_logFilePath);
+                    if (fileInfo.Length > MaxLogFileSize)
+                    {
+                        // Keep the old log as debug.log.old (overwrite previous .old file)
+                        var oldLogPath = _logFilePath + ".old";
+                        if (File.Exists(oldLogPath))
+                        {
+                            File.Delete(oldLogPath);
+                        }
+                        File.Move(_logFilePath, oldLogPath);
+                    }
+                }
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine($"Warning: Failed to rotate log file: {ex.Message}");
+            }
+        }
+    }
+}
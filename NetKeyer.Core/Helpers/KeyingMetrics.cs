@@ -0,0 +1,131 @@
+using System;
+using System.Diagnostics.Metrics;
+using System.Threading;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// Keying health published as System.Diagnostics.Metrics instruments on the "NetKeyer" meter,
+/// for watching a running station from outside the process:
+///   dotnet-counters monitor -n NetKeyer --counters NetKeyer
+/// or scraped through <see cref="MetricsEndpoint"/>.
+///
+/// The Record methods are called from the input, audio and keying threads. They never block
+/// or allocate, and cost next to nothing while no tool is listening. Durations are in
+/// milliseconds.
+/// </summary>
+public static class KeyingMetrics
+{
+    public const string METER_NAME = "NetKeyer";
+
+    // Gaps between key-downs longer than this end a keying "session" for GC accounting
+    private const int KEYING_IDLE_MS = 1000;
+
+    private static readonly Meter _meter = new Meter(METER_NAME);
+
+    private static readonly Counter<long> _paddleEdges = _meter.CreateCounter<long>(
+        "netkeyer.paddle.edges", "{edge}", "Paddle, straight key and PTT input edges from all devices");
+    private static readonly Counter<long> _elements = _meter.CreateCounter<long>(
+        "netkeyer.keyer.elements", "{element}", "Keyed elements: iambic dits and dahs, and straight key-downs");
+    private static readonly Histogram<double> _audioCallbackTime = _meter.CreateHistogram<double>(
+        "netkeyer.audio.callback.duration", "ms", "Time spent rendering each sidetone audio buffer");
+    private static readonly Counter<long> _audioXruns = _meter.CreateCounter<long>(
+        "netkeyer.audio.xruns", "{xrun}", "Audio output underflows reported by the audio device");
+    private static readonly Histogram<double> _midiLatency = _meter.CreateHistogram<double>(
+        "netkeyer.midi.callback.latency", "ms", "MIDI driver timestamp to the message reaching NetKeyer");
+    private static readonly Histogram<double> _radioSendTime = _meter.CreateHistogram<double>(
+        "netkeyer.radio.send.duration", "ms", "Duration of each CW key command sent to the radio");
+    private static readonly Counter<long> _watchdogKeyUps = _meter.CreateCounter<long>(
+        "netkeyer.radio.watchdog.keyups", "{key-up}", "Key-ups forced because the radio stayed keyed longer than the limit");
+    private static readonly Counter<long> _moxCommands = _meter.CreateCounter<long>(
+        "netkeyer.radio.mox.commands", "{command}", "MOX commands sent to the radio for PTT keying");
+    private static readonly Histogram<double> _pttTimeToTx = _meter.CreateHistogram<double>(
+        "netkeyer.radio.ptt.latency", "ms", "PTT press to the radio reporting it is transmitting, including the debounce time");
+    private static readonly Histogram<double> _radioAckTime = _meter.CreateHistogram<double>(
+        "netkeyer.radio.ack.latency", "ms", "Key-down sent to the radio reporting it is transmitting");
+    private static readonly Histogram<double> _settingsDelay = _meter.CreateHistogram<double>(
+        "netkeyer.radio.settings.delay", "ms", "Settings change made to its command being sent to the radio");
+    private static readonly Histogram<double> _sidetoneStart = _meter.CreateHistogram<double>(
+        "netkeyer.sidetone.start.latency", "ms", "Sidetone request to the audio buffer that starts the tone");
+
+    private static Func<int> _inputQueueDepth;
+    private static Func<int> _pendingSettings;
+    private static long _lastSidetoneStartTicks;
+    private static double _outputLatencyMs;
+    private static long _lastKeyingTimestamp;
+    private static long _lastPauseTicks;
+    private static long _keyingPauseTicks;
+
+    static KeyingMetrics()
+    {
+        _meter.CreateObservableGauge("netkeyer.input.queue.depth",
+            () => _inputQueueDepth?.Invoke() ?? 0, "{edge}", "Input edges waiting for the keying core");
+        _meter.CreateObservableGauge("netkeyer.radio.settings.pending",
+            () => _pendingSettings?.Invoke() ?? 0, "{command}", "Settings commands waiting to be sent to the radio");
+        _meter.CreateObservableGauge("netkeyer.sidetone.latency",
+            () => Timebase.ToMilliseconds(Interlocked.Read(ref _lastSidetoneStartTicks)) + Volatile.Read(ref _outputLatencyMs),
+            "ms", "Latest sidetone start latency plus the output device's reported latency");
+        _meter.CreateObservableCounter("netkeyer.gc.pause.keying",
+            () => TimeSpan.FromTicks(Interlocked.Read(ref _keyingPauseTicks)).TotalMilliseconds,
+            "ms", "Garbage collection pause time while keying");
+    }
+
+    public static void RecordPaddleEdge() => _paddleEdges.Add(1);
+
+    /// <summary>
+    /// Counts a keyed element and accounts GC pauses since the previous one to keying, if
+    /// it was recent enough to be part of the same transmission.
+    /// </summary>
+    public static void RecordElement()
+    {
+        _elements.Add(1);
+
+        long now = Timebase.Now;
+        long pause = GC.GetTotalPauseDuration().Ticks;
+        long last = Interlocked.Exchange(ref _lastKeyingTimestamp, now);
+        long lastPause = Interlocked.Exchange(ref _lastPauseTicks, pause);
+        if (last != 0 && Timebase.ToMillisecondsLong(now - last) < KEYING_IDLE_MS && pause > lastPause)
+            Interlocked.Add(ref _keyingPauseTicks, pause - lastPause);
+    }
+
+    /// <param name="start">Timestamp taken when the callback started.</param>
+    public static void RecordAudioCallback(long start) => _audioCallbackTime.Record(Timebase.ElapsedMilliseconds(start));
+
+    public static void RecordAudioXrun() => _audioXruns.Add(1);
+
+    public static void RecordMidiLatency(long ticks) => _midiLatency.Record(Timebase.ToMilliseconds(ticks));
+
+    public static void RecordRadioSend(long ticks) => _radioSendTime.Record(Timebase.ToMilliseconds(ticks));
+
+    public static void RecordWatchdogKeyUp() => _watchdogKeyUps.Add(1);
+
+    public static void RecordMoxCommand() => _moxCommands.Add(1);
+
+    public static void RecordPttTimeToTx(long ticks) => _pttTimeToTx.Record(Timebase.ToMilliseconds(ticks));
+
+    public static void RecordRadioAck(long ticks) => _radioAckTime.Record(Timebase.ToMilliseconds(ticks));
+
+    public static void RecordSettingsDelay(long ticks) => _settingsDelay.Record(Timebase.ToMilliseconds(ticks));
+
+    public static void RecordSidetoneStart(long ticks)
+    {
+        ticks = Math.Max(0, ticks);
+        Interlocked.Exchange(ref _lastSidetoneStartTicks, ticks);
+        _sidetoneStart.Record(Timebase.ToMilliseconds(ticks));
+    }
+
+    /// <summary>
+    /// Output latency the audio device reports, added to the measured start latency.
+    /// </summary>
+    public static void SetAudioOutputLatency(double milliseconds) => Volatile.Write(ref _outputLatencyMs, milliseconds);
+
+    public static void SetInputQueueDepthSource(Func<int> depth) => _inputQueueDepth = depth;
+
+    public static void SetPendingSettingsSource(Func<int> pending) => _pendingSettings = pending;
+
+    /// <summary>
+    /// Removes <paramref name="pending"/> as the pending settings source, unless another
+    /// source has replaced it since.
+    /// </summary>
+    public static void ClearPendingSettingsSource(Func<int> pending) => Interlocked.CompareExchange(ref _pendingSettings, null, pending);
+}
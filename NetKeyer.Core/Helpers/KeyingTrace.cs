@@ -0,0 +1,319 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text.Json;
+using System.Threading;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// Low-overhead event trace of the keying path, for seeing the MIDI callback, the keyer's
+/// decisions, audio buffers and radio sends on one timeline. Exports Chrome trace JSON,
+/// which chrome://tracing and ui.perfetto.dev open.
+///
+/// Each thread records into its own chunk of fixed-size events, stamped with
+/// <see cref="Timebase"/>; recording takes no lock and, once a thread has its chunk,
+/// allocates nothing. Full chunks go to a shared list, and when the trace reaches its size
+/// limit the oldest chunk is reused, so a long session keeps its most recent events. Event
+/// names must be string literals (they are stored by reference).
+///
+/// Disabled (the default), each call is a single flag test. Start it with NETKEYER_TRACE
+/// set to a file path (or "1" for keying-trace.json next to the debug log), which records
+/// the whole session and writes the file at exit, or with Help → Record Keying Trace.
+/// </summary>
+public static class KeyingTrace
+{
+    private const int CHUNK_EVENTS = 16384;
+    private const int MAX_CHUNKS = 64;
+
+    private const byte PHASE_BEGIN = (byte)'B';
+    private const byte PHASE_END = (byte)'E';
+    private const byte PHASE_INSTANT = (byte)'i';
+
+    private static readonly ConcurrentQueue<Chunk> _fullChunks = new();
+    private static readonly ConcurrentBag<Chunk> _freeChunks = new();
+    private static readonly List<ThreadTrace> _threads = new();
+    private static volatile bool _enabled;
+    private static int _generation;
+    private static int _allocatedChunks;
+    private static long _droppedChunks;
+
+    [ThreadStatic]
+    private static ThreadTrace t_thread;
+
+    public static bool IsEnabled => _enabled;
+
+    /// <summary>
+    /// Chunks of events overwritten because the trace reached its size limit.
+    /// </summary>
+    public static long DroppedChunks => Interlocked.Read(ref _droppedChunks);
+
+    /// <summary>
+    /// Marks the start of a span on this thread; pair with <see cref="End"/>.
+    /// </summary>
+    public static void Begin(string name, long value = 0)
+    {
+        if (_enabled)
+            Record(PHASE_BEGIN, name, value, Timebase.Now);
+    }
+
+    public static void End(string name)
+    {
+        if (_enabled)
+            Record(PHASE_END, name, 0, Timebase.Now);
+    }
+
+    public static void Instant(string name, long value = 0)
+    {
+        if (_enabled)
+            Record(PHASE_INSTANT, name, value, Timebase.Now);
+    }
+
+    /// <summary>
+    /// An instant at an earlier time, such as an input edge's own timestamp.
+    /// </summary>
+    public static void InstantAt(string name, long timestamp, long value = 0)
+    {
+        if (_enabled)
+            Record(PHASE_INSTANT, name, value, timestamp);
+    }
+
+    /// <summary>
+    /// A span for the rest of a block: <c>using var _ = KeyingTrace.Span("audio callback");</c>
+    /// </summary>
+    public static Scope Span(string name, long value = 0)
+    {
+        if (!_enabled)
+            return default;
+
+        Record(PHASE_BEGIN, name, value, Timebase.Now);
+        return new Scope(name);
+    }
+
+    public readonly ref struct Scope
+    {
+        private readonly string _name;
+
+        internal Scope(string name)
+        {
+            _name = name;
+        }
+
+        public void Dispose()
+        {
+            if (_name != null)
+                End(_name);
+        }
+    }
+
+    /// <summary>
+    /// Discards any previous trace and starts recording.
+    /// </summary>
+    public static void Start()
+    {
+        // Threads notice the new generation and start a fresh chunk
+        Interlocked.Increment(ref _generation);
+        while (_fullChunks.TryDequeue(out var chunk))
+            _freeChunks.Add(chunk);
+        Interlocked.Exchange(ref _droppedChunks, 0);
+        _enabled = true;
+    }
+
+    public static void Stop()
+    {
+        _enabled = false;
+    }
+
+    /// <summary>
+    /// Starts a whole-session trace if NETKEYER_TRACE is set, to be written at exit.
+    /// </summary>
+    public static void StartFromEnvironment()
+    {
+        var value = Environment.GetEnvironmentVariable("NETKEYER_TRACE");
+        if (string.IsNullOrWhiteSpace(value) || value == "0")
+            return;
+
+        string path = value == "1"
+            ? Path.Combine(Path.GetDirectoryName(DebugLogger.LogFilePath) ?? ".", "keying-trace.json")
+            : value;
+
+        Start();
+        AppDomain.CurrentDomain.ProcessExit += (_, _) =>
+        {
+            Stop();
+            Export(path);
+        };
+        Console.WriteLine($"Keying trace enabled; it will be written to {path} at exit");
+    }
+
+    /// <summary>
+    /// Writes the events recorded since <see cref="Start"/> as Chrome trace JSON. Stop the
+    /// trace first; events recorded during the export may be missing.
+    /// </summary>
+    /// <returns>Number of events written, or -1 if the file couldn't be written.</returns>
+    public static int Export(string path)
+    {
+        int generation = Volatile.Read(ref _generation);
+        var chunks = _fullChunks.ToList();
+        lock (_threads)
+            chunks.AddRange(_threads.Select(t => t.Current).Where(c => c != null));
+
+        try
+        {
+            using var stream = File.Create(path);
+            using var json = new Utf8JsonWriter(stream);
+            json.WriteStartObject();
+            json.WriteString("displayTimeUnit", "ms");
+            json.WriteStartArray("traceEvents");
+
+            int pid = Environment.ProcessId;
+            WriteMetadata(json, pid, 0, "process_name", "NetKeyer");
+            foreach (var thread in chunks.Where(c => c.Generation == generation).Select(c => c.Thread).Distinct())
+                WriteMetadata(json, pid, thread.ThreadId, "thread_name", thread.Name);
+
+            int written = 0;
+            foreach (var chunk in chunks)
+            {
+                if (chunk.Generation != generation)
+                    continue;
+
+                int count = Volatile.Read(ref chunk.Count);
+                for (int i = 0; i < count; i++)
+                {
+                    ref var e = ref chunk.Events[i];
+                    json.WriteStartObject();
+                    json.WriteString("name", e.Name);
+                    json.WriteString("ph", e.Phase == PHASE_BEGIN ? "B" : e.Phase == PHASE_END ? "E" : "i");
+                    json.WriteNumber("ts", Timebase.ToNanoseconds(e.Timestamp) / 1000.0);
+                    json.WriteNumber("pid", pid);
+                    json.WriteNumber("tid", chunk.Thread.ThreadId);
+                    if (e.Phase == PHASE_INSTANT)
+                        json.WriteString("s", "t");
+                    if (e.Value != 0)
+                    {
+                        json.WriteStartObject("args");
+                        json.WriteNumber("value", e.Value);
+                        json.WriteEndObject();
+                    }
+                    json.WriteEndObject();
+                    written++;
+                }
+            }
+
+            json.WriteEndArray();
+            json.WriteEndObject();
+            Console.WriteLine($"Keying trace: wrote {written} events to {path} ({DroppedChunks} chunks of older events overwritten)");
+            return written;
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            Console.WriteLine($"Warning: Failed to write keying trace: {ex.Message}");
+            return -1;
+        }
+    }
+
+    private static void WriteMetadata(Utf8JsonWriter json, int pid, int tid, string kind, string name)
+    {
+        json.WriteStartObject();
+        json.WriteString("name", kind);
+        json.WriteString("ph", "M");
+        json.WriteNumber("pid", pid);
+        json.WriteNumber("tid", tid);
+        json.WriteStartObject("args");
+        json.WriteString("name", name);
+        json.WriteEndObject();
+        json.WriteEndObject();
+    }
+
+    private static void Record(byte phase, string name, long value, long timestamp)
+    {
+        var thread = t_thread ??= RegisterThread();
+        var chunk = thread.Current;
+        if (chunk == null || chunk.Generation != Volatile.Read(ref _generation) || chunk.Count == CHUNK_EVENTS)
+            chunk = NextChunk(thread);
+
+        // Only this thread writes the chunk; the export reads up to the published count
+        int index = chunk.Count;
+        ref var e = ref chunk.Events[index];
+        e.Timestamp = timestamp;
+        e.Name = name;
+        e.Value = value;
+        e.Phase = phase;
+        Volatile.Write(ref chunk.Count, index + 1);
+    }
+
+    private static ThreadTrace RegisterThread()
+    {
+        var current = Thread.CurrentThread;
+        var thread = new ThreadTrace(current.ManagedThreadId,
+            current.Name ?? (current.IsThreadPoolThread ? $"pool {current.ManagedThreadId}" : $"thread {current.ManagedThreadId}"));
+        lock (_threads)
+            _threads.Add(thread);
+        return thread;
+    }
+
+    private static Chunk NextChunk(ThreadTrace thread)
+    {
+        int generation = Volatile.Read(ref _generation);
+        var previous = thread.Current;
+        if (previous != null && previous.Generation == generation)
+            _fullChunks.Enqueue(previous);
+        else if (previous != null)
+            _freeChunks.Add(previous);
+
+        if (!_freeChunks.TryTake(out var chunk))
+        {
+            if (Interlocked.Increment(ref _allocatedChunks) <= MAX_CHUNKS)
+            {
+                chunk = new Chunk();
+            }
+            else
+            {
+                Interlocked.Decrement(ref _allocatedChunks);
+
+                // At the size limit: overwrite the oldest events
+                if (_fullChunks.TryDequeue(out chunk))
+                    Interlocked.Increment(ref _droppedChunks);
+                else
+                    chunk = new Chunk();
+            }
+        }
+
+        chunk.Thread = thread;
+        chunk.Generation = generation;
+        chunk.Count = 0;
+        thread.Current = chunk;
+        return chunk;
+    }
+
+    private struct TraceEvent
+    {
+        public long Timestamp;
+        public long Value;
+        public string Name;
+        public byte Phase;
+    }
+
+    private sealed class Chunk
+    {
+        public readonly TraceEvent[] Events = new TraceEvent[CHUNK_EVENTS];
+        public ThreadTrace Thread;
+        public int Generation;
+        public int Count;
+    }
+
+    private sealed class ThreadTrace
+    {
+        public ThreadTrace(int threadId, string name)
+        {
+            ThreadId = threadId;
+            Name = name;
+        }
+
+        public int ThreadId { get; }
+        public string Name { get; }
+        public Chunk Current;
+    }
+}
@@ -0,0 +1,149 @@
+using System;
+using System.Numerics;
+using System.Threading;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// Lock-free log-linear histogram of <see cref="Timebase"/> intervals, for latency telemetry
+/// on realtime paths. <see cref="Record"/> never blocks or allocates, so it can be called from
+/// the audio and keying threads. Values are bucketed in microseconds: exact below 16 µs, then
+/// eight buckets per power of two (about 6% resolution) up to several hours.
+/// </summary>
+public sealed class LatencyHistogram
+{
+    private const int LINEAR_BUCKETS = 16;   // 0..15 µs, one bucket each
+    private const int SUB_BUCKET_BITS = 3;   // 8 buckets per octave above that
+    private const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    private const int FIRST_OCTAVE = 4;      // log2(LINEAR_BUCKETS)
+    private const int LAST_OCTAVE = 40;
+    private const int BUCKET_COUNT = LINEAR_BUCKETS + (LAST_OCTAVE - FIRST_OCTAVE + 1) * SUB_BUCKETS;
+
+    private readonly long[] _buckets = new long[BUCKET_COUNT];
+    private long _count;
+    private long _sumMicroseconds;
+    private long _maxMicroseconds;
+
+    public LatencyHistogram(string name)
+    {
+        Name = name;
+    }
+
+    public string Name { get; }
+
+    public long Count => Interlocked.Read(ref _count);
+
+    /// <summary>
+    /// Records an interval in <see cref="Timebase"/> ticks. Negative intervals (clock
+    /// domains that disagree slightly) count as zero.
+    /// </summary>
+    public void Record(long ticks)
+    {
+        long us = ticks > 0 ? Timebase.ToMicroseconds(ticks) : 0;
+        Interlocked.Increment(ref _buckets[BucketIndex(us)]);
+        Interlocked.Increment(ref _count);
+        Interlocked.Add(ref _sumMicroseconds, us);
+
+        long max = Interlocked.Read(ref _maxMicroseconds);
+        while (us > max)
+        {
+            long seen = Interlocked.CompareExchange(ref _maxMicroseconds, us, max);
+            if (seen == max)
+                break;
+            max = seen;
+        }
+    }
+
+    /// <summary>
+    /// Clears all samples. Samples recorded concurrently may land on either side of the reset.
+    /// </summary>
+    public void Reset()
+    {
+        for (int i = 0; i < _buckets.Length; i++)
+            Interlocked.Exchange(ref _buckets[i], 0);
+        Interlocked.Exchange(ref _count, 0);
+        Interlocked.Exchange(ref _sumMicroseconds, 0);
+        Interlocked.Exchange(ref _maxMicroseconds, 0);
+    }
+
+    public double MeanMilliseconds
+    {
+        get
+        {
+            long count = Count;
+            return count == 0 ? 0 : Interlocked.Read(ref _sumMicroseconds) / 1000.0 / count;
+        }
+    }
+
+    public double MaxMilliseconds => Interlocked.Read(ref _maxMicroseconds) / 1000.0;
+
+    /// <summary>
+    /// Approximate percentile (0-100) in milliseconds: the midpoint of the bucket holding it.
+    /// </summary>
+    public double PercentileMilliseconds(double percentile)
+    {
+        long total = 0;
+        for (int i = 0; i < _buckets.Length; i++)
+            total += Interlocked.Read(ref _buckets[i]);
+        if (total == 0)
+            return 0;
+
+        long rank = Math.Max(1, (long)Math.Ceiling(total * percentile / 100.0));
+        long seen = 0;
+        for (int i = 0; i < _buckets.Length; i++)
+        {
+            seen += Interlocked.Read(ref _buckets[i]);
+            if (seen >= rank)
+            {
+                double midpoint = BucketLowerBound(i) + (BucketWidth(i) - 1) / 2.0;
+                return Math.Min(midpoint / 1000.0, MaxMilliseconds);
+            }
+        }
+        return MaxMilliseconds;
+    }
+
+    /// <summary>
+    /// One-line summary for logs, e.g. "send n=120 mean=0.081 p50=0.070 p99=0.310 max=0.402 ms".
+    /// </summary>
+    public override string ToString()
+    {
+        long count = Count;
+        if (count == 0)
+            return $"{Name} n=0";
+
+        return $"{Name} n={count} mean={MeanMilliseconds:F3} p50={PercentileMilliseconds(50):F3} " +
+               $"p90={PercentileMilliseconds(90):F3} p99={PercentileMilliseconds(99):F3} max={MaxMilliseconds:F3} ms";
+    }
+
+    private static int BucketIndex(long us)
+    {
+        if (us < LINEAR_BUCKETS)
+            return (int)us;
+
+        int octave = BitOperations.Log2((ulong)us);
+        if (octave > LAST_OCTAVE)
+            return BUCKET_COUNT - 1;
+
+        int sub = (int)(us >> (octave - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return LINEAR_BUCKETS + (octave - FIRST_OCTAVE) * SUB_BUCKETS + sub;
+    }
+
+    private static long BucketLowerBound(int index)
+    {
+        if (index < LINEAR_BUCKETS)
+            return index;
+
+        int octave = FIRST_OCTAVE + (index - LINEAR_BUCKETS) / SUB_BUCKETS;
+        int sub = (index - LINEAR_BUCKETS) % SUB_BUCKETS;
+        return (1L << octave) + ((long)sub << (octave - SUB_BUCKET_BITS));
+    }
+
+    private static long BucketWidth(int index)
+    {
+        if (index < LINEAR_BUCKETS)
+            return 1;
+
+        int octave = FIRST_OCTAVE + (index - LINEAR_BUCKETS) / SUB_BUCKETS;
+        return 1L << (octave - SUB_BUCKET_BITS);
+    }
+}
@@ -0,0 +1,112 @@
+using System;
+using System.Threading;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// Bounded lock-free multi-producer / single-consumer queue (Vyukov's array queue).
+/// Producers never block or allocate; <see cref="TryEnqueue"/> returns false when full.
+/// Only one thread at a time may call <see cref="TryDequeue"/>; callers that dequeue
+/// from different threads must serialize them with their own lock.
+/// </summary>
+public sealed class MpscQueue<T>
+{
+    private struct Cell
+    {
+        public long Sequence;
+        public T Value;
+    }
+
+    private readonly Cell[] _cells;
+    private readonly long _mask;
+    private long _enqueuePosition;
+    private long _dequeuePosition;
+
+    /// <param name="capacity">Queue size; rounded up to a power of two.</param>
+    public MpscQueue(int capacity)
+    {
+        if (capacity < 2)
+            throw new ArgumentOutOfRangeException(nameof(capacity));
+
+        int size = 1;
+        while (size < capacity)
+            size <<= 1;
+
+        _cells = new Cell[size];
+        _mask = size - 1;
+        for (int i = 0; i < size; i++)
+            _cells[i].Sequence = i;
+    }
+
+    public int Capacity => _cells.Length;
+
+    /// <summary>
+    /// Number of items queued. Only a snapshot while other threads are using the queue.
+    /// </summary>
+    public int Count => (int)Math.Clamp(Volatile.Read(ref _enqueuePosition) - Volatile.Read(ref _dequeuePosition), 0, _cells.Length);
+
+    public bool IsEmpty
+    {
+        get
+        {
+            long position = Volatile.Read(ref _dequeuePosition);
+            return Volatile.Read(ref _cells[position & _mask].Sequence) != position + 1;
+        }
+    }
+
+    /// <summary>
+    /// Adds an item. Safe to call from any number of threads concurrently.
+    /// </summary>
+    public bool TryEnqueue(in T item)
+    {
+        long position = Volatile.Read(ref _enqueuePosition);
+        while (true)
+        {
+            ref Cell cell = ref _cells[position & _mask];
+            long sequence = Volatile.Read(ref cell.Sequence);
+            long diff = sequence - position;
+
+            if (diff == 0)
+            {
+                // Cell is free for this position; claim it
+                if (Interlocked.CompareExchange(ref _enqueuePosition, position + 1, position) == position)
+                {
+                    cell.Value = item;
+                    Volatile.Write(ref cell.Sequence, position + 1);
+                    return true;
+                }
+                position = Volatile.Read(ref _enqueuePosition);
+            }
+            else if (diff < 0)
+            {
+                // Consumer hasn't freed this cell yet: full
+                return false;
+            }
+            else
+            {
+                // Another producer claimed it; catch up
+                position = Volatile.Read(ref _enqueuePosition);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Removes the oldest item. Single consumer only.
+    /// </summary>
+    public bool TryDequeue(out T item)
+    {
+        long position = _dequeuePosition;
+        ref Cell cell = ref _cells[position & _mask];
+        if (Volatile.Read(ref cell.Sequence) != position + 1)
+        {
+            item = default;
+            return false;
+        }
+
+        item = cell.Value;
+        cell.Value = default;
+        Volatile.Write(ref cell.Sequence, position + _mask + 1);
+        Volatile.Write(ref _dequeuePosition, position + 1);
+        return true;
+    }
+}
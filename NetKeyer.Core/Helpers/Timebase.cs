@@ -0,0 +1,96 @@
+using System.Diagnostics;
+
+namespace NetKeyer.Helpers;
+
+/// <summary>
+/// The single monotonic clock for everything timing-sensitive: input edge stamps, keyer
+/// timing, network packets, radio CWKey timestamps and debug logs. Timestamps are
+/// <see cref="Stopwatch.GetTimestamp"/> ticks (QueryPerformanceCounter on Windows,
+/// CLOCK_MONOTONIC on Linux), so values from any subsystem can be subtracted directly.
+/// Converters map to nanoseconds, audio sample frames and the FlexRadio 16-bit
+/// millisecond CWKey domain. Foreign clocks (MIDI backends, the audio render position)
+/// are mapped onto it with <see cref="ClockMapper"/>.
+/// </summary>
+public static class Timebase
+{
+    private const long NanosecondsPerSecond = 1_000_000_000;
+    private const long MicrosecondsPerSecond = 1_000_000;
+    private const long MillisecondsPerSecond = 1_000;
+
+    /// <summary>
+    /// Ticks per second.
+    /// </summary>
+    public static readonly long Frequency = Stopwatch.Frequency;
+
+    /// <summary>
+    /// Current timestamp in ticks.
+    /// </summary>
+    public static long Now => Stopwatch.GetTimestamp();
+
+    /// <summary>
+    /// Current timestamp in nanoseconds.
+    /// </summary>
+    public static long NowNanoseconds => ToNanoseconds(Stopwatch.GetTimestamp());
+
+    // Conversions split whole seconds from the remainder so large values never overflow
+
+    public static long ToNanoseconds(long ticks)
+        => ticks / Frequency * NanosecondsPerSecond + ticks % Frequency * NanosecondsPerSecond / Frequency;
+
+    public static long FromNanoseconds(long nanoseconds)
+        => nanoseconds / NanosecondsPerSecond * Frequency + nanoseconds % NanosecondsPerSecond * Frequency / NanosecondsPerSecond;
+
+    public static long ToMicroseconds(long ticks)
+        => ticks / Frequency * MicrosecondsPerSecond + ticks % Frequency * MicrosecondsPerSecond / Frequency;
+
+    public static long FromMicroseconds(long microseconds)
+        => microseconds / MicrosecondsPerSecond * Frequency + microseconds % MicrosecondsPerSecond * Frequency / MicrosecondsPerSecond;
+
+    public static long ToMillisecondsLong(long ticks)
+        => ticks / Frequency * MillisecondsPerSecond + ticks % Frequency * MillisecondsPerSecond / Frequency;
+
+    public static long FromMilliseconds(long milliseconds)
+        => milliseconds / MillisecondsPerSecond * Frequency + milliseconds % MillisecondsPerSecond * Frequency / MillisecondsPerSecond;
+
+    /// <summary>
+    /// Converts a tick interval to fractional milliseconds, for logging and statistics.
+    /// </summary>
+    public static double ToMilliseconds(long ticks) => ticks * 1000.0 / Frequency;
+
+    /// <summary>
+    /// Milliseconds elapsed since <paramref name="timestamp"/>.
+    /// </summary>
+    public static double ElapsedMilliseconds(long timestamp) => ToMilliseconds(Stopwatch.GetTimestamp() - timestamp);
+
+    // ---- audio stream clock ----
+
+    public static long FramesToNanoseconds(long frames, int sampleRate)
+        => frames / sampleRate * NanosecondsPerSecond + frames % sampleRate * NanosecondsPerSecond / sampleRate;
+
+    public static long FramesToTicks(long frames, int sampleRate)
+        => frames / sampleRate * Frequency + frames % sampleRate * Frequency / sampleRate;
+
+    public static long TicksToFrames(long ticks, int sampleRate)
+        => ticks / Frequency * sampleRate + ticks % Frequency * sampleRate / Frequency;
+
+    // ---- FlexRadio CWKey timestamps ----
+
+    /// <summary>
+    /// Converts a timestamp to the radio's CWKey time domain: a free-running millisecond
+    /// counter truncated to 16 bits. The radio only uses differences between successive
+    /// stamps, so the epoch doesn't matter, only that every stamp comes from this clock.
+    /// </summary>
+    public static ushort ToRadioTimestamp(long ticks) => (ushort)ToMillisecondsLong(ticks);
+
+    /// <summary>
+    /// Formats a timestamp as the four hex digit string CWKey expects.
+    /// </summary>
+    public static string FormatRadioTimestamp(long ticks) => FormatRadioTimestamp(ToRadioTimestamp(ticks));
+
+    /// <summary>
+    /// Formats a radio timestamp as the four hex digit string CWKey expects. The keying core
+    /// passes stamps as numbers, so only the FlexLib boundary, which builds a command string
+    /// anyway, allocates one.
+    /// </summary>
+    public static string FormatRadioTimestamp(ushort radioTimestamp) => radioTimestamp.ToString("X4");
+}
@@ -0,0 +1,495 @@
+using System;
+using NetKeyer.Audio;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Keying;
+
+/// <summary>
+/// Iambic keyer implementation supporting Mode A and Mode B.
+/// Handles timing, paddle latching, and element generation for iambic keying.
+/// Uses event-driven architecture based on audio sample timing.
+/// Not thread-safe: the instance is owned by <see cref="NetKeyer.Services.KeyingController"/>,
+/// which serializes paddle updates, control calls and the sidetone callbacks (forwarded to the
+/// Handle* methods) through its keying core.
+/// </summary>
+public class IambicKeyer
+{
+    private readonly Func<ushort> _getTimestamp;
+    private readonly Action<bool, ushort, uint> _sendRadioKey;
+    private ISidetoneGenerator _sidetoneGenerator;
+    private readonly uint _radioClientHandle;
+
+    private bool _iambicDitLatched = false;
+    private bool _iambicDahLatched = false;
+    private bool _ditPaddleAtStart = false;
+    private bool _dahPaddleAtStart = false;
+    private bool _ditPaddleAtSilenceStart = false;
+    private bool _dahPaddleAtSilenceStart = false;
+    private bool _currentDitPaddleState = false;
+    private bool _currentDahPaddleState = false;
+    private int _ditLength = 60; // milliseconds
+    private KeyerState _keyerState = KeyerState.Idle;
+    private bool _lastElementWasDit = true; // Track what was actually sent last
+    private long _lastStateChangeTick = Timebase.Now;
+
+    private static readonly bool _keyerDebug = DebugCategory.Keyer.IsEnabled;
+
+    // Computed timestamp tracking
+    private long _sequenceStartTimestamp;      // Timebase timestamp when sequence started
+    private long _computedElapsedMs;           // Computed elapsed time in milliseconds
+    private bool _inTimedSequence;             // True when using computed timestamps
+
+    private enum KeyerState
+    {
+        Idle,              // Nothing playing, nothing queued
+        TonePlaying,       // Tone actively playing (between OnToneStart and OnToneComplete)
+        InterElementSpace  // Silence between elements
+    }
+
+    /// <summary>
+    /// Gets or sets whether to use Mode B (true) or Mode A (false).
+    /// </summary>
+    public bool IsModeB { get; set; } = true;
+
+    /// <summary>
+    /// True when no element is playing or queued, so timing parameters can change freely.
+    /// </summary>
+    public bool IsIdle => _keyerState == KeyerState.Idle;
+
+    /// <summary>
+    /// Creates a new iambic keyer instance.
+    /// </summary>
+    /// <param name="sidetoneGenerator">Sidetone generator for local audio feedback</param>
+    /// <param name="radioClientHandle">Radio client handle for sending commands (0 for sidetone-only)</param>
+    /// <param name="getTimestamp">Function to get current radio timestamp (<see cref="Timebase.ToRadioTimestamp"/>) for radio commands</param>
+    /// <param name="sendRadioKey">Action to send CW key command to radio (can be null for sidetone-only)</param>
+    public IambicKeyer(
+        ISidetoneGenerator sidetoneGenerator,
+        uint radioClientHandle,
+        Func<ushort> getTimestamp,
+        Action<bool, ushort, uint> sendRadioKey)
+    {
+        _sidetoneGenerator = sidetoneGenerator ?? throw new ArgumentNullException(nameof(sidetoneGenerator));
+        _radioClientHandle = radioClientHandle;
+        _getTimestamp = getTimestamp ?? throw new ArgumentNullException(nameof(getTimestamp));
+        _sendRadioKey = sendRadioKey; // Can be null for sidetone-only mode
+    }
+
+    /// <summary>
+    /// Sets the CW speed in WPM and recalculates timing.
+    /// </summary>
+    public void SetWpm(int wpm)
+    {
+        if (wpm > 0)
+        {
+            _ditLength = 1200 / wpm;
+        }
+        else
+        {
+            _ditLength = 60; // Default to 20 WPM
+        }
+
+        // Reset computed timing when WPM changes to avoid drift
+        ResetTimedSequence();
+    }
+
+    /// <summary>
+    /// Updates the keyer with current paddle states.
+    /// Call this whenever paddle state changes.
+    /// </summary>
+    public void UpdatePaddleState(bool ditPaddle, bool dahPaddle)
+    {
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] UpdatePaddleState: L={ditPaddle} R={dahPaddle} State={_keyerState}");
+        KeyingTrace.Instant("keyer paddles", (ditPaddle ? 1 : 0) | (dahPaddle ? 2 : 0));
+
+        // Safety check: if state machine has been stuck for >1 second, force reset
+        if (_keyerState != KeyerState.Idle)
+        {
+            if (Timebase.ElapsedMilliseconds(_lastStateChangeTick) > 1000)
+            {
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] State timeout detected - forcing reset from {_keyerState}");
+                Stop();
+            }
+        }
+
+        // Update current paddle states
+        _currentDitPaddleState = ditPaddle;
+        _currentDahPaddleState = dahPaddle;
+
+        // If keyer is idle and at least one paddle is pressed, start sending
+        if (_keyerState == KeyerState.Idle && (ditPaddle || dahPaddle))
+        {
+            StartNextElement();
+        }
+        // If keyer is playing, update alternation latches for opposite paddle
+        else if (_keyerState == KeyerState.TonePlaying)
+        {
+            // Set alternation latch for opposite paddle if it's pressed during tone
+            // (paddle is "newly pressed" if it wasn't already pressed at element start)
+            if (_lastElementWasDit && dahPaddle && !_dahPaddleAtStart && !_iambicDahLatched)
+            {
+                _iambicDahLatched = true;
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] Setting DAH latch (opposite paddle during dit tone)");
+            }
+            if (!_lastElementWasDit && ditPaddle && !_ditPaddleAtStart && !_iambicDitLatched)
+            {
+                _iambicDitLatched = true;
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] Setting DIT latch (opposite paddle during dah tone)");
+            }
+        }
+        // If in inter-element space, latch either paddle if newly pressed during silence
+        // Decision about next element happens in OnBeforeSilenceEnd
+        else if (_keyerState == KeyerState.InterElementSpace)
+        {
+            // Latch dit paddle if newly pressed during silence
+            if (ditPaddle && !_ditPaddleAtSilenceStart && !_iambicDitLatched)
+            {
+                _iambicDitLatched = true;
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] Setting DIT latch (newly pressed during silence)");
+            }
+            // Latch dah paddle if newly pressed during silence
+            if (dahPaddle && !_dahPaddleAtSilenceStart && !_iambicDahLatched)
+            {
+                _iambicDahLatched = true;
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] Setting DAH latch (newly pressed during silence)");
+            }
+            // Don't call Stop() here - decision happens in OnBeforeSilenceEnd
+        }
+    }
+
+    /// <summary>
+    /// Stops the keyer immediately and resets to idle state.
+    /// </summary>
+    public void Stop()
+    {
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] Stop called, going to Idle");
+
+        // Send radio key-up if needed
+        SendRadioKey(false);
+
+        // Reset state
+        _keyerState = KeyerState.Idle;
+        _lastStateChangeTick = Timebase.Now;
+        _iambicDitLatched = false;
+        _iambicDahLatched = false;
+        _ditPaddleAtStart = false;
+        _dahPaddleAtStart = false;
+        _ditPaddleAtSilenceStart = false;
+        _dahPaddleAtSilenceStart = false;
+
+        // Reset computed timing
+        ResetTimedSequence();
+    }
+
+    /// <summary>
+    /// Stops the keyer like <see cref="Stop"/>, for an element that never finished (the audio
+    /// device stalled). The key-up is stamped now rather than at the element's computed time,
+    /// which would be in the past.
+    /// </summary>
+    public void Abort()
+    {
+        ResetTimedSequence();
+        Stop();
+    }
+
+    /// <summary>
+    /// Resets computed timestamp tracking. Called when timing parameters change mid-sequence.
+    /// </summary>
+    private void ResetTimedSequence()
+    {
+        _inTimedSequence = false;
+        _computedElapsedMs = 0;
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] Timed sequence reset");
+    }
+
+    /// <summary>
+    /// Disposes the keyer and releases the sidetone generator.
+    /// </summary>
+    public void Dispose()
+    {
+        _sidetoneGenerator = null;
+    }
+
+    /// <summary>
+    /// Updates the sidetone generator. Useful when changing audio output device.
+    /// The owner moves its event subscriptions across to the new generator.
+    /// </summary>
+    public void UpdateSidetoneGenerator(ISidetoneGenerator sidetoneGenerator)
+    {
+        _sidetoneGenerator = sidetoneGenerator ?? throw new ArgumentNullException(nameof(sidetoneGenerator));
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Using sidetone generator ({sidetoneGenerator.GetHashCode()})");
+    }
+
+    /// <summary>
+    /// Called when a tone starts (including queued tones). Send radio key-down.
+    /// </summary>
+    public void HandleToneStart()
+    {
+        // If transitioning from Idle to TonePlaying, start a new timed sequence
+        if (_keyerState == KeyerState.Idle)
+        {
+            _sequenceStartTimestamp = Timebase.Now;
+            _computedElapsedMs = 0;
+            _inTimedSequence = true;
+            if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Starting new timed sequence at {_sequenceStartTimestamp}");
+        }
+        // If transitioning from InterElementSpace to TonePlaying, advance by the space duration
+        else if (_keyerState == KeyerState.InterElementSpace && _inTimedSequence)
+        {
+            _computedElapsedMs += _ditLength;
+            if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Advanced computed time by inter-element space {_ditLength}ms (total elapsed: {_computedElapsedMs}ms)");
+        }
+
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] OnToneStart: Tone starting, sending radio key-down");
+        KeyingTrace.Instant("keyer tone start", _lastElementWasDit ? _ditLength : _ditLength * 3);
+        KeyingMetrics.RecordElement();
+
+        // Capture paddle states at ACTUAL element start time (not decision time)
+        // This is critical for Mode B completion logic to work correctly
+        _ditPaddleAtStart = _currentDitPaddleState;
+        _dahPaddleAtStart = _currentDahPaddleState;
+
+        // Send radio key-down
+        SendRadioKey(true);
+        _keyerState = KeyerState.TonePlaying;
+        _lastStateChangeTick = Timebase.Now;
+    }
+
+    /// <summary>
+    /// Called when a tone completes. Send radio key-up, capture paddle states at silence start,
+    /// reset latches, and queue the inter-element silence.
+    /// </summary>
+    public void HandleToneComplete()
+    {
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] OnToneComplete: Tone ended, capturing paddle states at silence start");
+        KeyingTrace.Instant("keyer tone complete");
+
+        // Advance computed time by the element duration we just completed BEFORE sending key-up
+        // This ensures key-up timestamp reflects the end of the element
+        if (_inTimedSequence)
+        {
+            int elementDuration = _lastElementWasDit ? _ditLength : (_ditLength * 3);
+            _computedElapsedMs += elementDuration;
+            if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Advanced computed time by {elementDuration}ms (total elapsed: {_computedElapsedMs}ms)");
+        }
+
+        // Send radio key-up with the advanced timestamp
+        SendRadioKey(false);
+
+        // Set state to InterElementSpace
+        _keyerState = KeyerState.InterElementSpace;
+        _lastStateChangeTick = Timebase.Now;
+
+        // Capture paddle states at START of silence (for repetition logic)
+        _ditPaddleAtSilenceStart = _currentDitPaddleState;
+        _dahPaddleAtSilenceStart = _currentDahPaddleState;
+
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Paddle states at silence start: dit={_ditPaddleAtSilenceStart}, dah={_dahPaddleAtSilenceStart}, ditLatch={_iambicDitLatched}, dahLatch={_iambicDahLatched}");
+
+        // Queue just the silence (decision about next element happens in OnBeforeSilenceEnd)
+        // Note: Alternation latches remain set and will be checked in OnBeforeSilenceEnd
+        _sidetoneGenerator?.QueueSilence(_ditLength);
+    }
+
+    /// <summary>
+    /// Starts or queues a tone with the specified duration.
+    /// Clears latches and tracks element type.
+    /// </summary>
+    private void StartOrQueueTone(int toneDurationMs)
+    {
+        bool isDit = (toneDurationMs == _ditLength);
+
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Starting/queueing {(isDit ? "dit" : "dah")} ({toneDurationMs}ms)");
+
+        // Start tone (will queue if in silence, start immediately if idle)
+        _sidetoneGenerator?.StartTone(toneDurationMs);
+
+        // Clear latches and track element
+        _iambicDitLatched = false;
+        _iambicDahLatched = false;
+        _lastElementWasDit = isDit;
+    }
+
+    /// <summary>
+    /// Called when silence is about to end. Make late decision about next element.
+    /// This is the critical decision point where we determine what to send next based on
+    /// paddle states during both the tone and the silence period.
+    /// </summary>
+    public void HandleBeforeSilenceEnd()
+    {
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] OnBeforeSilenceEnd: Making decision about next element");
+
+        // Decide what to send next based on current state and latches
+        int? nextToneDuration = DetermineNextToneDuration();
+        KeyingTrace.Instant("keyer decision", nextToneDuration ?? 0);
+
+        if (nextToneDuration.HasValue)
+        {
+            StartOrQueueTone(nextToneDuration.Value);
+        }
+        else
+        {
+            if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] No element to send, silence will complete and go idle");
+            // If no tone, silence will complete and OnSilenceComplete will handle going idle
+        }
+    }
+
+    /// <summary>
+    /// Called when silence completes with no queued tone. Transition to idle and reset state.
+    /// Note: Decision about whether to send another element was already made in OnBeforeSilenceEnd.
+    /// If we reach here, it means no tone was queued, so we're done.
+    /// </summary>
+    public void HandleSilenceComplete()
+    {
+        // Stale: the late decision was delivered after the silence had already ended (the
+        // owner was busy and applied both events afterwards) and has started the next tone
+        if (_keyerState == KeyerState.TonePlaying)
+        {
+            if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] OnSilenceComplete: next tone already playing, ignoring");
+            return;
+        }
+
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] OnSilenceComplete: Silence ended with no queued tone, going idle");
+        KeyingTrace.Instant("keyer idle");
+
+        _keyerState = KeyerState.Idle;
+        _lastStateChangeTick = Timebase.Now;
+
+        // End timed sequence when returning to idle
+        _inTimedSequence = false;
+
+        // Reset all state
+        _iambicDitLatched = false;
+        _iambicDahLatched = false;
+        _ditPaddleAtStart = false;
+        _dahPaddleAtStart = false;
+        _ditPaddleAtSilenceStart = false;
+        _dahPaddleAtSilenceStart = false;
+    }
+
+    /// <summary>
+    /// Determines what element to send next based on paddle states and latches, then starts it.
+    /// Called from Idle state when at least one paddle is pressed.
+    /// Note: Will always send an element (never returns to idle) since at least one paddle is pressed.
+    /// </summary>
+    private void StartNextElement()
+    {
+        int? nextDuration = DetermineNextToneDuration();
+
+        // When called from Idle with at least one paddle pressed, DetermineNextToneDuration
+        // will always return a tone duration, so this should never be null.
+        // The null check is kept for safety but the else branch is unreachable.
+        if (nextDuration.HasValue)
+        {
+            StartOrQueueTone(nextDuration.Value);
+        }
+    }
+
+    /// <summary>
+    /// Determines what the next tone duration should be based on current paddle states and latches.
+    /// Uses correct alternation/repetition logic:
+    /// - Alternation: opposite paddle latched (pressed during tone/silence) OR currently pressed
+    /// - Repetition: same paddle latched (pressed during silence) OR currently pressed at end of silence
+    /// Returns null if no tone should be sent. Internal for tools/KeyingBenchmarks.
+    /// </summary>
+    internal int? DetermineNextToneDuration()
+    {
+        bool sendDit = false;
+        bool sendDah = false;
+
+        if (_lastElementWasDit || _keyerState == KeyerState.Idle)
+        {
+            // Just sent dit (or starting from idle)
+            // Priority 1: Alternation - opposite paddle latched or pressed
+            if (_iambicDahLatched || _currentDahPaddleState)
+            {
+                sendDah = true;
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Alternation: sending dah (latch={_iambicDahLatched}, current={_currentDahPaddleState})");
+            }
+            // Priority 2: Repetition - same paddle latched or pressed at end of silence
+            else if (_iambicDitLatched || _currentDitPaddleState)
+            {
+                sendDit = true;
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Repetition: sending dit (latch={_iambicDitLatched}, current={_currentDitPaddleState})");
+            }
+            // Priority 3 (Mode B only): Squeeze - both held at tone start, both now released
+            else if (IsModeB && _dahPaddleAtStart && !_currentDahPaddleState && !_currentDitPaddleState)
+            {
+                sendDah = true;
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] Mode B squeeze: sending dah (both were held at tone start, both now released)");
+            }
+        }
+        else // was sending dah
+        {
+            // Just sent dah
+            // Priority 1: Alternation - opposite paddle latched or pressed
+            if (_iambicDitLatched || _currentDitPaddleState)
+            {
+                sendDit = true;
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Alternation: sending dit (latch={_iambicDitLatched}, current={_currentDitPaddleState})");
+            }
+            // Priority 2: Repetition - same paddle latched or pressed at end of silence
+            else if (_iambicDahLatched || _currentDahPaddleState)
+            {
+                sendDah = true;
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Repetition: sending dah (latch={_iambicDahLatched}, current={_currentDahPaddleState})");
+            }
+            // Priority 3 (Mode B only): Squeeze - both held at tone start, both now released
+            else if (IsModeB && _ditPaddleAtStart && !_currentDitPaddleState && !_currentDahPaddleState)
+            {
+                sendDit = true;
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] Mode B squeeze: sending dit (both were held at tone start, both now released)");
+            }
+        }
+
+        // Handle special case: both paddles pressed from idle = dit first
+        if (_keyerState == KeyerState.Idle && _currentDitPaddleState && _currentDahPaddleState)
+        {
+            sendDit = true;
+            sendDah = false;
+            if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, "[IambicKeyer] Both paddles from idle: sending dit first");
+        }
+
+        if (sendDit)
+            return _ditLength;
+        else if (sendDah)
+            return _ditLength * 3;
+        else
+            return null;
+    }
+
+    /// <summary>
+    /// Sends radio key command (if radio is configured).
+    /// </summary>
+    private void SendRadioKey(bool state)
+    {
+        if (_sendRadioKey != null && _radioClientHandle != 0)
+        {
+            ushort timestamp;
+            string timestampType;
+
+            if (_inTimedSequence)
+            {
+                // Compute timestamp based on sequence start + computed elapsed time
+                timestamp = Timebase.ToRadioTimestamp(_sequenceStartTimestamp + Timebase.FromMilliseconds(_computedElapsedMs));
+                timestampType = "computed";
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] Computed timestamp details: seq_start={_sequenceStartTimestamp}, elapsed={_computedElapsedMs}ms, result={timestamp:X4}");
+            }
+            else
+            {
+                // Straight key mode or fallback: use real timestamp
+                timestamp = _getTimestamp();
+                timestampType = "real";
+            }
+
+            // Log the actual CWKey command being sent
+            if (_keyerDebug)
+            {
+                string keyState = state ? "KEY-DOWN" : "KEY-UP";
+                DebugLogger.Log(DebugCategory.Keyer, $"[IambicKeyer] >>> Sending CWKey to radio: {keyState}, timestamp={timestamp:X4} ({timestampType}), handle={_radioClientHandle}");
+            }
+
+            _sendRadioKey(state, timestamp, _radioClientHandle);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+namespace NetKeyer.Keying;
+
+/// <summary>
+/// Immutable snapshot of the keyer-relevant settings. The keying core reads the latest
+/// published snapshot at element boundaries, so a change from any thread is picked up
+/// without a lock and never alters an element already being sent. The With* methods return
+/// the same instance when nothing changes, so publishing an unchanged value is free.
+/// </summary>
+public sealed class KeyerParameters
+{
+    /// <summary>
+    /// Longest the radio may stay keyed before the watchdog forces key-up, unless configured.
+    /// </summary>
+    public const int DEFAULT_MAX_KEY_DOWN_MS = 10000;
+
+    /// <summary>
+    /// What the keying core starts with: iambic Mode B, no speed or pitch known yet.
+    /// </summary>
+    public static readonly KeyerParameters Default = new KeyerParameters(0, true, true, false, 0, DEFAULT_MAX_KEY_DOWN_MS, 0, 0);
+
+    public KeyerParameters(int wpm, bool isIambic, bool isModeB, bool swapPaddles, int pitchHz, int maxKeyDownMs,
+                           int pttDebounceMs, int pttHangMs)
+    {
+        Wpm = wpm;
+        IsIambic = isIambic;
+        IsModeB = isModeB;
+        SwapPaddles = swapPaddles;
+        PitchHz = pitchHz;
+        MaxKeyDownMs = maxKeyDownMs;
+        PttDebounceMs = pttDebounceMs;
+        PttHangMs = pttHangMs;
+    }
+
+    public int Wpm { get; }
+    public bool IsIambic { get; }
+    public bool IsModeB { get; }
+    public bool SwapPaddles { get; }
+
+    /// <summary>
+    /// Sidetone pitch in Hz, or 0 to leave the sidetone generator's frequency alone.
+    /// </summary>
+    public int PitchHz { get; }
+
+    /// <summary>
+    /// Longest continuous key-down sent to the radio, in either keying mode, before
+    /// <see cref="NetKeyer.Services.KeyDownWatchdog"/> forces key-up; 0 turns the watchdog off.
+    /// Unlike the other parameters this applies immediately, not at an element boundary.
+    /// </summary>
+    public int MaxKeyDownMs { get; }
+
+    /// <summary>
+    /// How long PTT must be held before MOX goes on, in non-CW modes. This debounces the PTT
+    /// input and delays MOX by the same amount: a press shorter than this sends nothing. Like the hang time this is read by <see cref="NetKeyer.Services.PttSequencer"/> as
+    /// soon as it is published.
+    /// </summary>
+    public int PttDebounceMs { get; }
+
+    /// <summary>
+    /// How long MOX stays on after PTT is released. Pressing PTT again within it keeps
+    /// transmitting without another MOX command.
+    /// </summary>
+    public int PttHangMs { get; }
+
+    public KeyerParameters WithWpm(int wpm) =>
+        wpm == Wpm ? this : new KeyerParameters(wpm, IsIambic, IsModeB, SwapPaddles, PitchHz, MaxKeyDownMs, PttDebounceMs, PttHangMs);
+
+    public KeyerParameters WithKeyingMode(bool isIambic, bool isModeB) =>
+        isIambic == IsIambic && isModeB == IsModeB ? this : new KeyerParameters(Wpm, isIambic, isModeB, SwapPaddles, PitchHz, MaxKeyDownMs, PttDebounceMs, PttHangMs);
+
+    public KeyerParameters WithSwapPaddles(bool swapPaddles) =>
+        swapPaddles == SwapPaddles ? this : new KeyerParameters(Wpm, IsIambic, IsModeB, swapPaddles, PitchHz, MaxKeyDownMs, PttDebounceMs, PttHangMs);
+
+    public KeyerParameters WithPitch(int pitchHz) =>
+        pitchHz == PitchHz ? this : new KeyerParameters(Wpm, IsIambic, IsModeB, SwapPaddles, pitchHz, MaxKeyDownMs, PttDebounceMs, PttHangMs);
+
+    public KeyerParameters WithMaxKeyDown(int maxKeyDownMs) =>
+        maxKeyDownMs == MaxKeyDownMs ? this : new KeyerParameters(Wpm, IsIambic, IsModeB, SwapPaddles, PitchHz, maxKeyDownMs, PttDebounceMs, PttHangMs);
+
+    public KeyerParameters WithPttTiming(int debounceMs, int hangMs) =>
+        debounceMs == PttDebounceMs && hangMs == PttHangMs ? this : new KeyerParameters(Wpm, IsIambic, IsModeB, SwapPaddles, PitchHz, MaxKeyDownMs, debounceMs, hangMs);
+
+    public override string ToString()
+    {
+        return $"{Wpm} WPM, {(IsIambic ? (IsModeB ? "iambic B" : "iambic A") : "straight")}{(SwapPaddles ? ", swapped" : "")}, {PitchHz} Hz";
+    }
+}
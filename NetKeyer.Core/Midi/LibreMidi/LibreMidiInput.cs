@@ -1,27 +1,39 @@
 using System;
 using System.Collections.Generic;
+using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using System.Text;
 using NetKeyer.Helpers;
+using NetKeyer.Realtime;
 
 namespace NetKeyer.Midi.LibreMidi
 {
+    /// <summary>
+    /// Receives one MIDI message.  The span points straight into the shim's buffer and is
+    /// only valid for the duration of the call; <paramref name="timestamp"/> is the
+    /// <see cref="Timebase"/> time of the message: the backend's own timestamp mapped onto
+    /// the timebase when the shim provides it, otherwise the arrival time.
+    /// </summary>
+    internal delegate void MidiMessageHandler(ReadOnlySpan<byte> message, long timestamp);
+
     /// <summary>
     /// Managed wrapper around the netkeyer_midi_shim native library.
     /// Enumerates MIDI input ports and opens one for receiving messages.
     /// </summary>
-    internal class LibreMidiInput : IDisposable
+    internal unsafe class LibreMidiInput : IDisposable
     {
         private IntPtr _observer = IntPtr.Zero;
         private IntPtr _inputHandle = IntPtr.Zero;
-        private GCHandle _callbackHandle;
-        private NativeMethods.MessageCallback _callback;
+        private GCHandle _selfHandle;
+        private readonly ClockMapper _backendClock = new ClockMapper();
+        private static bool _timestampShimMissing;
 
         /// <summary>
         /// Fired for each complete MIDI message received from the open port.
         /// SysEx, timing, and active sensing are pre-filtered by the shim.
+        /// The message is not copied, so handlers must not retain the span.
         /// </summary>
-        public event Action<byte[]> MessageReceived;
+        public event MidiMessageHandler MessageReceived;
 
         /// <summary>
         /// Returns the names of all currently available MIDI input ports.
@@ -30,17 +42,17 @@ namespace NetKeyer.Midi.LibreMidi
         public static List<string> GetAvailableDevices()
         {
             var devices = new List<string>();
-            DebugLogger.Log("midi", "[MIDI] nkm_create_observer: calling");
+            DebugLogger.Log(DebugCategory.Midi, "[MIDI] nkm_create_observer: calling");
             IntPtr obs = NativeMethods.nkm_create_observer();
             if (obs == IntPtr.Zero)
             {
-                DebugLogger.Log("midi", "[MIDI] nkm_create_observer: returned NULL — observer creation failed (check stderr for libremidi errors)");
+                DebugLogger.Log(DebugCategory.Midi, "[MIDI] nkm_create_observer: returned NULL — observer creation failed (check stderr for libremidi errors)");
                 return devices;
             }
             try
             {
                 int count = NativeMethods.nkm_input_count(obs);
-                DebugLogger.Log("midi", $"[MIDI] nkm_input_count: {count} port(s) found");
+                DebugLogger.Log(DebugCategory.Midi, $"[MIDI] nkm_input_count: {count} port(s) found");
                 var buf = new byte[512];
                 for (int i = 0; i < count; i++)
                 {
@@ -50,12 +62,12 @@ namespace NetKeyer.Midi.LibreMidi
                         int nul = Array.IndexOf(buf, (byte)0);
                         int len = nul >= 0 ? nul : buf.Length;
                         var name = Encoding.UTF8.GetString(buf, 0, len);
-                        DebugLogger.Log("midi", $"[MIDI] port {i}: \"{name}\"");
+                        DebugLogger.Log(DebugCategory.Midi, $"[MIDI] port {i}: \"{name}\"");
                         devices.Add(name);
                     }
                     else
                     {
-                        DebugLogger.Log("midi", $"[MIDI] nkm_input_name({i}): failed");
+                        DebugLogger.Log(DebugCategory.Midi, $"[MIDI] nkm_input_name({i}): failed");
                     }
                 }
             }
@@ -87,14 +99,30 @@ namespace NetKeyer.Midi.LibreMidi
                 throw new InvalidOperationException($"MIDI device '{deviceName}' not found");
             }
 
-            // Pin the delegate so the GC cannot move or collect it while native code holds a pointer.
-            _callback = OnNativeMessage;
-            _callbackHandle = GCHandle.Alloc(_callback);
+            // The callbacks are static; native code hands this handle back as ctx so they can
+            // find this instance, and it keeps the instance alive while the port is open.
+            // Prefer the timestamped callback; older shim builds don't export it.
+            _backendClock.Reset();
+            _selfHandle = GCHandle.Alloc(this);
+            IntPtr ctx = GCHandle.ToIntPtr(_selfHandle);
+            if (!_timestampShimMissing)
+            {
+                try
+                {
+                    _inputHandle = NativeMethods.nkm_open_input_ts(_observer, targetIndex, &OnNativeTimestampedMessage, ctx);
+                }
+                catch (EntryPointNotFoundException)
+                {
+                    _timestampShimMissing = true;
+                    DebugLogger.Log(DebugCategory.Midi, "[MIDI] Shim has no nkm_open_input_ts; using arrival timestamps (rebuild native/ for backend timestamps)");
+                }
+            }
 
-            _inputHandle = NativeMethods.nkm_open_input(_observer, targetIndex, _callback, IntPtr.Zero);
+            if (_timestampShimMissing)
+                _inputHandle = NativeMethods.nkm_open_input(_observer, targetIndex, &OnNativeMessage, ctx);
             if (_inputHandle == IntPtr.Zero)
             {
-                _callbackHandle.Free();
+                _selfHandle.Free();
                 NativeMethods.nkm_free_observer(_observer);
                 _observer = IntPtr.Zero;
                 throw new InvalidOperationException($"Failed to open MIDI device '{deviceName}'");
@@ -113,10 +141,8 @@ namespace NetKeyer.Midi.LibreMidi
                 _inputHandle = IntPtr.Zero;
             }
 
-            if (_callbackHandle.IsAllocated)
-                _callbackHandle.Free();
-
-            _callback = null;
+            if (_selfHandle.IsAllocated)
+                _selfHandle.Free();
 
             if (_observer != IntPtr.Zero)
             {
@@ -147,12 +173,38 @@ namespace NetKeyer.Midi.LibreMidi
             return -1;
         }
 
-        private void OnNativeMessage(IntPtr ctx, IntPtr data, int len)
+        private static LibreMidiInput FromContext(IntPtr ctx) => (LibreMidiInput)GCHandle.FromIntPtr(ctx).Target;
+
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static void OnNativeMessage(IntPtr ctx, IntPtr data, int len)
         {
             if (len <= 0 || data == IntPtr.Zero) return;
-            var bytes = new byte[len];
-            Marshal.Copy(data, bytes, 0, len);
-            MessageReceived?.Invoke(bytes);
+            long timestamp = Timebase.Now;
+            RealtimeProfile.EnterThread(RealtimeThreadRole.Input);
+            using var trace = KeyingTrace.Span("midi callback", len);
+            FromContext(ctx).MessageReceived?.Invoke(new ReadOnlySpan<byte>((void*)data, len), timestamp);
+        }
+
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static void OnNativeTimestampedMessage(IntPtr ctx, long timestampNs, IntPtr data, int len)
+        {
+            if (len <= 0 || data == IntPtr.Zero) return;
+            FromContext(ctx).DeliverTimestamped(timestampNs, data, len);
+        }
+
+        private void DeliverTimestamped(long timestampNs, IntPtr data, int len)
+        {
+            long arrival = Timebase.Now;
+            RealtimeProfile.EnterThread(RealtimeThreadRole.Input);
+
+            // Backends without timestamps report 0; anything else is mapped from the
+            // backend's clock, which removes scheduling delay between the driver and here
+            long timestamp = timestampNs > 0 ? _backendClock.Observe(timestampNs, arrival) : arrival;
+            if (timestampNs > 0)
+                KeyingMetrics.RecordMidiLatency(arrival - timestamp);
+            KeyingTrace.InstantAt("midi driver timestamp", timestamp);
+            using var trace = KeyingTrace.Span("midi callback", len);
+            MessageReceived?.Invoke(new ReadOnlySpan<byte>((void*)data, len), timestamp);
         }
     }
 }
@@ -0,0 +1,48 @@
+using System;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace NetKeyer.Midi.LibreMidi
+{
+    /// <summary>
+    /// Entry points of the netkeyer_midi_shim native library. Message callbacks are unmanaged
+    /// function pointers to <see cref="UnmanagedCallersOnlyAttribute"/> methods; the ctx
+    /// argument is handed back to them unchanged.
+    /// </summary>
+    internal static unsafe partial class NativeMethods
+    {
+        const string Lib = "netkeyer_midi_shim";
+
+        [LibraryImport(Lib)]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        internal static partial IntPtr nkm_create_observer();
+
+        [LibraryImport(Lib)]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        internal static partial void nkm_free_observer(IntPtr obs);
+
+        [LibraryImport(Lib)]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        internal static partial int nkm_input_count(IntPtr obs);
+
+        [LibraryImport(Lib)]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        internal static partial int nkm_input_name(IntPtr obs, int index,
+            [Out] byte[] buf, int bufLen);
+
+        [LibraryImport(Lib)]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        internal static partial IntPtr nkm_open_input(IntPtr obs, int index,
+            delegate* unmanaged[Cdecl]<IntPtr, IntPtr, int, void> callback, IntPtr ctx);
+
+        // Not present in shims built before timestamp support; callers fall back to nkm_open_input
+        [LibraryImport(Lib)]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        internal static partial IntPtr nkm_open_input_ts(IntPtr obs, int index,
+            delegate* unmanaged[Cdecl]<IntPtr, long, IntPtr, int, void> callback, IntPtr ctx);
+
+        [LibraryImport(Lib)]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        internal static partial void nkm_close_input(IntPtr handle);
+    }
+}
@@ -0,0 +1,179 @@
+using System;
+using System.Collections.Generic;
+using NetKeyer.Helpers;
+using NetKeyer.Midi.LibreMidi;
+using NetKeyer.Models;
+
+namespace NetKeyer.Midi
+{
+    public class MidiPaddleInput : IDisposable
+    {
+        private const byte NOTE_ON = 0x90;
+        private const byte NOTE_OFF = 0x80;
+
+        private LibreMidiInput _libreMidi;
+
+        // Current input state, packed with the PaddleState bit layout
+        private byte _stateBits;
+
+        private List<MidiNoteMapping> _noteMappings;
+
+        // Note number -> mapped functions, rebuilt whenever the mappings change so that
+        // the receive path is a single array index instead of a list search.
+        private volatile MidiNoteFunction[] _noteFunctions;
+
+        private static readonly bool _midiDebug = DebugCategory.Midi.IsEnabled;
+
+        public event Action<PaddleState> PaddleStateChanged;
+
+        public static List<string> GetAvailableDevices()
+        {
+            try
+            {
+                return LibreMidiInput.GetAvailableDevices();
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine($"Error enumerating MIDI devices: {ex.Message}");
+                return new List<string>();
+            }
+        }
+
+        public void SetNoteMappings(List<MidiNoteMapping> mappings)
+        {
+            _noteMappings = mappings ?? MidiNoteMapping.GetDefaultMappings();
+            _noteFunctions = BuildNoteFunctionTable(_noteMappings);
+        }
+
+        private static MidiNoteFunction[] BuildNoteFunctionTable(List<MidiNoteMapping> mappings)
+        {
+            var table = new MidiNoteFunction[128];
+
+            // Walk backwards so the first mapping for a note wins, matching the old lookup
+            for (int i = mappings.Count - 1; i >= 0; i--)
+            {
+                var mapping = mappings[i];
+                if (mapping != null && mapping.NoteNumber >= 0 && mapping.NoteNumber < table.Length)
+                {
+                    table[mapping.NoteNumber] = mapping.Functions;
+                }
+            }
+
+            return table;
+        }
+
+        public void Open(string deviceName)
+        {
+            Close();
+
+            // Ensure we have note mappings
+            if (_noteMappings == null)
+            {
+                SetNoteMappings(null);
+            }
+
+            try
+            {
+                _libreMidi = new LibreMidiInput();
+                _libreMidi.MessageReceived += OnMidiMessage;
+                _libreMidi.Open(deviceName);
+
+                Console.WriteLine($"Opened MIDI device: {deviceName}");
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine($"Failed to open MIDI device: {ex.Message}");
+                _libreMidi?.Dispose();
+                _libreMidi = null;
+                throw;
+            }
+        }
+
+        public void Close()
+        {
+            if (_libreMidi != null)
+            {
+                try
+                {
+                    _libreMidi.MessageReceived -= OnMidiMessage;
+                    _libreMidi.Close();
+                }
+                catch (Exception ex)
+                {
+                    Console.WriteLine($"Error closing MIDI device: {ex.Message}");
+                }
+                finally
+                {
+                    _libreMidi.Dispose();
+                    _libreMidi = null;
+                }
+            }
+
+            // Reset all states
+            _stateBits = 0;
+        }
+
+        // libremidi delivers one complete MIDI message per callback, with SysEx,
+        // timing, and active-sensing already filtered by the shim.  No manual
+        // running-status or multi-packet parsing is needed here.  Internal for
+        // tools/KeyingBenchmarks, which checks that decoding never allocates.
+        internal void OnMidiMessage(ReadOnlySpan<byte> data, long timestamp)
+        {
+            if (data.Length < 3) return;
+            byte messageType = (byte)(data[0] & 0xF0);
+            byte note = data[1];
+            if (messageType == NOTE_ON)
+                HandleNoteEvent(note, true, timestamp);  // HaliKey quirk: velocity 0 still treated as ON
+            else if (messageType == NOTE_OFF)
+                HandleNoteEvent(note, false, timestamp);
+        }
+
+        // Internal for tools/KeyingBenchmarks, which feeds it notes without a device
+        internal void HandleNoteEvent(int noteNumber, bool isOn, long timestamp)
+        {
+            if (_midiDebug) DebugLogger.Log(DebugCategory.Midi, $"[MIDI] Note {noteNumber} {(isOn ? "ON" : "OFF")}");
+            KeyingTrace.Instant(isOn ? "midi note on" : "midi note off", noteNumber);
+
+            var noteFunctions = _noteFunctions;
+            var functions = noteFunctions != null && noteNumber < noteFunctions.Length ? noteFunctions[noteNumber] : MidiNoteFunction.None;
+            if (functions == MidiNoteFunction.None)
+            {
+                if (_midiDebug) DebugLogger.Log(DebugCategory.Midi, $"[MIDI] Ignoring unmapped note {noteNumber}");
+                return;
+            }
+
+            byte mask = (byte)functions;
+
+            // Handle note OFF when we didn't see note ON: treat it as a brief press/release
+            // so a fast tap is not lost.  Only the paddles need this; the keyer has to see
+            // the press to latch an element.
+            if (!isOn)
+            {
+                byte missedPress = (byte)(mask & ~_stateBits & (PaddleState.LeftPaddleBit | PaddleState.RightPaddleBit));
+                if (missedPress != 0)
+                {
+                    if (_midiDebug) DebugLogger.Log(DebugCategory.Midi, $"[MIDI] Paddle OFF without ON (bits 0x{missedPress:X}) - treating as brief press/release");
+                    _stateBits |= missedPress;
+                    PaddleStateChanged?.Invoke(new PaddleState(_stateBits, timestamp));
+                }
+            }
+
+            // Update states based on mapped functions
+            byte newBits = isOn ? (byte)(_stateBits | mask) : (byte)(_stateBits & ~mask);
+
+            // Fire event if any state changed
+            if (newBits != _stateBits)
+            {
+                _stateBits = newBits;
+                var state = new PaddleState(newBits, timestamp);
+                if (_midiDebug) DebugLogger.Log(DebugCategory.Midi, $"[MIDI] Firing event: {state}");
+                PaddleStateChanged?.Invoke(state);
+            }
+        }
+
+        public void Dispose()
+        {
+            Close();
+        }
+    }
+}
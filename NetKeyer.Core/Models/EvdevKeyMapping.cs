@@ -0,0 +1,47 @@
+using System;
+using System.Collections.Generic;
+
+namespace NetKeyer.Models
+{
+    /// <summary>
+    /// Maps a Linux input event key code (KEY_* from linux/input-event-codes.h) to
+    /// keyer functions.  Uses the same function flags as the MIDI note mappings.
+    /// </summary>
+    public class EvdevKeyMapping
+    {
+        // Key codes used by the common HID keyboard keyer adapters
+        public const int KEY_LEFTCTRL = 29;
+        public const int KEY_RIGHTCTRL = 97;
+
+        public int KeyCode { get; set; }
+        public MidiNoteFunction Functions { get; set; }
+
+        public EvdevKeyMapping()
+        {
+        }
+
+        public EvdevKeyMapping(int keyCode, MidiNoteFunction functions)
+        {
+            KeyCode = keyCode;
+            Functions = functions;
+        }
+
+        public bool HasFunction(MidiNoteFunction function)
+        {
+            return (Functions & function) != 0;
+        }
+
+        /// <summary>
+        /// Defaults for Vail-style USB adapters in keyboard mode, which send
+        /// Left Ctrl for dit and Right Ctrl for dah.
+        /// </summary>
+        public static List<EvdevKeyMapping> GetDefaultMappings()
+        {
+            return new List<EvdevKeyMapping>
+            {
+                new EvdevKeyMapping(KEY_LEFTCTRL, MidiNoteFunction.LeftPaddle | MidiNoteFunction.StraightKey | MidiNoteFunction.PTT),
+                new EvdevKeyMapping(KEY_RIGHTCTRL, MidiNoteFunction.RightPaddle | MidiNoteFunction.StraightKey | MidiNoteFunction.PTT)
+            };
+        }
+    }
+}
@@ -0,0 +1,13 @@
+namespace NetKeyer.Models
+{
+    /// <summary>
+    /// Kind of paddle input device; also the value saved as <c>InputType</c> in settings.json.
+    /// </summary>
+    public enum InputDeviceType
+    {
+        Serial,
+        MIDI,
+        Evdev,
+        Network
+    }
+}
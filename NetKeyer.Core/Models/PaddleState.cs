@@ -0,0 +1,73 @@
+using System;
+
+namespace NetKeyer.Models
+{
+    /// <summary>
+    /// Snapshot of all keying inputs at one instant, passed by value from the input
+    /// devices to the keying controller so that delivering an edge never allocates.
+    /// The four inputs are packed into a single byte using the same bit layout as
+    /// <see cref="MidiNoteFunction"/>, so a note's function mask can be applied directly.
+    /// Formats into a span, so debug logging a state doesn't allocate.
+    /// </summary>
+    public readonly struct PaddleState : IEquatable<PaddleState>, ISpanFormattable
+    {
+        public const byte LeftPaddleBit = (byte)MidiNoteFunction.LeftPaddle;
+        public const byte RightPaddleBit = (byte)MidiNoteFunction.RightPaddle;
+        public const byte StraightKeyBit = (byte)MidiNoteFunction.StraightKey;
+        public const byte PttBit = (byte)MidiNoteFunction.PTT;
+
+        /// <summary>
+        /// Packed input bits (see the *Bit constants).
+        /// </summary>
+        public readonly byte Bits;
+
+        /// <summary>
+        /// <see cref="NetKeyer.Helpers.Timebase"/> timestamp captured when the
+        /// edge that produced this state was received from the device.
+        /// </summary>
+        public readonly long Timestamp;
+
+        public PaddleState(byte bits, long timestamp)
+        {
+            Bits = bits;
+            Timestamp = timestamp;
+        }
+
+        public PaddleState(bool leftPaddle, bool rightPaddle, bool straightKey, bool ptt, long timestamp)
+        {
+            Bits = (byte)((leftPaddle ? LeftPaddleBit : 0)
+                        | (rightPaddle ? RightPaddleBit : 0)
+                        | (straightKey ? StraightKeyBit : 0)
+                        | (ptt ? PttBit : 0));
+            Timestamp = timestamp;
+        }
+
+        public bool LeftPaddle => (Bits & LeftPaddleBit) != 0;
+        public bool RightPaddle => (Bits & RightPaddleBit) != 0;
+        public bool StraightKey => (Bits & StraightKeyBit) != 0;
+        public bool PTT => (Bits & PttBit) != 0;
+
+        /// <summary>
+        /// Returns a copy with the left and right paddle bits exchanged.
+        /// Straight key and PTT are not affected.
+        /// </summary>
+        public PaddleState WithSwappedPaddles()
+        {
+            int swapped = (Bits & ~(LeftPaddleBit | RightPaddleBit))
+                        | (LeftPaddle ? RightPaddleBit : 0)
+                        | (RightPaddle ? LeftPaddleBit : 0);
+            return new PaddleState((byte)swapped, Timestamp);
+        }
+
+        public bool Equals(PaddleState other) => Bits == other.Bits && Timestamp == other.Timestamp;
+        public override bool Equals(object obj) => obj is PaddleState other && Equals(other);
+        public override int GetHashCode() => HashCode.Combine(Bits, Timestamp);
+
+        public override string ToString() => $"L={LeftPaddle} R={RightPaddle} SK={StraightKey} PTT={PTT}";
+
+        public string ToString(string format, IFormatProvider formatProvider) => ToString();
+
+        public bool TryFormat(Span<char> destination, out int charsWritten, ReadOnlySpan<char> format, IFormatProvider provider) =>
+            destination.TryWrite($"L={LeftPaddle} R={RightPaddle} SK={StraightKey} PTT={PTT}", out charsWritten);
+    }
+}
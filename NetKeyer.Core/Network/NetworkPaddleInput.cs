@@ -0,0 +1,571 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+using NetKeyer.Helpers;
+using NetKeyer.Models;
+using NetKeyer.Realtime;
+
+namespace NetKeyer.Network
+{
+    /// <summary>
+    /// Snapshot of the network input's link statistics.
+    /// </summary>
+    public readonly struct NetworkInputStats
+    {
+        public long PacketsReceived { get; init; }
+        public long EdgesReceived { get; init; }
+        public long EdgesLost { get; init; }
+        public long EdgesRecovered { get; init; }
+        public long Reordered { get; init; }
+        public long Late { get; init; }
+        public long Timeouts { get; init; }
+        public long Rejected { get; init; }
+        public double JitterMs { get; init; }
+        public double PlayoutDelayMs { get; init; }
+        public string Sender { get; init; }
+
+        public double LossPercent => EdgesReceived + EdgesLost == 0 ? 0 : 100.0 * EdgesLost / (EdgesReceived + EdgesLost);
+
+        public override string ToString() =>
+            $"{Sender ?? "no sender"}: delay {PlayoutDelayMs:F0} ms, jitter {JitterMs:F1} ms, " +
+            $"loss {LossPercent:F1}% ({EdgesLost} lost, {EdgesRecovered} recovered), {Reordered} reordered, {Late} late" +
+            (Rejected > 0 ? $", {Rejected} from senders not allowed" : "");
+    }
+
+    /// <summary>
+    /// Receives <see cref="PaddlePacket"/> datagrams from a remote sender and replays the edges
+    /// on the local clock through an adaptive jitter buffer, so the remote operator's element
+    /// timing is preserved rather than the network's.
+    ///
+    /// The sender's clock is mapped onto ours using the minimum observed transit time; each
+    /// edge is then played out at its sender time plus that offset plus a playout delay sized
+    /// from the measured jitter.  The delay only changes while the keys are up so it never
+    /// stretches or shrinks an element, except that a late packet grows it immediately.
+    ///
+    /// The socket binds to loopback unless another local address is given, and datagrams from
+    /// senders outside the allowed list are dropped before they reach the jitter buffer.
+    /// </summary>
+    public class NetworkPaddleInput : IDisposable
+    {
+        public const int DEFAULT_PORT = 7373;
+
+        private const long MIN_PLAYOUT_DELAY_US = 5_000;
+        private const long MAX_PLAYOUT_DELAY_US = 250_000;
+        private const long DELAY_MARGIN_US = 2_000;
+        private const long OFFSET_WINDOW_US = 10_000_000;    // min-transit window (clock drift tracking)
+        private const long LINK_TIMEOUT_US = 600_000;        // force key-up after this long without packets
+        private const int MAX_PENDING_EDGES = 64;
+        private const int IDLE_WAIT_MS = 50;
+
+        private struct Edge
+        {
+            public uint Sequence;
+            public byte Bits;
+            public long PlayoutTicks;
+        }
+
+        private Socket _socket;
+        private Thread _receiveThread;
+        private Thread _playoutThread;
+        private volatile bool _running;
+        private readonly AutoResetEvent _wake = new(false);
+        private readonly object _lock = new();
+
+        // Jitter buffer, sorted by sequence
+        private readonly Edge[] _pending = new Edge[MAX_PENDING_EDGES];
+        private int _pendingCount;
+        private bool _haveSequence;
+        private uint _highestSequence;
+        private uint _deliveredSequence;
+        private byte _deliveredBits;
+        private long _lastPacketTicks;
+
+        // IPv4 addresses, in network byte order, that may send; empty allows any sender
+        private uint[] _allowedSenders = Array.Empty<uint>();
+
+        // Sender lock: the first sender owns the input until its link times out
+        private SocketAddress _senderAddress;
+        private string _senderName;
+
+        // Clock mapping and delay estimation (all microseconds)
+        private bool _haveTransit;
+        private long _windowStartUs;
+        private long _windowMinTransitUs;
+        private long _previousWindowMinTransitUs;
+        private long _windowMaxExcessUs;
+        private long _previousWindowMaxExcessUs;
+        private long _lastTransitUs;
+        private double _jitterUs;
+        private long _offsetUs;
+        private long _playoutDelayUs = MIN_PLAYOUT_DELAY_US;
+
+        // Statistics
+        private long _packetsReceived;
+        private long _edgesReceived;
+        private long _edgesLost;
+        private long _edgesRecovered;
+        private long _reordered;
+        private long _late;
+        private long _timeouts;
+        private long _rejected;
+
+        private static readonly bool _networkDebug = DebugCategory.Network.IsEnabled;
+
+        public event Action<PaddleState> PaddleStateChanged;
+
+        public int Port { get; private set; }
+
+        public IPAddress BindAddress { get; private set; }
+
+        /// <summary>
+        /// Binds the UDP port on <paramref name="bindAddress"/> (loopback when null) and starts
+        /// receiving, accepting datagrams only from <paramref name="allowedSenders"/> unless that
+        /// is null or empty.  Both are IPv4.  Throws <see cref="InvalidOperationException"/> on failure.
+        /// </summary>
+        public void Open(int port, IPAddress bindAddress = null, IReadOnlyCollection<IPAddress> allowedSenders = null)
+        {
+            Close();
+
+            bindAddress ??= IPAddress.Loopback;
+            if (bindAddress.AddressFamily != AddressFamily.InterNetwork)
+                throw new InvalidOperationException($"Network input bind address {bindAddress} is not an IPv4 address");
+
+            allowedSenders ??= Array.Empty<IPAddress>();
+            var allowed = new uint[allowedSenders.Count];
+            int count = 0;
+            foreach (var sender in allowedSenders)
+            {
+                if (sender.AddressFamily != AddressFamily.InterNetwork)
+                    throw new InvalidOperationException($"Network input allowed sender {sender} is not an IPv4 address");
+                allowed[count++] = BinaryPrimitives.ReadUInt32LittleEndian(sender.GetAddressBytes());
+            }
+
+            try
+            {
+                _socket = new Socket(AddressFamily.InterNetwork, SocketType.Dgram, ProtocolType.Udp);
+                _socket.Bind(new IPEndPoint(bindAddress, port));
+            }
+            catch (Exception ex)
+            {
+                _socket?.Dispose();
+                _socket = null;
+                throw new InvalidOperationException($"Cannot listen on UDP {bindAddress}:{port}: {ex.Message}", ex);
+            }
+
+            Port = port;
+            BindAddress = bindAddress;
+            _allowedSenders = allowed;
+            ResetState();
+            _running = true;
+
+            _receiveThread = new Thread(ReceiveLoop) { Name = "network input rx", IsBackground = true, Priority = ThreadPriority.AboveNormal };
+            _playoutThread = new Thread(PlayoutLoop) { Name = "network input playout", IsBackground = true, Priority = ThreadPriority.Highest };
+            _receiveThread.Start();
+            _playoutThread.Start();
+
+            Console.WriteLine(allowed.Length == 0
+                ? $"Listening for network paddle input on UDP {bindAddress}:{port}"
+                : $"Listening for network paddle input on UDP {bindAddress}:{port} from {string.Join(", ", allowedSenders)}");
+        }
+
+        public void Close()
+        {
+            if (!_running && _socket == null)
+                return;
+
+            _running = false;
+
+            // Disposing the socket unblocks ReceiveFrom
+            _socket?.Dispose();
+            _socket = null;
+            _wake.Set();
+
+            _receiveThread?.Join();
+            _playoutThread?.Join();
+            _receiveThread = null;
+            _playoutThread = null;
+
+            if (_packetsReceived > 0)
+                Console.WriteLine($"Network input closed. {GetStats()}");
+        }
+
+        public NetworkInputStats GetStats()
+        {
+            lock (_lock)
+            {
+                return new NetworkInputStats
+                {
+                    PacketsReceived = _packetsReceived,
+                    EdgesReceived = _edgesReceived,
+                    EdgesLost = _edgesLost,
+                    EdgesRecovered = _edgesRecovered,
+                    Reordered = _reordered,
+                    Late = _late,
+                    Timeouts = _timeouts,
+                    Rejected = _rejected,
+                    JitterMs = _jitterUs / 1000.0,
+                    PlayoutDelayMs = _playoutDelayUs / 1000.0,
+                    Sender = _senderName
+                };
+            }
+        }
+
+        public void Dispose()
+        {
+            Close();
+            _wake.Dispose();
+        }
+
+        // ---- receive side ----
+
+        private void ReceiveLoop()
+        {
+            var buffer = new byte[PaddlePacket.Size * 2];
+            var address = new SocketAddress(AddressFamily.InterNetwork);
+            var socket = _socket;
+
+            while (_running)
+            {
+                RealtimeProfile.EnterThread(RealtimeThreadRole.Input);
+                int received;
+                try
+                {
+                    received = socket.ReceiveFrom(buffer, SocketFlags.None, address);
+                }
+                catch (ObjectDisposedException)
+                {
+                    break;
+                }
+                catch (SocketException ex)
+                {
+                    if (!_running)
+                        break;
+                    if (_networkDebug) DebugLogger.Log(DebugCategory.Network, $"[Network] Receive error: {ex.SocketErrorCode}");
+                    continue;
+                }
+
+                long arrivalTicks = Timebase.Now;
+                if (!IsAllowedSender(address))
+                {
+                    RejectSender(address);
+                    continue;
+                }
+
+                if (PaddlePacket.TryRead(buffer.AsSpan(0, received), out var packet))
+                {
+                    HandlePacket(in packet, address, arrivalTicks);
+                }
+            }
+        }
+
+        private void HandlePacket(in PaddlePacket packet, SocketAddress address, long arrivalTicks)
+        {
+            lock (_lock)
+            {
+                if (!AcceptSender(address, arrivalTicks))
+                    return;
+
+                _packetsReceived++;
+                _lastPacketTicks = arrivalTicks;
+
+                long arrivalUs = Timebase.ToMicroseconds(arrivalTicks);
+                UpdateClockEstimate(arrivalUs - packet.SendTimeUs, arrivalUs);
+
+                // The datagram carries its edge and the one before it; queuing the previous
+                // edge first recovers a single lost datagram without waiting for a heartbeat
+                if (packet.Sequence > 1)
+                    QueueEdge(packet.Sequence - 1, packet.PreviousBits, packet.PreviousTimeUs, arrivalUs, isPrimary: false);
+                if (packet.Sequence > 0)
+                    QueueEdge(packet.Sequence, packet.Bits, packet.TimeUs, arrivalUs, isPrimary: !packet.IsHeartbeat);
+            }
+
+            _wake.Set();
+        }
+
+        private bool IsAllowedSender(SocketAddress address)
+        {
+            var allowed = _allowedSenders;
+            if (allowed.Length == 0)
+                return true;
+
+            // IPv4 socket addresses carry the address in bytes 4-7, in network byte order
+            uint sender = BinaryPrimitives.ReadUInt32LittleEndian(address.Buffer.Span.Slice(4, 4));
+            return Array.IndexOf(allowed, sender) >= 0;
+        }
+
+        private void RejectSender(SocketAddress address)
+        {
+            long rejected;
+            lock (_lock)
+            {
+                rejected = ++_rejected;
+            }
+
+            // Name the first one; a flood of them is counted in the stats, not printed
+            if (rejected == 1)
+                Console.WriteLine($"Network input: ignoring datagrams from {new IPEndPoint(IPAddress.Any, 0).Create(address)}, not an allowed sender");
+            else if (_networkDebug)
+                DebugLogger.Log(DebugCategory.Network, $"[Network] Rejected datagram {rejected} from a sender not allowed");
+        }
+
+        private bool AcceptSender(SocketAddress address, long arrivalTicks)
+        {
+            if (_senderAddress != null && _senderAddress.Equals(address))
+                return true;
+
+            bool linkAlive = _senderAddress != null
+                && Timebase.ToMicroseconds(arrivalTicks - _lastPacketTicks) < LINK_TIMEOUT_US;
+            if (linkAlive)
+                return false;
+
+            // New (or replacement) sender: start from a clean slate
+            _senderAddress = new SocketAddress(address.Family, address.Size);
+            address.Buffer.CopyTo(_senderAddress.Buffer);
+            _senderName = ((IPEndPoint)new IPEndPoint(IPAddress.Any, 0).Create(address)).ToString();
+            Console.WriteLine($"Network input: accepted sender {_senderName}");
+
+            _haveSequence = false;
+            _haveTransit = false;
+            _pendingCount = 0;
+            return true;
+        }
+
+        private void UpdateClockEstimate(long transitUs, long nowUs)
+        {
+            if (!_haveTransit)
+            {
+                _haveTransit = true;
+                _windowStartUs = nowUs;
+                _windowMinTransitUs = _previousWindowMinTransitUs = transitUs;
+                _windowMaxExcessUs = _previousWindowMaxExcessUs = 0;
+                _lastTransitUs = transitUs;
+                _jitterUs = 0;
+                _offsetUs = transitUs;
+                return;
+            }
+
+            // RFC 3550 interarrival jitter
+            long d = Math.Abs(transitUs - _lastTransitUs);
+            _jitterUs += (d - _jitterUs) / 16.0;
+            _lastTransitUs = transitUs;
+
+            // Two overlapping windows so the minimum can rise again if the clocks drift apart
+            if (nowUs - _windowStartUs > OFFSET_WINDOW_US)
+            {
+                _previousWindowMinTransitUs = _windowMinTransitUs;
+                _previousWindowMaxExcessUs = _windowMaxExcessUs;
+                _windowMinTransitUs = transitUs;
+                _windowMaxExcessUs = 0;
+                _windowStartUs = nowUs;
+            }
+
+            _windowMinTransitUs = Math.Min(_windowMinTransitUs, transitUs);
+            long baseTransitUs = Math.Min(_windowMinTransitUs, _previousWindowMinTransitUs);
+            _windowMaxExcessUs = Math.Max(_windowMaxExcessUs, transitUs - baseTransitUs);
+
+            // Adopt the new mapping only between elements so running elements keep their length
+            if (_pendingCount == 0 && _deliveredBits == 0)
+            {
+                _offsetUs = baseTransitUs;
+                _playoutDelayUs = TargetDelayUs();
+            }
+        }
+
+        private long TargetDelayUs()
+        {
+            long peakExcessUs = Math.Max(_windowMaxExcessUs, _previousWindowMaxExcessUs);
+            long targetUs = Math.Max(peakExcessUs, (long)(4 * _jitterUs)) + DELAY_MARGIN_US;
+            return Math.Clamp(targetUs, MIN_PLAYOUT_DELAY_US, MAX_PLAYOUT_DELAY_US);
+        }
+
+        private void QueueEdge(uint sequence, byte bits, long senderTimeUs, long arrivalUs, bool isPrimary)
+        {
+            if (!_haveSequence)
+            {
+                // First contact: sync to the current edge, nothing before it is meaningful
+                if (!isPrimary && sequence != 0)
+                    return;
+                _haveSequence = true;
+                _highestSequence = _deliveredSequence = sequence - 1;
+            }
+
+            if (sequence <= _deliveredSequence)
+            {
+                // Already played, or arrived after a later edge was played
+                if (isPrimary)
+                    _late++;
+                return;
+            }
+
+            int index = FindPending(sequence);
+            if (index >= 0)
+                return; // already queued
+
+            if (sequence > _highestSequence)
+            {
+                uint gap = sequence - _highestSequence - 1;
+                _edgesLost += gap;
+                _highestSequence = sequence;
+
+                // Its own datagram was lost; we got it from a later one
+                if (!isPrimary)
+                    _edgesRecovered++;
+            }
+            else
+            {
+                // Filled a hole we had counted as lost
+                _edgesLost--;
+                if (isPrimary)
+                    _reordered++;
+                else
+                    _edgesRecovered++;
+            }
+
+            _edgesReceived++;
+
+            long playoutUs = senderTimeUs + _offsetUs + _playoutDelayUs;
+            if (playoutUs < arrivalUs)
+            {
+                _late++;
+
+                // Arrived after its playout time: grow the delay now rather than keep clipping
+                long neededUs = Math.Min(MAX_PLAYOUT_DELAY_US, _playoutDelayUs + (arrivalUs - playoutUs) + DELAY_MARGIN_US);
+                if (_networkDebug) DebugLogger.Log(DebugCategory.Network, $"[Network] Edge {sequence} late by {(arrivalUs - playoutUs) / 1000.0:F1} ms, delay -> {neededUs / 1000.0:F1} ms");
+                _playoutDelayUs = neededUs;
+                playoutUs = arrivalUs;
+            }
+
+            if (_pendingCount == _pending.Length)
+            {
+                // Should never happen with sane delays; drop the oldest to stay bounded
+                Array.Copy(_pending, 1, _pending, 0, _pendingCount - 1);
+                _pendingCount--;
+            }
+
+            // Insert keeping sequence order
+            int insertAt = _pendingCount;
+            while (insertAt > 0 && _pending[insertAt - 1].Sequence > sequence)
+                insertAt--;
+            Array.Copy(_pending, insertAt, _pending, insertAt + 1, _pendingCount - insertAt);
+            _pending[insertAt] = new Edge
+            {
+                Sequence = sequence,
+                Bits = bits,
+                PlayoutTicks = Timebase.FromMicroseconds(playoutUs)
+            };
+            _pendingCount++;
+        }
+
+        private int FindPending(uint sequence)
+        {
+            for (int i = 0; i < _pendingCount; i++)
+            {
+                if (_pending[i].Sequence == sequence)
+                    return i;
+            }
+            return -1;
+        }
+
+        // ---- playout side ----
+
+        private void PlayoutLoop()
+        {
+            var due = new Edge[MAX_PENDING_EDGES];
+
+            while (_running)
+            {
+                RealtimeProfile.EnterThread(RealtimeThreadRole.Input);
+                int dueCount = 0;
+                bool timedOut = false;
+                long waitTicks;
+
+                lock (_lock)
+                {
+                    long now = Timebase.Now;
+
+                    // Edges play strictly in sequence order; a later edge that is already due
+                    // also releases anything queued before it
+                    while (_pendingCount > 0 && _pending[0].PlayoutTicks <= now)
+                    {
+                        due[dueCount++] = _pending[0];
+                        _deliveredSequence = _pending[0].Sequence;
+                        _deliveredBits = _pending[0].Bits;
+                        Array.Copy(_pending, 1, _pending, 0, _pendingCount - 1);
+                        _pendingCount--;
+                    }
+
+                    if (_deliveredBits != 0 && _lastPacketTicks != 0
+                        && Timebase.ToMicroseconds(now - _lastPacketTicks) > LINK_TIMEOUT_US)
+                    {
+                        // Link is dead with a key down: release rather than transmit forever
+                        timedOut = true;
+                        _timeouts++;
+                        _deliveredBits = 0;
+                        _pendingCount = 0;
+                    }
+
+                    waitTicks = _pendingCount > 0
+                        ? _pending[0].PlayoutTicks - now
+                        : Timebase.FromMicroseconds(IDLE_WAIT_MS * 1000L);
+                }
+
+                for (int i = 0; i < dueCount; i++)
+                {
+                    PaddleStateChanged?.Invoke(new PaddleState(due[i].Bits, Timebase.Now));
+                }
+
+                if (timedOut)
+                {
+                    Console.WriteLine("Network input: link timed out with key down, releasing");
+                    PaddleStateChanged?.Invoke(new PaddleState(0, Timebase.Now));
+                }
+
+                WaitUntil(waitTicks);
+            }
+        }
+
+        private void WaitUntil(long waitTicks)
+        {
+            if (waitTicks <= 0)
+                return;
+
+            // Sleep for the bulk of the wait, then spin the last couple of milliseconds:
+            // OS timer granularity would otherwise add up to a tick of error per edge
+            long deadline = Timebase.Now + waitTicks;
+            long spinTicks = Timebase.FromMicroseconds(2_000);
+            if (waitTicks > spinTicks)
+            {
+                int sleepMs = (int)(Timebase.ToMicroseconds(waitTicks - spinTicks) / 1000);
+                if (sleepMs > 0 && _wake.WaitOne(sleepMs))
+                    return; // new packet: re-evaluate the queue
+            }
+
+            while (_running && Timebase.Now < deadline)
+            {
+                Thread.SpinWait(50);
+            }
+        }
+
+        private void ResetState()
+        {
+            lock (_lock)
+            {
+                _pendingCount = 0;
+                _haveSequence = false;
+                _highestSequence = _deliveredSequence = 0;
+                _deliveredBits = 0;
+                _lastPacketTicks = 0;
+                _senderAddress = null;
+                _senderName = null;
+                _haveTransit = false;
+                _playoutDelayUs = MIN_PLAYOUT_DELAY_US;
+                _packetsReceived = _edgesReceived = _edgesLost = _edgesRecovered = 0;
+                _reordered = _late = _timeouts = _rejected = 0;
+                _jitterUs = 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+using System;
+using System.Buffers.Binary;
+
+namespace NetKeyer.Network
+{
+    /// <summary>
+    /// Wire format for remote paddle datagrams (little-endian, 40 bytes):
+    ///
+    ///   0  u32  magic "NKPD"
+    ///   4  u8   version (1)
+    ///   5  u8   flags (bit 0 = heartbeat)
+    ///   6  u8   paddle bits of this edge (PaddleState layout)
+    ///   7  u8   paddle bits of the previous edge
+    ///   8  u32  edge sequence number (increments per edge, not per datagram)
+    ///  12  u32  reserved
+    ///  16  i64  sender monotonic time of this edge, microseconds
+    ///  24  i64  sender monotonic time of the previous edge, microseconds
+    ///  32  i64  sender monotonic time this datagram was sent, microseconds
+    ///
+    /// Each datagram repeats the previous edge so a single lost packet doesn't lose an edge,
+    /// and heartbeats repeat the latest edge so the receiver can converge after losses.
+    /// </summary>
+    public readonly struct PaddlePacket
+    {
+        public const int Size = 40;
+        public const uint Magic = 0x44504B4E; // "NKPD"
+        public const byte Version = 1;
+        public const byte FlagHeartbeat = 0x01;
+
+        public readonly byte Flags;
+        public readonly byte Bits;
+        public readonly byte PreviousBits;
+        public readonly uint Sequence;
+        public readonly long TimeUs;
+        public readonly long PreviousTimeUs;
+        public readonly long SendTimeUs;
+
+        public PaddlePacket(byte flags, byte bits, byte previousBits, uint sequence, long timeUs, long previousTimeUs, long sendTimeUs)
+        {
+            Flags = flags;
+            Bits = bits;
+            PreviousBits = previousBits;
+            Sequence = sequence;
+            TimeUs = timeUs;
+            PreviousTimeUs = previousTimeUs;
+            SendTimeUs = sendTimeUs;
+        }
+
+        public bool IsHeartbeat => (Flags & FlagHeartbeat) != 0;
+
+        public void Write(Span<byte> buffer)
+        {
+            BinaryPrimitives.WriteUInt32LittleEndian(buffer, Magic);
+            buffer[4] = Version;
+            buffer[5] = Flags;
+            buffer[6] = Bits;
+            buffer[7] = PreviousBits;
+            BinaryPrimitives.WriteUInt32LittleEndian(buffer[8..], Sequence);
+            BinaryPrimitives.WriteUInt32LittleEndian(buffer[12..], 0);
+            BinaryPrimitives.WriteInt64LittleEndian(buffer[16..], TimeUs);
+            BinaryPrimitives.WriteInt64LittleEndian(buffer[24..], PreviousTimeUs);
+            BinaryPrimitives.WriteInt64LittleEndian(buffer[32..], SendTimeUs);
+        }
+
+        public static bool TryRead(ReadOnlySpan<byte> buffer, out PaddlePacket packet)
+        {
+            packet = default;
+            if (buffer.Length < Size
+                || BinaryPrimitives.ReadUInt32LittleEndian(buffer) != Magic
+                || buffer[4] != Version)
+            {
+                return false;
+            }
+
+            packet = new PaddlePacket(
+                buffer[5],
+                buffer[6],
+                buffer[7],
+                BinaryPrimitives.ReadUInt32LittleEndian(buffer[8..]),
+                BinaryPrimitives.ReadInt64LittleEndian(buffer[16..]),
+                BinaryPrimitives.ReadInt64LittleEndian(buffer[24..]),
+                BinaryPrimitives.ReadInt64LittleEndian(buffer[32..]));
+            return true;
+        }
+    }
+}
@@ -0,0 +1,127 @@
+using System;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+using NetKeyer.Helpers;
+using NetKeyer.Models;
+
+namespace NetKeyer.Network
+{
+    /// <summary>
+    /// Forwards local paddle edges to a remote NetKeyer's network input as
+    /// <see cref="PaddlePacket"/> datagrams, with periodic heartbeats so the
+    /// receiver can recover from loss and detect a dead link.
+    /// </summary>
+    public class UdpPaddleSender : IDisposable
+    {
+        public const int HEARTBEAT_INTERVAL_MS = 100;
+
+        private readonly Socket _socket;
+        private readonly Timer _heartbeatTimer;
+        private readonly byte[] _buffer = new byte[PaddlePacket.Size];
+        private readonly object _lock = new();
+
+        private uint _sequence;
+        private byte _bits;
+        private byte _previousBits;
+        private long _timeUs;
+        private long _previousTimeUs;
+        private bool _disposed;
+
+        public string Target { get; }
+
+        /// <summary>
+        /// Creates a sender for "host:port".  Throws <see cref="InvalidOperationException"/>
+        /// if the target can't be parsed or resolved.
+        /// </summary>
+        public UdpPaddleSender(string target)
+        {
+            int colon = target?.LastIndexOf(':') ?? -1;
+            if (colon <= 0 || !int.TryParse(target.AsSpan(colon + 1), out int port) || port <= 0 || port > 65535)
+                throw new InvalidOperationException($"Invalid network forward target '{target}' (expected host:port)");
+
+            IPAddress address;
+            try
+            {
+                var host = target[..colon].Trim('[', ']');
+                if (!IPAddress.TryParse(host, out address))
+                    address = Dns.GetHostAddresses(host)[0];
+            }
+            catch (Exception ex)
+            {
+                throw new InvalidOperationException($"Cannot resolve network forward target '{target}': {ex.Message}", ex);
+            }
+
+            Target = target;
+            _socket = new Socket(address.AddressFamily, SocketType.Dgram, ProtocolType.Udp);
+            _socket.Connect(new IPEndPoint(address, port));
+
+            _timeUs = Timebase.ToMicroseconds(Timebase.Now);
+            _previousTimeUs = _timeUs;
+            _heartbeatTimer = new Timer(_ => SendHeartbeat(), null, HEARTBEAT_INTERVAL_MS, HEARTBEAT_INTERVAL_MS);
+        }
+
+        /// <summary>
+        /// Sends one edge.  States that don't change the paddle bits are not sent.
+        /// </summary>
+        public void Send(PaddleState state)
+        {
+            lock (_lock)
+            {
+                if (_disposed || state.Bits == _bits)
+                    return;
+
+                _previousBits = _bits;
+                _previousTimeUs = _timeUs;
+                _bits = state.Bits;
+                _timeUs = Timebase.ToMicroseconds(state.Timestamp);
+                _sequence++;
+
+                SendLocked(0);
+            }
+        }
+
+        private void SendHeartbeat()
+        {
+            lock (_lock)
+            {
+                if (!_disposed)
+                    SendLocked(PaddlePacket.FlagHeartbeat);
+            }
+        }
+
+        private void SendLocked(byte flags)
+        {
+            var packet = new PaddlePacket(flags, _bits, _previousBits, _sequence, _timeUs, _previousTimeUs,
+                Timebase.ToMicroseconds(Timebase.Now));
+            packet.Write(_buffer);
+
+            try
+            {
+                _socket.Send(_buffer, SocketFlags.None);
+            }
+            catch (SocketException)
+            {
+                // Receiver not up yet (ICMP port unreachable) - heartbeats keep retrying
+            }
+        }
+
+        public void Dispose()
+        {
+            lock (_lock)
+            {
+                if (_disposed)
+                    return;
+
+                // Don't leave the remote end keyed
+                if (_bits != 0)
+                    Send(new PaddleState(0, Timebase.Now));
+
+                _disposed = true;
+            }
+
+            _heartbeatTimer.Dispose();
+            _socket.Dispose();
+        }
+    }
+}
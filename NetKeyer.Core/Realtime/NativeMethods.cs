@@ -0,0 +1,76 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace NetKeyer.Realtime
+{
+    /// <summary>
+    /// Thread affinity and scheduling entry points: libc on Linux, kernel32 and avrt (MMCSS) on
+    /// Windows.
+    /// </summary>
+    internal static unsafe partial class NativeMethods
+    {
+        const string LibC = "libc";
+        const string Kernel32 = "kernel32.dll";
+        const string Avrt = "avrt.dll";
+
+        internal const int SCHED_FIFO = 1;
+        internal const int EPERM = 1;
+
+        internal const int THREAD_PRIORITY_TIME_CRITICAL = 15;
+        internal const int THREAD_PRIORITY_ERROR_RETURN = 0x7FFFFFFF;
+        internal const int AVRT_PRIORITY_HIGH = 1;
+        internal const int AVRT_PRIORITY_CRITICAL = 2;
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct SchedParam
+        {
+            public int sched_priority;
+        }
+
+        // For all of these, pid 0 is the calling thread, and any other value a thread id
+        [LibraryImport(LibC, SetLastError = true)]
+        internal static partial int sched_setaffinity(int pid, nint cpusetsize, ulong* mask);
+
+        [LibraryImport(LibC, SetLastError = true)]
+        internal static partial int sched_getaffinity(int pid, nint cpusetsize, ulong* mask);
+
+        [LibraryImport(LibC, SetLastError = true)]
+        internal static partial int sched_setscheduler(int pid, int policy, SchedParam* param);
+
+        [LibraryImport(LibC, SetLastError = true)]
+        internal static partial int sched_getscheduler(int pid);
+
+        [LibraryImport(LibC, SetLastError = true)]
+        internal static partial int sched_getparam(int pid, SchedParam* param);
+
+        [LibraryImport(LibC)]
+        internal static partial int gettid();
+
+        [LibraryImport(Kernel32)]
+        internal static partial IntPtr GetCurrentThread();
+
+        [LibraryImport(Kernel32)]
+        internal static partial uint GetCurrentThreadId();
+
+        [LibraryImport(Kernel32, SetLastError = true)]
+        internal static partial nuint SetThreadAffinityMask(IntPtr thread, nuint mask);
+
+        [LibraryImport(Kernel32, SetLastError = true)]
+        [return: MarshalAs(UnmanagedType.Bool)]
+        internal static partial bool SetThreadPriority(IntPtr thread, int priority);
+
+        [LibraryImport(Kernel32, SetLastError = true)]
+        internal static partial int GetThreadPriority(IntPtr thread);
+
+        [LibraryImport(Avrt, SetLastError = true, StringMarshalling = StringMarshalling.Utf16)]
+        internal static partial IntPtr AvSetMmThreadCharacteristicsW(string taskName, ref uint taskIndex);
+
+        [LibraryImport(Avrt, SetLastError = true)]
+        [return: MarshalAs(UnmanagedType.Bool)]
+        internal static partial bool AvSetMmThreadPriority(IntPtr avrtHandle, int priority);
+
+        [LibraryImport(Avrt, SetLastError = true)]
+        [return: MarshalAs(UnmanagedType.Bool)]
+        internal static partial bool AvRevertMmThreadCharacteristics(IntPtr avrtHandle);
+    }
+}
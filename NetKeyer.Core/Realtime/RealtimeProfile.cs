@@ -0,0 +1,553 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.ComponentModel;
+using System.Diagnostics;
+using System.IO;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Runtime.Versioning;
+using System.Text;
+using System.Threading;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Realtime
+{
+    /// <summary>
+    /// Threads on the keying path, each with its own scheduling priority.
+    /// </summary>
+    public enum RealtimeThreadRole
+    {
+        /// <summary>Sidetone audio callback (PortAudio or WASAPI).</summary>
+        Audio,
+        /// <summary>Keying core thread.</summary>
+        Keying,
+        /// <summary>MIDI callbacks and the evdev and network input threads.</summary>
+        Input
+    }
+
+    /// <summary>
+    /// Optional real-time profile for the threads on the keying path. When enabled, each of them
+    /// pins itself to the chosen cores and raises its priority: SCHED_FIFO on Linux (which needs
+    /// an rtprio limit or CAP_SYS_NICE), MMCSS "Pro Audio" on Windows. Optionally every other
+    /// thread in the process (UI, render, thread pool, GC) is moved off those cores.
+    ///
+    /// Audio and MIDI callbacks run on threads the drivers create, so nothing can configure them
+    /// from outside: every real-time thread calls <see cref="EnterThread"/> from its loop or
+    /// callback instead. That costs one thread-static compare once the profile is applied, and
+    /// applies it again on the next call after <see cref="Configure"/>. Each thread remembers the
+    /// scheduling and cores it had before, and puts them back itself on that next call when the
+    /// profile has been turned off or reconfigured.
+    /// </summary>
+    public static class RealtimeProfile
+    {
+        // Linux SCHED_FIFO priorities, below the kernel's own threads (50 for IRQ threads is
+        // common with PREEMPT_RT, so audio sits above them like JACK does)
+        private const int AUDIO_FIFO_PRIORITY = 70;
+        private const int KEYING_FIFO_PRIORITY = 68;
+        private const int INPUT_FIFO_PRIORITY = 66;
+
+        // One 64-bit mask covers the cores we can pin to
+        private const int MAX_CORES = 64;
+
+        // Affinity set size for saving a thread's cores, since the call fails if the set doesn't
+        // fit: 1024 cores
+        private const int AFFINITY_WORDS = 16;
+
+        private static readonly bool _debug = DebugCategory.Realtime.IsEnabled;
+
+        private static readonly ConcurrentDictionary<long, RealtimeThreadRole> _realtimeThreads = new ConcurrentDictionary<long, RealtimeThreadRole>();
+        private static readonly string[] _roleStatus = new string[3];
+        private static readonly object _configureLock = new object();
+
+        private static volatile int _generation;
+        private static volatile bool _enabled;
+        private static ulong _coreMask;
+        private static ulong _processMask;
+        private static bool _isolate;
+        private static volatile string _isolationStatus;
+
+        [ThreadStatic]
+        private static int _appliedGeneration;
+
+        // What this thread had before the profile was applied to it; null when it isn't applied
+        [ThreadStatic]
+        private static SavedThreadState _savedState;
+
+        public static bool IsEnabled => _enabled;
+
+        /// <summary>
+        /// Cores the real-time threads are pinned to, or 0 when the profile is off.
+        /// </summary>
+        public static ulong CoreMask => _enabled ? Volatile.Read(ref _coreMask) : 0;
+
+        /// <summary>
+        /// Turns the profile on or off. <paramref name="cores"/> is a list of core numbers and
+        /// ranges such as "3" or "2-3,6"; empty means the last core. Real-time threads pick the
+        /// change up the next time they call <see cref="EnterThread"/>, restoring their previous
+        /// scheduling and cores first. Threads moved off the real-time cores go back to the
+        /// process's cores at once.
+        /// </summary>
+        /// <exception cref="ArgumentException"><paramref name="cores"/> doesn't parse.</exception>
+        public static void Configure(bool enabled, string cores, bool isolateCores)
+        {
+            ulong mask = 0;
+            if (enabled)
+            {
+                if (string.IsNullOrWhiteSpace(cores))
+                    mask = 1UL << (Math.Min(Environment.ProcessorCount, MAX_CORES) - 1);
+                else if (!TryParseCores(cores, out mask, out string error))
+                    throw new ArgumentException($"Real-time cores '{cores}': {error}", nameof(cores));
+            }
+
+            bool wasIsolated;
+            lock (_configureLock)
+            {
+                wasIsolated = _enabled && _isolate;
+                if (_processMask == 0)
+                    _processMask = ReadProcessMask();
+
+                Volatile.Write(ref _coreMask, mask);
+                _isolate = enabled && isolateCores;
+                _isolationStatus = null;
+                Array.Clear(_roleStatus);
+                _enabled = enabled;
+                _generation++;
+
+                if (_debug) DebugLogger.Log(DebugCategory.Realtime, enabled
+                    ? $"[RealtimeProfile] Enabled: cores {FormatCores(mask)}, isolate {isolateCores}"
+                    : $"[RealtimeProfile] Disabled");
+            }
+
+            // Real-time threads restore their own cores; everything else goes back now
+            if (wasIsolated)
+                RestoreOtherThreads();
+            if (enabled && isolateCores)
+                IsolateOtherThreads();
+        }
+
+        /// <summary>
+        /// Parses a core list ("3", "2-3", "0,2,4-5") into a mask.
+        /// </summary>
+        public static bool TryParseCores(string text, out ulong mask, out string error)
+        {
+            mask = 0;
+            error = null;
+            foreach (var part in text.Split(',', StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries))
+            {
+                int dash = part.IndexOf('-');
+                string firstText = dash < 0 ? part : part.Substring(0, dash);
+                string lastText = dash < 0 ? part : part.Substring(dash + 1);
+                if (!int.TryParse(firstText, out int first) || !int.TryParse(lastText, out int last) || first > last)
+                {
+                    error = $"'{part}' is not a core number or range";
+                    return false;
+                }
+                if (first < 0 || last >= MAX_CORES || last >= Environment.ProcessorCount)
+                {
+                    error = $"core {last} does not exist (this machine has {Environment.ProcessorCount})";
+                    return false;
+                }
+                for (int core = first; core <= last; core++)
+                    mask |= 1UL << core;
+            }
+
+            if (mask == 0)
+            {
+                error = "no cores given";
+                return false;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Applies the profile to the calling thread if it hasn't been yet. Real-time threads
+        /// call this at the top of each callback or loop iteration.
+        /// </summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static void EnterThread(RealtimeThreadRole role)
+        {
+            if (_appliedGeneration != _generation)
+                ApplyToCurrentThread(role);
+        }
+
+        private static void ApplyToCurrentThread(RealtimeThreadRole role)
+        {
+            _appliedGeneration = _generation;
+            if (_savedState != null)
+            {
+                RestoreCurrentThread(_savedState);
+                _savedState = null;
+            }
+            if (!_enabled)
+                return;
+
+            ulong mask = Volatile.Read(ref _coreMask);
+            var saved = new SavedThreadState { ThreadId = CurrentThreadId() };
+            _realtimeThreads[saved.ThreadId] = role;
+
+            string status = $"{PinCurrentThread(mask, saved)}, {RaiseCurrentThreadPriority(role, saved)}";
+            _savedState = saved;
+            _roleStatus[(int)role] = status;
+            if (_debug) DebugLogger.Log(DebugCategory.Realtime, $"[RealtimeProfile] {role} thread {saved.ThreadId}: {status}");
+
+            // Threads started since the last pass (a new audio stream, the UI's render thread)
+            // may be sharing our cores; move them without making this thread wait
+            if (_isolate)
+                ThreadPool.UnsafeQueueUserWorkItem(_ => IsolateOtherThreads(), null);
+        }
+
+        /// <summary>
+        /// Moves every thread that isn't a real-time thread off the real-time cores. Threads
+        /// created later by those threads inherit their cores on Linux; on Windows they start on
+        /// all cores, so this runs again whenever a real-time thread starts.
+        /// </summary>
+        public static void IsolateOtherThreads()
+        {
+            PruneExitedThreads();
+
+            ulong realtimeMask = CoreMask;
+            if (realtimeMask == 0 || (!OperatingSystem.IsLinux() && !OperatingSystem.IsWindows()))
+            {
+                _isolationStatus = realtimeMask == 0 ? null : "other threads not moved (not supported on this platform)";
+                return;
+            }
+
+            ulong others = _processMask & ~realtimeMask;
+            if (others == 0)
+            {
+                _isolationStatus = "other threads not moved (no cores left for them)";
+                return;
+            }
+
+            int moved = 0, failed = 0;
+            try
+            {
+                MoveOtherThreads(others, ref moved, ref failed);
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException or InvalidOperationException)
+            {
+                _isolationStatus = $"other threads not moved ({ex.Message})";
+                return;
+            }
+
+            _isolationStatus = failed == 0
+                ? $"other threads on cores {FormatCores(others)}"
+                : $"other threads on cores {FormatCores(others)} ({failed} could not be moved)";
+            if (_debug) DebugLogger.Log(DebugCategory.Realtime, $"[RealtimeProfile] Moved {moved} threads to cores {FormatCores(others)}, {failed} failed");
+        }
+
+        /// <summary>
+        /// Puts every thread that isn't a real-time thread back on the process's cores, undoing
+        /// <see cref="IsolateOtherThreads"/>. Real-time threads restore their own cores.
+        /// </summary>
+        private static void RestoreOtherThreads()
+        {
+            PruneExitedThreads();
+            if (_processMask == 0 || (!OperatingSystem.IsLinux() && !OperatingSystem.IsWindows()))
+                return;
+
+            int moved = 0, failed = 0;
+            try
+            {
+                MoveOtherThreads(_processMask, ref moved, ref failed);
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException or InvalidOperationException)
+            {
+                Console.WriteLine($"Real-time profile: could not move threads back to all cores: {ex.Message}");
+                return;
+            }
+            if (_debug) DebugLogger.Log(DebugCategory.Realtime, $"[RealtimeProfile] Moved {moved} threads back to cores {FormatCores(_processMask)}, {failed} failed");
+        }
+
+        /// <summary>
+        /// Sets the cores of every thread in the process except the real-time ones.
+        /// </summary>
+        private static void MoveOtherThreads(ulong mask, ref int moved, ref int failed)
+        {
+            if (OperatingSystem.IsLinux())
+                MoveLinuxThreads(mask, ref moved, ref failed);
+            else if (OperatingSystem.IsWindows())
+                MoveWindowsThreads(mask, ref moved, ref failed);
+        }
+
+        /// <summary>
+        /// Forgets real-time threads that have exited without restoring themselves (a closed
+        /// audio stream's callback thread, say), so their ids can't shield a new thread that
+        /// reuses one from isolation.
+        /// </summary>
+        private static void PruneExitedThreads()
+        {
+            if (_realtimeThreads.IsEmpty || (!OperatingSystem.IsLinux() && !OperatingSystem.IsWindows()))
+                return;
+
+            var live = new HashSet<long>();
+            try
+            {
+                if (OperatingSystem.IsLinux())
+                {
+                    foreach (var task in Directory.EnumerateDirectories("/proc/self/task"))
+                    {
+                        if (int.TryParse(Path.GetFileName(task), out int tid))
+                            live.Add(tid);
+                    }
+                }
+                else
+                {
+                    using var process = Process.GetCurrentProcess();
+                    foreach (ProcessThread thread in process.Threads)
+                    {
+                        using (thread)
+                            live.Add(thread.Id);
+                    }
+                }
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException or InvalidOperationException)
+            {
+                return;
+            }
+
+            foreach (long tid in _realtimeThreads.Keys)
+            {
+                if (!live.Contains(tid))
+                    _realtimeThreads.TryRemove(tid, out _);
+            }
+        }
+
+        /// <summary>
+        /// The effective configuration, one line per real-time thread role.
+        /// </summary>
+        public static string Describe()
+        {
+            if (!_enabled)
+                return "Real-time profile: off";
+
+            var sb = new StringBuilder();
+            sb.Append("Real-time profile: cores ").Append(FormatCores(CoreMask));
+            if (_isolate)
+                sb.Append("; ").Append(_isolationStatus ?? "other threads not moved yet");
+            foreach (RealtimeThreadRole role in new[] { RealtimeThreadRole.Audio, RealtimeThreadRole.Keying, RealtimeThreadRole.Input })
+                sb.Append('\n').Append("  ").Append(role.ToString().ToLowerInvariant()).Append(": ").Append(_roleStatus[(int)role] ?? "not started");
+            return sb.ToString();
+        }
+
+        public static string FormatCores(ulong mask)
+        {
+            var sb = new StringBuilder();
+            for (int core = 0; core < MAX_CORES; core++)
+            {
+                if ((mask & (1UL << core)) == 0)
+                    continue;
+                int last = core;
+                while (last + 1 < MAX_CORES && (mask & (1UL << (last + 1))) != 0)
+                    last++;
+                if (sb.Length > 0)
+                    sb.Append(',');
+                sb.Append(core);
+                if (last > core)
+                    sb.Append('-').Append(last);
+                core = last;
+            }
+            return sb.ToString();
+        }
+
+        private static unsafe string PinCurrentThread(ulong mask, SavedThreadState saved)
+        {
+            if (OperatingSystem.IsLinux())
+            {
+                var previous = new ulong[AFFINITY_WORDS];
+                fixed (ulong* set = previous)
+                {
+                    if (NativeMethods.sched_getaffinity(0, AFFINITY_WORDS * sizeof(ulong), set) < 0)
+                        return $"not pinned (errno {Marshal.GetLastPInvokeError()})";
+                }
+                if (NativeMethods.sched_setaffinity(0, sizeof(ulong), &mask) == 0)
+                {
+                    saved.LinuxAffinity = previous;
+                    return $"cores {FormatCores(mask)}";
+                }
+                return $"not pinned (errno {Marshal.GetLastPInvokeError()})";
+            }
+            if (OperatingSystem.IsWindows())
+            {
+                nuint previous = NativeMethods.SetThreadAffinityMask(NativeMethods.GetCurrentThread(), (nuint)mask);
+                if (previous != 0)
+                {
+                    saved.WindowsAffinity = previous;
+                    return $"cores {FormatCores(mask)}";
+                }
+                return $"not pinned (error {Marshal.GetLastPInvokeError()})";
+            }
+            return "not pinned (not supported on this platform)";
+        }
+
+        private static unsafe string RaiseCurrentThreadPriority(RealtimeThreadRole role, SavedThreadState saved)
+        {
+            if (OperatingSystem.IsLinux())
+            {
+                int previousPolicy = NativeMethods.sched_getscheduler(0);
+                var previousParam = new NativeMethods.SchedParam();
+                if (previousPolicy < 0 || NativeMethods.sched_getparam(0, &previousParam) != 0)
+                    return $"normal priority (could not read the current policy, errno {Marshal.GetLastPInvokeError()})";
+
+                var param = new NativeMethods.SchedParam
+                {
+                    sched_priority = role switch
+                    {
+                        RealtimeThreadRole.Audio => AUDIO_FIFO_PRIORITY,
+                        RealtimeThreadRole.Keying => KEYING_FIFO_PRIORITY,
+                        _ => INPUT_FIFO_PRIORITY
+                    }
+                };
+                if (NativeMethods.sched_setscheduler(0, NativeMethods.SCHED_FIFO, &param) == 0)
+                {
+                    saved.LinuxPolicy = previousPolicy;
+                    saved.LinuxPriority = previousParam.sched_priority;
+                    return $"SCHED_FIFO {param.sched_priority}";
+                }
+                int errno = Marshal.GetLastPInvokeError();
+                return errno == NativeMethods.EPERM
+                    ? "normal priority (SCHED_FIFO not permitted; give this user an rtprio limit)"
+                    : $"normal priority (SCHED_FIFO failed, errno {errno})";
+            }
+            if (OperatingSystem.IsWindows())
+            {
+                int previousPriority = NativeMethods.GetThreadPriority(NativeMethods.GetCurrentThread());
+                uint taskIndex = 0;
+                IntPtr task = NativeMethods.AvSetMmThreadCharacteristicsW("Pro Audio", ref taskIndex);
+                if (task != IntPtr.Zero)
+                {
+                    saved.MmcssTask = task;
+                    NativeMethods.AvSetMmThreadPriority(task, role == RealtimeThreadRole.Audio
+                        ? NativeMethods.AVRT_PRIORITY_CRITICAL
+                        : NativeMethods.AVRT_PRIORITY_HIGH);
+                    return "MMCSS Pro Audio";
+                }
+                if (previousPriority != NativeMethods.THREAD_PRIORITY_ERROR_RETURN &&
+                    NativeMethods.SetThreadPriority(NativeMethods.GetCurrentThread(), NativeMethods.THREAD_PRIORITY_TIME_CRITICAL))
+                {
+                    saved.WindowsPriority = previousPriority;
+                    return "time critical priority";
+                }
+                return $"normal priority (error {Marshal.GetLastPInvokeError()})";
+            }
+            return "priority unchanged (not supported on this platform)";
+        }
+
+        /// <summary>
+        /// Puts back the scheduling and cores the calling thread had before the profile was
+        /// applied to it.
+        /// </summary>
+        private static unsafe void RestoreCurrentThread(SavedThreadState saved)
+        {
+            _realtimeThreads.TryRemove(saved.ThreadId, out _);
+
+            if (OperatingSystem.IsLinux())
+            {
+                if (saved.LinuxPolicy >= 0)
+                {
+                    var param = new NativeMethods.SchedParam { sched_priority = saved.LinuxPriority };
+                    if (NativeMethods.sched_setscheduler(0, saved.LinuxPolicy, &param) != 0)
+                        Console.WriteLine($"Real-time profile: could not restore thread {saved.ThreadId} scheduling (errno {Marshal.GetLastPInvokeError()})");
+                }
+                if (saved.LinuxAffinity != null)
+                {
+                    fixed (ulong* set = saved.LinuxAffinity)
+                    {
+                        if (NativeMethods.sched_setaffinity(0, AFFINITY_WORDS * sizeof(ulong), set) != 0)
+                            Console.WriteLine($"Real-time profile: could not restore thread {saved.ThreadId} cores (errno {Marshal.GetLastPInvokeError()})");
+                    }
+                }
+            }
+            else if (OperatingSystem.IsWindows())
+            {
+                if (saved.MmcssTask != IntPtr.Zero)
+                    NativeMethods.AvRevertMmThreadCharacteristics(saved.MmcssTask);
+                if (saved.WindowsPriority != NativeMethods.THREAD_PRIORITY_ERROR_RETURN)
+                    NativeMethods.SetThreadPriority(NativeMethods.GetCurrentThread(), saved.WindowsPriority);
+                if (saved.WindowsAffinity != 0)
+                    NativeMethods.SetThreadAffinityMask(NativeMethods.GetCurrentThread(), saved.WindowsAffinity);
+            }
+
+            if (_debug) DebugLogger.Log(DebugCategory.Realtime, $"[RealtimeProfile] Thread {saved.ThreadId} restored");
+        }
+
+        private static unsafe void MoveLinuxThreads(ulong mask, ref int moved, ref int failed)
+        {
+            foreach (var task in Directory.EnumerateDirectories("/proc/self/task"))
+            {
+                if (!int.TryParse(Path.GetFileName(task), out int tid) || _realtimeThreads.ContainsKey(tid))
+                    continue;
+                if (NativeMethods.sched_setaffinity(tid, sizeof(ulong), &mask) == 0)
+                    moved++;
+                else
+                    failed++;
+            }
+        }
+
+        [SupportedOSPlatform("windows")]
+        private static void MoveWindowsThreads(ulong mask, ref int moved, ref int failed)
+        {
+            using var process = Process.GetCurrentProcess();
+            foreach (ProcessThread thread in process.Threads)
+            {
+                using (thread)
+                {
+                    if (_realtimeThreads.ContainsKey(thread.Id))
+                        continue;
+                    try
+                    {
+                        thread.ProcessorAffinity = (IntPtr)(long)mask;
+                        moved++;
+                    }
+                    catch (Exception ex) when (ex is Win32Exception or InvalidOperationException)
+                    {
+                        // The thread exited, or belongs to the system
+                        failed++;
+                    }
+                }
+            }
+        }
+
+        private static unsafe ulong ReadProcessMask()
+        {
+            ulong all = Environment.ProcessorCount >= MAX_CORES ? ulong.MaxValue : (1UL << Environment.ProcessorCount) - 1;
+            if (OperatingSystem.IsLinux())
+            {
+                // Sized for 1024 cores, since the call fails if the set doesn't fit
+                ulong* set = stackalloc ulong[16];
+                return NativeMethods.sched_getaffinity(0, 16 * sizeof(ulong), set) >= 0 ? set[0] : all;
+            }
+            if (OperatingSystem.IsWindows())
+            {
+                using var process = Process.GetCurrentProcess();
+                return (ulong)(long)process.ProcessorAffinity;
+            }
+            return all;
+        }
+
+        /// <summary>
+        /// A real-time thread's scheduling and cores from before the profile was applied. Only
+        /// what the profile actually changed is filled in.
+        /// </summary>
+        private sealed class SavedThreadState
+        {
+            public long ThreadId;
+            public int LinuxPolicy = -1;
+            public int LinuxPriority;
+            public ulong[] LinuxAffinity;
+            public int WindowsPriority = NativeMethods.THREAD_PRIORITY_ERROR_RETURN;
+            public nuint WindowsAffinity;
+            public IntPtr MmcssTask;
+        }
+
+        private static long CurrentThreadId()
+        {
+            if (OperatingSystem.IsLinux())
+                return NativeMethods.gettid();
+            if (OperatingSystem.IsWindows())
+                return NativeMethods.GetCurrentThreadId();
+            return Environment.CurrentManagedThreadId;
+        }
+    }
+}
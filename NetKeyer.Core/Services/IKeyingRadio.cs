@@ -0,0 +1,35 @@
+using System;
+
+namespace NetKeyer.Services;
+
+/// <summary>
+/// The radio as the keying core sees it: CW key and MOX commands, and whether the radio is
+/// transmitting. The application implements it over FlexLib's <c>Radio</c>, which keeps
+/// FlexLib and its string-named property change events out of the core.
+/// </summary>
+public interface IKeyingRadio
+{
+    /// <summary>
+    /// Sends a CW key edge. Called on the audio or keying core thread, so it must not block.
+    /// </summary>
+    /// <param name="state">True for key down.</param>
+    /// <param name="timestamp">Radio CWKey timestamp (<see cref="NetKeyer.Helpers.Timebase.ToRadioTimestamp"/>).</param>
+    /// <param name="guiClientHandle">GUI client the key belongs to.</param>
+    void CWKey(bool state, ushort timestamp, uint guiClientHandle);
+
+    /// <summary>
+    /// Keys or unkeys the transmitter (PTT input in voice modes).
+    /// </summary>
+    void SetMox(bool state);
+
+    /// <summary>
+    /// True while the radio reports its interlock as transmitting.
+    /// </summary>
+    bool IsTransmitting { get; }
+
+    /// <summary>
+    /// Raised with the new <see cref="IsTransmitting"/> value when it changes, on the radio's
+    /// status thread.
+    /// </summary>
+    event Action<bool> TransmittingChanged;
+}
@@ -0,0 +1,487 @@
+using System;
+using System.Collections.Generic;
+using System.IO.Ports;
+using System.Linq;
+using System.Net;
+using NetKeyer.Evdev;
+using NetKeyer.Helpers;
+using NetKeyer.Midi;
+using NetKeyer.Models;
+using NetKeyer.Network;
+
+namespace NetKeyer.Services;
+
+public class InputDeviceManager : IDisposable
+{
+    private SerialPort _serialPort;
+    private MidiPaddleInput _midiInput;
+    private EvdevPaddleInput _evdevInput;
+    private NetworkPaddleInput _networkInput;
+    private UdpPaddleSender _forwarder;
+    private IPAddress _networkBindAddress = IPAddress.Loopback;
+    private IPAddress[] _networkAllowedSenders = Array.Empty<IPAddress>();
+    private long _inputDeviceOpenedTimestamp; // Timebase ticks; 0 = no grace period active
+    private const int INPUT_GRACE_PERIOD_MS = 100; // Ignore paddle events for this many ms after opening device
+
+    private volatile bool _swapPaddles;
+
+    public bool IsDeviceOpen => (_serialPort != null && _serialPort.IsOpen) || _midiInput != null || _evdevInput != null || _networkInput != null;
+    public InputDeviceType? CurrentDeviceType { get; private set; }
+
+    public event Action<PaddleState> PaddleStateChanged;
+
+    /// <summary>
+    /// Link statistics while the network input is open, otherwise null.
+    /// </summary>
+    public NetworkInputStats? NetworkStats => _networkInput?.GetStats();
+
+    public List<string> DiscoverSerialPorts()
+    {
+        var ports = new List<string>();
+
+        try
+        {
+            var portNames = SerialPort.GetPortNames();
+
+            // Remove duplicates (SerialPort.GetPortNames() can return duplicates on some platforms)
+            var uniquePorts = portNames.Distinct().ToArray();
+
+            Array.Sort(uniquePorts, (a, b) =>
+            {
+                try
+                {
+                    // Extract just the filename from path
+                    string nameA = a;
+                    string nameB = b;
+                    int lastSlashA = a.LastIndexOfAny(new[] { '/', '\\' });
+                    int lastSlashB = b.LastIndexOfAny(new[] { '/', '\\' });
+                    if (lastSlashA >= 0) nameA = a.Substring(lastSlashA + 1);
+                    if (lastSlashB >= 0) nameB = b.Substring(lastSlashB + 1);
+
+                    // Try to extract numeric part for sorting
+                    string numStrA = nameA.Replace("ttyUSB", "").Replace("COM", "").Replace("ttyACM", "");
+                    string numStrB = nameB.Replace("ttyUSB", "").Replace("COM", "").Replace("ttyACM", "");
+
+                    if (int.TryParse(numStrA, out int idA) && int.TryParse(numStrB, out int idB))
+                        return idA.CompareTo(idB);
+
+                    return nameA.CompareTo(nameB);
+                }
+                catch
+                {
+                    return a.CompareTo(b);
+                }
+            });
+
+            ports.AddRange(uniquePorts);
+
+            if (ports.Count == 0)
+            {
+                ports.Add("No ports found");
+            }
+        }
+        catch (Exception ex)
+        {
+            ports.Add($"Error: {ex.Message}");
+        }
+
+        return ports;
+    }
+
+    public List<string> DiscoverMidiDevices()
+    {
+        var devices = new List<string>();
+
+        try
+        {
+            var midiDevices = MidiPaddleInput.GetAvailableDevices();
+            devices.AddRange(midiDevices);
+
+            if (devices.Count == 0)
+            {
+                devices.Add("No MIDI devices found");
+            }
+        }
+        catch (Exception ex)
+        {
+            devices.Add($"MIDI Error: {ex.Message}");
+        }
+
+        return devices;
+    }
+
+    public List<string> DiscoverEvdevDevices()
+    {
+        var devices = new List<string>();
+
+        try
+        {
+            devices.AddRange(EvdevPaddleInput.GetAvailableDevices());
+
+            if (devices.Count == 0)
+            {
+                devices.Add("No input devices found");
+            }
+        }
+        catch (Exception ex)
+        {
+            devices.Add($"Input device Error: {ex.Message}");
+        }
+
+        return devices;
+    }
+
+    public void OpenDevice(InputDeviceType deviceType, string deviceName, List<MidiNoteMapping> midiNoteMappings = null,
+        List<EvdevKeyMapping> evdevKeyMappings = null)
+    {
+        CloseDevice();
+
+        if (deviceType == InputDeviceType.Serial)
+        {
+            OpenSerialPort(deviceName);
+        }
+        else if (deviceType == InputDeviceType.Evdev)
+        {
+            OpenEvdevDevice(deviceName, evdevKeyMappings);
+        }
+        else if (deviceType == InputDeviceType.Network)
+        {
+            OpenNetworkInput(deviceName);
+        }
+        else // MIDI
+        {
+            OpenMidiDevice(deviceName, midiNoteMappings);
+        }
+
+        CurrentDeviceType = deviceType;
+    }
+
+    private void OpenSerialPort(string portName)
+    {
+        if (string.IsNullOrEmpty(portName) || portName.Contains("No ports") || portName.Contains("Error"))
+        {
+            throw new InvalidOperationException("No serial port selected");
+        }
+
+        try
+        {
+            _serialPort = new SerialPort(portName);
+            _serialPort.BaudRate = 9600; // Baud rate doesn't matter for control lines
+            _serialPort.PinChanged += SerialPort_PinChanged;
+            _serialPort.Open();
+
+            // Mark when we opened the device to enable grace period
+            _inputDeviceOpenedTimestamp = Timebase.Now;
+
+            // Emit initial state event with current pin states
+            // This ensures indicators update immediately when device is opened
+            RaiseLocalPaddleStateChanged(ReadSerialPaddleState(Timebase.Now));
+        }
+        catch (Exception ex)
+        {
+            _serialPort = null;
+            throw new InvalidOperationException($"Serial port error: {ex.Message}", ex);
+        }
+    }
+
+    private void OpenMidiDevice(string deviceName, List<MidiNoteMapping> midiNoteMappings)
+    {
+        if (string.IsNullOrEmpty(deviceName) || deviceName.Contains("No MIDI") || deviceName.Contains("Error"))
+        {
+            throw new InvalidOperationException("No MIDI device selected");
+        }
+
+        try
+        {
+            _midiInput = new MidiPaddleInput();
+            _midiInput.SetNoteMappings(midiNoteMappings);
+            _midiInput.PaddleStateChanged += PaddleInput_PaddleStateChanged;
+            _midiInput.Open(deviceName);
+
+            // Mark when we opened the device to enable grace period
+            _inputDeviceOpenedTimestamp = Timebase.Now;
+        }
+        catch (Exception ex)
+        {
+            _midiInput = null;
+            throw new InvalidOperationException($"MIDI device error: {ex.Message}", ex);
+        }
+    }
+
+    /// <summary>
+    /// Attaches a MIDI input without opening a port, for the real-time checks, which feed it
+    /// messages directly and measure delivery through this class. No grace period applies.
+    /// </summary>
+    internal MidiPaddleInput AttachMidiInput(List<MidiNoteMapping> midiNoteMappings)
+    {
+        CloseDevice();
+        _midiInput = new MidiPaddleInput();
+        _midiInput.SetNoteMappings(midiNoteMappings);
+        _midiInput.PaddleStateChanged += PaddleInput_PaddleStateChanged;
+        CurrentDeviceType = InputDeviceType.MIDI;
+        return _midiInput;
+    }
+
+    private void OpenEvdevDevice(string deviceName, List<EvdevKeyMapping> evdevKeyMappings)
+    {
+        if (string.IsNullOrEmpty(deviceName) || deviceName.Contains("No input devices") || deviceName.Contains("Error"))
+        {
+            throw new InvalidOperationException("No input device selected");
+        }
+
+        try
+        {
+            _evdevInput = new EvdevPaddleInput();
+            _evdevInput.SetKeyMappings(evdevKeyMappings);
+            _evdevInput.PaddleStateChanged += PaddleInput_PaddleStateChanged;
+            _evdevInput.Open(deviceName);
+
+            // Mark when we opened the device to enable grace period
+            _inputDeviceOpenedTimestamp = Timebase.Now;
+        }
+        catch (Exception ex)
+        {
+            _evdevInput?.Dispose();
+            _evdevInput = null;
+            throw new InvalidOperationException($"Input device error: {ex.Message}", ex);
+        }
+    }
+
+    private void OpenNetworkInput(string port)
+    {
+        if (!int.TryParse(port, out int udpPort) || udpPort <= 0 || udpPort > 65535)
+        {
+            throw new InvalidOperationException($"Invalid UDP port '{port}'");
+        }
+
+        try
+        {
+            _networkInput = new NetworkPaddleInput();
+            _networkInput.PaddleStateChanged += NetworkInput_PaddleStateChanged;
+            _networkInput.Open(udpPort, _networkBindAddress, _networkAllowedSenders);
+        }
+        catch (Exception ex)
+        {
+            _networkInput?.Dispose();
+            _networkInput = null;
+            throw new InvalidOperationException($"Network input error: {ex.Message}", ex);
+        }
+    }
+
+    public void CloseDevice()
+    {
+        CloseSerialPort();
+        CloseMidiDevice();
+        CloseEvdevDevice();
+        CloseNetworkInput();
+        CurrentDeviceType = null;
+    }
+
+    private void CloseSerialPort()
+    {
+        if (_serialPort != null)
+        {
+            try
+            {
+                if (_serialPort.IsOpen)
+                    _serialPort.Close();
+                _serialPort.PinChanged -= SerialPort_PinChanged;
+                _serialPort.Dispose();
+            }
+            catch { }
+            _serialPort = null;
+            _inputDeviceOpenedTimestamp = 0;
+        }
+    }
+
+    private void CloseMidiDevice()
+    {
+        if (_midiInput != null)
+        {
+            try
+            {
+                _midiInput.PaddleStateChanged -= PaddleInput_PaddleStateChanged;
+                _midiInput.Close();
+                _midiInput.Dispose();
+            }
+            catch { }
+            _midiInput = null;
+            _inputDeviceOpenedTimestamp = 0;
+        }
+    }
+
+    private void CloseEvdevDevice()
+    {
+        if (_evdevInput != null)
+        {
+            try
+            {
+                _evdevInput.PaddleStateChanged -= PaddleInput_PaddleStateChanged;
+                _evdevInput.Close();
+                _evdevInput.Dispose();
+            }
+            catch { }
+            _evdevInput = null;
+            _inputDeviceOpenedTimestamp = 0;
+        }
+    }
+
+    private void CloseNetworkInput()
+    {
+        if (_networkInput != null)
+        {
+            try
+            {
+                _networkInput.PaddleStateChanged -= NetworkInput_PaddleStateChanged;
+                _networkInput.Dispose();
+            }
+            catch { }
+            _networkInput = null;
+        }
+    }
+
+    /// <summary>
+    /// Sets the local address the network input listens on (empty for loopback) and the
+    /// sender addresses it accepts (empty for any), taking effect the next time it is opened.
+    /// Throws <see cref="InvalidOperationException"/> if an address can't be parsed, leaving
+    /// the previous setting in place.
+    /// </summary>
+    public void SetNetworkInputAccess(string bindAddress, IEnumerable<string> allowedSenders)
+    {
+        var bind = IPAddress.Loopback;
+        if (!string.IsNullOrWhiteSpace(bindAddress) && !IPAddress.TryParse(bindAddress.Trim(), out bind))
+            throw new InvalidOperationException($"Invalid network input bind address '{bindAddress}'");
+
+        var allowed = new List<IPAddress>();
+        foreach (var sender in allowedSenders ?? Enumerable.Empty<string>())
+        {
+            if (string.IsNullOrWhiteSpace(sender))
+                continue;
+            if (!IPAddress.TryParse(sender.Trim(), out var address))
+                throw new InvalidOperationException($"Invalid network input allowed sender '{sender}'");
+            allowed.Add(address);
+        }
+
+        _networkBindAddress = bind;
+        _networkAllowedSenders = allowed.ToArray();
+    }
+
+    /// <summary>
+    /// Forwards every local paddle edge to a remote NetKeyer's network input ("host:port"),
+    /// or stops forwarding when target is empty.
+    /// </summary>
+    public void SetForwardTarget(string target)
+    {
+        if (_forwarder?.Target == target)
+            return;
+
+        _forwarder?.Dispose();
+        _forwarder = null;
+
+        if (!string.IsNullOrWhiteSpace(target))
+        {
+            _forwarder = new UdpPaddleSender(target);
+            Console.WriteLine($"Forwarding paddle input to {target}");
+        }
+    }
+
+    public void UpdateEvdevKeyMappings(List<EvdevKeyMapping> mappings)
+    {
+        _evdevInput?.SetKeyMappings(mappings);
+    }
+
+    public void UpdateMidiNoteMappings(List<MidiNoteMapping> mappings)
+    {
+        _midiInput?.SetNoteMappings(mappings);
+    }
+
+    public void SetSwapPaddles(bool swap)
+    {
+        _swapPaddles = swap;
+    }
+
+    private void SerialPort_PinChanged(object sender, SerialPinChangedEventArgs e)
+    {
+        // Not a real-time thread: System.IO.Ports raises PinChanged on a shared thread-pool
+        // worker, which must not be pinned or given real-time priority
+        long timestamp = Timebase.Now;
+
+        // Check if we're in the grace period after opening the input device
+        if (IsInGracePeriod(timestamp))
+        {
+            return;
+        }
+
+        // HaliKey v1: CTS (left) + DSR (right)
+        if (e.EventType == SerialPinChange.CtsChanged || e.EventType == SerialPinChange.DsrChanged)
+        {
+            try
+            {
+                RaiseLocalPaddleStateChanged(ReadSerialPaddleState(timestamp));
+            }
+            catch { }
+        }
+    }
+
+    private bool IsInGracePeriod(long edgeTimestamp)
+    {
+        long opened = _inputDeviceOpenedTimestamp;
+        return opened != 0 && Timebase.ToMilliseconds(edgeTimestamp - opened) < INPUT_GRACE_PERIOD_MS;
+    }
+
+    private PaddleState ReadSerialPaddleState(long timestamp)
+    {
+        // Read current pin states
+        bool leftPaddle = _serialPort.CtsHolding;
+        bool rightPaddle = _serialPort.DsrHolding;
+
+        // Apply swap if enabled
+        if (_swapPaddles)
+        {
+            (leftPaddle, rightPaddle) = (rightPaddle, leftPaddle);
+        }
+
+        // For serial input, set StraightKey and PTT to the OR of both paddles
+        // This allows any paddle to trigger straight key or PTT mode
+        bool anyPaddle = leftPaddle || rightPaddle;
+
+        return new PaddleState(leftPaddle, rightPaddle, anyPaddle, anyPaddle, timestamp);
+    }
+
+    // Shared by the MIDI and evdev inputs, which report complete PaddleStates
+    private void PaddleInput_PaddleStateChanged(PaddleState state)
+    {
+        // Check if we're in the grace period after opening the input device
+        if (IsInGracePeriod(state.Timestamp))
+        {
+            return;
+        }
+
+        // Apply swap if enabled (only affects paddles, not straight key or PTT)
+        RaiseLocalPaddleStateChanged(_swapPaddles ? state.WithSwappedPaddles() : state);
+    }
+
+    private void NetworkInput_PaddleStateChanged(PaddleState state)
+    {
+        // The sender already applied its own swap setting; apply ours on top like any device.
+        // Network input is never forwarded again.
+        KeyingTrace.InstantAt("network paddle edge", state.Timestamp, state.Bits);
+        using var trace = KeyingTrace.Span("paddle state dispatch");
+        PaddleStateChanged?.Invoke(_swapPaddles ? state.WithSwappedPaddles() : state);
+    }
+
+    private void RaiseLocalPaddleStateChanged(PaddleState state)
+    {
+        KeyingTrace.InstantAt("paddle edge", state.Timestamp, state.Bits);
+        using var trace = KeyingTrace.Span("paddle state dispatch");
+        _forwarder?.Send(state);
+        PaddleStateChanged?.Invoke(state);
+    }
+
+    public void Dispose()
+    {
+        CloseDevice();
+        _forwarder?.Dispose();
+        _forwarder = null;
+    }
+}
@@ -0,0 +1,98 @@
+using System;
+using System.Threading;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Services;
+
+/// <summary>
+/// Hard limit on how long the radio stays keyed. The keyer's own stuck-state reset only runs
+/// when a paddle edge arrives, and iambic key-ups come from the audio callback, so a stalled or
+/// stopped audio device can leave the radio keyed indefinitely. This watchdog runs on its own
+/// thread and depends on neither: once a key-down has lasted longer than the limit, it calls
+/// the expiry handler with the key-down timestamp.
+///
+/// <see cref="KeyDown"/> and <see cref="KeyUp"/> are one interlocked write each, so they can
+/// be called on every element from the audio thread. The thread checks every
+/// <see cref="CHECK_INTERVAL_MS"/>, which bounds how late past the limit the key-up comes.
+/// </summary>
+public sealed class KeyDownWatchdog : IDisposable
+{
+    public const int CHECK_INTERVAL_MS = 50;
+
+    private readonly Func<int> _maxKeyDownMs;
+    private readonly Action<long> _expired;
+    private readonly ManualResetEventSlim _stopSignal = new ManualResetEventSlim(false);
+    private readonly Thread _thread;
+    private long _keyDownSince;
+    private long _expiries;
+
+    /// <param name="maxKeyDownMs">Current limit in milliseconds, read at every check; 0 or
+    /// less means no limit.</param>
+    /// <param name="expired">Called on the watchdog thread with the timestamp of the key-down
+    /// that exceeded the limit. It is not called again for the same key-down.</param>
+    public KeyDownWatchdog(Func<int> maxKeyDownMs, Action<long> expired)
+    {
+        _maxKeyDownMs = maxKeyDownMs ?? throw new ArgumentNullException(nameof(maxKeyDownMs));
+        _expired = expired ?? throw new ArgumentNullException(nameof(expired));
+
+        _thread = new Thread(WatchLoop)
+        {
+            Name = "key-down watchdog",
+            IsBackground = true,
+            Priority = ThreadPriority.AboveNormal
+        };
+        _thread.Start();
+    }
+
+    /// <summary>
+    /// Number of key-downs that exceeded the limit.
+    /// </summary>
+    public long Expiries => Interlocked.Read(ref _expiries);
+
+    /// <summary>
+    /// The radio was keyed at <paramref name="timestamp"/>. A key-down while already down
+    /// keeps the original start time.
+    /// </summary>
+    public void KeyDown(long timestamp)
+    {
+        Interlocked.CompareExchange(ref _keyDownSince, timestamp, 0);
+    }
+
+    public void KeyUp()
+    {
+        Interlocked.Exchange(ref _keyDownSince, 0);
+    }
+
+    public void Dispose()
+    {
+        _stopSignal.Set();
+        if (Thread.CurrentThread != _thread)
+            _thread.Join();
+        _stopSignal.Dispose();
+    }
+
+    private void WatchLoop()
+    {
+        while (!_stopSignal.Wait(CHECK_INTERVAL_MS))
+        {
+            long since = Interlocked.Read(ref _keyDownSince);
+            int limit = _maxKeyDownMs();
+            if (since == 0 || limit <= 0 || Timebase.ElapsedMilliseconds(since) <= limit)
+                continue;
+
+            // Claim this key-down, unless a key-up (or a new key-down) got there first
+            if (Interlocked.CompareExchange(ref _keyDownSince, 0, since) != since)
+                continue;
+
+            Interlocked.Increment(ref _expiries);
+            try
+            {
+                _expired(since);
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine($"Key-down watchdog: {ex.Message}");
+            }
+        }
+    }
+}
@@ -0,0 +1,829 @@
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using NetKeyer.Audio;
+using NetKeyer.Helpers;
+using NetKeyer.Keying;
+using NetKeyer.Models;
+using NetKeyer.Realtime;
+
+namespace NetKeyer.Services;
+
+/// <summary>
+/// The keying core: owns all keyer state (mode, straight key/PTT edge tracking and the
+/// <see cref="IambicKeyer"/>) and is the only code that mutates it.
+///
+/// Input devices never touch that state directly. Their edges go into a lock-free queue and
+/// are applied in timestamp order by whichever thread is currently pumping the core, under a
+/// single pump lock:
+///  - the audio thread, at every sidetone callback (so element decisions made in
+///    OnBeforeSilenceEnd always see the latest edges, with sample accuracy), or
+///  - the dedicated "keying core" thread, woken by each enqueue, which covers the idle case
+///    where the audio device may not be calling back at all.
+/// Control calls from the UI and the connection code (radio, sidetone generator, transmit mode,
+/// Stop) never take the pump lock either, so the audio thread is never held up behind them: the
+/// change is queued for the core thread, and calls whose effect the caller relies on wait until
+/// it has been applied (a key-up sent by Stop() has reached the radio before the caller moves
+/// on). PTT edges in non-CW modes are handed to a <see cref="PttSequencer"/>, which sends MOX on
+/// its own thread.
+///
+/// Keyer parameters (speed, keying mode, pitch) are different: they are published as an
+/// immutable <see cref="KeyerParameters"/> snapshot without taking the lock, from the UI or
+/// straight from the radio's property events, and the core applies the latest snapshot at the
+/// next element boundary, or right away while the keyer is idle.
+///
+/// Lock order is pump lock, then sidetone generator lock: the core calls into the generator
+/// (tones, straight key sidetone, speed and pitch) with the pump lock held. The generator raises
+/// its events while holding its own lock, so the callbacks only try the pump lock and never wait
+/// for it. If another thread is pumping, the event goes into a second queue and that thread
+/// applies it before it lets go of the lock. That costs the event its sample accuracy, but only
+/// when it collides with an edge or parameter change being applied.
+/// </summary>
+public class KeyingController
+{
+    private const int INPUT_QUEUE_CAPACITY = 1024;
+    private const int DRAIN_BATCH_SIZE = 64;
+    private const int ENQUEUE_RETRIES = 16;
+    private const int TONE_EVENT_QUEUE_CAPACITY = 64;
+    private const int PTT_RELEASE_TIMEOUT_MS = 1000;
+
+    private IKeyingRadio _connectedRadio;
+    private uint _boundGuiClientHandle;
+    private ISidetoneGenerator _sidetoneGenerator;
+    private IambicKeyer _iambicKeyer;
+    private bool _isTransmitModeCW = true;
+    private bool _isSidetoneOnlyMode = false;
+    private bool _isIambicMode = true;
+
+    // Latest published keyer parameters (any thread), and the ones the core last applied
+    private KeyerParameters _parameters = KeyerParameters.Default;
+    private KeyerParameters _appliedParameters = KeyerParameters.Default;
+
+    // Initialization parameters
+    private Func<ushort> _timestampGenerator;
+    private Action<bool, ushort, uint> _cwKeyCallback;
+
+    // Previously applied input bits, for straight key and PTT edge detection
+    private byte _previousBits;
+
+    // Input edges waiting to be applied, and the lock held by whichever thread applies them
+    private readonly MpscQueue<PaddleState> _inputQueue = new MpscQueue<PaddleState>(INPUT_QUEUE_CAPACITY);
+    private readonly PaddleState[] _drainBatch = new PaddleState[DRAIN_BATCH_SIZE];
+    private readonly object _pumpLock = new object();
+    private bool _draining;
+    private long _droppedEdges;
+
+    // Sidetone events raised while another thread was pumping, for that thread to apply
+    private readonly MpscQueue<ToneEvent> _toneEvents = new MpscQueue<ToneEvent>(TONE_EVENT_QUEUE_CAPACITY);
+    private bool _applyingToneEvents;
+    private long _deferredToneEvents;
+
+    private enum ToneEvent
+    {
+        ToneStart,
+        ToneComplete,
+        BeforeSilenceEnd,
+        SilenceComplete
+    }
+
+    // Control changes waiting for the core thread, and how many it has applied
+    private readonly Queue<Action> _controlChanges = new Queue<Action>();
+    private readonly object _controlLock = new object();
+    private long _controlChangesPosted;
+    private long _controlChangesApplied;
+
+    private readonly RadioKeyTelemetry _telemetry = new RadioKeyTelemetry();
+    private readonly KeyDownWatchdog _watchdog;
+
+    // Set by the watchdog when it forces key-up, cleared by the core once it has applied it.
+    // While set no key-down reaches the radio
+    private bool _forcedKeyUp;
+    private readonly PttSequencer _pttSequencer;
+
+    private readonly AutoResetEvent _inputSignal = new AutoResetEvent(false);
+    private readonly Thread _coreThread;
+    private volatile bool _running = true;
+
+    private static readonly bool _keyerDebug = DebugCategory.Keyer.IsEnabled;
+
+    public KeyingController(ISidetoneGenerator sidetoneGenerator)
+    {
+        // Everything the callbacks and the core thread use exists before either can run
+        _watchdog = new KeyDownWatchdog(() => Volatile.Read(ref _parameters).MaxKeyDownMs, ForceKeyUp);
+        _pttSequencer = new PttSequencer(() => Volatile.Read(ref _parameters));
+
+        _sidetoneGenerator = sidetoneGenerator;
+        SubscribeSidetoneEvents(_sidetoneGenerator);
+
+        _coreThread = new Thread(CoreThreadLoop)
+        {
+            Name = "keying core",
+            IsBackground = true,
+            Priority = ThreadPriority.Highest
+        };
+        _coreThread.Start();
+
+        KeyingMetrics.SetInputQueueDepthSource(() => _inputQueue.Count);
+    }
+
+    /// <summary>
+    /// Number of input edges discarded because the queue was full.
+    /// </summary>
+    public long DroppedEdges => Interlocked.Read(ref _droppedEdges);
+
+    /// <summary>
+    /// Number of sidetone events that arrived while another thread was pumping the core, and
+    /// were applied by that thread instead of in the callback.
+    /// </summary>
+    public long DeferredToneEvents => Interlocked.Read(ref _deferredToneEvents);
+
+    /// <summary>
+    /// Latency histograms for key commands sent to the radio.
+    /// </summary>
+    public RadioKeyTelemetry Telemetry => _telemetry;
+
+    /// <summary>
+    /// Number of times the key-down watchdog forced the radio's key up.
+    /// </summary>
+    public long WatchdogKeyUps => _watchdog.Expiries;
+
+    /// <summary>
+    /// MOX commands and time to TX for PTT keying in non-CW modes.
+    /// </summary>
+    public PttSequencer Ptt => _pttSequencer;
+
+    /// <summary>
+    /// True while the last key command sent to the radio was a key-down.
+    /// </summary>
+    public bool IsRadioKeyDown => _telemetry.KeyDown;
+
+    /// <summary>
+    /// The most recently published keyer parameters, which may not have been applied yet.
+    /// </summary>
+    public KeyerParameters Parameters => Volatile.Read(ref _parameters);
+
+    /// <summary>
+    /// The keyer parameters the core is currently keying with.
+    /// </summary>
+    public KeyerParameters AppliedParameters => Volatile.Read(ref _appliedParameters);
+
+    public void Initialize(uint guiClientHandle, Func<ushort> timestampGenerator, Action<bool, ushort, uint> cwKeyCallback)
+    {
+        RunOnCore(() =>
+        {
+            _boundGuiClientHandle = guiClientHandle;
+            _timestampGenerator = timestampGenerator;
+            _cwKeyCallback = cwKeyCallback;
+
+            // Without a sidetone generator (audio still starting up) the keyer is created
+            // when one is attached
+            CreateIambicKeyer();
+        });
+    }
+
+    public void SetRadio(IKeyingRadio radio, bool isSidetoneOnly = false)
+    {
+        RunOnCore(() =>
+        {
+            DrainInputQueue();
+            _connectedRadio = radio;
+            _isSidetoneOnlyMode = isSidetoneOnly;
+            _telemetry.Attach(radio);
+            _watchdog.KeyUp();
+        });
+        _pttSequencer.SetRadio(radio);
+    }
+
+    public void SetSidetoneGenerator(ISidetoneGenerator sidetoneGenerator)
+    {
+        RunOnCore(() =>
+        {
+            UnsubscribeSidetoneEvents(_sidetoneGenerator);
+            _sidetoneGenerator = sidetoneGenerator;
+            SubscribeSidetoneEvents(_sidetoneGenerator);
+
+            // Pitch and speed only reach the generator from the parameters, so a new one
+            // starts from the applied set; later changes follow through ApplyPendingParameters
+            if (_sidetoneGenerator != null)
+            {
+                if (_appliedParameters.PitchHz != 0)
+                    _sidetoneGenerator.SetFrequency(_appliedParameters.PitchHz);
+                _sidetoneGenerator.SetWpm(_appliedParameters.Wpm);
+            }
+
+            // Update iambic keyer's sidetone generator without recreating the keyer
+            if (_iambicKeyer != null)
+                _iambicKeyer.UpdateSidetoneGenerator(_sidetoneGenerator);
+            else
+                CreateIambicKeyer();
+        });
+    }
+
+    /// <summary>
+    /// Called from the radio's property events; returns without waiting for the core.
+    /// </summary>
+    public void SetTransmitMode(bool isCW)
+    {
+        RunOnCore(() =>
+        {
+            DrainInputQueue();
+            _isTransmitModeCW = isCW;
+        }, wait: false);
+
+        // PTT keying ends with the non-CW mode; its release edge would now be ignored
+        if (isCW)
+            _pttSequencer.Release();
+    }
+
+    public void SetKeyingMode(bool isIambic, bool isModeB)
+    {
+        UpdateParameters(p => p.WithKeyingMode(isIambic, isModeB));
+    }
+
+    public void SetSpeed(int wpm)
+    {
+        UpdateParameters(p => p.WithWpm(wpm));
+    }
+
+    /// <summary>
+    /// Publishes a change to the keyer parameters. Lock-free, so it can be called directly
+    /// from FlexLib's event thread without waiting for the UI or for the audio thread to finish
+    /// a callback; the core applies it at the next element boundary. Returns the parameters
+    /// now published.
+    /// </summary>
+    /// <param name="update">Derives the new parameters from the current ones; may run more
+    /// than once if another update races with it.</param>
+    public KeyerParameters UpdateParameters(Func<KeyerParameters, KeyerParameters> update)
+    {
+        var current = Volatile.Read(ref _parameters);
+        while (true)
+        {
+            var updated = update(current);
+            if (ReferenceEquals(updated, current))
+                return current;
+
+            var seen = Interlocked.CompareExchange(ref _parameters, updated, current);
+            if (ReferenceEquals(seen, current))
+            {
+                // Wake the core in case the keyer is idle and nothing else will pump it
+                _inputSignal.Set();
+                return updated;
+            }
+            current = seen;
+        }
+    }
+
+    /// <summary>
+    /// Queues an input edge for the keying core. Never blocks or allocates, so it is safe
+    /// to call directly from device callback threads.
+    /// </summary>
+    public void HandlePaddleStateChange(PaddleState state)
+    {
+        KeyingMetrics.RecordPaddleEdge();
+
+        int attempts = 0;
+        while (!_inputQueue.TryEnqueue(state))
+        {
+            // Only reachable if the core has stalled; give it a moment, then drop
+            if (++attempts > ENQUEUE_RETRIES)
+            {
+                Interlocked.Increment(ref _droppedEdges);
+                if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[KeyingController] Input queue full, dropped {state}");
+                return;
+            }
+            _inputSignal.Set();
+            Thread.Yield();
+        }
+
+        _inputSignal.Set();
+    }
+
+    public void HandlePaddleStateChange(bool leftPaddle, bool rightPaddle, bool straightKey, bool ptt)
+    {
+        HandlePaddleStateChange(new PaddleState(leftPaddle, rightPaddle, straightKey, ptt, Timebase.Now));
+    }
+
+    public void Stop()
+    {
+        RunOnCore(() =>
+        {
+            DrainInputQueue();
+            _iambicKeyer?.Stop();
+        });
+
+        // MOX is off too before the caller moves on (typically to disconnect)
+        _pttSequencer.Release();
+        if (!_pttSequencer.WaitForRelease(PTT_RELEASE_TIMEOUT_MS))
+            Console.WriteLine("PTT release not confirmed: the MOX off command is still being sent");
+    }
+
+    public void ResetState()
+    {
+        RunOnCore(() =>
+        {
+            // Edges still queued belong to the device being closed
+            while (_inputQueue.TryDequeue(out _)) { }
+            _previousBits = 0;
+        });
+    }
+
+    public void Dispose()
+    {
+        _running = false;
+        _inputSignal.Set();
+        if (Thread.CurrentThread != _coreThread)
+            _coreThread.Join();
+        lock (_controlLock)
+        {
+            // Release callers waiting for a change the core will now never apply
+            Monitor.PulseAll(_controlLock);
+        }
+        _watchdog.Dispose();
+        _pttSequencer.Dispose();
+
+        lock (_pumpLock)
+        {
+            UnsubscribeSidetoneEvents(_sidetoneGenerator);
+            _iambicKeyer?.Dispose();
+            _iambicKeyer = null;
+            _telemetry.Dispose();
+        }
+    }
+
+    private void CreateIambicKeyer()
+    {
+        if (_sidetoneGenerator == null || _timestampGenerator == null)
+            return;
+
+        _iambicKeyer = new IambicKeyer(
+            _sidetoneGenerator,
+            _boundGuiClientHandle,
+            _timestampGenerator,
+            SendKeyerElement
+        )
+        {
+            IsModeB = _appliedParameters.IsModeB
+        };
+        _iambicKeyer.SetWpm(_appliedParameters.Wpm);
+    }
+
+    /// <summary>
+    /// Queues a control change for the core thread to apply with the pump lock held and, if
+    /// <paramref name="wait"/>, returns once it has been applied. Changes are applied in the
+    /// order they were queued.
+    /// </summary>
+    private void RunOnCore(Action change, bool wait = true)
+    {
+        long ticket;
+        lock (_controlLock)
+        {
+            _controlChanges.Enqueue(change);
+            ticket = ++_controlChangesPosted;
+        }
+        _inputSignal.Set();
+
+        if (!wait)
+            return;
+
+        lock (_controlLock)
+        {
+            while (_controlChangesApplied < ticket && _running)
+                Monitor.Wait(_controlLock);
+        }
+    }
+
+    // ---- core ----
+
+    private void CoreThreadLoop()
+    {
+        while (_running)
+        {
+            _inputSignal.WaitOne();
+            RealtimeProfile.EnterThread(RealtimeThreadRole.Keying);
+
+            lock (_pumpLock)
+            {
+                ApplyToneEvents();
+                ApplyControlChanges();
+                ApplyPendingParameters();
+                DrainInputQueue();
+                ApplyToneEvents();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Applies the queued control changes. Must be called with the pump lock held, on the core
+    /// thread.
+    /// </summary>
+    private void ApplyControlChanges()
+    {
+        while (true)
+        {
+            Action change;
+            lock (_controlLock)
+            {
+                if (!_controlChanges.TryDequeue(out change))
+                    return;
+            }
+
+            try
+            {
+                change();
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine($"Keying core control change failed: {ex.Message}");
+            }
+
+            lock (_controlLock)
+            {
+                _controlChangesApplied++;
+                Monitor.PulseAll(_controlLock);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Applies the latest published keyer parameters. Must be called with the pump lock held.
+    /// While an iambic element or its trailing space is in progress the change waits, unless
+    /// <paramref name="elementBoundary"/> says the keyer is about to choose its next element,
+    /// so an element's timing never changes underneath it.
+    /// </summary>
+    private void ApplyPendingParameters(bool elementBoundary = false)
+    {
+        var parameters = Volatile.Read(ref _parameters);
+        var applied = _appliedParameters;
+        if (ReferenceEquals(parameters, applied))
+            return;
+        if (!elementBoundary && _isIambicMode && _iambicKeyer != null && !_iambicKeyer.IsIdle)
+            return;
+
+        if (parameters.Wpm != applied.Wpm)
+        {
+            _iambicKeyer?.SetWpm(parameters.Wpm);
+            _sidetoneGenerator?.SetWpm(parameters.Wpm);
+        }
+
+        if (parameters.PitchHz != applied.PitchHz && parameters.PitchHz != 0)
+            _sidetoneGenerator?.SetFrequency(parameters.PitchHz);
+
+        if (_iambicKeyer != null)
+            _iambicKeyer.IsModeB = parameters.IsModeB;
+
+        if (parameters.IsIambic != _isIambicMode)
+        {
+            _isIambicMode = parameters.IsIambic;
+
+            // Stop keyer when switching to straight key mode
+            if (!_isIambicMode)
+                _iambicKeyer?.Stop();
+        }
+
+        // Paddle swap is applied where edges are read, ahead of the queue
+        Volatile.Write(ref _appliedParameters, parameters);
+        if (_keyerDebug) DebugLogger.Log(DebugCategory.Keyer, $"[KeyingController] Applied {parameters}{(elementBoundary ? " at element boundary" : "")}");
+    }
+
+    /// <summary>
+    /// Applies every queued edge in timestamp order. Must be called with the pump lock held.
+    /// Edges from different devices can arrive out of order (evdev and network inputs carry
+    /// source timestamps), so each batch is sorted before it is applied.
+    /// </summary>
+    private void DrainInputQueue()
+    {
+        // Applying an edge can start a tone, and the generator fires OnToneStart synchronously
+        // back into us; don't recurse into the queue from there
+        if (_draining)
+            return;
+
+        _draining = true;
+        try
+        {
+            var batch = _drainBatch;
+            while (true)
+            {
+                int count = 0;
+                while (count < batch.Length && _inputQueue.TryDequeue(out batch[count]))
+                    count++;
+                if (count == 0)
+                    break;
+
+                // Insertion sort: batches are tiny and almost always already in order
+                for (int i = 1; i < count; i++)
+                {
+                    var edge = batch[i];
+                    int j = i - 1;
+                    while (j >= 0 && batch[j].Timestamp > edge.Timestamp)
+                    {
+                        batch[j + 1] = batch[j];
+                        j--;
+                    }
+                    batch[j + 1] = edge;
+                }
+
+                for (int i = 0; i < count; i++)
+                    ApplyPaddleState(batch[i]);
+            }
+        }
+        finally
+        {
+            _draining = false;
+        }
+    }
+
+    private void ApplyPaddleState(PaddleState state)
+    {
+        bool straightKeyChanged = ((state.Bits ^ _previousBits) & PaddleState.StraightKeyBit) != 0;
+        bool pttChanged = ((state.Bits ^ _previousBits) & PaddleState.PttBit) != 0;
+
+        // Handle keying based on mode and transmit slice mode
+        if (_connectedRadio != null && _boundGuiClientHandle != 0)
+        {
+            if (_isTransmitModeCW)
+            {
+                // CW mode - use paddle/straight key keying
+                if (_isIambicMode)
+                {
+                    // Iambic mode - use paddle inputs
+                    _iambicKeyer?.UpdatePaddleState(state.LeftPaddle, state.RightPaddle);
+                }
+                else
+                {
+                    // Straight key mode - use straight key input
+                    // (InputDeviceManager sets this to OR of both paddles for serial input)
+                    if (straightKeyChanged)
+                    {
+                        SendCWKey(state.StraightKey, state.Timestamp);
+                    }
+                }
+            }
+            else
+            {
+                // Non-CW mode - use PTT keying, sequenced and sent off this thread
+                if (pttChanged)
+                {
+                    _pttSequencer.SetPtt(state.PTT, state.Timestamp);
+                }
+            }
+        }
+        else if (_isSidetoneOnlyMode)
+        {
+            // Sidetone-only mode - still run keyer logic, just no radio commands
+            if (_isIambicMode)
+            {
+                _iambicKeyer?.UpdatePaddleState(state.LeftPaddle, state.RightPaddle);
+            }
+            else
+            {
+                // Straight key mode - use straight key input
+                // (InputDeviceManager sets this to OR of both paddles for serial input)
+                if (straightKeyChanged)
+                {
+                    SendCWKey(state.StraightKey, state.Timestamp);
+                }
+            }
+        }
+
+        _previousBits = state.Bits;
+    }
+
+    // ---- sidetone callbacks (audio thread, or whichever thread started the tone) ----
+    // In straight key mode the sidetone follows the key directly; the idle iambic keyer must
+    // not react to those tones, or it sends a second key-up when each one ends.
+
+    private void SubscribeSidetoneEvents(ISidetoneGenerator generator)
+    {
+        if (generator == null)
+            return;
+
+        generator.OnToneStart += OnToneStart;
+        generator.OnToneComplete += OnToneComplete;
+        generator.OnBeforeSilenceEnd += OnBeforeSilenceEnd;
+        generator.OnSilenceComplete += OnSilenceComplete;
+    }
+
+    private void UnsubscribeSidetoneEvents(ISidetoneGenerator generator)
+    {
+        if (generator == null)
+            return;
+
+        generator.OnToneStart -= OnToneStart;
+        generator.OnToneComplete -= OnToneComplete;
+        generator.OnBeforeSilenceEnd -= OnBeforeSilenceEnd;
+        generator.OnSilenceComplete -= OnSilenceComplete;
+    }
+
+    private void OnToneStart() => HandleToneEvent(ToneEvent.ToneStart);
+
+    private void OnToneComplete() => HandleToneEvent(ToneEvent.ToneComplete);
+
+    private void OnBeforeSilenceEnd() => HandleToneEvent(ToneEvent.BeforeSilenceEnd);
+
+    private void OnSilenceComplete() => HandleToneEvent(ToneEvent.SilenceComplete);
+
+    /// <summary>
+    /// Runs with the generator's lock held. Waiting for the pump lock here could deadlock with
+    /// a core thread that holds it and is waiting for the generator, so if the lock is taken
+    /// the event is queued for whoever holds it.
+    /// </summary>
+    private void HandleToneEvent(ToneEvent toneEvent)
+    {
+        if (!Monitor.TryEnter(_pumpLock))
+        {
+            Interlocked.Increment(ref _deferredToneEvents);
+            if (!_toneEvents.TryEnqueue(toneEvent))
+                Console.WriteLine($"Keying core stalled, dropped sidetone event {toneEvent}");
+            else if (_keyerDebug)
+                DebugLogger.Log(DebugCategory.Keyer, $"[KeyingController] Core busy, deferred {toneEvent}");
+
+            // The holder may be past its last look at the queue; the core applies it then
+            _inputSignal.Set();
+            return;
+        }
+
+        try
+        {
+            // Events deferred earlier come first
+            ApplyToneEvents();
+            ApplyToneEvent(toneEvent);
+        }
+        finally
+        {
+            Monitor.Exit(_pumpLock);
+        }
+    }
+
+    /// <summary>
+    /// Applies the deferred sidetone events in the order they were raised. Must be called with
+    /// the pump lock held. A tone started while applying one raises OnToneStart straight back
+    /// into us; that event is applied then, and the rest of the queue after it.
+    /// </summary>
+    private void ApplyToneEvents()
+    {
+        if (_applyingToneEvents)
+            return;
+
+        _applyingToneEvents = true;
+        try
+        {
+            while (_toneEvents.TryDequeue(out var toneEvent))
+                ApplyToneEvent(toneEvent);
+        }
+        finally
+        {
+            _applyingToneEvents = false;
+        }
+    }
+
+    private void ApplyToneEvent(ToneEvent toneEvent)
+    {
+        DrainInputQueue();
+        switch (toneEvent)
+        {
+            case ToneEvent.ToneStart:
+                if (_isIambicMode)
+                    _iambicKeyer?.HandleToneStart();
+                break;
+
+            case ToneEvent.ToneComplete:
+                if (_isIambicMode)
+                    _iambicKeyer?.HandleToneComplete();
+                break;
+
+            case ToneEvent.BeforeSilenceEnd:
+                ApplyPendingParameters(elementBoundary: true);
+                if (_isIambicMode)
+                    _iambicKeyer?.HandleBeforeSilenceEnd();
+                break;
+
+            case ToneEvent.SilenceComplete:
+                if (_isIambicMode)
+                    _iambicKeyer?.HandleSilenceComplete();
+                ApplyPendingParameters();
+                break;
+        }
+    }
+
+    private void SendCWKey(bool state, long edgeTimestamp)
+    {
+        // The watchdog's key-up wins over a key-down the core hasn't caught up with yet
+        if (state && Volatile.Read(ref _forcedKeyUp))
+            return;
+
+        // Control sidetone
+        if (state)
+        {
+            KeyingMetrics.RecordElement();
+            _sidetoneGenerator?.Start();
+        }
+        else
+        {
+            _sidetoneGenerator?.Stop();
+        }
+
+        // Send to radio if connected (not in sidetone-only mode)
+        if (_connectedRadio != null && _boundGuiClientHandle != 0)
+        {
+            try
+            {
+                // Stamp with the time the edge was captured, not when it was applied
+                ushort radioTimestamp = Timebase.ToRadioTimestamp(edgeTimestamp);
+
+                long sendStart = Timebase.Now;
+                using var trace = KeyingTrace.Span("radio cw key", state ? 1 : 0);
+                _connectedRadio.CWKey(state, radioTimestamp, _boundGuiClientHandle);
+                _telemetry.RecordSend(state, edgeTimestamp, sendStart, Timebase.Now);
+                if (state)
+                    _watchdog.KeyDown(sendStart);
+                else
+                    _watchdog.KeyUp();
+            }
+            catch { }
+        }
+    }
+
+    /// <summary>
+    /// Radio key sink for the iambic keyer (audio thread).
+    /// </summary>
+    private void SendKeyerElement(bool state, ushort timestamp, uint clientHandle)
+    {
+        if (_cwKeyCallback == null)
+            return;
+        if (state && Volatile.Read(ref _forcedKeyUp))
+            return;
+
+        long sendStart = Timebase.Now;
+        using var trace = KeyingTrace.Span("radio cw key", state ? 1 : 0);
+        _cwKeyCallback(state, timestamp, clientHandle);
+        if (_connectedRadio != null)
+        {
+            _telemetry.RecordSend(state, 0, sendStart, Timebase.Now);
+            if (state)
+                _watchdog.KeyDown(sendStart);
+            else
+                _watchdog.KeyUp();
+        }
+    }
+
+    /// <summary>
+    /// Key-down watchdog expiry (watchdog thread): the radio has been keyed longer than
+    /// <see cref="KeyerParameters.MaxKeyDownMs"/>, whatever the audio device is doing.
+    ///
+    /// The key-up itself is applied by the core, like any other control change, so it is
+    /// ordered with the keying that caused it. The watchdog doesn't wait for that: whoever is
+    /// pumping the core may be what is stuck, inside an audio or radio call. It latches
+    /// <see cref="_forcedKeyUp"/>, which holds back every key-down until the core has caught
+    /// up, and keys the radio up directly as well, since the radio's command path is
+    /// thread-safe. A key-down already past the latch can still reach the radio after that
+    /// direct key-up, but the core's own key-up comes after it.
+    /// </summary>
+    private void ForceKeyUp(long keyDownSince)
+    {
+        long heldMs = Timebase.ToMillisecondsLong(Timebase.Now - keyDownSince);
+        KeyingTrace.InstantAt("watchdog key-down", keyDownSince, heldMs);
+        using var trace = KeyingTrace.Span("watchdog key-up", heldMs);
+        KeyingMetrics.RecordWatchdogKeyUp();
+        Console.WriteLine($"Radio keyed for {heldMs} ms (limit {Volatile.Read(ref _parameters).MaxKeyDownMs} ms), forcing key-up");
+
+        Volatile.Write(ref _forcedKeyUp, true);
+        RunOnCore(ApplyForcedKeyUp, wait: false);
+        SendRadioKeyUp();
+    }
+
+    /// <summary>
+    /// The core's half of <see cref="ForceKeyUp"/>. The iambic keyer sends the key-up through
+    /// its own sink and goes idle, so the next paddle press starts cleanly even if the audio
+    /// device never calls back. In straight key mode the sidetone stops with the key; a
+    /// straight key still held down stays ignored until it is released.
+    /// </summary>
+    private void ApplyForcedKeyUp()
+    {
+        if (_isIambicMode && _iambicKeyer != null)
+        {
+            _iambicKeyer.Abort();
+        }
+        else
+        {
+            _sidetoneGenerator?.Stop();
+            SendRadioKeyUp();
+        }
+        _watchdog.KeyUp();
+        Volatile.Write(ref _forcedKeyUp, false);
+    }
+
+    private void SendRadioKeyUp()
+    {
+        var radio = _connectedRadio;
+        if (radio == null || _boundGuiClientHandle == 0)
+            return;
+
+        try
+        {
+            long sendStart = Timebase.Now;
+            radio.CWKey(false, Timebase.ToRadioTimestamp(sendStart), _boundGuiClientHandle);
+            _telemetry.RecordSend(false, 0, sendStart, Timebase.Now);
+        }
+        catch { }
+    }
+}
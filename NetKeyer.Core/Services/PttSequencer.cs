@@ -0,0 +1,264 @@
+using System;
+using System.Threading;
+using NetKeyer.Helpers;
+using NetKeyer.Keying;
+
+namespace NetKeyer.Services;
+
+/// <summary>
+/// Turns PTT input edges into MOX commands for non-CW modes, on its own thread, so the keying
+/// core never waits on the radio's MOX property set.
+///
+/// Timing runs on <see cref="Timebase"/> from each edge's capture timestamp, not from when the
+/// edge was applied. MOX goes on once PTT has been held for the debounce time and goes off once
+/// it has been released for the hang time, so a press shorter than the debounce and a release
+/// shorter than the hang send nothing. The debounce delays MOX itself, and the radio's own TX
+/// delay still comes after it. The input is a single slot holding the latest edge: edges
+/// that arrive while a MOX command is still being sent are collapsed into the state they end
+/// in, so choppy PTT input never queues up a run of toggles.
+///
+/// Reports the MOX command count (<see cref="KeyingMetrics"/> carries the rate) and time to
+/// TX, from the PTT press to the radio reporting TRANSMITTING. With NETKEYER_DEBUG=ptt each
+/// command is logged.
+/// </summary>
+public sealed class PttSequencer : IDisposable
+{
+    private static readonly bool _debug = DebugCategory.Ptt.IsEnabled;
+
+    private readonly Func<KeyerParameters> _parameters;
+    private readonly AutoResetEvent _signal = new AutoResetEvent(false);
+    private readonly object _sendLock = new object();
+    private readonly object _releaseLock = new object();
+    private readonly Thread _thread;
+    private volatile bool _running = true;
+
+    // Latest PTT edge: capture timestamp shifted left one bit, PTT state in bit 0. 0 means none
+    private long _input;
+
+    // Guarded by the send lock
+    private IKeyingRadio _radio;
+    private bool _moxOn;
+
+    // Releases asked for, and how many of them the sequencer thread has carried out
+    private long _releasesRequested;
+    private long _releasesDone;
+
+    private long _pendingPress;
+    private long _moxCommands;
+    private long _lastTimeToTxTicks;
+
+    /// <param name="parameters">Latest keyer parameters, for the debounce and hang times.</param>
+    public PttSequencer(Func<KeyerParameters> parameters)
+    {
+        _parameters = parameters ?? throw new ArgumentNullException(nameof(parameters));
+
+        _thread = new Thread(SequenceLoop)
+        {
+            Name = "PTT sequencer",
+            IsBackground = true,
+            Priority = ThreadPriority.AboveNormal
+        };
+        _thread.Start();
+    }
+
+    /// <summary>
+    /// MOX commands sent to the radio.
+    /// </summary>
+    public long MoxCommands => Interlocked.Read(ref _moxCommands);
+
+    /// <summary>
+    /// PTT press to the radio transmitting, for the most recent transmission, in
+    /// milliseconds; 0 until the radio has acknowledged one.
+    /// </summary>
+    public double LastTimeToTxMs => Timebase.ToMilliseconds(Interlocked.Read(ref _lastTimeToTxTicks));
+
+    public void SetRadio(IKeyingRadio radio)
+    {
+        lock (_sendLock)
+        {
+            if (Equals(radio, _radio))
+                return;
+
+            if (_radio != null)
+                _radio.TransmittingChanged -= Radio_TransmittingChanged;
+            _radio = radio;
+            _moxOn = false;
+            Interlocked.Exchange(ref _input, 0);
+            Interlocked.Exchange(ref _pendingPress, 0);
+            if (_radio != null)
+                _radio.TransmittingChanged += Radio_TransmittingChanged;
+        }
+    }
+
+    /// <summary>
+    /// A PTT edge captured at <paramref name="timestamp"/>. Never blocks.
+    /// </summary>
+    public void SetPtt(bool down, long timestamp)
+    {
+        KeyingTrace.Instant("ptt", down ? 1 : 0);
+        Interlocked.Exchange(ref _input, (timestamp << 1) | (down ? 1L : 0L));
+        _signal.Set();
+    }
+
+    /// <summary>
+    /// Drops MOX without the hang time, for leaving PTT keying (disconnecting, or the transmit
+    /// slice changing to CW). PTT held down at the time is ignored until it is pressed again.
+    /// Never blocks: the command is sent on the sequencer thread; use
+    /// <see cref="WaitForRelease"/> to wait for it.
+    /// </summary>
+    public void Release()
+    {
+        Interlocked.Exchange(ref _input, 0);
+        Interlocked.Increment(ref _releasesRequested);
+        _signal.Set();
+    }
+
+    /// <summary>
+    /// Waits until every release requested so far has been sent. Returns false if that takes
+    /// longer than <paramref name="timeoutMs"/>, e.g. because the radio is not answering.
+    /// </summary>
+    public bool WaitForRelease(int timeoutMs)
+    {
+        long requested = Interlocked.Read(ref _releasesRequested);
+        long deadline = Timebase.Now + Timebase.FromMilliseconds(timeoutMs);
+        lock (_releaseLock)
+        {
+            while (Interlocked.Read(ref _releasesDone) < requested && _running)
+            {
+                int remainingMs = (int)Math.Ceiling(Timebase.ToMilliseconds(deadline - Timebase.Now));
+                if (remainingMs <= 0 || !Monitor.Wait(_releaseLock, remainingMs))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    public void Dispose()
+    {
+        _running = false;
+        _signal.Set();
+        if (Thread.CurrentThread != _thread)
+            _thread.Join();
+        lock (_releaseLock)
+        {
+            Monitor.PulseAll(_releaseLock);
+        }
+
+        lock (_sendLock)
+        {
+            if (_radio != null)
+                _radio.TransmittingChanged -= Radio_TransmittingChanged;
+            _radio = null;
+        }
+    }
+
+    private void SequenceLoop()
+    {
+        while (_running)
+        {
+            int waitMs;
+            lock (_sendLock)
+            {
+                ApplyRelease();
+                waitMs = Sequence();
+            }
+            if (waitMs != 0)
+                _signal.WaitOne(waitMs);
+        }
+    }
+
+    /// <summary>
+    /// Carries out the releases asked for since the last pass. Must be called with the send
+    /// lock held.
+    /// </summary>
+    private void ApplyRelease()
+    {
+        long requested = Interlocked.Read(ref _releasesRequested);
+        if (requested == Interlocked.Read(ref _releasesDone))
+            return;
+
+        if (_moxOn && _radio != null)
+            SendMox(false, Timebase.Now);
+
+        lock (_releaseLock)
+        {
+            Interlocked.Exchange(ref _releasesDone, requested);
+            Monitor.PulseAll(_releaseLock);
+        }
+    }
+
+    /// <summary>
+    /// Sends the MOX command the latest edge calls for, if it is due. Returns how long to wait
+    /// before the next deadline: 0 to run again at once, <see cref="Timeout.Infinite"/> for
+    /// none. Must be called with the send lock held.
+    /// </summary>
+    private int Sequence()
+    {
+        long input = Interlocked.Read(ref _input);
+        if (input == 0 || _radio == null)
+            return Timeout.Infinite;
+
+        bool down = (input & 1) != 0;
+        long edge = input >> 1;
+        var parameters = _parameters();
+        long now = Timebase.Now;
+
+        // Pressed again during the hang time, or released again during the debounce: nothing
+        // to send, and nothing left to wait for
+        if (down == _moxOn)
+            return Timeout.Infinite;
+
+        long due = edge + Timebase.FromMilliseconds(down ? parameters.PttDebounceMs : parameters.PttHangMs);
+        if (now < due)
+            return Math.Max(1, (int)Math.Ceiling(Timebase.ToMilliseconds(due - now)));
+
+        SendMox(down, edge);
+        return 0;
+    }
+
+    /// <summary>
+    /// Must be called with the send lock held.
+    /// </summary>
+    private void SendMox(bool on, long edge)
+    {
+        // Before the command: the radio can report TRANSMITTING before SetMox returns
+        Interlocked.Exchange(ref _pendingPress, on ? edge : 0);
+
+        long sendStart = Timebase.Now;
+        using (KeyingTrace.Span("radio mox", on ? 1 : 0))
+        {
+            try
+            {
+                _radio.SetMox(on);
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine($"MOX {(on ? "on" : "off")} failed: {ex.Message}");
+            }
+        }
+
+        // Even if the command failed: retrying would only repeat it on every edge
+        _moxOn = on;
+        Interlocked.Increment(ref _moxCommands);
+        KeyingMetrics.RecordMoxCommand();
+
+        if (_debug) DebugLogger.Log(DebugCategory.Ptt, $"[PttSequencer] MOX {(on ? "on" : "off")} {Timebase.ToMilliseconds(sendStart - edge):F1} ms after the PTT edge, set took {Timebase.ElapsedMilliseconds(sendStart):F1} ms ({MoxCommands} commands)");
+    }
+
+    private void Radio_TransmittingChanged(bool transmitting)
+    {
+        if (!transmitting)
+            return;
+
+        long press = Interlocked.Exchange(ref _pendingPress, 0);
+        if (press == 0)
+            return;
+
+        // No timeout needed: MOX off clears the pending press, so this is always the
+        // transmission it started
+        long ticks = Timebase.Now - press;
+        Interlocked.Exchange(ref _lastTimeToTxTicks, ticks);
+        KeyingMetrics.RecordPttTimeToTx(ticks);
+        if (_debug) DebugLogger.Log(DebugCategory.Ptt, $"[PttSequencer] Transmitting {Timebase.ToMilliseconds(ticks):F1} ms after PTT press");
+    }
+}
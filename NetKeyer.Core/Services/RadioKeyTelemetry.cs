@@ -0,0 +1,170 @@
+using System;
+using System.Threading;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Services;
+
+/// <summary>
+/// Latency telemetry for the radio key sink, separating our own latency from the network's
+/// and the radio's:
+///  - queue: input edge timestamp to the CWKey call (straight key; the iambic keyer's
+///    elements are clock-driven and have no input edge),
+///  - send: duration of the CWKey call itself,
+///  - ack: key-down sent to the radio reporting interlock state TRANSMITTING, when the key
+///    was up before. This includes the network both ways and the radio's break-in.
+/// Recording never blocks or allocates. With NETKEYER_DEBUG=radio-latency a summary is
+/// logged periodically while keying.
+/// </summary>
+public class RadioKeyTelemetry : IDisposable
+{
+    private const int SUMMARY_INTERVAL_MS = 30000;
+    private const int ACK_TIMEOUT_MS = 2000;
+
+    private static readonly bool _debug = DebugCategory.RadioLatency.IsEnabled;
+
+    private readonly Timer _summaryTimer;
+    private IKeyingRadio _radio;
+    private volatile bool _transmitting;
+    private volatile bool _keyDown;
+    private long _pendingKeyDown;
+    private long _keyCommands;
+    private long _unacknowledgedKeyDowns;
+    private long _lastSummaryCommands;
+    private long _lastSummaryTimestamp = Timebase.Now;
+
+    public RadioKeyTelemetry()
+    {
+        if (_debug)
+            _summaryTimer = new Timer(_ => LogSummary(), null, SUMMARY_INTERVAL_MS, SUMMARY_INTERVAL_MS);
+    }
+
+    public LatencyHistogram Queue { get; } = new LatencyHistogram("queue");
+    public LatencyHistogram Send { get; } = new LatencyHistogram("send");
+    public LatencyHistogram Ack { get; } = new LatencyHistogram("ack");
+
+    public long KeyCommands => Interlocked.Read(ref _keyCommands);
+
+    /// <summary>
+    /// State of the last key command sent.
+    /// </summary>
+    public bool KeyDown => _keyDown;
+
+    /// <summary>
+    /// Key-downs the radio didn't acknowledge with TRANSMITTING within two seconds
+    /// (transmit inhibited, break-in off, or the status was lost).
+    /// </summary>
+    public long UnacknowledgedKeyDowns => Interlocked.Read(ref _unacknowledgedKeyDowns);
+
+    /// <summary>
+    /// Starts watching <paramref name="radio"/>'s interlock state. Samples from the previous
+    /// radio are discarded.
+    /// </summary>
+    public void Attach(IKeyingRadio radio)
+    {
+        if (Equals(radio, _radio))
+            return;
+
+        Detach();
+        Reset();
+
+        _radio = radio;
+        if (_radio != null)
+        {
+            _transmitting = _radio.IsTransmitting;
+            _radio.TransmittingChanged += Radio_TransmittingChanged;
+        }
+    }
+
+    public void Detach()
+    {
+        if (_radio != null)
+        {
+            _radio.TransmittingChanged -= Radio_TransmittingChanged;
+            _radio = null;
+        }
+        Interlocked.Exchange(ref _pendingKeyDown, 0);
+    }
+
+    /// <summary>
+    /// Records one CWKey call.
+    /// </summary>
+    /// <param name="down">Key state sent.</param>
+    /// <param name="queuedTimestamp">Timestamp of the input edge that caused it, or 0 if none.</param>
+    /// <param name="sendStart">Timestamp taken just before the call.</param>
+    /// <param name="sendEnd">Timestamp taken just after the call returned.</param>
+    public void RecordSend(bool down, long queuedTimestamp, long sendStart, long sendEnd)
+    {
+        Interlocked.Increment(ref _keyCommands);
+        _keyDown = down;
+        if (queuedTimestamp != 0)
+            Queue.Record(sendStart - queuedTimestamp);
+        Send.Record(sendEnd - sendStart);
+        KeyingMetrics.RecordRadioSend(sendEnd - sendStart);
+
+        if (!down || _transmitting)
+            return;
+
+        // Time the first key-down of each transmission; later ones are covered by the
+        // same TRANSMITTING state
+        long pending = Interlocked.Read(ref _pendingKeyDown);
+        if (pending != 0 && Timebase.ToMillisecondsLong(sendStart - pending) < ACK_TIMEOUT_MS)
+            return;
+        if (pending != 0)
+            Interlocked.Increment(ref _unacknowledgedKeyDowns);
+        Interlocked.Exchange(ref _pendingKeyDown, sendStart);
+    }
+
+    public void Reset()
+    {
+        Queue.Reset();
+        Send.Reset();
+        Ack.Reset();
+        Interlocked.Exchange(ref _keyCommands, 0);
+        Interlocked.Exchange(ref _unacknowledgedKeyDowns, 0);
+        Interlocked.Exchange(ref _pendingKeyDown, 0);
+        _lastSummaryCommands = 0;
+        _lastSummaryTimestamp = Timebase.Now;
+    }
+
+    private void Radio_TransmittingChanged(bool transmitting)
+    {
+        long now = Timebase.Now;
+        _transmitting = transmitting;
+        if (!_transmitting)
+            return;
+
+        long pending = Interlocked.Exchange(ref _pendingKeyDown, 0);
+        if (pending != 0)
+        {
+            Ack.Record(now - pending);
+            KeyingMetrics.RecordRadioAck(now - pending);
+        }
+    }
+
+    private void LogSummary()
+    {
+        long commands = KeyCommands;
+        long now = Timebase.Now;
+        long interval = commands - _lastSummaryCommands;
+        double seconds = Timebase.ToMilliseconds(now - _lastSummaryTimestamp) / 1000.0;
+        _lastSummaryCommands = commands;
+        _lastSummaryTimestamp = now;
+
+        // Nothing new to say while the key is idle
+        if (interval == 0)
+            return;
+
+        DebugLogger.Log(DebugCategory.RadioLatency, $"[RadioKeyTelemetry] {commands} key commands, {interval / seconds:F1}/s over the last {seconds:F0} s, {UnacknowledgedKeyDowns} key-downs unacknowledged");
+        DebugLogger.Log(DebugCategory.RadioLatency, $"[RadioKeyTelemetry]   {Queue}");
+        DebugLogger.Log(DebugCategory.RadioLatency, $"[RadioKeyTelemetry]   {Send}");
+        DebugLogger.Log(DebugCategory.RadioLatency, $"[RadioKeyTelemetry]   {Ack}");
+    }
+
+    public void Dispose()
+    {
+        _summaryTimer?.Dispose();
+        if (_debug)
+            LogSummary();
+        Detach();
+    }
+}
@@ -17,8 +17,12 @@
 // located at the root of this source code repository.
 // ------------------------------------------------------------
 using Avalonia;
+using NetKeyer.Helpers;
+using NetKeyer.Midi;
+using NetKeyer.Services;
 using System;
 using System.IO;
+using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using Velopack;
 
@@ -38,6 +42,26 @@ sealed class Program
         // Velopack: Handle app installation/update events before starting the main app
         VelopackApp.Build().Run();
 
+        // Whole-session keying trace, if NETKEYER_TRACE is set
+        KeyingTrace.StartFromEnvironment();
+
+        // Local Prometheus endpoint for the keying metrics, if NETKEYER_METRICS_PORT is set
+        MetricsEndpoint.StartFromEnvironment();
+
+        // Keying daemon with no UI, for a PC that only bridges a paddle to the radio
+        if (HeadlessKeyer.IsRequested(args))
+        {
+            Environment.ExitCode = HeadlessKeyer.Run(args);
+            return;
+        }
+
+        RunDesktop(args);
+    }
+
+    // Kept out of Main so headless mode never loads the Avalonia assemblies
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    private static void RunDesktop(string[] args)
+    {
         BuildAvaloniaApp().StartWithClassicDesktopLifetime(args);
     }
 
@@ -50,12 +74,13 @@ sealed class Program
 
     /// <summary>
     /// Configures native library loading for cross-platform compatibility.
-    /// Registers a resolver for the netkeyer_midi_shim native library so that
-    /// it is found in the application's base directory regardless of platform.
+    /// Registers a resolver for the netkeyer_midi_shim native library (imported by
+    /// NetKeyer.Core) so that it is found in the application's base directory
+    /// regardless of platform.
     /// </summary>
     private static void ConfigureNativeLibraries()
     {
-        NativeLibrary.SetDllImportResolver(typeof(Program).Assembly, (name, asm, path) =>
+        NativeLibrary.SetDllImportResolver(typeof(MidiPaddleInput).Assembly, (name, asm, path) =>
         {
             if (name != "netkeyer_midi_shim") return IntPtr.Zero;
             var dir = AppContext.BaseDirectory;
@@ -0,0 +1,142 @@
+using System;
+using System.IO;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace NetKeyer.Services;
+
+/// <summary>
+/// A line-based control protocol on a local Unix domain socket (which Windows 10 and later
+/// support too): every request line gets one response line from the handler. Clients are
+/// served on the thread pool, so the handler must be safe to call from any thread.
+/// </summary>
+public sealed class ControlSocketServer : IDisposable
+{
+    private const int LISTEN_BACKLOG = 4;
+    private const int MAX_LINE_LENGTH = 256;
+
+    private readonly Socket _listener;
+    private readonly Func<string, string> _handler;
+    private readonly CancellationTokenSource _stopping = new CancellationTokenSource();
+
+    public ControlSocketServer(string path, Func<string, string> handler)
+    {
+        Path = path;
+        _handler = handler ?? throw new ArgumentNullException(nameof(handler));
+
+        var folder = System.IO.Path.GetDirectoryName(path);
+        if (!string.IsNullOrEmpty(folder))
+            Directory.CreateDirectory(folder);
+
+        // A socket file left by a previous run would make Bind fail. Only remove it if nothing
+        // answers on it: deleting a live one would cut off the instance still serving it
+        if (File.Exists(path))
+        {
+            if (IsListening(path))
+                throw new InvalidOperationException("another NetKeyer instance is already listening on it");
+            File.Delete(path);
+        }
+
+        _listener = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+        _listener.Bind(new UnixDomainSocketEndPoint(path));
+        _listener.Listen(LISTEN_BACKLOG);
+        _ = AcceptLoopAsync();
+    }
+
+    /// <summary>
+    /// Path of the socket file.
+    /// </summary>
+    public string Path { get; }
+
+    private static bool IsListening(string path)
+    {
+        using var probe = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+        try
+        {
+            probe.Connect(new UnixDomainSocketEndPoint(path));
+            return true;
+        }
+        catch (SocketException)
+        {
+            // Refused: a stale file with nobody behind it
+            return false;
+        }
+    }
+
+    private async Task AcceptLoopAsync()
+    {
+        while (!_stopping.IsCancellationRequested)
+        {
+            Socket client;
+            try
+            {
+                client = await _listener.AcceptAsync(_stopping.Token);
+            }
+            catch (Exception ex) when (ex is OperationCanceledException or ObjectDisposedException)
+            {
+                return;
+            }
+            catch (SocketException ex)
+            {
+                Console.WriteLine($"Control socket stopped accepting: {ex.Message}");
+                return;
+            }
+
+            _ = ServeAsync(client);
+        }
+    }
+
+    private async Task ServeAsync(Socket client)
+    {
+        using (client)
+        using (var stream = new NetworkStream(client, ownsSocket: false))
+        using (var reader = new StreamReader(stream, Encoding.UTF8))
+        using (var writer = new StreamWriter(stream, new UTF8Encoding(false)) { NewLine = "\n", AutoFlush = true })
+        {
+            try
+            {
+                string line;
+                while ((line = await reader.ReadLineAsync(_stopping.Token)) != null)
+                {
+                    if (line.Length > MAX_LINE_LENGTH)
+                    {
+                        await writer.WriteLineAsync("error line too long");
+                        return;
+                    }
+
+                    string response;
+                    try
+                    {
+                        response = _handler(line.Trim());
+                    }
+                    catch (Exception ex)
+                    {
+                        response = $"error {ex.Message}";
+                    }
+
+                    await writer.WriteLineAsync(response);
+                }
+            }
+            catch (Exception ex) when (ex is OperationCanceledException or IOException or ObjectDisposedException)
+            {
+                // Client went away, or we are shutting down
+            }
+        }
+    }
+
+    public void Dispose()
+    {
+        _stopping.Cancel();
+        _listener.Dispose();
+
+        try
+        {
+            File.Delete(Path);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+        }
+    }
+}
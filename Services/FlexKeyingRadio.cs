@@ -0,0 +1,62 @@
+using System;
+using System.ComponentModel;
+using Flex.Smoothlake.FlexLib;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Services;
+
+/// <summary>
+/// <see cref="IKeyingRadio"/> over a FlexLib <see cref="Radio"/>. Two adapters over the same
+/// radio are equal, so attaching the keying core to a radio it already has is still a no-op.
+/// </summary>
+public sealed class FlexKeyingRadio : IKeyingRadio
+{
+    private readonly Radio _radio;
+    private Action<bool> _transmittingChanged;
+
+    public FlexKeyingRadio(Radio radio)
+    {
+        _radio = radio ?? throw new ArgumentNullException(nameof(radio));
+    }
+
+    public bool IsTransmitting => _radio.InterlockState == InterlockState.Transmitting;
+
+    public event Action<bool> TransmittingChanged
+    {
+        // Only listen to the radio while someone is listening to us, so a detached adapter
+        // leaves no handler behind on the radio
+        add
+        {
+            lock (_radio)
+            {
+                if (_transmittingChanged == null)
+                    _radio.PropertyChanged += Radio_PropertyChanged;
+                _transmittingChanged += value;
+            }
+        }
+        remove
+        {
+            lock (_radio)
+            {
+                _transmittingChanged -= value;
+                if (_transmittingChanged == null)
+                    _radio.PropertyChanged -= Radio_PropertyChanged;
+            }
+        }
+    }
+
+    public void CWKey(bool state, ushort timestamp, uint guiClientHandle) =>
+        _radio.CWKey(state, Timebase.FormatRadioTimestamp(timestamp), guiClientHandle);
+
+    public void SetMox(bool state) => _radio.Mox = state;
+
+    public override bool Equals(object obj) => obj is FlexKeyingRadio other && other._radio == _radio;
+
+    public override int GetHashCode() => _radio.GetHashCode();
+
+    private void Radio_PropertyChanged(object sender, PropertyChangedEventArgs e)
+    {
+        if (e.PropertyName == "InterlockState")
+            _transmittingChanged?.Invoke(IsTransmitting);
+    }
+}
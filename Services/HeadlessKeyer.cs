@@ -0,0 +1,538 @@
+using System;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Threading;
+using Flex.Smoothlake.FlexLib;
+using NetKeyer.Audio;
+using NetKeyer.Evdev;
+using NetKeyer.Helpers;
+using NetKeyer.Keying;
+using NetKeyer.Models;
+using NetKeyer.Realtime;
+
+namespace NetKeyer.Services;
+
+/// <summary>
+/// NetKeyer without the UI (<c>--headless</c>), for a PC that only bridges a paddle to the
+/// radio. Everything comes from the saved settings: the input and audio devices, and the
+/// radio and station last connected from the GUI, which is reconnected whenever the
+/// connection drops. Speed, keying mode and status are available over a local control socket
+/// (<see cref="ControlSocketServer"/>).
+///
+/// SmartLink (WAN) radios need the GUI's sign-in, so only LAN radios are supported here.
+/// </summary>
+public sealed class HeadlessKeyer : IDisposable
+{
+    public const string HEADLESS_ARGUMENT = "--headless";
+    public const string CONTROL_ARGUMENT = "--control";
+
+    private const int SUPERVISE_INTERVAL_MS = 1000;
+    private const int RETRY_INTERVAL_MS = 5000;
+    private const int DISCOVERY_WAIT_MS = 5000;
+    private const int MIN_WPM = 5;
+    private const int MAX_WPM = 60;
+    private const int DEFAULT_SIDETONE_VOLUME = 50;
+    private const int ATTACH_PARENT_PROCESS = -1;
+
+    private static readonly bool _debug = DebugCategory.RadioSelect.IsEnabled;
+
+    private readonly UserSettings _settings;
+    private readonly InputDeviceManager _inputDeviceManager = new InputDeviceManager();
+    private readonly KeyingController _keyingController = new KeyingController(null);
+    private readonly TransmitSliceMonitor _transmitSliceMonitor = new TransmitSliceMonitor();
+    private readonly RadioSettingsSynchronizer _radioSettingsSynchronizer;
+    private readonly ManualResetEventSlim _exitRequested = new ManualResetEventSlim(false);
+    private readonly long _startTimestamp = Timebase.Now;
+
+    private ISidetoneGenerator _sidetoneGenerator;
+    private IKeepAwakeStream _keepAwakeStream;
+    private volatile Radio _connectedRadio;
+    private uint _boundGuiClientHandle;
+    private bool _discoveryStarted;
+    private long _nextInputAttempt;
+    private long _nextRadioAttempt;
+    private volatile string _inputStatus = "not open";
+    private volatile string _radioStatus = "not connected";
+
+    private HeadlessKeyer(UserSettings settings)
+    {
+        _settings = settings;
+
+        try
+        {
+            RealtimeProfile.Configure(_settings.RealtimeProfile, _settings.RealtimeCores, _settings.RealtimeIsolateCores);
+        }
+        catch (ArgumentException ex)
+        {
+            Console.WriteLine(ex.Message);
+        }
+
+        _inputDeviceManager.PaddleStateChanged += _keyingController.HandlePaddleStateChange;
+        try
+        {
+            _inputDeviceManager.SetNetworkInputAccess(_settings.NetworkInputBindAddress, _settings.NetworkInputAllowedSenders);
+        }
+        catch (Exception ex)
+        {
+            Console.WriteLine(ex.Message);
+        }
+        try
+        {
+            _inputDeviceManager.SetForwardTarget(_settings.NetworkForwardTarget);
+        }
+        catch (Exception ex)
+        {
+            Console.WriteLine(ex.Message);
+        }
+
+        // Same defaults as the GUI; the radio's own values replace them once connected
+        _keyingController.Initialize(0, GetTimestamp, SendRadioKey);
+        _keyingController.SetKeyingMode(true, true);
+        _keyingController.SetSpeed(20);
+        _keyingController.UpdateParameters(p => p.WithSwapPaddles(false).WithPitch(600)
+            .WithMaxKeyDown(_settings.MaxKeyDownMs).WithPttTiming(_settings.PttDebounceMs, _settings.PttHangMs));
+
+        _transmitSliceMonitor.TransmitModeChanged += (_, e) => _keyingController.SetTransmitMode(e.IsTransmitModeCW);
+
+        // No UI thread to batch onto: apply radio changes where they arrive
+        _radioSettingsSynchronizer = new RadioSettingsSynchronizer(action => action());
+        _radioSettingsSynchronizer.SettingChangedFromRadio += RadioSettingsSynchronizer_SettingChanged;
+        _radioSettingsSynchronizer.SetKeyStateSource(() => _keyingController.IsRadioKeyDown);
+        _radioSettingsSynchronizer.SetKeyerParameterSink(update =>
+        {
+            var parameters = _keyingController.UpdateParameters(update);
+            _inputDeviceManager.SetSwapPaddles(parameters.SwapPaddles);
+        });
+    }
+
+    /// <summary>
+    /// True if the command line asks for headless mode.
+    /// </summary>
+    public static bool IsRequested(string[] args) => args.Contains(HEADLESS_ARGUMENT);
+
+    /// <summary>
+    /// Default control socket path, next to settings.json.
+    /// </summary>
+    public static string DefaultControlSocketPath =>
+        System.IO.Path.Combine(Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData), "NetKeyer", "control.sock");
+
+    /// <summary>
+    /// Runs until SIGINT or SIGTERM (Ctrl+C or closing the console on Windows). Returns the
+    /// process exit code.
+    /// </summary>
+    public static int Run(string[] args)
+    {
+        int controlIndex = Array.IndexOf(args, CONTROL_ARGUMENT);
+        string controlPath = controlIndex >= 0 && controlIndex + 1 < args.Length ? args[controlIndex + 1] : DefaultControlSocketPath;
+
+        // NetKeyer is a GUI executable on Windows, which gets no console of its own
+        if (OperatingSystem.IsWindows())
+            AttachConsole(ATTACH_PARENT_PROCESS);
+
+        using var keyer = new HeadlessKeyer(UserSettings.Load());
+        using var sigint = PosixSignalRegistration.Create(PosixSignal.SIGINT, keyer.OnExitSignal);
+        using var sigterm = PosixSignalRegistration.Create(PosixSignal.SIGTERM, keyer.OnExitSignal);
+        return keyer.RunUntilExit(controlPath);
+    }
+
+    private void OnExitSignal(PosixSignalContext context)
+    {
+        // Shut down in order (key-up to the radio first) rather than being killed mid-element
+        context.Cancel = true;
+        _exitRequested.Set();
+    }
+
+    private int RunUntilExit(string controlPath)
+    {
+        Console.WriteLine($"NetKeyer headless: {_settings.InputType} input, radio {DescribeSavedRadio()}");
+        if (RealtimeProfile.IsEnabled)
+            Console.WriteLine(RealtimeProfile.Describe());
+
+        // FlexLib needs this before any connection, discovered or not
+        API.ProgramName = "NetKeyer";
+
+        StartAudio();
+        TryOpenInputDevice();
+        Console.WriteLine($"Ready to key: {Timebase.ElapsedMilliseconds(_startTimestamp):F0} ms after start, {StartupStats.Describe()}");
+
+        ControlSocketServer control = null;
+        try
+        {
+            control = new ControlSocketServer(controlPath, HandleCommand);
+            Console.WriteLine($"Control socket: {control.Path}");
+        }
+        catch (Exception ex)
+        {
+            Console.WriteLine($"Control socket unavailable at {controlPath}: {ex.Message}");
+        }
+
+        using (control)
+        {
+            do
+            {
+                Supervise();
+            }
+            while (!_exitRequested.Wait(SUPERVISE_INTERVAL_MS));
+        }
+
+        Console.WriteLine("Shutting down");
+        return 0;
+    }
+
+    /// <summary>
+    /// Reopens the input device and reconnects the radio when either has gone away.
+    /// </summary>
+    private void Supervise()
+    {
+        long now = Timebase.Now;
+
+        if (!_inputDeviceManager.IsDeviceOpen && now >= _nextInputAttempt)
+            TryOpenInputDevice();
+
+        var radio = _connectedRadio;
+        if (radio != null && !radio.Connected)
+        {
+            Console.WriteLine($"Lost connection to radio {radio.Serial}");
+            DetachRadio();
+        }
+
+        if (_connectedRadio == null && !string.IsNullOrEmpty(_settings.SelectedRadioSerial) && now >= _nextRadioAttempt)
+        {
+            bool connected;
+            try
+            {
+                connected = TryConnectRadio();
+            }
+            catch (Exception ex)
+            {
+                // Keep running and retry; a daemon that exits can't key anything
+                _radioStatus = $"connection failed: {ex.Message}";
+                Console.WriteLine($"Radio connection failed: {ex.Message}");
+                connected = false;
+            }
+
+            if (!connected)
+                _nextRadioAttempt = Timebase.Now + Timebase.FromMilliseconds(RETRY_INTERVAL_MS);
+        }
+    }
+
+    private void StartAudio()
+    {
+        string deviceId = _settings.SelectedAudioDeviceId;
+        try
+        {
+            try
+            {
+                _sidetoneGenerator = SidetoneGeneratorFactory.Create(deviceId, _settings.WasapiAggressiveLowLatency);
+            }
+            catch (Exception ex) when (!string.IsNullOrEmpty(deviceId))
+            {
+                // Saved device may have been unplugged; fall back to the system default
+                Console.WriteLine($"Audio device '{deviceId}' unavailable, using default: {ex.Message}");
+                _sidetoneGenerator = SidetoneGeneratorFactory.Create(null, _settings.WasapiAggressiveLowLatency);
+            }
+
+            // The GUI's default volume until the radio reports its own; pitch and speed come
+            // from the keying controller's parameters
+            _sidetoneGenerator.SetVolume(DEFAULT_SIDETONE_VOLUME);
+            _keyingController.SetSidetoneGenerator(_sidetoneGenerator);
+        }
+        catch (Exception ex)
+        {
+            // The iambic keyer is timed by the sidetone, so only straight key works without it
+            Console.WriteLine($"Warning: Could not initialize sidetone generator: {ex.Message}");
+        }
+
+        if (_settings.KeepAudioDeviceAwake)
+        {
+            try
+            {
+                _keepAwakeStream = KeepAwakeStreamFactory.Create(deviceId);
+                _keepAwakeStream.Start();
+            }
+            catch (Exception ex)
+            {
+                DebugLogger.Log(DebugCategory.Audio, $"Warning: Could not initialize keep-awake stream: {ex.Message}");
+            }
+        }
+    }
+
+    private void TryOpenInputDevice()
+    {
+        var (type, deviceName) = SavedInputDevice();
+        try
+        {
+            _inputDeviceManager.OpenDevice(type, deviceName, _settings.MidiNoteMappings, _settings.EvdevKeyMappings);
+            _keyingController.ResetState();
+            _inputStatus = $"{type} {deviceName}";
+            Console.WriteLine($"Input device open: {_inputStatus}");
+        }
+        catch (Exception ex)
+        {
+            _inputStatus = $"{type} {deviceName} unavailable: {ex.Message}";
+            Console.WriteLine($"Input device {_inputStatus}");
+            _nextInputAttempt = Timebase.Now + Timebase.FromMilliseconds(RETRY_INTERVAL_MS);
+        }
+    }
+
+    private (InputDeviceType Type, string DeviceName) SavedInputDevice()
+    {
+        return _settings.InputType switch
+        {
+            "MIDI" => (InputDeviceType.MIDI, _settings.SelectedMidiDevice),
+            "Evdev" when EvdevPaddleInput.IsSupported => (InputDeviceType.Evdev, _settings.SelectedEvdevDevice),
+            "Network" => (InputDeviceType.Network, _settings.NetworkInputPort.ToString()),
+            _ => (InputDeviceType.Serial, _settings.SelectedSerialPort)
+        };
+    }
+
+    /// <summary>
+    /// Connects to the saved radio at its remembered address, or wherever discovery finds it,
+    /// and binds to the saved station.
+    /// </summary>
+    private bool TryConnectRadio()
+    {
+        string serial = _settings.SelectedRadioSerial;
+        string station = _settings.SelectedGuiClientStation;
+
+        var radio = RadioConnector.CreateRememberedRadio(_settings.SelectedRadioModel, serial,
+            _settings.SelectedRadioNickname, _settings.SelectedRadioAddress, _settings.SelectedRadioVersion);
+        if (radio == null || !radio.Connect())
+        {
+            if (_debug) DebugLogger.Log(DebugCategory.RadioSelect, $"[Headless] Radio {serial} not reachable at {_settings.SelectedRadioAddress}, trying discovery");
+            radio = FindDiscoveredRadio(serial);
+            if (radio == null || !radio.Connect())
+            {
+                _radioStatus = $"radio {serial} not found";
+                return false;
+            }
+        }
+
+        var guiClient = RadioConnector.WaitForGuiClient(radio, c => c.Station == station);
+        if (guiClient == null)
+        {
+            _radioStatus = $"station '{station}' not found on radio {serial}";
+            Console.WriteLine($"Station '{station}' not found on radio {serial}");
+            radio.Disconnect();
+            return false;
+        }
+
+        AttachRadio(radio, guiClient);
+        return true;
+    }
+
+    private Radio FindDiscoveredRadio(string serial)
+    {
+        if (!_discoveryStarted)
+        {
+            _discoveryStarted = true;
+            API.Init();
+        }
+
+        long deadline = Timebase.Now + Timebase.FromMilliseconds(DISCOVERY_WAIT_MS);
+        do
+        {
+            var radio = API.RadioList.ToArray().FirstOrDefault(r => r.Serial == serial && !r.IsWan);
+            if (radio != null)
+                return radio;
+        }
+        while (!_exitRequested.Wait(250) && Timebase.Now < deadline);
+
+        return null;
+    }
+
+    private void AttachRadio(Radio radio, GUIClient guiClient)
+    {
+        radio.BindGUIClient(guiClient.ClientID);
+        _boundGuiClientHandle = guiClient.ClientHandle;
+        _connectedRadio = radio;
+
+        _keyingController.Initialize(_boundGuiClientHandle, GetTimestamp, SendRadioKey);
+        _transmitSliceMonitor.AttachToRadio(radio, _boundGuiClientHandle);
+        _keyingController.SetRadio(new FlexKeyingRadio(radio), isSidetoneOnly: false);
+        _keyingController.SetTransmitMode(_transmitSliceMonitor.IsTransmitModeCW);
+
+        _radioSettingsSynchronizer.AttachToRadio(radio);
+        try
+        {
+            _radioSettingsSynchronizer.ApplyInitialSettingsFromRadio();
+        }
+        catch (Exception ex)
+        {
+            Console.WriteLine(ex.Message);
+        }
+
+        // Discovery may have found the radio at a new address
+        string address = radio.IP?.ToString();
+        if (address != _settings.SelectedRadioAddress)
+        {
+            _settings.SelectedRadioAddress = address;
+            _settings.SelectedRadioVersion = RadioConnector.FormatVersion(radio);
+            _settings.Save();
+        }
+
+        _radioStatus = $"connected to {radio.Nickname} ({radio.Model}) station '{guiClient.Station}'";
+        Console.WriteLine($"Radio {_radioStatus}: {StartupStats.Describe()}");
+    }
+
+    private void DetachRadio()
+    {
+        var radio = _connectedRadio;
+        if (radio == null)
+            return;
+
+        // Key-up first, while the radio may still be listening
+        _keyingController.Stop();
+        _sidetoneGenerator?.Stop();
+
+        _transmitSliceMonitor.Detach();
+        _radioSettingsSynchronizer.DetachFromRadio();
+        _keyingController.SetRadio(null);
+        _connectedRadio = null;
+        _boundGuiClientHandle = 0;
+        _radioStatus = "not connected";
+
+        try
+        {
+            radio.Disconnect();
+        }
+        catch (Exception ex)
+        {
+            if (_debug) DebugLogger.Log(DebugCategory.RadioSelect, $"[Headless] Disconnect failed: {ex.Message}");
+        }
+    }
+
+    private static ushort GetTimestamp() => Timebase.ToRadioTimestamp(Timebase.Now);
+
+    private void SendRadioKey(bool state, ushort timestamp, uint handle)
+    {
+        _connectedRadio?.CWKey(state, Timebase.FormatRadioTimestamp(timestamp), handle);
+    }
+
+    /// <summary>
+    /// Radio values applied outside the keyer parameter sink: the initial values read on
+    /// connection, and sidetone volume.
+    /// </summary>
+    private void RadioSettingsSynchronizer_SettingChanged(object sender, RadioSettingChangedEventArgs e)
+    {
+        switch (e.PropertyName)
+        {
+            case "CWSpeed" when e.Value is int wpm:
+                _keyingController.SetSpeed(wpm);
+                break;
+
+            case "CWPitch" when e.Value is int pitch:
+                _keyingController.UpdateParameters(p => p.WithPitch(pitch));
+                break;
+
+            case "TXCWMonitorGain" when e.Value is int volume:
+                _sidetoneGenerator?.SetVolume(volume);
+                break;
+        }
+    }
+
+    /// <summary>
+    /// One control protocol request: <c>status</c>, <c>speed [wpm]</c>,
+    /// <c>mode [iambic-a|iambic-b|straight]</c>, <c>realtime</c> or <c>help</c>. Responses start with "ok" or
+    /// "error".
+    /// </summary>
+    private string HandleCommand(string line)
+    {
+        var parts = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+        if (parts.Length == 0)
+            return "error empty command";
+
+        var parameters = _keyingController.Parameters;
+        switch (parts[0].ToLowerInvariant())
+        {
+            case "status":
+                return $"ok radio={Quote(_radioStatus)} input={Quote(_inputStatus)} speed={parameters.Wpm} mode={FormatMode(parameters)} " +
+                       $"pitch={parameters.PitchHz} transmit={(_transmitSliceMonitor.IsTransmitModeCW ? "cw" : "ptt")} " +
+                       $"key={(_keyingController.IsRadioKeyDown ? "down" : "up")} dropped={_keyingController.DroppedEdges} " +
+                       $"watchdog={_keyingController.WatchdogKeyUps} mox={_keyingController.Ptt.MoxCommands} " +
+                       $"ptt-tx={_keyingController.Ptt.LastTimeToTxMs:F0}ms " +
+                       $"uptime={Timebase.ElapsedMilliseconds(_startTimestamp) / 1000:F0}s workingset={StartupStats.WorkingSetMb:F1}MB";
+
+            case "speed":
+                if (parts.Length == 1)
+                    return $"ok speed {parameters.Wpm}";
+                if (parts.Length != 2 || !int.TryParse(parts[1], out int wpm) || wpm < MIN_WPM || wpm > MAX_WPM)
+                    return $"error usage: speed <{MIN_WPM}-{MAX_WPM}>";
+
+                _keyingController.SetSpeed(wpm);
+                _radioSettingsSynchronizer.SyncCwSpeedToRadio(wpm);
+                return $"ok speed {wpm}";
+
+            case "mode":
+                if (parts.Length == 1)
+                    return $"ok mode {FormatMode(parameters)}";
+
+                bool isIambic, isModeB = parameters.IsModeB;
+                switch (parts.Length == 2 ? parts[1].ToLowerInvariant() : null)
+                {
+                    case "iambic-a":
+                        isIambic = true;
+                        isModeB = false;
+                        break;
+                    case "iambic-b":
+                        isIambic = true;
+                        isModeB = true;
+                        break;
+                    case "straight":
+                        isIambic = false;
+                        break;
+                    default:
+                        return "error usage: mode <iambic-a|iambic-b|straight>";
+                }
+
+                _keyingController.SetKeyingMode(isIambic, isModeB);
+                _radioSettingsSynchronizer.SyncIambicModeToRadio(isIambic);
+                _radioSettingsSynchronizer.SyncIambicModeBToRadio(isModeB);
+                return $"ok mode {FormatMode(_keyingController.Parameters)}";
+
+            case "realtime":
+                // One response line per request, so the per-thread lines are joined
+                return "ok " + string.Join("; ", RealtimeProfile.Describe().Split('\n').Select(l => l.Trim()));
+
+            case "help":
+                return "ok commands: status, speed [wpm], mode [iambic-a|iambic-b|straight], realtime, help";
+
+            default:
+                return $"error unknown command '{parts[0]}'";
+        }
+    }
+
+    private static string FormatMode(KeyerParameters parameters) =>
+        !parameters.IsIambic ? "straight" : parameters.IsModeB ? "iambic-b" : "iambic-a";
+
+    private static string Quote(string value) => $"\"{value.Replace("\"", "'")}\"";
+
+    private string DescribeSavedRadio()
+    {
+        if (string.IsNullOrEmpty(_settings.SelectedRadioSerial))
+            return "none saved (sidetone only; connect once from the GUI to save one)";
+
+        return $"{_settings.SelectedRadioSerial} station '{_settings.SelectedGuiClientStation}'";
+    }
+
+    [DllImport("kernel32.dll", SetLastError = true)]
+    private static extern bool AttachConsole(int processId);
+
+    public void Dispose()
+    {
+        DetachRadio();
+        _radioSettingsSynchronizer.Dispose();
+        _keyingController.Stop();
+        _inputDeviceManager.Dispose();
+        _keepAwakeStream?.Stop();
+        _keepAwakeStream?.Dispose();
+        _sidetoneGenerator?.Dispose();
+        _keyingController.Dispose();
+
+        if (_discoveryStarted)
+            API.CloseSession();
+
+        UserSettings.Flush();
+        DebugLogger.Flush();
+    }
+}
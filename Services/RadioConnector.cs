@@ -0,0 +1,125 @@
+using System;
+using System.Net;
+using System.Reflection;
+using System.Threading.Tasks;
+using Flex.Smoothlake.FlexLib;
+using Flex.Util;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Services;
+
+/// <summary>
+/// Connection helpers that don't depend on FlexLib discovery having seen the radio: building a
+/// <see cref="Radio"/> for a remembered LAN address, and waiting for a station's GUIClient to
+/// be fully populated after <see cref="Radio.Connect"/>.
+/// </summary>
+public static class RadioConnector
+{
+    /// <summary>
+    /// How long to wait after Connect() for the radio's "client connected" status to deliver
+    /// the station's ClientID. On a LAN this normally arrives within a few tens of milliseconds.
+    /// </summary>
+    public const int GUI_CLIENT_TIMEOUT_MS = 3000;
+
+    private static readonly bool _debug = DebugCategory.RadioSelect.IsEnabled;
+
+    /// <summary>
+    /// Creates a LAN <see cref="Radio"/> for a radio remembered from a previous session, so it
+    /// can be connected without waiting for its discovery broadcast. Returns null if the saved
+    /// details are incomplete or FlexLib doesn't expose the expected constructor.
+    ///
+    /// The instance is not in <see cref="API.RadioList"/>: when discovery later sees the radio
+    /// it creates a second instance with the same serial, and FlexLib never raises RadioRemoved
+    /// for this one. The caller has to treat the two as the same radio.
+    /// </summary>
+    public static Radio CreateRememberedRadio(string model, string serial, string nickname, string address, string version)
+    {
+        if (string.IsNullOrEmpty(serial) || !IPAddress.TryParse(address, out var ip))
+            return null;
+
+        // FlexLib has no public way to create a radio other than from discovery packets; the
+        // constructor it uses for that is internal, so reach it by reflection and fall back to
+        // discovery if it changes
+        var ctor = typeof(Radio).GetConstructor(
+            BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic,
+            null,
+            new[] { typeof(string), typeof(string), typeof(string), typeof(IPAddress), typeof(string) },
+            null);
+        if (ctor == null)
+        {
+            Console.WriteLine("Warning: this FlexLib has no Radio(model, serial, nickname, address, version) " +
+                              "constructor; reconnecting to the last radio through discovery instead");
+            return null;
+        }
+
+        try
+        {
+            return (Radio)ctor.Invoke(new object[] { model ?? "", serial, nickname ?? "", ip, version ?? "" });
+        }
+        catch (Exception ex)
+        {
+            Console.WriteLine($"Warning: could not create remembered radio {serial}, reconnecting through discovery instead: " +
+                              (ex.InnerException ?? ex).Message);
+            return null;
+        }
+    }
+
+    /// <summary>
+    /// Version string in the form the <see cref="Radio"/> constructor parses, for persisting
+    /// alongside the radio's address.
+    /// </summary>
+    public static string FormatVersion(Radio radio)
+    {
+        return FlexVersion.ToString(radio.Version);
+    }
+
+    /// <summary>
+    /// Waits until the radio reports a GUIClient matching <paramref name="match"/> with its
+    /// ClientID (UUID) populated. Completes as soon as the status arrives rather than after a
+    /// fixed delay; returns null if it hasn't arrived within <paramref name="timeoutMs"/>.
+    /// </summary>
+    public static GUIClient WaitForGuiClient(Radio radio, Func<GUIClient, bool> match, int timeoutMs = GUI_CLIENT_TIMEOUT_MS)
+    {
+        var ready = new TaskCompletionSource<GUIClient>(TaskCreationOptions.RunContinuationsAsynchronously);
+
+        void Check(GUIClient _)
+        {
+            var guiClient = FindGuiClient(radio, match);
+            if (guiClient != null)
+                ready.TrySetResult(guiClient);
+        }
+
+        Radio.GUIClientAddedEventHandler added = Check;
+        Radio.GUIClientUpdatedEventHandler updated = Check;
+        radio.GUIClientAdded += added;
+        radio.GUIClientUpdated += updated;
+        try
+        {
+            // The status may already have been processed before we subscribed
+            Check(null);
+
+            long start = Timebase.Now;
+            bool completed = ready.Task.Wait(timeoutMs);
+            if (_debug) DebugLogger.Log(DebugCategory.RadioSelect, $"[RadioConnector] GUI client {(completed ? "ready" : "timed out")} after {Timebase.ElapsedMilliseconds(start):F0} ms");
+            return completed ? ready.Task.Result : null;
+        }
+        finally
+        {
+            radio.GUIClientAdded -= added;
+            radio.GUIClientUpdated -= updated;
+        }
+    }
+
+    private static GUIClient FindGuiClient(Radio radio, Func<GUIClient, bool> match)
+    {
+        lock (radio.GuiClientsLockObj)
+        {
+            foreach (var guiClient in radio.GuiClients)
+            {
+                if (match(guiClient) && !string.IsNullOrEmpty(guiClient.ClientID))
+                    return guiClient;
+            }
+        }
+        return null;
+    }
+}
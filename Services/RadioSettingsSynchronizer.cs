@@ -1,7 +1,10 @@
 using System;
 using System.ComponentModel;
+using System.Threading;
 using Avalonia.Threading;
 using Flex.Smoothlake.FlexLib;
+using NetKeyer.Helpers;
+using NetKeyer.Keying;
 
 namespace NetKeyer.Services;
 
@@ -11,18 +14,176 @@ public class RadioSettingChangedEventArgs : EventArgs
     public object Value { get; set; }
 }
 
-public class RadioSettingsSynchronizer
+/// <summary>
+/// Keeps the CW settings in the UI and on the radio in step.
+///
+/// Outbound changes are coalesced per setting: the latest value wins and each setting is sent
+/// at most once per <see cref="MIN_SEND_INTERVAL_MS"/>, so dragging a slider sends a handful of
+/// commands rather than one per pixel. Sends happen on a low-priority thread that holds them
+/// back while the radio key is down, so settings never queue in front of a key-up on the
+/// command channel that also carries <c>cw key</c>.
+///
+/// Inbound property changes from FlexLib are collected and delivered to the UI thread as one
+/// batch per frame. A setting with an outbound value still pending isn't echoed back to the
+/// UI, so a slider being dragged doesn't jump back to the value the radio last acknowledged.
+/// Keyer-relevant changes also go straight to the keying core from FlexLib's event thread
+/// (see <see cref="SetKeyerParameterSink"/>), so a speed change made on the radio takes
+/// effect at the next element even while the UI thread is busy.
+///
+/// Dispose it when it's replaced or at exit: that stops the settings thread and removes it as
+/// the pending-settings source for <see cref="KeyingMetrics"/>.
+/// </summary>
+public class RadioSettingsSynchronizer : IDisposable
 {
+    private const int MIN_SEND_INTERVAL_MS = 100;
+    private const int MAX_KEY_DOWN_DEFER_MS = 250;
+    private const int KEY_DOWN_POLL_MS = 5;
+    private const int FRAME_MS = 16;
+
+    private static readonly bool _debug = DebugCategory.RadioSettings.IsEnabled;
+
     private Radio _connectedRadio;
     private bool _updatingFromRadio = false;
 
+    // ---- outbound (UI thread -> settings thread -> radio) ----
+
+    private enum Setting
+    {
+        CwSpeed,
+        CwPitch,
+        SidetoneVolume,
+        IambicMode,
+        IambicModeB,
+        SwapPaddles,
+        Count
+    }
+
+    private struct OutboundSetting
+    {
+        public bool Pending;
+        public int Value;
+        public long PendingSince;
+        public long LastSent;
+    }
+
+    private readonly OutboundSetting[] _outbound = new OutboundSetting[(int)Setting.Count];
+    private readonly object _outboundLock = new object();
+    private readonly AutoResetEvent _outboundSignal = new AutoResetEvent(false);
+    private readonly Thread _sendThread;
+    private readonly Func<int> _pendingSettingsSource;
+    private volatile bool _running = true;
+    private Func<bool> _isKeyDown;
+    private long _sentCommands;
+    private long _suppressedCommands;
+    private long _keyDownDeferrals;
+
+    // ---- inbound (FlexLib -> UI thread) ----
+
+    private int _pendingInbound; // bit per Setting
+    private int _inboundScheduled;
+    private long _lastInboundFlush;
+    private readonly Timer _inboundTimer;
+    private readonly Action<Action> _postInbound;
+    private long _inboundNotifications;
+    private long _inboundBatches;
+    private Action<Func<KeyerParameters, KeyerParameters>> _keyerParameterSink;
+
     public event EventHandler<RadioSettingChangedEventArgs> SettingChangedFromRadio;
 
+    public RadioSettingsSynchronizer()
+        : this(action => Dispatcher.UIThread.Post(action))
+    {
+    }
+
+    /// <summary>
+    /// Creates a synchronizer that raises <see cref="SettingChangedFromRadio"/> batches through
+    /// <paramref name="postInbound"/> rather than on the Avalonia UI thread, for headless mode.
+    /// </summary>
+    public RadioSettingsSynchronizer(Action<Action> postInbound)
+    {
+        _postInbound = postInbound ?? throw new ArgumentNullException(nameof(postInbound));
+        _inboundTimer = new Timer(_ => _postInbound(FlushInbound));
+        _sendThread = new Thread(SendLoop)
+        {
+            Name = "radio settings",
+            IsBackground = true,
+            Priority = ThreadPriority.BelowNormal
+        };
+        _sendThread.Start();
+
+        _pendingSettingsSource = () => PendingCommands;
+        KeyingMetrics.SetPendingSettingsSource(_pendingSettingsSource);
+    }
+
+    /// <summary>
+    /// Outbound commands actually sent to the radio.
+    /// </summary>
+    public long SentCommands => Interlocked.Read(ref _sentCommands);
+
+    /// <summary>
+    /// Outbound values replaced by a newer one before they were sent.
+    /// </summary>
+    public long SuppressedCommands => Interlocked.Read(ref _suppressedCommands);
+
+    /// <summary>
+    /// Times a send was held back because the radio key was down.
+    /// </summary>
+    public long KeyDownDeferrals => Interlocked.Read(ref _keyDownDeferrals);
+
+    /// <summary>
+    /// Settings changes waiting to be sent to the radio.
+    /// </summary>
+    public int PendingCommands
+    {
+        get
+        {
+            int pending = 0;
+            lock (_outboundLock)
+            {
+                for (int i = 0; i < _outbound.Length; i++)
+                {
+                    if (_outbound[i].Pending)
+                        pending++;
+                }
+            }
+            return pending;
+        }
+    }
+
+    /// <summary>
+    /// Property change notifications received from FlexLib, and the UI batches they were
+    /// delivered in.
+    /// </summary>
+    public long InboundNotifications => Interlocked.Read(ref _inboundNotifications);
+    public long InboundBatches => Interlocked.Read(ref _inboundBatches);
+
+    /// <summary>
+    /// Tells the synchronizer whether the radio key is currently down, so settings commands
+    /// can wait for the key-up. Called on the settings thread.
+    /// </summary>
+    public void SetKeyStateSource(Func<bool> isKeyDown)
+    {
+        _isKeyDown = isKeyDown;
+    }
+
+    /// <summary>
+    /// Routes speed, keying mode, paddle swap and pitch changes reported by the radio to the
+    /// keying core. The sink is called on FlexLib's event thread, ahead of and independent of
+    /// the batched UI update, with the change to apply to the current keyer parameters.
+    /// </summary>
+    public void SetKeyerParameterSink(Action<Func<KeyerParameters, KeyerParameters>> sink)
+    {
+        _keyerParameterSink = sink;
+    }
+
     public void AttachToRadio(Radio radio)
     {
         DetachFromRadio();
 
-        _connectedRadio = radio;
+        lock (_outboundLock)
+        {
+            _connectedRadio = radio;
+        }
 
         if (_connectedRadio != null)
         {
@@ -32,11 +193,21 @@ public class RadioSettingsSynchronizer
 
     public void DetachFromRadio()
     {
-        if (_connectedRadio != null)
+        lock (_outboundLock)
         {
-            _connectedRadio.PropertyChanged -= Radio_PropertyChanged;
-            _connectedRadio = null;
+            // Values queued for the old radio are dropped with it
+            for (int i = 0; i < _outbound.Length; i++)
+                _outbound[i].Pending = false;
+
+            if (_connectedRadio != null)
+            {
+                _connectedRadio.PropertyChanged -= Radio_PropertyChanged;
+                _connectedRadio = null;
+            }
         }
+        Interlocked.Exchange(ref _pendingInbound, 0);
+
+        if (_debug) DebugLogger.Log(DebugCategory.RadioSettings, $"[RadioSettingsSynchronizer] {SentCommands} sent, {SuppressedCommands} suppressed, {KeyDownDeferrals} deferred for key-down, {InboundNotifications} notifications in {InboundBatches} UI batches");
     }
 
     public void ApplyInitialSettingsFromRadio()
@@ -66,133 +237,336 @@ public class RadioSettingsSynchronizer
 
     public void SyncCwSpeedToRadio(int value)
     {
-        if (_connectedRadio != null && !_updatingFromRadio)
-        {
-            try
-            {
-                _connectedRadio.CWSpeed = value;
-            }
-            catch { }
-        }
+        QueueSetting(Setting.CwSpeed, value);
     }
 
     public void SyncCwPitchToRadio(int value)
     {
-        if (_connectedRadio != null && !_updatingFromRadio)
-        {
-            try
-            {
-                _connectedRadio.CWPitch = value;
-            }
-            catch { }
-        }
+        QueueSetting(Setting.CwPitch, value);
     }
 
     public void SyncSidetoneVolumeToRadio(int value)
     {
-        if (_connectedRadio != null && !_updatingFromRadio)
+        QueueSetting(Setting.SidetoneVolume, value);
+    }
+
+    public void SyncIambicModeToRadio(bool isIambic)
+    {
+        QueueSetting(Setting.IambicMode, isIambic ? 1 : 0);
+    }
+
+    public void SyncIambicModeBToRadio(bool isModeB)
+    {
+        QueueSetting(Setting.IambicModeB, isModeB ? 1 : 0);
+    }
+
+    public void SyncSwapPaddlesToRadio(bool swap)
+    {
+        QueueSetting(Setting.SwapPaddles, swap ? 1 : 0);
+    }
+
+    private void QueueSetting(Setting setting, int value)
+    {
+        if (_connectedRadio == null || _updatingFromRadio || !_running)
+            return;
+
+        lock (_outboundLock)
         {
-            try
-            {
-                _connectedRadio.TXCWMonitorGain = value;
-            }
-            catch { }
+            ref var slot = ref _outbound[(int)setting];
+            if (slot.Pending)
+                Interlocked.Increment(ref _suppressedCommands);
+            else
+                slot.PendingSince = Timebase.Now;
+            slot.Pending = true;
+            slot.Value = value;
         }
+        _outboundSignal.Set();
     }
 
-    public void SyncIambicModeToRadio(bool isIambic)
+    // ---- settings thread ----
+
+    private void SendLoop()
     {
-        if (_connectedRadio != null && !_updatingFromRadio)
+        int waitMs = Timeout.Infinite;
+        while (true)
         {
-            try
-            {
-                _connectedRadio.CWIambic = isIambic;
-            }
-            catch { }
+            _outboundSignal.WaitOne(waitMs);
+            if (!_running)
+                return;
+            waitMs = SendDueSettings();
         }
     }
 
-    public void SyncIambicModeBToRadio(bool isModeB)
+    /// <summary>
+    /// Sends every pending setting whose interval has elapsed. Returns how long to wait before
+    /// the next one is due, or Timeout.Infinite if nothing is pending.
+    /// </summary>
+    private int SendDueSettings()
     {
-        if (_connectedRadio != null && !_updatingFromRadio)
+        long now = Timebase.Now;
+        long nextDue = long.MaxValue;
+
+        for (int i = 0; i < _outbound.Length; i++)
         {
-            try
+            Radio radio;
+            int value;
+            lock (_outboundLock)
             {
-                if (isModeB)
+                ref var slot = ref _outbound[i];
+                if (!slot.Pending)
+                    continue;
+
+                long due = slot.LastSent + Timebase.FromMilliseconds(MIN_SEND_INTERVAL_MS);
+                if (now < due)
                 {
-                    // Set Mode B - this sends "cw mode 1"
-                    _connectedRadio.CWIambicModeB = true;
-                    // Also explicitly clear Mode A
-                    _connectedRadio.CWIambicModeA = false;
+                    nextDue = Math.Min(nextDue, due);
+                    continue;
                 }
-                else
+
+                // cw key commands go first: wait for the key-up, unless the key has been held
+                // so long (tuning, a stuck input) that the setting would seem lost
+                if (_isKeyDown?.Invoke() == true &&
+                    Timebase.ToMillisecondsLong(now - slot.PendingSince) < MAX_KEY_DOWN_DEFER_MS)
                 {
-                    // Set Mode A - this sends "cw mode 0"
-                    _connectedRadio.CWIambicModeA = true;
-                    // Also explicitly clear Mode B
-                    _connectedRadio.CWIambicModeB = false;
+                    Interlocked.Increment(ref _keyDownDeferrals);
+                    nextDue = Math.Min(nextDue, now + Timebase.FromMilliseconds(KEY_DOWN_POLL_MS));
+                    continue;
                 }
+
+                slot.Pending = false;
+                slot.LastSent = now;
+                value = slot.Value;
+                KeyingMetrics.RecordSettingsDelay(now - slot.PendingSince);
+                radio = _connectedRadio;
+            }
+
+            if (radio != null)
+            {
+                SendSetting(radio, (Setting)i, value);
+                Interlocked.Increment(ref _sentCommands);
             }
-            catch { }
         }
+
+        if (nextDue == long.MaxValue)
+            return Timeout.Infinite;
+        return (int)Math.Max(1, Timebase.ToMillisecondsLong(nextDue - Timebase.Now));
     }
 
-    public void SyncSwapPaddlesToRadio(bool swap)
+    private static void SendSetting(Radio radio, Setting setting, int value)
     {
-        if (_connectedRadio != null && !_updatingFromRadio)
+        try
         {
-            try
+            switch (setting)
             {
-                _connectedRadio.CWSwapPaddles = swap;
+                case Setting.CwSpeed:
+                    radio.CWSpeed = value;
+                    break;
+
+                case Setting.CwPitch:
+                    radio.CWPitch = value;
+                    break;
+
+                case Setting.SidetoneVolume:
+                    radio.TXCWMonitorGain = value;
+                    break;
+
+                case Setting.IambicMode:
+                    radio.CWIambic = value != 0;
+                    break;
+
+                case Setting.IambicModeB:
+                    if (value != 0)
+                    {
+                        // Set Mode B - this sends "cw mode 1"
+                        radio.CWIambicModeB = true;
+                        // Also explicitly clear Mode A
+                        radio.CWIambicModeA = false;
+                    }
+                    else
+                    {
+                        // Set Mode A - this sends "cw mode 0"
+                        radio.CWIambicModeA = true;
+                        // Also explicitly clear Mode B
+                        radio.CWIambicModeB = false;
+                    }
+                    break;
+
+                case Setting.SwapPaddles:
+                    radio.CWSwapPaddles = value != 0;
+                    break;
             }
-            catch { }
         }
+        catch { }
+    }
+
+    public void Dispose()
+    {
+        if (!_running)
+            return;
+
+        // Drops anything still pending, so the settings thread has nothing left to send
+        DetachFromRadio();
+        _running = false;
+        _outboundSignal.Set();
+        if (Thread.CurrentThread != _sendThread)
+            _sendThread.Join();
+
+        _inboundTimer.Dispose();
+        _outboundSignal.Dispose();
+        KeyingMetrics.ClearPendingSettingsSource(_pendingSettingsSource);
     }
 
+    // ---- inbound ----
+
     private void Radio_PropertyChanged(object sender, PropertyChangedEventArgs e)
     {
-        // Dispatch all UI updates to the UI thread
-        Dispatcher.UIThread.Post(() =>
+        Setting setting;
+        switch (e.PropertyName)
         {
-            if (_connectedRadio == null)
+            case "CWSpeed":
+                setting = Setting.CwSpeed;
+                break;
+
+            case "CWPitch":
+                setting = Setting.CwPitch;
+                break;
+
+            case "TXCWMonitorGain":
+                setting = Setting.SidetoneVolume;
+                break;
+
+            case "CWIambic":
+                setting = Setting.IambicMode;
+                break;
+
+            case "CWIambicModeB":
+            case "CWIambicModeA":
+                setting = Setting.IambicModeB;
+                break;
+
+            case "CWSwapPaddles":
+                setting = Setting.SwapPaddles;
+                break;
+
+            default:
                 return;
+        }
 
-            _updatingFromRadio = true;
-            try
+        Interlocked.Increment(ref _inboundNotifications);
+        if (sender is Radio radio)
+            ForwardToKeyer(radio, setting);
+        Interlocked.Or(ref _pendingInbound, 1 << (int)setting);
+
+        // One UI update per frame, however many notifications arrive in it
+        if (Interlocked.Exchange(ref _inboundScheduled, 1) != 0)
+            return;
+
+        long sinceLastFlush = Timebase.ToMillisecondsLong(Timebase.Now - Interlocked.Read(ref _lastInboundFlush));
+        if (sinceLastFlush >= FRAME_MS)
+            _postInbound(FlushInbound);
+        else
+            _inboundTimer.Change(FRAME_MS - sinceLastFlush, Timeout.Infinite);
+    }
+
+    private void ForwardToKeyer(Radio radio, Setting setting)
+    {
+        var sink = _keyerParameterSink;
+        if (sink == null)
+            return;
+
+        // As with the UI, an echo of an older value mustn't undo a change still on its way out
+        lock (_outboundLock)
+        {
+            if (_outbound[(int)setting].Pending)
+                return;
+        }
+
+        switch (setting)
+        {
+            case Setting.CwSpeed:
+                int wpm = radio.CWSpeed;
+                sink(p => p.WithWpm(wpm));
+                break;
+
+            case Setting.CwPitch:
+                int pitch = radio.CWPitch;
+                sink(p => p.WithPitch(pitch));
+                break;
+
+            case Setting.IambicMode:
+                bool iambic = radio.CWIambic;
+                sink(p => p.WithKeyingMode(iambic, p.IsModeB));
+                break;
+
+            case Setting.IambicModeB:
+                bool modeB = radio.CWIambicModeB;
+                sink(p => p.WithKeyingMode(p.IsIambic, modeB));
+                break;
+
+            case Setting.SwapPaddles:
+                bool swap = radio.CWSwapPaddles;
+                sink(p => p.WithSwapPaddles(swap));
+                break;
+        }
+    }
+
+    private void FlushInbound()
+    {
+        Interlocked.Exchange(ref _lastInboundFlush, Timebase.Now);
+        Interlocked.Exchange(ref _inboundScheduled, 0);
+        int pending = Interlocked.Exchange(ref _pendingInbound, 0);
+
+        if (_connectedRadio == null || pending == 0)
+            return;
+
+        Interlocked.Increment(ref _inboundBatches);
+        _updatingFromRadio = true;
+        try
+        {
+            for (int i = 0; i < (int)Setting.Count; i++)
             {
-                switch (e.PropertyName)
+                if ((pending & (1 << i)) == 0)
+                    continue;
+
+                // Our own newer value is on its way; don't bounce the UI back to the old one
+                lock (_outboundLock)
                 {
-                    case "CWSpeed":
+                    if (_outbound[i].Pending)
+                        continue;
+                }
+
+                switch ((Setting)i)
+                {
+                    case Setting.CwSpeed:
                         RaiseSettingChanged("CWSpeed", _connectedRadio.CWSpeed);
                         break;
 
-                    case "CWPitch":
+                    case Setting.CwPitch:
                         RaiseSettingChanged("CWPitch", _connectedRadio.CWPitch);
                         break;
 
-                    case "TXCWMonitorGain":
+                    case Setting.SidetoneVolume:
                         RaiseSettingChanged("TXCWMonitorGain", _connectedRadio.TXCWMonitorGain);
                         break;
 
-                    case "CWIambic":
+                    case Setting.IambicMode:
                         RaiseSettingChanged("CWIambic", _connectedRadio.CWIambic);
                         break;
 
-                    case "CWIambicModeB":
-                    case "CWIambicModeA":
+                    case Setting.IambicModeB:
                         RaiseSettingChanged("CWIambicModeB", _connectedRadio.CWIambicModeB);
                         break;
 
-                    case "CWSwapPaddles":
+                    case Setting.SwapPaddles:
                         RaiseSettingChanged("CWSwapPaddles", _connectedRadio.CWSwapPaddles);
                         break;
                 }
             }
-            finally
-            {
-                _updatingFromRadio = false;
-            }
-        });
+        }
+        finally
+        {
+            _updatingFromRadio = false;
+        }
     }
 
     private void RaiseSettingChanged(string propertyName, object value)
@@ -30,14 +30,14 @@ public class WanConnectionReadyEventArgs : EventArgs
 public class SmartLinkManager
 {
     private readonly SmartLinkAuthService _smartLinkAuth;
-    private WanServer _wanServer;
-    private readonly ManualResetEvent _wanConnectionReadyEvent = new ManualResetEvent(false);
+    private readonly SmartLinkServerConnection _server = new SmartLinkServerConnection();
     private UserSettings _settings;
     private List<Radio> _cachedWanRadios = new List<Radio>();
 
     public bool IsAvailable { get; private set; }
     public bool IsAuthenticated => _smartLinkAuth?.AuthState == SmartLinkAuthState.Authenticated;
-    public WanServer WanServer => _wanServer;
+    public WanServer WanServer => _server.WanServer;
+    public bool IsServerConnected => _server.IsConnected;
 
     public event EventHandler<SmartLinkStatusChangedEventArgs> StatusChanged;
     public event EventHandler<string> ErrorOccurred;
@@ -49,6 +49,10 @@ public class SmartLinkManager
     {
         _settings = settings;
 
+        _server.RadioListReceived += WanServer_WanRadioListReceived;
+        _server.RegistrationInvalid += WanServer_RegistrationInvalid;
+        _server.RadioConnectReady += WanServer_RadioConnectReady;
+
         // Initialize SmartLink authentication service
         // Try user config first, fall back to secret provider if available
         IClientIdProvider clientIdProvider = new ConfigFileClientIdProvider();
@@ -101,11 +105,19 @@ public class SmartLinkManager
         if (string.IsNullOrEmpty(_settings.SmartLinkRefreshToken))
             return false;
 
+        // The TLS handshake with the server doesn't need the token, so it overlaps the refresh
+        var connectTask = _server.ConnectAsync();
+
         var success = await _smartLinkAuth.RestoreSessionAsync(_settings.SmartLinkRefreshToken);
         if (success)
         {
             await ConnectToServerAsync();
         }
+        else
+        {
+            await connectTask;
+            _server.Disconnect();
+        }
         return success;
     }
 
@@ -127,7 +139,7 @@ public class SmartLinkManager
     public void Logout()
     {
         _smartLinkAuth?.Logout();
-        _wanServer?.Disconnect();
+        _server.Disconnect();
 
         // Clear cached WAN radios
         _cachedWanRadios.Clear();
@@ -137,76 +149,40 @@ public class SmartLinkManager
         _settings.Save();
     }
 
-    public async Task ConnectToServerAsync()
+    /// <summary>
+    /// Connects to the SmartLink server and registers, which makes it send the radio list.
+    /// The handshake runs off the calling thread, and callers arriving while one is in
+    /// progress share it.
+    /// </summary>
+    public async Task ConnectToServerAsync(CancellationToken cancellationToken = default)
     {
-        if (_wanServer == null)
+        if (await _server.ConnectAsync(cancellationToken))
         {
-            _wanServer = new WanServer();
-            WanServer.WanRadioRadioListRecieved += WanServer_WanRadioListReceived;
-            _wanServer.WanApplicationRegistrationInvalid += WanServer_RegistrationInvalid;
-            _wanServer.WanRadioConnectReady += WanServer_RadioConnectReady;
-        }
-
-        if (!_wanServer.IsConnected)
-        {
-            _wanServer.Connect();
-
-            if (_wanServer.IsConnected)
+            var token = _smartLinkAuth.GetIdToken();
+            var platform = Environment.OSVersion.Platform.ToString();
+            if (_server.Register("NetKeyer", platform, token))
             {
-                var token = _smartLinkAuth.GetIdToken();
-                var platform = Environment.OSVersion.Platform.ToString();
-                _wanServer.SendRegisterApplicationMessageToServer("NetKeyer", platform, token);
-
                 RaiseStatusChanged("Connected to SmartLink", IsAuthenticated, GetButtonText());
             }
-            else
-            {
-                RaiseStatusChanged("Failed to connect to SmartLink server", IsAuthenticated, GetButtonText());
-            }
         }
-
-        await Task.CompletedTask;
-    }
-
-    public async Task<(bool Success, string WanConnectionHandle)> RequestWanConnectionAsync(string radioSerial, int timeoutMs = 10000)
-    {
-        if (_wanServer == null || !_wanServer.IsConnected)
+        else
         {
-            return (false, null);
+            RaiseStatusChanged("Failed to connect to SmartLink server", IsAuthenticated, GetButtonText());
         }
+    }
 
-        // Reset the event and subscribe to connect_ready event
-        _wanConnectionReadyEvent.Reset();
-
-        string capturedHandle = null;
-        EventHandler<WanConnectionReadyEventArgs> handler = (s, e) =>
-        {
-            if (e.Serial == radioSerial)
-            {
-                capturedHandle = e.WanConnectionHandle;
-                _wanConnectionReadyEvent.Set();
-            }
-        };
-
-        WanRadioConnectReady += handler;
-
-        try
-        {
-            // Request connection to this radio
-            _wanServer.SendConnectMessageToRadio(radioSerial, HolePunchPort: 0);
-
-            // Wait for connect_ready response (with timeout)
-            if (!_wanConnectionReadyEvent.WaitOne(timeoutMs))
-            {
-                return (false, null);
-            }
-
-            return (true, capturedHandle);
-        }
-        finally
-        {
-            WanRadioConnectReady -= handler;
-        }
+    /// <summary>
+    /// Asks the SmartLink server for a connection to <paramref name="radio"/>, negotiating a
+    /// hole punch port if the radio has no forwarded ports. On success the handle is to be set
+    /// as the radio's WANConnectionHandle before Radio.Connect().
+    /// </summary>
+    /// <exception cref="OperationCanceledException"><paramref name="cancellationToken"/> was
+    /// cancelled.</exception>
+    public async Task<(bool Success, string WanConnectionHandle)> RequestWanConnectionAsync(Radio radio,
+        int timeoutMs = SmartLinkServerConnection.DEFAULT_REQUEST_TIMEOUT_MS, CancellationToken cancellationToken = default)
+    {
+        var handle = await _server.RequestRadioConnectionAsync(radio, timeoutMs, cancellationToken);
+        return (handle != null, handle);
     }
 
     public List<Radio> GetCachedWanRadios()
@@ -288,7 +264,7 @@ public class SmartLinkManager
         _settings.Save();
 
         // Disconnect from WAN server
-        _wanServer?.Disconnect();
+        _server.Disconnect();
 
         RaiseStatusChanged("Registration invalid - please log in again", false, "Login to SmartLink");
         RegistrationInvalid?.Invoke(this, EventArgs.Empty);
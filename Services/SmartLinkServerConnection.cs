@@ -0,0 +1,238 @@
+using System;
+using System.Collections.Generic;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+using System.Threading.Tasks;
+using Flex.Smoothlake.FlexLib;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Services;
+
+/// <summary>
+/// The connection to the SmartLink server, without the authentication around it.
+///
+/// FlexLib's <see cref="WanServer"/> is synchronous: Connect() blocks on the TLS handshake and
+/// the reply to a radio connect request arrives later as an event. This wraps both as tasks
+/// that never block the caller. Concurrent <see cref="ConnectAsync"/> calls share one
+/// handshake, and each radio connect request completes from the server's connect_ready
+/// message, a timeout or the caller's cancellation token.
+///
+/// Radios behind NAT without forwarded ports are reached by UDP hole punching: the request
+/// carries a local port, and FlexLib then runs both the radio's TLS command connection and
+/// its UDP stream (the netcw keying path included) directly between that port and the
+/// radio's.
+/// </summary>
+public class SmartLinkServerConnection
+{
+    public const int DEFAULT_REQUEST_TIMEOUT_MS = 10000;
+    private const int HOLE_PUNCH_PORT_ATTEMPTS = 8;
+
+    private static readonly bool _debug = DebugCategory.SmartLink.IsEnabled;
+
+    private readonly WanServer _wanServer = new WanServer();
+    private readonly object _connectLock = new object();
+    private readonly Dictionary<string, TaskCompletionSource<string>> _pendingRequests = new Dictionary<string, TaskCompletionSource<string>>();
+    private Task<bool> _connectTask;
+    private bool _registered;
+
+    /// <param name="hostName">Server to connect to instead of FlexRadio's (a local stand-in).</param>
+    /// <param name="port">Its TLS port.</param>
+    public SmartLinkServerConnection(string hostName = null, int port = 0)
+    {
+        if (hostName != null)
+            _wanServer.HostName = hostName;
+        if (port != 0)
+            _wanServer.HostPort = port.ToString();
+
+        WanServer.WanRadioRadioListRecieved += WanServer_RadioListReceived;
+        _wanServer.WanApplicationRegistrationInvalid += WanServer_RegistrationInvalid;
+        _wanServer.WanRadioConnectReady += WanServer_RadioConnectReady;
+    }
+
+    public WanServer WanServer => _wanServer;
+
+    public bool IsConnected => _wanServer.IsConnected;
+
+    /// <summary>
+    /// Raised on FlexLib's receive thread with each radio list from the server.
+    /// </summary>
+    public event Action<List<Radio>> RadioListReceived;
+
+    public event Action RegistrationInvalid;
+
+    /// <summary>
+    /// Raised on FlexLib's receive thread for every connect_ready, with the WAN connection
+    /// handle and the radio's serial.
+    /// </summary>
+    public event Action<string, string> RadioConnectReady;
+
+    /// <summary>
+    /// Opens the TLS connection to the server on a thread-pool thread. Completes with whether
+    /// the server is connected; a handshake already in progress is shared rather than started
+    /// again. The token only stops the caller waiting, as FlexLib's handshake can't be aborted.
+    /// </summary>
+    public Task<bool> ConnectAsync(CancellationToken cancellationToken = default)
+    {
+        Task<bool> task;
+        lock (_connectLock)
+        {
+            if (_wanServer.IsConnected)
+                return Task.FromResult(true);
+
+            if (_connectTask == null || _connectTask.IsCompleted)
+            {
+                _connectTask = Task.Run(() =>
+                {
+                    long start = Timebase.Now;
+                    _wanServer.Connect();
+                    if (_debug) DebugLogger.Log(DebugCategory.SmartLink, $"[SmartLinkServerConnection] Connect to {_wanServer.HostName}:{_wanServer.HostPort} {(_wanServer.IsConnected ? "succeeded" : "failed")} in {Timebase.ElapsedMilliseconds(start):F0} ms");
+
+                    // A new connection needs registering again
+                    lock (_connectLock)
+                        _registered = false;
+                    return _wanServer.IsConnected;
+                });
+            }
+            task = _connectTask;
+        }
+        return task.WaitAsync(cancellationToken);
+    }
+
+    /// <summary>
+    /// Registers the application on the current connection, which makes the server send the
+    /// radio list. Returns false if not connected or already registered on this connection.
+    /// </summary>
+    public bool Register(string programName, string platform, string idToken)
+    {
+        lock (_connectLock)
+        {
+            if (!_wanServer.IsConnected || _registered)
+                return false;
+            _registered = true;
+        }
+
+        _wanServer.SendRegisterApplicationMessageToServer(programName, platform, idToken);
+        return true;
+    }
+
+    /// <summary>
+    /// Asks the server to set up a connection to <paramref name="radio"/> and returns the WAN
+    /// connection handle to set on it before Radio.Connect(), or null if the server isn't
+    /// connected or didn't answer within <paramref name="timeoutMs"/>. If the radio has no
+    /// forwarded ports, a hole punch port is negotiated and stored on the radio for FlexLib.
+    /// </summary>
+    /// <exception cref="OperationCanceledException"><paramref name="cancellationToken"/> was
+    /// cancelled.</exception>
+    public async Task<string> RequestRadioConnectionAsync(Radio radio, int timeoutMs = DEFAULT_REQUEST_TIMEOUT_MS,
+        CancellationToken cancellationToken = default)
+    {
+        if (radio == null || !_wanServer.IsConnected)
+            return null;
+
+        int holePunchPort = 0;
+        if (radio.RequiresHolePunch)
+        {
+            holePunchPort = AllocateHolePunchPort();
+            if (holePunchPort == 0)
+            {
+                Console.WriteLine($"SmartLink: no local port free for hole punching to {radio.Serial}");
+                return null;
+            }
+            radio.NegotiatedHolePunchPort = holePunchPort;
+        }
+
+        string serial = radio.Serial;
+        var request = new TaskCompletionSource<string>(TaskCreationOptions.RunContinuationsAsynchronously);
+        lock (_pendingRequests)
+        {
+            // A newer request for the same radio supersedes the old one
+            if (_pendingRequests.TryGetValue(serial, out var previous))
+                previous.TrySetResult(null);
+            _pendingRequests[serial] = request;
+        }
+
+        long start = Timebase.Now;
+        try
+        {
+            _wanServer.SendConnectMessageToRadio(serial, holePunchPort);
+            string handle = await request.Task.WaitAsync(TimeSpan.FromMilliseconds(timeoutMs), cancellationToken);
+            if (_debug) DebugLogger.Log(DebugCategory.SmartLink, $"[SmartLinkServerConnection] connect_ready for {serial} after {Timebase.ElapsedMilliseconds(start):F0} ms{(holePunchPort != 0 ? $", hole punch port {holePunchPort}" : "")}");
+            return handle;
+        }
+        catch (TimeoutException)
+        {
+            if (_debug) DebugLogger.Log(DebugCategory.SmartLink, $"[SmartLinkServerConnection] No connect_ready for {serial} within {timeoutMs} ms");
+            return null;
+        }
+        finally
+        {
+            lock (_pendingRequests)
+            {
+                if (_pendingRequests.TryGetValue(serial, out var current) && current == request)
+                    _pendingRequests.Remove(serial);
+            }
+        }
+    }
+
+    public void Disconnect()
+    {
+        _wanServer.Disconnect();
+
+        // Nothing will answer requests made on the old connection
+        lock (_pendingRequests)
+        {
+            foreach (var request in _pendingRequests.Values)
+                request.TrySetResult(null);
+            _pendingRequests.Clear();
+        }
+    }
+
+    /// <summary>
+    /// Picks a local port that is free for both TCP and UDP, since FlexLib binds the radio's
+    /// TLS connection and its UDP stream to the same hole punch port. Returns 0 if none was found.
+    /// </summary>
+    private static int AllocateHolePunchPort()
+    {
+        for (int attempt = 0; attempt < HOLE_PUNCH_PORT_ATTEMPTS; attempt++)
+        {
+            try
+            {
+                using var udp = new Socket(AddressFamily.InterNetwork, SocketType.Dgram, ProtocolType.Udp);
+                udp.Bind(new IPEndPoint(IPAddress.Any, 0));
+                int port = ((IPEndPoint)udp.LocalEndPoint).Port;
+
+                using var tcp = new Socket(AddressFamily.InterNetwork, SocketType.Stream, ProtocolType.Tcp);
+                tcp.Bind(new IPEndPoint(IPAddress.Any, port));
+                return port;
+            }
+            catch (SocketException)
+            {
+                // Taken for TCP; try another
+            }
+        }
+        return 0;
+    }
+
+    private void WanServer_RadioListReceived(List<Radio> radios)
+    {
+        RadioListReceived?.Invoke(radios);
+    }
+
+    private void WanServer_RegistrationInvalid()
+    {
+        RegistrationInvalid?.Invoke();
+    }
+
+    private void WanServer_RadioConnectReady(string wanConnectionHandle, string serial)
+    {
+        TaskCompletionSource<string> request;
+        lock (_pendingRequests)
+        {
+            if (_pendingRequests.Remove(serial, out request))
+                request.TrySetResult(wanConnectionHandle);
+        }
+
+        RadioConnectReady?.Invoke(wanConnectionHandle, serial);
+    }
+}
@@ -86,11 +86,11 @@ public class TransmitSliceMonitor
             bool wasCW = _isTransmitModeCW;
             _isTransmitModeCW = (mode == "CW");
 
-            DebugLogger.Log("slice", $"[TransmitSliceMode] Slice {txSlice.Index} mode: {mode}, isCW: {_isTransmitModeCW}");
+            DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode] Slice {txSlice.Index} mode: {mode}, isCW: {_isTransmitModeCW}");
 
             if (wasCW != _isTransmitModeCW)
             {
-                DebugLogger.Log("slice", $"[TransmitSliceMode] Mode changed from {(wasCW ? "CW" : "non-CW")} to {(_isTransmitModeCW ? "CW" : "non-CW")}");
+                DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode] Mode changed from {(wasCW ? "CW" : "non-CW")} to {(_isTransmitModeCW ? "CW" : "non-CW")}");
 
                 // Notify listeners
                 TransmitModeChanged?.Invoke(this, new TransmitModeChangedEventArgs { IsTransmitModeCW = _isTransmitModeCW });
@@ -98,7 +98,7 @@ public class TransmitSliceMonitor
         }
         else
         {
-            DebugLogger.Log("slice", $"[TransmitSliceMode] No transmit slice for our client, defaulting to CW mode");
+            DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode] No transmit slice for our client, defaulting to CW mode");
 
             bool wasCW = _isTransmitModeCW;
             _isTransmitModeCW = true; // Default to CW mode if no transmit slice
@@ -119,13 +119,13 @@ public class TransmitSliceMonitor
         // Debug: Check radio and slices
         if (_connectedRadio != null)
         {
-            DebugLogger.Log("slice", $"[TransmitSliceMode] Connected radio has {_connectedRadio.SliceList.Count} slices");
-            DebugLogger.Log("slice", $"[TransmitSliceMode] Our bound ClientHandle: {_boundGuiClientHandle}");
-            DebugLogger.Log("slice", $"[TransmitSliceMode] Radio's internal ClientHandle: {_connectedRadio.ClientHandle}");
+            DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode] Connected radio has {_connectedRadio.SliceList.Count} slices");
+            DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode] Our bound ClientHandle: {_boundGuiClientHandle}");
+            DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode] Radio's internal ClientHandle: {_connectedRadio.ClientHandle}");
 
             foreach (var slice in _connectedRadio.SliceList)
             {
-                DebugLogger.Log("slice", $"[TransmitSliceMode]   Slice {slice.Index}: IsTransmitSlice={slice.IsTransmitSlice}, ClientHandle={slice.ClientHandle}, Mode={slice.DemodMode}");
+                DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode]   Slice {slice.Index}: IsTransmitSlice={slice.IsTransmitSlice}, ClientHandle={slice.ClientHandle}, Mode={slice.DemodMode}");
             }
         }
 
@@ -136,11 +136,11 @@ public class TransmitSliceMonitor
             _monitoredTransmitSlice = txSlice;
             _monitoredTransmitSlice.PropertyChanged += TransmitSlice_PropertyChanged;
 
-            DebugLogger.Log("slice", $"[TransmitSliceMode] Subscribed to slice {_monitoredTransmitSlice.Index}");
+            DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode] Subscribed to slice {_monitoredTransmitSlice.Index}");
         }
         else
         {
-            DebugLogger.Log("slice", $"[TransmitSliceMode] No transmit slice found for our client");
+            DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode] No transmit slice found for our client");
         }
 
         UpdateTransmitSliceMode();
@@ -150,7 +150,7 @@ public class TransmitSliceMonitor
     {
         if (e.PropertyName == "DemodMode")
         {
-            DebugLogger.Log("slice", $"[TransmitSliceMode] DemodMode property changed");
+            DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode] DemodMode property changed");
             UpdateTransmitSliceMode();
         }
     }
@@ -160,7 +160,7 @@ public class TransmitSliceMonitor
         // Handle TransmitSlice changes (needs to be done outside UI thread)
         if (e.PropertyName == "TransmitSlice")
         {
-            DebugLogger.Log("slice", $"[TransmitSliceMode] Radio TransmitSlice property changed");
+            DebugLogger.Log(DebugCategory.Slice, $"[TransmitSliceMode] Radio TransmitSlice property changed");
             SubscribeToTransmitSlice();
         }
     }
@@ -76,92 +76,92 @@ public partial class AboutWindowViewModel : ViewModelBase
             IsCheckingForUpdates = true;
             UpdateStatus = "Checking for updates...";
 
-            DebugLogger.Log("update", "=== Manual update check started ===");
-            DebugLogger.Log("update", $"Current time: {DateTime.Now:yyyy-MM-dd HH:mm:ss}");
+            DebugLogger.Log(DebugCategory.Update, "=== Manual update check started ===");
+            DebugLogger.Log(DebugCategory.Update, $"Current time: {DateTime.Now:yyyy-MM-dd HH:mm:ss}");
 
-            DebugLogger.Log("update", "Creating GithubSource...");
+            DebugLogger.Log(DebugCategory.Update, "Creating GithubSource...");
             var source = new GithubSource("https://github.com/NetKeyer/NetKeyer", null, false);
-            DebugLogger.Log("update", "GithubSource created successfully");
+            DebugLogger.Log(DebugCategory.Update, "GithubSource created successfully");
 
-            DebugLogger.Log("update", "Creating UpdateManager...");
+            DebugLogger.Log(DebugCategory.Update, "Creating UpdateManager...");
             var mgr = new UpdateManager(source);
-            DebugLogger.Log("update", $"UpdateManager initialized");
-            DebugLogger.Log("update", $"  IsInstalled: {mgr.IsInstalled}");
-            DebugLogger.Log("update", $"  AppId: {mgr.AppId}");
-            DebugLogger.Log("update", $"  UpdateUrl: https://github.com/NetKeyer/NetKeyer");
+            DebugLogger.Log(DebugCategory.Update, $"UpdateManager initialized");
+            DebugLogger.Log(DebugCategory.Update, $"  IsInstalled: {mgr.IsInstalled}");
+            DebugLogger.Log(DebugCategory.Update, $"  AppId: {mgr.AppId}");
+            DebugLogger.Log(DebugCategory.Update, $"  UpdateUrl: https://github.com/NetKeyer/NetKeyer");
 
             if (!mgr.IsInstalled)
             {
-                DebugLogger.Log("update", "App not installed via Velopack - running in development mode");
+                DebugLogger.Log(DebugCategory.Update, "App not installed via Velopack - running in development mode");
                 UpdateStatus = "App is not installed via Velopack (running in development mode)";
                 return;
             }
 
-            DebugLogger.Log("update", $"Current version: {mgr.CurrentVersion}");
+            DebugLogger.Log(DebugCategory.Update, $"Current version: {mgr.CurrentVersion}");
 
             // Log system information
-            DebugLogger.Log("update", $"Operating System: {Environment.OSVersion}");
-            DebugLogger.Log("update", $"64-bit OS: {Environment.Is64BitOperatingSystem}");
-            DebugLogger.Log("update", $"64-bit Process: {Environment.Is64BitProcess}");
+            DebugLogger.Log(DebugCategory.Update, $"Operating System: {Environment.OSVersion}");
+            DebugLogger.Log(DebugCategory.Update, $"64-bit OS: {Environment.Is64BitOperatingSystem}");
+            DebugLogger.Log(DebugCategory.Update, $"64-bit Process: {Environment.Is64BitProcess}");
 
-            DebugLogger.Log("update", "Calling CheckForUpdatesAsync() - this will query GitHub releases...");
-            DebugLogger.Log("update", $"GitHub URL: https://github.com/NetKeyer/NetKeyer");
-            DebugLogger.Log("update", $"Thread ID: {System.Threading.Thread.CurrentThread.ManagedThreadId}");
+            DebugLogger.Log(DebugCategory.Update, "Calling CheckForUpdatesAsync() - this will query GitHub releases...");
+            DebugLogger.Log(DebugCategory.Update, $"GitHub URL: https://github.com/NetKeyer/NetKeyer");
+            DebugLogger.Log(DebugCategory.Update, $"Thread ID: {System.Threading.Thread.CurrentThread.ManagedThreadId}");
 
             // Add a 30-second timeout to prevent indefinite hanging
             var checkTask = mgr.CheckForUpdatesAsync();
-            DebugLogger.Log("update", "CheckForUpdatesAsync task started, waiting for completion...");
+            DebugLogger.Log(DebugCategory.Update, "CheckForUpdatesAsync task started, waiting for completion...");
 
             var timeoutTask = Task.Delay(TimeSpan.FromSeconds(30));
             var completedTask = await Task.WhenAny(checkTask, timeoutTask);
 
             if (completedTask == timeoutTask)
             {
-                DebugLogger.Log("update", "CheckForUpdatesAsync() timed out after 30 seconds");
-                DebugLogger.Log("update", $"Task status: {checkTask.Status}");
-                DebugLogger.Log("update", $"Task is completed: {checkTask.IsCompleted}");
-                DebugLogger.Log("update", $"Task is faulted: {checkTask.IsFaulted}");
+                DebugLogger.Log(DebugCategory.Update, "CheckForUpdatesAsync() timed out after 30 seconds");
+                DebugLogger.Log(DebugCategory.Update, $"Task status: {checkTask.Status}");
+                DebugLogger.Log(DebugCategory.Update, $"Task is completed: {checkTask.IsCompleted}");
+                DebugLogger.Log(DebugCategory.Update, $"Task is faulted: {checkTask.IsFaulted}");
                 throw new TimeoutException("Update check timed out after 30 seconds. Please check your internet connection and try again.");
             }
 
-            DebugLogger.Log("update", "CheckForUpdatesAsync task completed within timeout");
+            DebugLogger.Log(DebugCategory.Update, "CheckForUpdatesAsync task completed within timeout");
             var updateInfo = await checkTask;
 
-            DebugLogger.Log("update", $"CheckForUpdatesAsync() completed");
-            DebugLogger.Log("update", $"  updateInfo is null: {updateInfo == null}");
+            DebugLogger.Log(DebugCategory.Update, $"CheckForUpdatesAsync() completed");
+            DebugLogger.Log(DebugCategory.Update, $"  updateInfo is null: {updateInfo == null}");
 
             if (updateInfo == null)
             {
-                DebugLogger.Log("update", "No updates available - already on latest version");
+                DebugLogger.Log(DebugCategory.Update, "No updates available - already on latest version");
                 UpdateStatus = "You are running the latest version!";
                 return;
             }
 
             // Log detailed update information
-            DebugLogger.Log("update", "=== UPDATE FOUND ===");
-            DebugLogger.Log("update", $"Target version: {updateInfo.TargetFullRelease?.Version}");
+            DebugLogger.Log(DebugCategory.Update, "=== UPDATE FOUND ===");
+            DebugLogger.Log(DebugCategory.Update, $"Target version: {updateInfo.TargetFullRelease?.Version}");
 
             if (updateInfo.TargetFullRelease != null)
             {
                 var release = updateInfo.TargetFullRelease;
-                DebugLogger.Log("update", $"  FileName: {release.FileName}");
-                DebugLogger.Log("update", $"  SHA256: {release.SHA256}");
-                DebugLogger.Log("update", $"  Size: {release.Size} bytes");
-                DebugLogger.Log("update", $"  Type: {release.Type}");
+                DebugLogger.Log(DebugCategory.Update, $"  FileName: {release.FileName}");
+                DebugLogger.Log(DebugCategory.Update, $"  SHA256: {release.SHA256}");
+                DebugLogger.Log(DebugCategory.Update, $"  Size: {release.Size} bytes");
+                DebugLogger.Log(DebugCategory.Update, $"  Type: {release.Type}");
             }
 
             UpdateStatus = $"Update available: {updateInfo.TargetFullRelease?.Version}";
 
-            DebugLogger.Log("update", "Downloading update...");
+            DebugLogger.Log(DebugCategory.Update, "Downloading update...");
             UpdateStatus = "Downloading update...";
 
             await mgr.DownloadUpdatesAsync(updateInfo, progress =>
             {
-                DebugLogger.Log("update", $"Download progress: {progress}%");
+                DebugLogger.Log(DebugCategory.Update, $"Download progress: {progress}%");
                 UpdateStatus = $"Downloading update... {progress}%";
             });
 
-            DebugLogger.Log("update", "Download complete!");
+            DebugLogger.Log(DebugCategory.Update, "Download complete!");
 
             // Ask user if they want to restart
             var messageBox = MessageBoxManager.GetMessageBoxStandard(
@@ -173,7 +173,7 @@ public partial class AboutWindowViewModel : ViewModelBase
 
             if (result == ButtonResult.Yes)
             {
-                DebugLogger.Log("update", "User confirmed restart - applying update...");
+                DebugLogger.Log(DebugCategory.Update, "User confirmed restart - applying update...");
                 UpdateStatus = "Restarting to apply update...";
 
                 // Apply update and restart
@@ -181,24 +181,24 @@ public partial class AboutWindowViewModel : ViewModelBase
             }
             else
             {
-                DebugLogger.Log("update", "User postponed update installation");
+                DebugLogger.Log(DebugCategory.Update, "User postponed update installation");
                 UpdateStatus = "Update downloaded - restart app to install";
             }
         }
         catch (Exception ex)
         {
-            DebugLogger.Log("update", $"=== UPDATE CHECK FAILED ===");
-            DebugLogger.Log("update", $"Exception type: {ex.GetType().FullName}");
-            DebugLogger.Log("update", $"Message: {ex.Message}");
-            DebugLogger.Log("update", $"Stack trace:");
-            DebugLogger.Log("update", ex.StackTrace ?? "(no stack trace)");
+            DebugLogger.Log(DebugCategory.Update, $"=== UPDATE CHECK FAILED ===");
+            DebugLogger.Log(DebugCategory.Update, $"Exception type: {ex.GetType().FullName}");
+            DebugLogger.Log(DebugCategory.Update, $"Message: {ex.Message}");
+            DebugLogger.Log(DebugCategory.Update, $"Stack trace:");
+            DebugLogger.Log(DebugCategory.Update, ex.StackTrace ?? "(no stack trace)");
 
             if (ex.InnerException != null)
             {
-                DebugLogger.Log("update", $"Inner exception type: {ex.InnerException.GetType().FullName}");
-                DebugLogger.Log("update", $"Inner message: {ex.InnerException.Message}");
-                DebugLogger.Log("update", $"Inner stack trace:");
-                DebugLogger.Log("update", ex.InnerException.StackTrace ?? "(no stack trace)");
+                DebugLogger.Log(DebugCategory.Update, $"Inner exception type: {ex.InnerException.GetType().FullName}");
+                DebugLogger.Log(DebugCategory.Update, $"Inner message: {ex.InnerException.Message}");
+                DebugLogger.Log(DebugCategory.Update, $"Inner stack trace:");
+                DebugLogger.Log(DebugCategory.Update, ex.InnerException.StackTrace ?? "(no stack trace)");
             }
 
             UpdateStatus = $"Update check failed: {ex.Message}";
@@ -213,7 +213,7 @@ public partial class AboutWindowViewModel : ViewModelBase
         finally
         {
             IsCheckingForUpdates = false;
-            DebugLogger.Log("update", "=== Update check completed ===");
+            DebugLogger.Log(DebugCategory.Update, "=== Update check completed ===");
         }
     }
 
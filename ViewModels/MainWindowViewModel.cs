@@ -13,22 +13,19 @@ using CommunityToolkit.Mvvm.ComponentModel;
 using CommunityToolkit.Mvvm.Input;
 using Flex.Smoothlake.FlexLib;
 using NetKeyer.Audio;
+using NetKeyer.Evdev;
 using NetKeyer.Helpers;
 using NetKeyer.Keying;
 using NetKeyer.Midi;
 using NetKeyer.Models;
+using NetKeyer.Network;
+using NetKeyer.Realtime;
 using NetKeyer.Services;
 using NetKeyer.SmartLink;
 using PortAudioSharp;
 
 namespace NetKeyer.ViewModels;
 
-public enum InputDeviceType
-{
-    Serial,
-    MIDI
-}
-
 public enum PageType
 {
     Setup,
@@ -54,7 +51,7 @@ public partial class MainWindowViewModel : ViewModelBase
     private PageType _currentPage = PageType.Setup;
 
     [ObservableProperty]
-    [NotifyPropertyChangedFor(nameof(IsSerialInput), nameof(IsMidiInput))]
+    [NotifyPropertyChangedFor(nameof(IsSerialInput), nameof(IsMidiInput), nameof(IsEvdevInput), nameof(IsNetworkInput))]
     private InputDeviceType _inputType = InputDeviceType.Serial;
 
     public bool IsSetupPage => CurrentPage == PageType.Setup;
@@ -72,6 +69,21 @@ public partial class MainWindowViewModel : ViewModelBase
         set { if (value) InputType = InputDeviceType.MIDI; }
     }
 
+    public bool IsEvdevInput
+    {
+        get => InputType == InputDeviceType.Evdev;
+        set { if (value) InputType = InputDeviceType.Evdev; }
+    }
+
+    public bool IsNetworkInput
+    {
+        get => InputType == InputDeviceType.Network;
+        set { if (value) InputType = InputDeviceType.Network; }
+    }
+
+    // Raw evdev input devices only exist on Linux
+    public bool IsEvdevAvailable => EvdevPaddleInput.IsSupported;
+
     [ObservableProperty]
     private ObservableCollection<RadioClientSelection> _radioClientSelections = new();
 
@@ -90,6 +102,18 @@ public partial class MainWindowViewModel : ViewModelBase
     [ObservableProperty]
     private string _selectedMidiDevice;
 
+    [ObservableProperty]
+    private ObservableCollection<string> _evdevDevices = new();
+
+    [ObservableProperty]
+    private string _selectedEvdevDevice;
+
+    [ObservableProperty]
+    private int _networkInputPort = NetworkPaddleInput.DEFAULT_PORT;
+
+    [ObservableProperty]
+    private string _networkInputStatus = "";
+
     [ObservableProperty]
     private ObservableCollection<AudioDeviceInfo> _audioDevices = new();
 
@@ -139,6 +163,10 @@ public partial class MainWindowViewModel : ViewModelBase
     private string _rightPaddleStateText = "OFF";
 
     private Radio _connectedRadio;
+
+    // Radio connected directly from its remembered address at startup. It stands in for the
+    // instance discovery creates for the same serial while it is connected
+    private Radio _rememberedRadio;
     private uint _boundGuiClientHandle = 0;
     private UserSettings _settings;
     private bool _loadingSettings = false; // Prevent saving while loading
@@ -155,6 +183,9 @@ public partial class MainWindowViewModel : ViewModelBase
     // SmartLink support
     private SmartLinkManager _smartLinkManager;
 
+    // Cancels a radio connection in progress (on exit)
+    private CancellationTokenSource _connectCancellation;
+
     // Transmit slice monitoring
     private TransmitSliceMonitor _transmitSliceMonitor;
 
@@ -167,6 +198,31 @@ public partial class MainWindowViewModel : ViewModelBase
     // Keying controller
     private KeyingController _keyingController;
 
+    // Paddle indicators are decoupled from the keying path: the input thread only
+    // publishes the latest state word (edge sequence << 8 | PaddleState bits) and a
+    // frame-rate timer on the UI thread renders it when it has changed
+    private const int INDICATOR_REFRESH_MS = 16;
+    private long _indicatorStateWord;
+    private long _indicatorSequence;
+    private long _renderedIndicatorStateWord;
+    private DispatcherTimer _indicatorTimer;
+
+    // Network input link statistics are refreshed about once a second from the indicator timer
+    private const int NETWORK_STATUS_INTERVAL_TICKS = 1000 / INDICATOR_REFRESH_MS;
+    private int _networkStatusTicks;
+
+    private static readonly bool _inputDebug = DebugCategory.Input.IsEnabled;
+
+    // Startup phase timing ("startup" debug category)
+    private readonly long _startupTimestamp = Timebase.Now;
+    private static readonly bool _startupDebug = DebugCategory.Startup.IsEnabled;
+    private bool _firstInputDeviceOpened;
+    private bool _startupAudioDone;
+    private bool _readyToKeyLogged;
+
+    [ObservableProperty]
+    private string _startupStatus = "";
+
     [ObservableProperty]
     private bool _smartLinkAvailable = false;
 
@@ -198,10 +254,29 @@ public partial class MainWindowViewModel : ViewModelBase
     [ObservableProperty]
     private bool _rightPaddleVisible = true;  // Hide right paddle when appropriate
 
+    [ObservableProperty]
+    [NotifyPropertyChangedFor(nameof(KeyingTraceMenuHeader))]
+    private bool _isKeyingTraceRecording = KeyingTrace.IsEnabled;  // Started from the menu or NETKEYER_TRACE
+
     public MainWindowViewModel()
     {
+        LogStartupPhase("view model construction started");
+
         // Load user settings
         _settings = UserSettings.Load();
+        LogStartupPhase("settings loaded");
+
+        // Before any audio, input or keying thread starts, so each applies it on its first pass
+        try
+        {
+            RealtimeProfile.Configure(_settings.RealtimeProfile, _settings.RealtimeCores, _settings.RealtimeIsolateCores);
+            if (RealtimeProfile.IsEnabled)
+                Console.WriteLine(RealtimeProfile.Describe());
+        }
+        catch (ArgumentException ex)
+        {
+            Console.WriteLine(ex.Message);
+        }
 
         // Initialize SmartLink support
         _smartLinkManager = new SmartLinkManager(_settings);
@@ -212,21 +287,25 @@ public partial class MainWindowViewModel : ViewModelBase
 
         SmartLinkAvailable = _smartLinkManager.IsAvailable;
 
-        // Try to restore SmartLink session from saved refresh token
-        if (_smartLinkManager.IsAvailable)
-        {
-            Task.Run(async () => await _smartLinkManager.TryRestoreSessionAsync());
-        }
-
-        // Initialize FlexLib API
-        API.ProgramName = "NetKeyer";
-        API.RadioAdded += OnRadioAdded;
-        API.RadioRemoved += OnRadioRemoved;
-        API.Init();
-
         // Initialize input device manager (must be done before RefreshSerialPorts/RefreshMidiDevices)
         _inputDeviceManager = new InputDeviceManager();
         _inputDeviceManager.PaddleStateChanged += InputDeviceManager_PaddleStateChanged;
+        try
+        {
+            _inputDeviceManager.SetNetworkInputAccess(_settings.NetworkInputBindAddress, _settings.NetworkInputAllowedSenders);
+        }
+        catch (Exception ex)
+        {
+            Console.WriteLine(ex.Message);
+        }
+        try
+        {
+            _inputDeviceManager.SetForwardTarget(_settings.NetworkForwardTarget);
+        }
+        catch (Exception ex)
+        {
+            Console.WriteLine(ex.Message);
+        }
 
         // Apply saved input type
         _loadingSettings = true;
@@ -234,37 +313,248 @@ public partial class MainWindowViewModel : ViewModelBase
         {
             InputType = InputDeviceType.MIDI;
         }
+        else if (_settings.InputType == "Evdev" && EvdevPaddleInput.IsSupported)
+        {
+            InputType = InputDeviceType.Evdev;
+        }
+        else if (_settings.InputType == "Network")
+        {
+            InputType = InputDeviceType.Network;
+        }
+        NetworkInputPort = _settings.NetworkInputPort;
         _loadingSettings = false;
 
-        // Initial discovery
+        // Initialize keying controller. The sidetone generator is attached when audio
+        // startup completes; until then the controller simply has no keyer to drive.
+        _keyingController = new KeyingController(null);
+        _keyingController.Initialize(
+            _boundGuiClientHandle,
+            GetTimestamp,
+            (state, timestamp, handle) =>
+            {
+                if (_connectedRadio != null)
+                    _connectedRadio.CWKey(state, Timebase.FormatRadioTimestamp(timestamp), handle);
+            }
+        );
+        _keyingController.SetKeyingMode(IsIambicMode, IsIambicModeB);
+        _keyingController.SetSpeed(CwSpeed);
+        _keyingController.UpdateParameters(p => p.WithSwapPaddles(SwapPaddles).WithPitch(CwPitch)
+            .WithMaxKeyDown(_settings.MaxKeyDownMs).WithPttTiming(_settings.PttDebounceMs, _settings.PttHangMs));
+
+        // Initialize transmit slice monitor
+        _transmitSliceMonitor = new TransmitSliceMonitor();
+        _transmitSliceMonitor.TransmitModeChanged += TransmitSliceMonitor_ModeChanged;
+
+        // Initialize radio settings synchronizer
+        _radioSettingsSynchronizer = new RadioSettingsSynchronizer();
+        _radioSettingsSynchronizer.SettingChangedFromRadio += RadioSettingsSynchronizer_SettingChanged;
+        _radioSettingsSynchronizer.SetKeyStateSource(() => _keyingController?.IsRadioKeyDown == true);
+        _radioSettingsSynchronizer.SetKeyerParameterSink(ApplyKeyerParametersFromRadio);
+
+        // Radio list starts with just the sidetone-only entry; discovered radios are
+        // added as FlexLib reports them
         RefreshRadios();
-        RefreshSerialPorts();
-        RefreshMidiDevices();
 
-        // Initialize sidetone generator first with default device
-        // This initializes PortAudio (on non-Windows) which is needed for device enumeration
+        _ = RunStartupAsync();
+    }
+
+    /// <summary>
+    /// Brings up audio, device lists, radio discovery and SmartLink concurrently so the window
+    /// is usable immediately. The audio device and the device list for the saved input type
+    /// are started first since they gate keying; everything else fills in as it completes.
+    /// </summary>
+    private async Task RunStartupAsync()
+    {
+        StartupStatus = "Starting audio and scanning devices...";
+
+        // Keying-critical work first: open the saved audio device directly (rather than the
+        // default device followed by a reopen) and enumerate the saved input type
+        string audioDeviceId = _settings.SelectedAudioDeviceId;
+        bool aggressiveLowLatency = _settings.WasapiAggressiveLowLatency;
+        int volume = SidetoneVolume;
+        var audioTask = Task.Run(() => CreateStartupSidetoneGenerator(audioDeviceId, aggressiveLowLatency, volume));
+
+        var savedInputType = InputType;
+        var savedInputTask = Task.Run(() => DiscoverInputDevices(savedInputType));
+
+        // FlexLib discovery and SmartLink session restore don't gate local keying
+        API.ProgramName = "NetKeyer";
+        API.RadioAdded += OnRadioAdded;
+        API.RadioRemoved += OnRadioRemoved;
+        var discoveryTask = Task.Run(() =>
+        {
+            API.Init();
+            LogStartupPhase("radio discovery started");
+        });
+
+        // Discovery takes a broadcast interval or more; connect to last session's radio directly
+        var reconnectTask = ConnectToRememberedRadioAsync();
+
+        if (_smartLinkManager.IsAvailable)
+        {
+            _ = Task.Run(async () =>
+            {
+                await _smartLinkManager.TryRestoreSessionAsync();
+                LogStartupPhase("SmartLink session restore finished");
+            });
+        }
+
+        // Remaining input types, for when the user switches type on the setup page
+        var otherInputTasks = Enum.GetValues<InputDeviceType>()
+            .Where(t => t != savedInputType)
+            .Select(t => Task.Run(() => DiscoverInputDevices(t)))
+            .ToList();
+
+        PopulateInputDevices(savedInputType, await savedInputTask);
+        LogStartupPhase($"{savedInputType} devices enumerated");
+
+        // The saved input device is selectable now, so the reconnect can finish whenever it's ready
+        _ = CompleteStartupReconnectAsync(reconnectTask);
+
         try
         {
-            bool aggressiveLowLatency = _settings.WasapiAggressiveLowLatency;
-            _sidetoneGenerator = SidetoneGeneratorFactory.Create(null, aggressiveLowLatency);
-            _sidetoneGenerator.SetFrequency(CwPitch);
-            _sidetoneGenerator.SetVolume(SidetoneVolume);
-            _sidetoneGenerator.SetWpm(CwSpeed);
+            _sidetoneGenerator = await audioTask;
+            _keyingController?.SetSidetoneGenerator(_sidetoneGenerator);
+            LogStartupPhase("sidetone generator ready");
         }
         catch (Exception ex)
         {
             Console.WriteLine($"Warning: Could not initialize sidetone generator: {ex.Message}");
         }
 
-        // Now enumerate audio devices (requires PortAudio to be initialized on non-Windows)
-        RefreshAudioDevices();
+        // Audio enumeration requires PortAudio to be initialized on non-Windows, which
+        // creating the generator has done
+        var audioDevices = await Task.Run(() => EnumerateAudioDevices());
+        PopulateAudioDevices(audioDevices);
+        LogStartupPhase("audio devices enumerated");
 
-        // If a non-default device was selected from settings, reinitialize with that device
-        if (SelectedAudioDevice != null && !string.IsNullOrEmpty(SelectedAudioDevice.DeviceId))
+        StartKeepAwakeStream();
+
+        _startupAudioDone = true;
+        LogStartupPhase("audio ready");
+        LogReadyToKeyIfReady();
+
+        foreach (var task in otherInputTasks)
         {
-            ReinitializeSidetoneGenerator();
+            var (type, devices) = await task;
+            PopulateInputDevices(type, devices);
         }
+        LogStartupPhase("all input devices enumerated");
 
+        try
+        {
+            await discoveryTask;
+        }
+        catch (Exception ex)
+        {
+            Console.WriteLine($"Failed to start radio discovery: {ex.Message}");
+        }
+
+        StartupStatus = "";
+        LogStartupPhase("startup complete");
+    }
+
+    /// <summary>
+    /// Connects to the LAN radio and station saved from the last session using its remembered
+    /// address, in parallel with discovery. Completes with a null radio if nothing is saved or
+    /// the radio isn't reachable there any more; discovery then works as usual.
+    /// </summary>
+    private Task<(Radio Radio, GUIClient GuiClient)> ConnectToRememberedRadioAsync()
+    {
+        string serial = _settings.SelectedRadioSerial;
+        string station = _settings.SelectedGuiClientStation;
+        string address = _settings.SelectedRadioAddress;
+        if (string.IsNullOrEmpty(serial) || string.IsNullOrEmpty(station) || string.IsNullOrEmpty(address))
+            return Task.FromResult<(Radio, GUIClient)>(default);
+
+        string model = _settings.SelectedRadioModel;
+        string nickname = _settings.SelectedRadioNickname;
+        string version = _settings.SelectedRadioVersion;
+        return Task.Run<(Radio, GUIClient)>(() =>
+        {
+            var radio = RadioConnector.CreateRememberedRadio(model, serial, nickname, address, version);
+            if (radio == null || !radio.Connect())
+            {
+                DebugLogger.Log(DebugCategory.RadioSelect, $"[Startup] Remembered radio {serial} not reachable at {address}");
+                return default;
+            }
+
+            var guiClient = RadioConnector.WaitForGuiClient(radio, c => c.Station == station);
+            if (guiClient == null)
+            {
+                DebugLogger.Log(DebugCategory.RadioSelect, $"[Startup] Station '{station}' not found on remembered radio {serial}");
+                radio.Disconnect();
+                return default;
+            }
+
+            LogStartupPhase($"connected to remembered radio {serial} at {address}");
+            return (radio, guiClient);
+        });
+    }
+
+    private async Task CompleteStartupReconnectAsync(Task<(Radio Radio, GUIClient GuiClient)> reconnectTask)
+    {
+        Radio radio = null;
+        GUIClient guiClient = null;
+        try
+        {
+            (radio, guiClient) = await reconnectTask;
+        }
+        catch (Exception ex)
+        {
+            DebugLogger.Log(DebugCategory.RadioSelect, $"[Startup] Reconnect to remembered radio failed: {ex.Message}");
+        }
+
+        if (radio == null)
+            return;
+
+        // The user got there first (connected, or chose sidetone-only): drop the direct connection
+        if (_connectedRadio != null || _isSidetoneOnlyMode)
+        {
+            radio.Disconnect();
+            return;
+        }
+
+        _connectedRadio = radio;
+        _rememberedRadio = radio;
+        HasRadioError = false;
+        CompleteRadioConnection(guiClient);
+
+        // Show the connection in the radio list, even before discovery has seen the radio
+        RebuildRadioSelections(radio.Serial);
+        var selection = RadioClientSelections.FirstOrDefault(s => s.Radio == radio && s.GuiClient?.Station == guiClient.Station);
+        if (selection != null && SelectedRadioClient != selection)
+        {
+            _loadingSettings = true;
+            SelectedRadioClient = selection;
+            _loadingSettings = false;
+        }
+        LogStartupPhase("reconnected to remembered radio");
+    }
+
+    /// <summary>
+    /// Pitch and speed come from the keying controller when the generator is attached to it.
+    /// </summary>
+    private static ISidetoneGenerator CreateStartupSidetoneGenerator(string deviceId, bool aggressiveLowLatency, int volume)
+    {
+        ISidetoneGenerator generator;
+        try
+        {
+            generator = SidetoneGeneratorFactory.Create(deviceId, aggressiveLowLatency);
+        }
+        catch (Exception ex) when (!string.IsNullOrEmpty(deviceId))
+        {
+            // Saved device may have been unplugged; fall back to the system default
+            DebugLogger.Log(DebugCategory.Audio, $"Saved audio device '{deviceId}' unavailable, using default: {ex.Message}");
+            generator = SidetoneGeneratorFactory.Create(null, aggressiveLowLatency);
+        }
+
+        generator.SetVolume(volume);
+        return generator;
+    }
+
+    private void StartKeepAwakeStream()
+    {
         // Initialize keep-awake stream if enabled
         if (_settings.KeepAudioDeviceAwake)
         {
@@ -276,31 +566,29 @@ public partial class MainWindowViewModel : ViewModelBase
             }
             catch (Exception ex)
             {
-                DebugLogger.Log("audio", $"Warning: Could not initialize keep-awake stream: {ex.Message}");
+                DebugLogger.Log(DebugCategory.Audio, $"Warning: Could not initialize keep-awake stream: {ex.Message}");
             }
         }
+    }
 
-        // Initialize keying controller
-        _keyingController = new KeyingController(_sidetoneGenerator);
-        _keyingController.Initialize(
-            _boundGuiClientHandle,
-            GetTimestamp,
-            (state, timestamp, handle) =>
-            {
-                if (_connectedRadio != null)
-                    _connectedRadio.CWKey(state, timestamp, handle);
-            }
-        );
-        _keyingController.SetKeyingMode(IsIambicMode, IsIambicModeB);
-        _keyingController.SetSpeed(CwSpeed);
+    /// <summary>
+    /// Logs the time to the first keyable state: audio is up and an input device is open,
+    /// whichever of the two happens last. The input device only opens on connecting, so this
+    /// is usually after the remembered radio has reconnected.
+    /// </summary>
+    private void LogReadyToKeyIfReady()
+    {
+        if (_readyToKeyLogged || !_startupAudioDone || !_firstInputDeviceOpened)
+            return;
 
-        // Initialize transmit slice monitor
-        _transmitSliceMonitor = new TransmitSliceMonitor();
-        _transmitSliceMonitor.TransmitModeChanged += TransmitSliceMonitor_ModeChanged;
+        _readyToKeyLogged = true;
+        LogStartupPhase("ready to key");
+        if (_startupDebug) DebugLogger.Log(DebugCategory.Startup, $"[Startup] Time to first keyable state: {Timebase.ElapsedMilliseconds(_startupTimestamp):F0} ms ({StartupStats.Describe()})");
+    }
 
-        // Initialize radio settings synchronizer
-        _radioSettingsSynchronizer = new RadioSettingsSynchronizer();
-        _radioSettingsSynchronizer.SettingChangedFromRadio += RadioSettingsSynchronizer_SettingChanged;
+    private void LogStartupPhase(string phase)
+    {
+        if (_startupDebug) DebugLogger.Log(DebugCategory.Startup, $"[Startup] +{Timebase.ElapsedMilliseconds(_startupTimestamp):F1} ms: {phase}");
     }
 
     partial void OnCurrentPageChanged(PageType value)
@@ -312,6 +600,7 @@ public partial class MainWindowViewModel : ViewModelBase
             RefreshRadios();
             RefreshSerialPorts();
             RefreshMidiDevices();
+            RefreshEvdevDevices();
             RefreshAudioDevices();
         }
     }
@@ -320,14 +609,20 @@ public partial class MainWindowViewModel : ViewModelBase
     {
         if (!_loadingSettings && _settings != null)
         {
-            _settings.InputType = value == InputDeviceType.MIDI ? "MIDI" : "Serial";
+            _settings.InputType = value switch
+            {
+                InputDeviceType.MIDI => "MIDI",
+                InputDeviceType.Evdev => "Evdev",
+                InputDeviceType.Network => "Network",
+                _ => "Serial"
+            };
             _settings.Save();
         }
     }
 
     partial void OnSelectedRadioClientChanged(RadioClientSelection value)
     {
-        DebugLogger.Log("radio-select", $"[OnSelectedRadioClientChanged] value={(value?.DisplayName ?? "null")}, _loadingSettings={_loadingSettings}");
+        DebugLogger.Log(DebugCategory.RadioSelect, $"[OnSelectedRadioClientChanged] value={(value?.DisplayName ?? "null")}, _loadingSettings={_loadingSettings}");
 
         if (!_loadingSettings && value != null)
         {
@@ -361,14 +656,32 @@ public partial class MainWindowViewModel : ViewModelBase
         }
     }
 
+    partial void OnSelectedEvdevDeviceChanged(string value)
+    {
+        if (!_loadingSettings && _settings != null)
+        {
+            _settings.SelectedEvdevDevice = value;
+            _settings.Save();
+        }
+    }
+
+    partial void OnNetworkInputPortChanged(int value)
+    {
+        if (!_loadingSettings && _settings != null)
+        {
+            _settings.NetworkInputPort = value;
+            _settings.Save();
+        }
+    }
+
     partial void OnSelectedAudioDeviceChanged(AudioDeviceInfo value)
     {
-        DebugLogger.Log("audio", $"[OnSelectedAudioDeviceChanged] Called with device: {value?.DisplayName ?? "null"}");
-        DebugLogger.Log("audio", $"[OnSelectedAudioDeviceChanged] _loadingSettings={_loadingSettings}, _settings={(_settings != null ? "not null" : "null")}");
+        DebugLogger.Log(DebugCategory.Audio, $"[OnSelectedAudioDeviceChanged] Called with device: {value?.DisplayName ?? "null"}");
+        DebugLogger.Log(DebugCategory.Audio, $"[OnSelectedAudioDeviceChanged] _loadingSettings={_loadingSettings}, _settings={(_settings != null ? "not null" : "null")}");
 
         if (!_loadingSettings && _settings != null && value != null)
         {
-            DebugLogger.Log("audio", $"[OnSelectedAudioDeviceChanged] Saving device ID {value.DeviceId} and reinitializing");
+            DebugLogger.Log(DebugCategory.Audio, $"[OnSelectedAudioDeviceChanged] Saving device ID {value.DeviceId} and reinitializing");
             _settings.SelectedAudioDeviceId = value.DeviceId;
             _settings.Save();
 
@@ -377,7 +690,7 @@ public partial class MainWindowViewModel : ViewModelBase
         }
         else
         {
-            DebugLogger.Log("audio", "[OnSelectedAudioDeviceChanged] Skipping due to flags or null values");
+            DebugLogger.Log(DebugCategory.Audio, "[OnSelectedAudioDeviceChanged] Skipping due to flags or null values");
         }
     }
 
@@ -392,14 +705,12 @@ public partial class MainWindowViewModel : ViewModelBase
             string deviceId = SelectedAudioDevice?.DeviceId ?? "";
             bool aggressiveLowLatency = _settings.WasapiAggressiveLowLatency;
             _sidetoneGenerator = SidetoneGeneratorFactory.Create(deviceId, aggressiveLowLatency);
-            _sidetoneGenerator.SetFrequency(CwPitch);
             _sidetoneGenerator.SetVolume(SidetoneVolume);
-            _sidetoneGenerator.SetWpm(CwSpeed);
 
-            // Reconnect to keying controller
+            // Reconnect to keying controller, which sets pitch and speed from its parameters
             _keyingController?.SetSidetoneGenerator(_sidetoneGenerator);
 
-            DebugLogger.Log("audio", $"Sidetone generator reinitialized with device={deviceId}, aggressiveLowLatency={aggressiveLowLatency}");
+            DebugLogger.Log(DebugCategory.Audio, $"Sidetone generator reinitialized with device={deviceId}, aggressiveLowLatency={aggressiveLowLatency}");
 
             Console.WriteLine("Sidetone generator reinitialized with new audio device");
         }
@@ -424,16 +735,16 @@ public partial class MainWindowViewModel : ViewModelBase
                 string deviceId = SelectedAudioDevice?.DeviceId ?? "";
                 _keepAwakeStream = KeepAwakeStreamFactory.Create(deviceId);
                 _keepAwakeStream.Start();
-                DebugLogger.Log("audio", $"Keep-awake stream reinitialized with device={deviceId}");
+                DebugLogger.Log(DebugCategory.Audio, $"Keep-awake stream reinitialized with device={deviceId}");
             }
             else
             {
-                DebugLogger.Log("audio", "Keep-awake stream disabled");
+                DebugLogger.Log(DebugCategory.Audio, "Keep-awake stream disabled");
             }
         }
         catch (Exception ex)
         {
-            DebugLogger.Log("audio", $"Failed to reinitialize keep-awake stream: {ex.Message}");
+            DebugLogger.Log(DebugCategory.Audio, $"Failed to reinitialize keep-awake stream: {ex.Message}");
         }
     }
 
@@ -454,7 +765,7 @@ public partial class MainWindowViewModel : ViewModelBase
     [RelayCommand]
     private void RefreshRadios()
     {
-        DebugLogger.Log("radio-select", $"[RefreshRadios] START - current selection: {SelectedRadioClient?.DisplayName ?? "null"}");
+        DebugLogger.Log(DebugCategory.RadioSelect, $"[RefreshRadios] START - current selection: {SelectedRadioClient?.DisplayName ?? "null"}");
 
         // Set loading flag to prevent user selection tracking during rebuild
         _loadingSettings = true;
@@ -471,7 +782,7 @@ public partial class MainWindowViewModel : ViewModelBase
         });
 
         // Get discovered radios from FlexLib (local LAN radios)
-        foreach (var radio in API.RadioList)
+        foreach (var radio in GetLanRadios())
         {
             lock (radio.GuiClientsLockObj)
             {
@@ -539,10 +850,7 @@ public partial class MainWindowViewModel : ViewModelBase
             }
 
             // Reconnect to SmartLink server if needed (will trigger radio list refresh for updates)
-            Task.Run(async () =>
-            {
-                await _smartLinkManager.ConnectToServerAsync();
-            });
+            _ = _smartLinkManager.ConnectToServerAsync();
         }
 
         // Update the ObservableCollection in place to avoid binding issues
@@ -613,25 +921,125 @@ public partial class MainWindowViewModel : ViewModelBase
         // Apply the selected default (only if it changed)
         if (defaultSelection != null && SelectedRadioClient != defaultSelection)
         {
-            DebugLogger.Log("radio-select", $"[RefreshRadios] Setting selection to: {defaultSelection.DisplayName}");
+            DebugLogger.Log(DebugCategory.RadioSelect, $"[RefreshRadios] Setting selection to: {defaultSelection.DisplayName}");
             SelectedRadioClient = defaultSelection;
         }
         else if (defaultSelection == null)
         {
-            DebugLogger.Log("radio-select", "[RefreshRadios] No default selection found!");
+            DebugLogger.Log(DebugCategory.RadioSelect, "[RefreshRadios] No default selection found!");
+        }
+
+        _loadingSettings = false;
+        DebugLogger.Log(DebugCategory.RadioSelect, $"[RefreshRadios] END - final selection: {SelectedRadioClient?.DisplayName ?? "null"}");
+    }
+
+    /// <summary>
+    /// FlexLib's discovered LAN radios, with the radio connected at startup from its remembered
+    /// address in place of the discovered instance with the same serial (or added, if discovery
+    /// hasn't seen it yet), so the list always points at the instance that is connected.
+    /// </summary>
+    private List<Radio> GetLanRadios()
+    {
+        var radios = new List<Radio>();
+        var remembered = _rememberedRadio;
+        bool rememberedListed = false;
+        foreach (var radio in API.RadioList.ToArray())
+        {
+            if (remembered != null && !radio.IsWan && radio.Serial == remembered.Serial)
+            {
+                radios.Add(remembered);
+                rememberedListed = true;
+            }
+            else
+            {
+                radios.Add(radio);
+            }
         }
 
+        if (remembered != null && !rememberedListed)
+            radios.Add(remembered);
+        return radios;
+    }
+
+    /// <summary>
+    /// Refreshes the radio list with the entries for one LAN radio rebuilt from scratch, for
+    /// when the instance standing for it changes. A plain refresh keeps existing entries that
+    /// match by serial and station, which would leave them pointing at the other instance.
+    /// </summary>
+    private void RebuildRadioSelections(string serial)
+    {
+        _loadingSettings = true;
+        for (int i = RadioClientSelections.Count - 1; i >= 0; i--)
+        {
+            var radio = RadioClientSelections[i].Radio;
+            if (radio != null && !radio.IsWan && radio.Serial == serial)
+                RadioClientSelections.RemoveAt(i);
+        }
         _loadingSettings = false;
-        DebugLogger.Log("radio-select", $"[RefreshRadios] END - final selection: {SelectedRadioClient?.DisplayName ?? "null"}");
+
+        RefreshRadios();
     }
 
     [RelayCommand]
     private void RefreshSerialPorts()
+    {
+        PopulateSerialPorts(_inputDeviceManager.DiscoverSerialPorts());
+    }
+
+    [RelayCommand]
+    private void RefreshMidiDevices()
+    {
+        PopulateMidiDevices(_inputDeviceManager.DiscoverMidiDevices());
+    }
+
+    [RelayCommand]
+    private void RefreshEvdevDevices()
+    {
+        if (!EvdevPaddleInput.IsSupported)
+            return;
+
+        PopulateEvdevDevices(_inputDeviceManager.DiscoverEvdevDevices());
+    }
+
+    /// <summary>
+    /// Enumerates devices for one input type. Safe to call off the UI thread.
+    /// </summary>
+    private (InputDeviceType Type, List<string> Devices) DiscoverInputDevices(InputDeviceType type)
+    {
+        var devices = type switch
+        {
+            InputDeviceType.Serial => _inputDeviceManager.DiscoverSerialPorts(),
+            InputDeviceType.MIDI => _inputDeviceManager.DiscoverMidiDevices(),
+            InputDeviceType.Evdev when EvdevPaddleInput.IsSupported => _inputDeviceManager.DiscoverEvdevDevices(),
+            _ => null
+        };
+        return (type, devices);
+    }
+
+    private void PopulateInputDevices(InputDeviceType type, List<string> devices)
+    {
+        if (devices == null)
+            return;
+
+        switch (type)
+        {
+            case InputDeviceType.Serial:
+                PopulateSerialPorts(devices);
+                break;
+            case InputDeviceType.MIDI:
+                PopulateMidiDevices(devices);
+                break;
+            case InputDeviceType.Evdev:
+                PopulateEvdevDevices(devices);
+                break;
+        }
+    }
+
+    private void PopulateSerialPorts(List<string> ports)
     {
         _loadingSettings = true;
         SerialPorts.Clear();
 
-        var ports = _inputDeviceManager.DiscoverSerialPorts();
         foreach (var port in ports)
         {
             SerialPorts.Add(port);
@@ -649,13 +1057,11 @@ public partial class MainWindowViewModel : ViewModelBase
         _loadingSettings = false;
     }
 
-    [RelayCommand]
-    private void RefreshMidiDevices()
+    private void PopulateMidiDevices(List<string> devices)
     {
         _loadingSettings = true;
         MidiDevices.Clear();
 
-        var devices = _inputDeviceManager.DiscoverMidiDevices();
         foreach (var device in devices)
         {
             MidiDevices.Add(device);
@@ -676,24 +1082,70 @@ public partial class MainWindowViewModel : ViewModelBase
         _loadingSettings = false;
     }
 
+    private void PopulateEvdevDevices(List<string> devices)
+    {
+        _loadingSettings = true;
+        EvdevDevices.Clear();
+
+        foreach (var device in devices)
+        {
+            EvdevDevices.Add(device);
+        }
+
+        // Restore previously selected device if available (only if we have real devices)
+        if (!devices[0].Contains("No input devices") && !devices[0].Contains("Error"))
+        {
+            if (_settings != null && !string.IsNullOrEmpty(_settings.SelectedEvdevDevice))
+            {
+                if (EvdevDevices.Contains(_settings.SelectedEvdevDevice))
+                {
+                    SelectedEvdevDevice = _settings.SelectedEvdevDevice;
+                }
+            }
+        }
+
+        _loadingSettings = false;
+    }
+
     [RelayCommand]
     private void RefreshAudioDevices()
     {
-        DebugLogger.Log("audio", "[RefreshAudioDevices] Starting...");
-        _loadingSettings = true;
-        AudioDevices.Clear();
+        PopulateAudioDevices(EnumerateAudioDevices());
+    }
 
+    /// <summary>
+    /// Lists audio output devices, or returns null if enumeration failed. Safe to call off
+    /// the UI thread.
+    /// </summary>
+    private static List<(string deviceId, string name)> EnumerateAudioDevices()
+    {
         try
         {
             // Use platform-aware enumeration from factory
-            var devices = SidetoneGeneratorFactory.EnumerateDevices();
+            return SidetoneGeneratorFactory.EnumerateDevices();
+        }
+        catch (Exception ex)
+        {
+            DebugLogger.Log(DebugCategory.Audio, $"[RefreshAudioDevices] EXCEPTION: {ex.GetType().Name}: {ex.Message}");
+            DebugLogger.Log(DebugCategory.Audio, $"[RefreshAudioDevices] Stack trace: {ex.StackTrace}");
+            return null;
+        }
+    }
+
+    private void PopulateAudioDevices(List<(string deviceId, string name)> devices)
+    {
+        DebugLogger.Log(DebugCategory.Audio, "[RefreshAudioDevices] Starting...");
+        _loadingSettings = true;
+        AudioDevices.Clear();
 
+        if (devices != null)
+        {
             foreach (var (deviceId, name) in devices)
             {
                 AudioDevices.Add(new AudioDeviceInfo { DeviceId = deviceId, Name = name });
             }
 
-            DebugLogger.Log("audio", $"[RefreshAudioDevices] Total devices in collection: {AudioDevices.Count}");
+            DebugLogger.Log(DebugCategory.Audio, $"[RefreshAudioDevices] Total devices in collection: {AudioDevices.Count}");
 
             // Restore previously selected device if available
             if (_settings != null)
@@ -702,33 +1154,28 @@ public partial class MainWindowViewModel : ViewModelBase
                 if (savedDevice != null)
                 {
                     SelectedAudioDevice = savedDevice;
-                    DebugLogger.Log("audio", $"[RefreshAudioDevices] Restored saved device: {savedDevice.DisplayName}");
+                    DebugLogger.Log(DebugCategory.Audio, $"[RefreshAudioDevices] Restored saved device: {savedDevice.DisplayName}");
                 }
                 else
                 {
                     // Default to "System Default"
                     SelectedAudioDevice = AudioDevices.FirstOrDefault(d => string.IsNullOrEmpty(d.DeviceId));
-                    DebugLogger.Log("audio", "[RefreshAudioDevices] Using System Default");
+                    DebugLogger.Log(DebugCategory.Audio, "[RefreshAudioDevices] Using System Default");
                 }
             }
         }
-        catch (Exception ex)
+        else
         {
-            DebugLogger.Log("audio", $"[RefreshAudioDevices] EXCEPTION: {ex.GetType().Name}: {ex.Message}");
-            DebugLogger.Log("audio", $"[RefreshAudioDevices] Stack trace: {ex.StackTrace}");
             // Add default option on error
-            if (AudioDevices.Count == 0)
+            AudioDevices.Add(new AudioDeviceInfo
             {
-                AudioDevices.Add(new AudioDeviceInfo
-                {
-                    DeviceId = "",
-                    Name = "System Default"
-                });
-            }
+                DeviceId = "",
+                Name = "System Default"
+            });
             SelectedAudioDevice = AudioDevices[0];
         }
 
-        DebugLogger.Log("audio", "[RefreshAudioDevices] Complete");
+        DebugLogger.Log(DebugCategory.Audio, "[RefreshAudioDevices] Complete");
         _loadingSettings = false;
     }
 
@@ -782,36 +1229,36 @@ public partial class MainWindowViewModel : ViewModelBase
 
         if (dialog.DeviceChanged)
         {
-            DebugLogger.Log("audio", $"[SelectAudioDevice] Device changed to ID: {dialog.SelectedDeviceId}");
+            DebugLogger.Log(DebugCategory.Audio, $"[SelectAudioDevice] Device changed to ID: {dialog.SelectedDeviceId}");
 
             // Save the aggressive low-latency setting BEFORE reinitializing generator
             if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
             {
                 _settings.WasapiAggressiveLowLatency = dialog.AggressiveLowLatency;
-                DebugLogger.Log("audio", $"[SelectAudioDevice] Saved AggressiveLowLatency={dialog.AggressiveLowLatency}");
+                DebugLogger.Log(DebugCategory.Audio, $"[SelectAudioDevice] Saved AggressiveLowLatency={dialog.AggressiveLowLatency}");
             }
 
             // Save the keep-awake setting and update the stream
             bool keepAwakeChanged = _settings.KeepAudioDeviceAwake != dialog.KeepAudioDeviceAwake;
             _settings.KeepAudioDeviceAwake = dialog.KeepAudioDeviceAwake;
             _settings.Save();
-            DebugLogger.Log("audio", $"[SelectAudioDevice] Saved KeepAudioDeviceAwake={dialog.KeepAudioDeviceAwake}");
+            DebugLogger.Log(DebugCategory.Audio, $"[SelectAudioDevice] Saved KeepAudioDeviceAwake={dialog.KeepAudioDeviceAwake}");
 
             // Update the selected device - this will trigger OnSelectedAudioDeviceChanged
             // which handles saving settings and reinitializing the sidetone generator
             var newDeviceId = dialog.SelectedDeviceId;
 
-            DebugLogger.Log("audio", $"[SelectAudioDevice] AudioDevices count: {AudioDevices.Count}");
+            DebugLogger.Log(DebugCategory.Audio, $"[SelectAudioDevice] AudioDevices count: {AudioDevices.Count}");
             var deviceInfo = AudioDevices.FirstOrDefault(d => d.DeviceId == newDeviceId);
 
             if (deviceInfo != null)
             {
-                DebugLogger.Log("audio", $"[SelectAudioDevice] Found device in collection: {deviceInfo.DisplayName}");
+                DebugLogger.Log(DebugCategory.Audio, $"[SelectAudioDevice] Found device in collection: {deviceInfo.DisplayName}");
                 SelectedAudioDevice = deviceInfo;
             }
             else
             {
-                DebugLogger.Log("audio", $"[SelectAudioDevice] Device not found in AudioDevices collection!");
+                DebugLogger.Log(DebugCategory.Audio, $"[SelectAudioDevice] Device not found in AudioDevices collection!");
             }
 
             // Handle keep-awake stream changes
@@ -822,7 +1269,7 @@ public partial class MainWindowViewModel : ViewModelBase
         }
         else
         {
-            DebugLogger.Log("audio", "[SelectAudioDevice] DeviceChanged is false");
+            DebugLogger.Log(DebugCategory.Audio, "[SelectAudioDevice] DeviceChanged is false");
         }
     }
 
@@ -837,6 +1284,9 @@ public partial class MainWindowViewModel : ViewModelBase
         // Reset keying controller state
         _keyingController?.ResetState();
 
+        // Stop refreshing indicators from the closed device
+        StopIndicatorTimer();
+
         // Reset indicators
         LeftPaddleIndicatorColor = Brushes.Black;
         RightPaddleIndicatorColor = Brushes.Black;
@@ -846,15 +1296,30 @@ public partial class MainWindowViewModel : ViewModelBase
 
     private void OpenInputDevice()
     {
-        string deviceName = InputType == InputDeviceType.Serial ? SelectedSerialPort : SelectedMidiDevice;
+        string deviceName = InputType switch
+        {
+            InputDeviceType.Serial => SelectedSerialPort,
+            InputDeviceType.Evdev => SelectedEvdevDevice,
+            InputDeviceType.Network => NetworkInputPort.ToString(),
+            _ => SelectedMidiDevice
+        };
 
         try
         {
-            _inputDeviceManager.OpenDevice(InputType, deviceName, _settings.MidiNoteMappings);
+            _inputDeviceManager.OpenDevice(InputType, deviceName, _settings.MidiNoteMappings, _settings.EvdevKeyMappings);
 
             // Reset keying controller state to ensure clean start
             _keyingController?.ResetState();
 
+            StartIndicatorTimer();
+
+            if (!_firstInputDeviceOpened)
+            {
+                _firstInputDeviceOpened = true;
+                LogStartupPhase($"first input device opened ({InputType})");
+                LogReadyToKeyIfReady();
+            }
+
             // InputDeviceManager will emit an initial PaddleStateChanged event with current state
         }
         catch (Exception ex)
@@ -865,62 +1330,90 @@ public partial class MainWindowViewModel : ViewModelBase
         }
     }
 
-    private void InputDeviceManager_PaddleStateChanged(object sender, PaddleStateChangedEventArgs e)
+    private void InputDeviceManager_PaddleStateChanged(PaddleState state)
     {
+        // Keying goes first and directly; nothing on the UI side may delay it
+        _keyingController?.HandlePaddleStateChange(state);
+
+        // Publish for the indicator timer (single writer: the open input device's thread)
+        _indicatorSequence++;
+        Interlocked.Exchange(ref _indicatorStateWord, (_indicatorSequence << 8) | state.Bits);
+
         // Swap is now handled in InputDeviceManager
-        bool leftPaddleState = e.LeftPaddle;
-        bool rightPaddleState = e.RightPaddle;
-        bool straightKeyState = e.StraightKey;
-        bool pttState = e.PTT;
+        if (_inputDebug) DebugLogger.Log(DebugCategory.Input, $"[InputDeviceManager_PaddleStateChanged] Received event: {state}");
+    }
 
-        DebugLogger.Log("input", $"[InputDeviceManager_PaddleStateChanged] Received event: L={leftPaddleState} R={rightPaddleState} SK={straightKeyState} PTT={pttState}");
+    private void StartIndicatorTimer()
+    {
+        if (_indicatorTimer != null)
+            return;
 
-        // Update indicators
-        Dispatcher.UIThread.Post(() =>
+        _indicatorTimer = new DispatcherTimer(TimeSpan.FromMilliseconds(INDICATOR_REFRESH_MS), DispatcherPriority.Render, IndicatorTimer_Tick);
+        _indicatorTimer.Start();
+    }
+
+    private void StopIndicatorTimer()
+    {
+        _indicatorTimer?.Stop();
+        _indicatorTimer = null;
+    }
+
+    private void IndicatorTimer_Tick(object sender, EventArgs e)
+    {
+        if (InputType == InputDeviceType.Network && ++_networkStatusTicks >= NETWORK_STATUS_INTERVAL_TICKS)
         {
-            bool leftIndicatorState;
+            _networkStatusTicks = 0;
+            NetworkInputStatus = _inputDeviceManager.NetworkStats?.ToString() ?? "";
+        }
 
-            // Check transmit mode first (CW vs PTT), then keying mode (iambic vs straight)
-            if (!(_transmitSliceMonitor.IsTransmitModeCW || _isSidetoneOnlyMode))
-            {
-                // PTT mode (non-CW radio modes) - use PTT state
-                // (InputDeviceManager sets this to OR of both paddles for serial input)
-                leftIndicatorState = pttState;
-            }
-            else if (IsIambicMode)
-            {
-                // CW iambic mode - left paddle indicator
-                leftIndicatorState = leftPaddleState;
-            }
-            else
-            {
-                // CW straight key mode - use straight key state
-                // (InputDeviceManager sets this to OR of both paddles for serial input)
-                leftIndicatorState = straightKeyState;
-            }
+        // Only render when an edge arrived since the last frame; bursts between frames collapse to the latest state
+        long word = Interlocked.Read(ref _indicatorStateWord);
+        if (word == _renderedIndicatorStateWord)
+            return;
 
-            DebugLogger.Log("input", $"[Indicator Update] IsIambic={IsIambicMode} IsCW={_transmitSliceMonitor.IsTransmitModeCW} Sidetone={_isSidetoneOnlyMode} | L={leftPaddleState} R={rightPaddleState} SK={straightKeyState} PTT={pttState} | LeftInd={leftIndicatorState}");
+        _renderedIndicatorStateWord = word;
+        UpdatePaddleIndicators(new PaddleState((byte)(word & 0xFF), 0));
+    }
 
-            LeftPaddleIndicatorColor = leftIndicatorState ? Brushes.LimeGreen : Brushes.Black;
-            LeftPaddleStateText = leftIndicatorState ? "ON" : "OFF";
-            RightPaddleIndicatorColor = rightPaddleState ? Brushes.LimeGreen : Brushes.Black;
-            RightPaddleStateText = rightPaddleState ? "ON" : "OFF";
-        });
+    private void UpdatePaddleIndicators(PaddleState state)
+    {
+        bool leftIndicatorState;
 
-        // Delegate keying logic to KeyingController
-        _keyingController?.HandlePaddleStateChange(leftPaddleState, rightPaddleState, straightKeyState, pttState);
+        // Check transmit mode first (CW vs PTT), then keying mode (iambic vs straight)
+        if (!(_transmitSliceMonitor.IsTransmitModeCW || _isSidetoneOnlyMode))
+        {
+            // PTT mode (non-CW radio modes) - use PTT state
+            // (InputDeviceManager sets this to OR of both paddles for serial input)
+            leftIndicatorState = state.PTT;
+        }
+        else if (IsIambicMode)
+        {
+            // CW iambic mode - left paddle indicator
+            leftIndicatorState = state.LeftPaddle;
+        }
+        else
+        {
+            // CW straight key mode - use straight key state
+            // (InputDeviceManager sets this to OR of both paddles for serial input)
+            leftIndicatorState = state.StraightKey;
+        }
+
+        if (_inputDebug) DebugLogger.Log(DebugCategory.Input, $"[Indicator Update] IsIambic={IsIambicMode} IsCW={_transmitSliceMonitor.IsTransmitModeCW} Sidetone={_isSidetoneOnlyMode} | {state} | LeftInd={leftIndicatorState}");
+
+        LeftPaddleIndicatorColor = leftIndicatorState ? Brushes.LimeGreen : Brushes.Black;
+        LeftPaddleStateText = leftIndicatorState ? "ON" : "OFF";
+        RightPaddleIndicatorColor = state.RightPaddle ? Brushes.LimeGreen : Brushes.Black;
+        RightPaddleStateText = state.RightPaddle ? "ON" : "OFF";
     }
 
-    private string GetTimestamp()
+    private ushort GetTimestamp()
     {
-        // Use Environment.TickCount64 for millisecond precision timestamp
-        // Reduce to 16 bits (0-65535) and format as 4-digit hex string
-        long timestamp = Environment.TickCount64 % 65536;
-        return timestamp.ToString("X4");
+        // Millisecond counter from the shared timebase, reduced to 16 bits
+        return Timebase.ToRadioTimestamp(Timebase.Now);
     }
 
     [RelayCommand]
-    private void ToggleConnection()
+    private async Task ToggleConnection()
     {
         if (_connectedRadio == null && !_isSidetoneOnlyMode)
         {
@@ -948,6 +1441,7 @@ public partial class MainWindowViewModel : ViewModelBase
                     // User explicitly selected sidetone-only - clear persisted radio preference
                     _settings.SelectedRadioSerial = null;
                     _settings.SelectedGuiClientStation = null;
+                    _settings.SelectedRadioAddress = null;
                     _settings.Save();
                 }
                 // else: Implicit fallback to sidetone-only (no radios available) - keep existing saved preference
@@ -978,13 +1472,16 @@ public partial class MainWindowViewModel : ViewModelBase
             }
 
             _connectedRadio = SelectedRadioClient.Radio;
+            var radio = _connectedRadio;
             uint targetClientHandle = SelectedRadioClient.GuiClient.ClientHandle;
-            string targetStation = SelectedRadioClient.GuiClient.Station;
+
+            _connectCancellation = new CancellationTokenSource();
+            var cancellationToken = _connectCancellation.Token;
 
             // For WAN radios, we need to request connection from SmartLinkManager first
-            if (_connectedRadio.IsWan)
+            if (radio.IsWan)
             {
-                if (_smartLinkManager?.WanServer == null || !_smartLinkManager.WanServer.IsConnected)
+                if (_smartLinkManager == null || !_smartLinkManager.IsServerConnected)
                 {
                     RadioStatus = "Not connected to SmartLink server";
                     RadioStatusColor = Brushes.Red;
@@ -993,9 +1490,19 @@ public partial class MainWindowViewModel : ViewModelBase
                     return;
                 }
 
-                // Request connection to this radio
+                // Request connection to this radio; the server answers asynchronously
                 RadioStatus = "Requesting SmartLink connection...";
-                var result = _smartLinkManager.RequestWanConnectionAsync(_connectedRadio.Serial, 10000).Result;
+                (bool Success, string WanConnectionHandle) result;
+                try
+                {
+                    result = await _smartLinkManager.RequestWanConnectionAsync(radio,
+                        SmartLinkServerConnection.DEFAULT_REQUEST_TIMEOUT_MS, cancellationToken);
+                }
+                catch (OperationCanceledException)
+                {
+                    _connectedRadio = null;
+                    return;
+                }
 
                 if (!result.Success)
                 {
@@ -1006,9 +1513,9 @@ public partial class MainWindowViewModel : ViewModelBase
                     return;
                 }
 
-                _connectedRadio.WANConnectionHandle = result.WanConnectionHandle;
+                radio.WANConnectionHandle = result.WanConnectionHandle;
 
-                if (string.IsNullOrEmpty(_connectedRadio.WANConnectionHandle))
+                if (string.IsNullOrEmpty(radio.WANConnectionHandle))
                 {
                     RadioStatus = "Failed to get SmartLink connection handle";
                     RadioStatusColor = Brushes.Red;
@@ -1017,28 +1524,38 @@ public partial class MainWindowViewModel : ViewModelBase
                     return;
                 }
 
-                RadioStatus = "Connecting to radio via SmartLink...";
+                RadioStatus = radio.RequiresHolePunch
+                    ? $"Connecting to radio via SmartLink (hole punch port {radio.NegotiatedHolePunchPort})..."
+                    : "Connecting to radio via SmartLink...";
             }
 
-            // Now connect to the radio (works for both LAN and WAN)
-            bool connectResult = _connectedRadio.Connect();
+            // Now connect to the radio (works for both LAN and WAN). Connect() blocks on the
+            // network, so it runs off the UI thread.
+            bool connectResult = await Task.Run(() => radio.Connect());
 
             if (!connectResult)
             {
                 RadioStatus = "Failed to connect to radio";
                 RadioStatusColor = Brushes.Red;
                 HasRadioError = true;
-                _connectedRadio = null;
+                if (_connectedRadio == radio)
+                    _connectedRadio = null;
                 return;
             }
 
             // After Connect(), the radio sends "client connected" status messages that populate
-            // the ClientID (UUID) field in the GUIClient objects. Wait a moment for these to arrive.
-            Thread.Sleep(500);
-
-            // Look up the updated GUIClient from the connected radio's GuiClients list
-            // This will now have the ClientID (UUID) populated
-            GUIClient updatedGuiClient = _connectedRadio.FindGUIClientByClientHandle(targetClientHandle);
+            // the ClientID (UUID) field in the GUIClient objects. Wait for the one for our station.
+            GUIClient updatedGuiClient = await Task.Run(() =>
+                RadioConnector.WaitForGuiClient(radio, c => c.ClientHandle == targetClientHandle)
+                // Timed out: take the station as it is and let the UUID check below report it
+                ?? radio.FindGUIClientByClientHandle(targetClientHandle));
+
+            // Removed from the list, or exiting, while we waited
+            if (_connectedRadio != radio || cancellationToken.IsCancellationRequested)
+            {
+                radio.Disconnect();
+                return;
+            }
 
             if (updatedGuiClient == null)
             {
@@ -1063,66 +1580,7 @@ public partial class MainWindowViewModel : ViewModelBase
                 HasRadioError = false;
             }
 
-            // Bind to the selected station using its UUID
-            _connectedRadio.BindGUIClient(clientId);
-            _boundGuiClientHandle = targetClientHandle;
-            ConnectButtonText = "Disconnect";
-
-            // Reinitialize keying controller with the correct radio client handle
-            // First dispose the old controller to unsubscribe from events
-            _keyingController?.Dispose();
-            _keyingController = new KeyingController(_sidetoneGenerator);
-            _keyingController.Initialize(
-                _boundGuiClientHandle,
-                GetTimestamp,
-                (state, timestamp, handle) =>
-                {
-                    if (_connectedRadio != null)
-                        _connectedRadio.CWKey(state, timestamp, handle);
-                }
-            );
-            _keyingController.SetKeyingMode(IsIambicMode, IsIambicModeB);
-            _keyingController.SetSpeed(CwSpeed);
-
-            // Subscribe to radio property changes
-            _connectedRadio.PropertyChanged += Radio_PropertyChanged;
-
-            // Subscribe to transmit slice property changes and update initial mode
-            _transmitSliceMonitor.AttachToRadio(_connectedRadio, _boundGuiClientHandle);
-
-            // Attach keying controller to radio
-            _keyingController?.SetRadio(_connectedRadio, isSidetoneOnly: false);
-            _keyingController?.SetTransmitMode(_transmitSliceMonitor.IsTransmitModeCW);
-
-            // Attach radio settings synchronizer and apply initial settings
-            _radioSettingsSynchronizer.AttachToRadio(_connectedRadio);
-            try
-            {
-                _radioSettingsSynchronizer.ApplyInitialSettingsFromRadio();
-            }
-            catch (Exception ex)
-            {
-                RadioStatus = ex.Message;
-                RadioStatusColor = Brushes.Orange;
-                HasRadioError = true;
-            }
-
-            // SAVE PERSISTENCE: Save connected radio to settings
-            _settings.SelectedRadioSerial = _connectedRadio.Serial;
-            _settings.SelectedGuiClientStation = targetStation;
-            _settings.Save();
-
-            // Clear current selection - this is now the baseline
-            _currentUserSelection = null;
-
-            // Open the selected input device
-            OpenInputDevice();
-
-            // Switch to operating page
-            CurrentPage = PageType.Operating;
-
-            // Update paddle labels after connection
-            UpdatePaddleLabels();
+            CompleteRadioConnection(updatedGuiClient);
         }
         else
         {
@@ -1155,6 +1613,14 @@ public partial class MainWindowViewModel : ViewModelBase
                 _connectedRadio = null;
             }
 
+            // From here on the discovered instance is the one to connect to
+            if (_rememberedRadio != null)
+            {
+                string serial = _rememberedRadio.Serial;
+                _rememberedRadio = null;
+                RebuildRadioSelections(serial);
+            }
+
             // Close input device
             CloseInputDevice();
 
@@ -1174,12 +1640,7 @@ public partial class MainWindowViewModel : ViewModelBase
             // Re-establish SmartLink connection if authenticated (to refresh radio list)
             if (_smartLinkManager != null && _smartLinkManager.IsAuthenticated)
             {
-                Task.Run(async () =>
-                {
-                    await _smartLinkManager.ConnectToServerAsync();
-                    // Refresh radio list after SmartLink reconnects
-                    Dispatcher.UIThread.Post(() => RefreshRadios());
-                });
+                _ = ReconnectSmartLinkAndRefreshAsync();
             }
             else
             {
@@ -1192,13 +1653,102 @@ public partial class MainWindowViewModel : ViewModelBase
         }
     }
 
+    private async Task ReconnectSmartLinkAndRefreshAsync()
+    {
+        await _smartLinkManager.ConnectToServerAsync();
+
+        // Refresh radio list after SmartLink reconnects
+        Dispatcher.UIThread.Post(() => RefreshRadios());
+    }
+
+    /// <summary>
+    /// Binds to <paramref name="guiClient"/>'s station on the already-connected
+    /// <see cref="_connectedRadio"/>, attaches keying and radio monitoring to it, remembers it
+    /// for the next startup and switches to the operating page.
+    /// </summary>
+    private void CompleteRadioConnection(GUIClient guiClient)
+    {
+        // Bind to the selected station using its UUID
+        _connectedRadio.BindGUIClient(guiClient.ClientID);
+        _boundGuiClientHandle = guiClient.ClientHandle;
+        ConnectButtonText = "Disconnect";
+
+        // Reinitialize keying controller with the correct radio client handle
+        // First dispose the old controller to unsubscribe from events
+        _keyingController?.Dispose();
+        _keyingController = new KeyingController(_sidetoneGenerator);
+        _keyingController.Initialize(
+            _boundGuiClientHandle,
+            GetTimestamp,
+            (state, timestamp, handle) =>
+            {
+                if (_connectedRadio != null)
+                    _connectedRadio.CWKey(state, Timebase.FormatRadioTimestamp(timestamp), handle);
+            }
+        );
+        _keyingController.SetKeyingMode(IsIambicMode, IsIambicModeB);
+        _keyingController.SetSpeed(CwSpeed);
+        _keyingController.UpdateParameters(p => p.WithSwapPaddles(SwapPaddles).WithPitch(CwPitch)
+            .WithMaxKeyDown(_settings.MaxKeyDownMs).WithPttTiming(_settings.PttDebounceMs, _settings.PttHangMs));
+
+        // Subscribe to radio property changes
+        _connectedRadio.PropertyChanged += Radio_PropertyChanged;
+
+        // Subscribe to transmit slice property changes and update initial mode
+        _transmitSliceMonitor.AttachToRadio(_connectedRadio, _boundGuiClientHandle);
+
+        // Attach keying controller to radio
+        _keyingController?.SetRadio(new FlexKeyingRadio(_connectedRadio), isSidetoneOnly: false);
+        _keyingController?.SetTransmitMode(_transmitSliceMonitor.IsTransmitModeCW);
+
+        // Attach radio settings synchronizer and apply initial settings
+        _radioSettingsSynchronizer.AttachToRadio(_connectedRadio);
+        try
+        {
+            _radioSettingsSynchronizer.ApplyInitialSettingsFromRadio();
+        }
+        catch (Exception ex)
+        {
+            RadioStatus = ex.Message;
+            RadioStatusColor = Brushes.Orange;
+            HasRadioError = true;
+        }
+
+        // SAVE PERSISTENCE: Save connected radio to settings
+        _settings.SelectedRadioSerial = _connectedRadio.Serial;
+        _settings.SelectedGuiClientStation = guiClient.Station;
+        _settings.SelectedRadioAddress = _connectedRadio.IsWan ? null : _connectedRadio.IP?.ToString();
+        _settings.SelectedRadioModel = _connectedRadio.Model;
+        _settings.SelectedRadioNickname = _connectedRadio.Nickname;
+        _settings.SelectedRadioVersion = RadioConnector.FormatVersion(_connectedRadio);
+        _settings.Save();
+
+        // Clear current selection - this is now the baseline
+        _currentUserSelection = null;
+
+        // Open the selected input device
+        OpenInputDevice();
+
+        // Switch to operating page
+        CurrentPage = PageType.Operating;
+
+        // Update paddle labels after connection
+        UpdatePaddleLabels();
+    }
+
     [RelayCommand]
     private void Exit()
     {
+        // Stop waiting on a radio or SmartLink connection still in progress
+        _connectCancellation?.Cancel();
+
         // Clean up all keying state before exit
         _keyingController?.Stop();
         _sidetoneGenerator?.Stop();
 
+        // Stop sending settings before the radio goes away
+        _radioSettingsSynchronizer?.Dispose();
+
         if (_connectedRadio != null)
         {
             _connectedRadio.Disconnect();
@@ -1215,6 +1765,12 @@ public partial class MainWindowViewModel : ViewModelBase
         _sidetoneGenerator?.Dispose();
 
         API.CloseSession();
+
+        // Write any settings change still waiting out its debounce delay
+        UserSettings.Flush();
+
+        // And any debug log lines still queued for the writer thread
+        DebugLogger.Flush();
         Environment.Exit(0);
     }
 
@@ -1250,13 +1806,40 @@ public partial class MainWindowViewModel : ViewModelBase
         }
     }
 
+    /// <summary>
+    /// Starts a keying trace, or stops it and saves it next to the debug log as Chrome trace
+    /// JSON (open it in ui.perfetto.dev or chrome://tracing).
+    /// </summary>
+    [RelayCommand]
+    private void ToggleKeyingTrace()
+    {
+        if (!KeyingTrace.IsEnabled)
+        {
+            KeyingTrace.Start();
+            IsKeyingTraceRecording = true;
+            return;
+        }
+
+        KeyingTrace.Stop();
+        IsKeyingTraceRecording = false;
+
+        var logFolder = System.IO.Path.GetDirectoryName(Helpers.DebugLogger.LogFilePath);
+        if (string.IsNullOrEmpty(logFolder))
+            return;
+
+        var tracePath = System.IO.Path.Combine(logFolder, $"keying-trace-{DateTime.Now:yyyyMMdd-HHmmss}.json");
+        if (KeyingTrace.Export(tracePath) >= 0)
+        {
+            UrlHelper.OpenFolder(logFolder);
+        }
+    }
+
+    public string KeyingTraceMenuHeader => IsKeyingTraceRecording ? "Stop Keying Trace and Save" : "Record Keying Trace";
+
 
     partial void OnCwSpeedChanged(int value)
     {
-        // Update sidetone generator WPM for ramp calculations
-        _sidetoneGenerator?.SetWpm(value);
-
-        // Update keying controller WPM for timing calculations
+        // Keying controller timing; it passes the speed on to the sidetone generator for ramps
         _keyingController?.SetSpeed(value);
 
         // Sync to radio
@@ -1265,8 +1848,8 @@ public partial class MainWindowViewModel : ViewModelBase
 
     partial void OnCwPitchChanged(int value)
     {
-        // Update sidetone frequency
-        _sidetoneGenerator?.SetFrequency(value);
+        // Sidetone frequency; the keying controller applies it between elements
+        _keyingController?.UpdateParameters(p => p.WithPitch(value));
 
         // Sync to radio
         _radioSettingsSynchronizer?.SyncCwPitchToRadio(value);
@@ -1297,11 +1880,27 @@ public partial class MainWindowViewModel : ViewModelBase
     {
         // Update input device manager
         _inputDeviceManager?.SetSwapPaddles(value);
+        _keyingController?.UpdateParameters(p => p.WithSwapPaddles(value));
 
         // Sync to radio
         _radioSettingsSynchronizer?.SyncSwapPaddlesToRadio(value);
     }
 
+    /// <summary>
+    /// Keyer parameter changes from the radio, on FlexLib's event thread. They reach the keying
+    /// core here without waiting for the UI thread; the controls catch up with the next batch
+    /// of SettingChangedFromRadio.
+    /// </summary>
+    private void ApplyKeyerParametersFromRadio(Func<KeyerParameters, KeyerParameters> update)
+    {
+        var parameters = _keyingController?.UpdateParameters(update);
+        if (parameters == null)
+            return;
+
+        // Paddle swap happens where edges are read, before they reach the keying core
+        _inputDeviceManager?.SetSwapPaddles(parameters.SwapPaddles);
+    }
+
     private void OnRadioAdded(Radio radio)
     {
         // Subscribe to GUIClientAdded event for LAN radios to handle delayed GUI client population
@@ -1322,10 +1921,17 @@ public partial class MainWindowViewModel : ViewModelBase
             radio.GUIClientAdded -= Radio_GUIClientAdded;
         }
 
+        // FlexLib only tracks the instances it discovered; the remembered radio goes away
+        // with its discovered twin
+        bool connectedRadioRemoved = _connectedRadio == radio ||
+            (_connectedRadio != null && _connectedRadio == _rememberedRadio && !radio.IsWan && radio.Serial == _rememberedRadio.Serial);
+        if (connectedRadioRemoved)
+            _rememberedRadio = null;
+
         // Refresh the radio list when a radio is removed
         RefreshRadios();
 
-        if (_connectedRadio == radio)
+        if (connectedRadioRemoved)
         {
             _connectedRadio = null;
             RadioStatus = "Disconnected (radio removed)";
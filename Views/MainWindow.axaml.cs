@@ -76,6 +76,16 @@ public partial class MainWindow : Window
             }
         };
         
+        var keyingTraceItem = new NativeMenuItem("Record Keying Trace");
+        keyingTraceItem.Click += (s, e) =>
+        {
+            if (DataContext is MainWindowViewModel vm)
+            {
+                vm.ToggleKeyingTraceCommand?.Execute(null);
+                keyingTraceItem.Header = vm.KeyingTraceMenuHeader;
+            }
+        };
+        
         var aboutItem = new NativeMenuItem("About NetKeyer...");
         aboutItem.Click += (s, e) =>
         {
@@ -86,6 +96,7 @@ public partial class MainWindow : Window
         };
         
         helpSubMenu.Add(documentationItem);
+        helpSubMenu.Add(keyingTraceItem);
         helpSubMenu.Add(aboutItem);
         helpMenu.Menu = helpSubMenu;
         
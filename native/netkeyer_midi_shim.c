@@ -1,7 +1,7 @@
 /*
  * netkeyer_midi_shim.c
  *
- * Thin C wrapper around the libremidi v5 C API.  Exposes 6 simple functions
+ * Thin C wrapper around the libremidi v5 C API.  Exposes 7 simple functions
  * with no struct/union marshaling so that .NET can P/Invoke them safely.
  *
  * Build: see CMakeLists.txt in this directory.
@@ -194,23 +194,30 @@ NKM_API int nkm_input_name(void* handle, int index, char* buf, int buf_len)
 
 typedef void (*nkm_message_cb)(void* ctx, const uint8_t* data, int len);
 
+/* Same, plus the backend's timestamp for the message in nanoseconds.  The epoch is
+ * backend-specific, so callers map it onto their own clock. */
+typedef void (*nkm_message_ts_cb)(void* ctx, int64_t timestamp_ns,
+                                  const uint8_t* data, int len);
+
 typedef struct {
     libremidi_midi_in_handle* in;
     nkm_message_cb            user_cb;
+    nkm_message_ts_cb         user_ts_cb;
     void*                     user_ctx;
 } nkm_input_t;
 
 static void midi_in_callback(void* ctx, libremidi_timestamp ts,
                               const libremidi_midi1_symbol* data, size_t len)
 {
-    (void)ts;
     nkm_input_t* inp = (nkm_input_t*)ctx;
-    if (inp->user_cb)
+    if (inp->user_ts_cb)
+        inp->user_ts_cb(inp->user_ctx, (int64_t)ts, (const uint8_t*)data, (int)len);
+    else if (inp->user_cb)
         inp->user_cb(inp->user_ctx, (const uint8_t*)data, (int)len);
 }
 
-NKM_API void* nkm_open_input(void* obs_handle, int index,
-                              nkm_message_cb cb, void* user_ctx)
+static void* open_input(void* obs_handle, int index, nkm_message_cb cb,
+                        nkm_message_ts_cb ts_cb, void* user_ctx)
 {
     if (!obs_handle) return NULL;
     nkm_observer_t* o = (nkm_observer_t*)obs_handle;
@@ -218,9 +225,10 @@ NKM_API void* nkm_open_input(void* obs_handle, int index,
 
     nkm_input_t* inp = malloc(sizeof(nkm_input_t));
     if (!inp) return NULL;
-    inp->in       = NULL;
-    inp->user_cb  = cb;
-    inp->user_ctx = user_ctx;
+    inp->in         = NULL;
+    inp->user_cb    = cb;
+    inp->user_ts_cb = ts_cb;
+    inp->user_ctx   = user_ctx;
 
     libremidi_midi_configuration in_cfg;
     libremidi_midi_configuration_init(&in_cfg);
@@ -248,6 +256,18 @@ NKM_API void* nkm_open_input(void* obs_handle, int index,
     return inp;
 }
 
+NKM_API void* nkm_open_input(void* obs_handle, int index,
+                              nkm_message_cb cb, void* user_ctx)
+{
+    return open_input(obs_handle, index, cb, NULL, user_ctx);
+}
+
+NKM_API void* nkm_open_input_ts(void* obs_handle, int index,
+                                 nkm_message_ts_cb cb, void* user_ctx)
+{
+    return open_input(obs_handle, index, NULL, cb, user_ctx);
+}
+
 NKM_API void nkm_close_input(void* handle)
 {
     if (!handle) return;
@@ -0,0 +1,5 @@
+using Xunit;
+
+// The timing limits assume the keying core has the machine to itself, as it does in the
+// application, so test classes don't run alongside each other
+[assembly: CollectionBehavior(DisableTestParallelization = true)]
@@ -0,0 +1,74 @@
+using System;
+using System.Threading;
+using NetKeyer.Services;
+
+namespace NetKeyer.Core.Tests;
+
+/// <summary>
+/// An <see cref="IKeyingRadio"/> that records the key and MOX commands it is sent. The record
+/// is allocated up front, so sending to it never shows up in an allocation measurement.
+/// Commands beyond the capacity are counted but not kept.
+/// </summary>
+public sealed class FakeKeyingRadio : IKeyingRadio
+{
+    private readonly bool[] _keyStates;
+    private readonly uint[] _clientHandles;
+    private int _keyCommands;
+    private int _moxCommands;
+    private bool _isTransmitting;
+
+    public FakeKeyingRadio(int capacity = 65536)
+    {
+        _keyStates = new bool[capacity];
+        _clientHandles = new uint[capacity];
+    }
+
+    /// <summary>
+    /// Number of CWKey commands received.
+    /// </summary>
+    public int KeyCommands => Volatile.Read(ref _keyCommands);
+
+    /// <summary>
+    /// Number of MOX commands received.
+    /// </summary>
+    public int MoxCommands => Volatile.Read(ref _moxCommands);
+
+    /// <summary>
+    /// The state of the last MOX command.
+    /// </summary>
+    public bool Mox { get; private set; }
+
+    public int Capacity => _keyStates.Length;
+
+    public bool KeyState(int index) => _keyStates[index];
+
+    public uint ClientHandle(int index) => _clientHandles[index];
+
+    public bool IsTransmitting
+    {
+        get => Volatile.Read(ref _isTransmitting);
+        set
+        {
+            Volatile.Write(ref _isTransmitting, value);
+            TransmittingChanged?.Invoke(value);
+        }
+    }
+
+    public event Action<bool> TransmittingChanged;
+
+    public void CWKey(bool state, ushort timestamp, uint guiClientHandle)
+    {
+        int index = Interlocked.Increment(ref _keyCommands) - 1;
+        if (index < _keyStates.Length)
+        {
+            _keyStates[index] = state;
+            _clientHandles[index] = guiClientHandle;
+        }
+    }
+
+    public void SetMox(bool state)
+    {
+        Mox = state;
+        Interlocked.Increment(ref _moxCommands);
+    }
+}
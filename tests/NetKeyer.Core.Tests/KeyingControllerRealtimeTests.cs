@@ -0,0 +1,195 @@
+using System;
+using System.Threading;
+using NetKeyer.Helpers;
+using NetKeyer.Models;
+using NetKeyer.Services;
+using Xunit;
+
+namespace NetKeyer.Core.Tests;
+
+/// <summary>
+/// The real-time limits, measured through <see cref="KeyingController"/> with a fake radio
+/// attached, so the radio key path (keyer sink, telemetry, watchdog) is part of what is
+/// measured. Rendering keyed sidetone and delivering MIDI paddle edges must not allocate at
+/// all, and element decisions must stay under <see cref="DECISION_P99_LIMIT_US"/>.
+/// </summary>
+public class KeyingControllerRealtimeTests
+{
+    private const uint CLIENT_HANDLE = 0x4E4B0001;
+    private const int SAMPLE_RATE = 48000;
+    private const int BUFFER_FRAMES = 256;
+    private const int WARMUP_SECONDS = 2;
+    private const int RENDER_SECONDS = 10;
+    private const int PADDLE_PATTERN_MS = 150;
+    private const int WPM = 30;
+    private const int MIDI_MESSAGES = 100_000;
+    private const int CORE_TIMEOUT_MS = 2000;
+
+    // Decisions take around a microsecond on a desktop; the limit leaves room for a shared CI
+    // runner while still catching an accidental O(n) or allocating path
+    private const double DECISION_P99_LIMIT_US = 50;
+
+    [Fact]
+    public void KeyedSidetoneRenderDoesNotAllocate()
+    {
+        var radio = new FakeKeyingRadio();
+        var generator = new RenderingSidetoneGenerator();
+        var controller = CreateController(radio, generator);
+        try
+        {
+            var render = new KeyedRender(controller, generator);
+            render.Run(WARMUP_SECONDS);
+            int warmupCommands = radio.KeyCommands;
+
+            long before = GC.GetAllocatedBytesForCurrentThread();
+            render.Run(RENDER_SECONDS);
+            long allocated = GC.GetAllocatedBytesForCurrentThread() - before;
+
+            Assert.Equal(0, allocated);
+            Assert.True(radio.KeyCommands > warmupCommands, "the keyer sent no key commands");
+            AssertAlternatingKeyCommands(radio);
+        }
+        finally
+        {
+            controller.Dispose();
+        }
+    }
+
+    [Fact]
+    public void ElementDecisionP99IsWithinLimit()
+    {
+        var radio = new FakeKeyingRadio();
+        var generator = new RenderingSidetoneGenerator();
+        var controller = CreateController(radio, generator);
+        try
+        {
+            var render = new KeyedRender(controller, generator);
+            render.Run(WARMUP_SECONDS);
+
+            generator.TimeDecisions = true;
+            render.Run(RENDER_SECONDS);
+            generator.TimeDecisions = false;
+
+            var ticks = generator.DecisionTicks.ToArray();
+            Assert.NotEmpty(ticks);
+            Array.Sort(ticks);
+            double p99 = Timebase.ToNanoseconds(ticks[(ticks.Length - 1) * 99 / 100]) / 1000.0;
+            Assert.True(p99 <= DECISION_P99_LIMIT_US, $"element decision p99 {p99:F2} us over {ticks.Length} decisions (limit {DECISION_P99_LIMIT_US} us)");
+        }
+        finally
+        {
+            controller.Dispose();
+        }
+    }
+
+    /// <summary>
+    /// Delivers MIDI straight key edges the whole way the callback thread does, through
+    /// <see cref="InputDeviceManager"/> into the keying core's input queue. Only this thread is
+    /// measured; the core keys the radio on its own thread.
+    /// </summary>
+    [Fact]
+    public void MidiMessageDeliveryDoesNotAllocate()
+    {
+        var radio = new FakeKeyingRadio();
+        var controller = CreateController(radio, new RenderingSidetoneGenerator());
+        var manager = new InputDeviceManager();
+        try
+        {
+            controller.SetKeyingMode(isIambic: false, isModeB: false);
+            manager.PaddleStateChanged += controller.HandlePaddleStateChange;
+            var input = manager.AttachMidiInput(MidiNoteMapping.GetDefaultMappings());
+
+            ReadOnlySpan<byte> messages = stackalloc byte[]
+            {
+                0x90, 30, 0x7F,   // straight key down
+                0x80, 30, 0x00    // straight key up
+            };
+
+            void Feed(ReadOnlySpan<byte> all, int count)
+            {
+                for (int sent = 0; sent < count;)
+                {
+                    for (int i = 0; i < all.Length && sent < count; i += 3, sent++)
+                        input.OnMidiMessage(all.Slice(i, 3), Timebase.Now);
+                }
+            }
+
+            Feed(messages, MIDI_MESSAGES / 10);
+
+            long before = GC.GetAllocatedBytesForCurrentThread();
+            Feed(messages, MIDI_MESSAGES);
+            long allocated = GC.GetAllocatedBytesForCurrentThread() - before;
+
+            Assert.Equal(0, allocated);
+            Assert.True(SpinWait.SpinUntil(() => radio.KeyCommands > 0, CORE_TIMEOUT_MS), "the straight key never reached the radio");
+        }
+        finally
+        {
+            manager.Dispose();
+            controller.Dispose();
+        }
+    }
+
+    private static KeyingController CreateController(FakeKeyingRadio radio, RenderingSidetoneGenerator generator)
+    {
+        var controller = new KeyingController(generator);
+        controller.Initialize(CLIENT_HANDLE, () => Timebase.ToRadioTimestamp(Timebase.Now), radio.CWKey);
+        controller.SetRadio(radio);
+        controller.UpdateParameters(p => p.WithWpm(WPM).WithPitch(600));
+        return controller;
+    }
+
+    private static void AssertAlternatingKeyCommands(FakeKeyingRadio radio)
+    {
+        int count = Math.Min(radio.KeyCommands, radio.Capacity);
+        for (int i = 0; i < count; i++)
+        {
+            Assert.Equal(i % 2 == 0, radio.KeyState(i));
+            Assert.Equal(CLIENT_HANDLE, radio.ClientHandle(i));
+        }
+    }
+
+    /// <summary>
+    /// Plays the audio callback: renders sidetone in device-sized buffers, each one when the
+    /// previous one would have finished playing, with the paddles cycling through dit, dah,
+    /// squeeze and release. The pacing matters: the keying core thread applies edges while
+    /// the keyer is idle, and would fall behind a render loop running flat out.
+    /// </summary>
+    private sealed class KeyedRender
+    {
+        private readonly KeyingController _controller;
+        private readonly RenderingSidetoneGenerator _generator;
+        private readonly float[] _buffer = new float[BUFFER_FRAMES];
+        private long _frame;
+        private long _origin;
+        private int _pattern = -1;
+
+        public KeyedRender(KeyingController controller, RenderingSidetoneGenerator generator)
+        {
+            _controller = controller;
+            _generator = generator;
+        }
+
+        public void Run(int seconds)
+        {
+            if (_frame == 0)
+                _origin = Timebase.Now;
+
+            long end = _frame + (long)seconds * SAMPLE_RATE;
+            while (_frame < end)
+            {
+                while (Timebase.Now < _origin + Timebase.FramesToTicks(_frame, SAMPLE_RATE))
+                    Thread.Sleep(1);
+
+                int next = (int)(_frame * 1000 / SAMPLE_RATE / PADDLE_PATTERN_MS) % 4;
+                if (next != _pattern)
+                {
+                    _pattern = next;
+                    _controller.HandlePaddleStateChange(new PaddleState(_pattern == 0 || _pattern == 2, _pattern == 1 || _pattern == 2, false, false, Timebase.Now));
+                }
+                _generator.Render(_buffer);
+                _frame += BUFFER_FRAMES;
+            }
+        }
+    }
+}
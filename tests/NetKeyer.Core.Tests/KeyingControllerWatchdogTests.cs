@@ -0,0 +1,77 @@
+using System;
+using System.Threading;
+using NetKeyer.Helpers;
+using NetKeyer.Models;
+using NetKeyer.Services;
+using Xunit;
+
+namespace NetKeyer.Core.Tests;
+
+/// <summary>
+/// The key-down watchdog's forced key-up, as applied by <see cref="KeyingController"/>.
+/// </summary>
+public class KeyingControllerWatchdogTests
+{
+    private const uint CLIENT_HANDLE = 0x4E4B0001;
+    private const int MAX_KEY_DOWN_MS = 200;
+    private const int BUFFER_FRAMES = 256;
+    private const int BUFFER_MS = 5;
+    private const int TIMEOUT_MS = 3000;
+
+    [Fact]
+    public void StraightKeyHeldTooLongIsKeyedUpWithItsSidetone()
+    {
+        var radio = new FakeKeyingRadio();
+        var generator = new RenderingSidetoneGenerator();
+        var controller = new KeyingController(generator);
+        var buffer = new float[BUFFER_FRAMES];
+        try
+        {
+            controller.Initialize(CLIENT_HANDLE, () => Timebase.ToRadioTimestamp(Timebase.Now), radio.CWKey);
+            controller.SetRadio(radio);
+            controller.UpdateParameters(p => p.WithKeyingMode(false, false).WithMaxKeyDown(MAX_KEY_DOWN_MS));
+
+            controller.HandlePaddleStateChange(StraightKey(true));
+            Assert.True(RenderUntil(generator, buffer, () => controller.WatchdogKeyUps == 1 && !controller.IsRadioKeyDown),
+                "the watchdog didn't key the radio up");
+
+            // Render past the sidetone's ramp-down
+            RenderUntil(generator, buffer, () => false, 10 * BUFFER_MS);
+            Assert.True(generator.IsSilent, "the sidetone kept playing after the forced key-up");
+            Assert.False(radio.KeyState(radio.KeyCommands - 1));
+
+            // Once released, the key works again
+            int before = radio.KeyCommands;
+            controller.HandlePaddleStateChange(StraightKey(false));
+            Assert.True(RenderUntil(generator, buffer, () => radio.KeyCommands > before), "the key release was not applied");
+            before = radio.KeyCommands;
+            controller.HandlePaddleStateChange(StraightKey(true));
+            Assert.True(RenderUntil(generator, buffer, () => radio.KeyCommands > before && radio.KeyState(radio.KeyCommands - 1)),
+                "a key-down after the forced key-up never reached the radio");
+            Assert.True(controller.IsRadioKeyDown);
+        }
+        finally
+        {
+            controller.Dispose();
+        }
+    }
+
+    private static PaddleState StraightKey(bool down) => new PaddleState(false, false, down, false, Timebase.Now);
+
+    /// <summary>
+    /// Renders sidetone at roughly the audio device's pace until <paramref name="done"/> or
+    /// the timeout; returns whether it got there.
+    /// </summary>
+    private static bool RenderUntil(RenderingSidetoneGenerator generator, float[] buffer, Func<bool> done, int timeoutMs = TIMEOUT_MS)
+    {
+        long deadline = Environment.TickCount64 + timeoutMs;
+        while (!done())
+        {
+            if (Environment.TickCount64 > deadline)
+                return false;
+            generator.Render(buffer);
+            Thread.Sleep(BUFFER_MS);
+        }
+        return true;
+    }
+}
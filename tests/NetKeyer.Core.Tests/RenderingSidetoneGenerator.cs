@@ -0,0 +1,64 @@
+using System;
+using NetKeyer.Audio;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Core.Tests;
+
+/// <summary>
+/// A sidetone generator over a <see cref="SidetoneProvider"/> with no audio device: the test
+/// plays the part of the audio callback and calls <see cref="Render"/>, which raises the
+/// provider's events as the real generator does. While <see cref="TimeDecisions"/> is set,
+/// the time the keying core spends in each end-of-silence event (where the keyer chooses and
+/// sends its next element) is recorded.
+/// </summary>
+public sealed class RenderingSidetoneGenerator : ISidetoneGenerator
+{
+    private readonly SidetoneProvider _provider = new SidetoneProvider();
+    private readonly long[] _decisionTicks;
+    private int _decisionCount;
+
+    public event Action OnSilenceComplete;
+    public event Action OnToneStart;
+    public event Action OnToneComplete;
+    public event Action OnBeforeSilenceEnd;
+    public event Action OnBecomeIdle;
+
+    public RenderingSidetoneGenerator(int maxDecisions = 16384)
+    {
+        _decisionTicks = new long[maxDecisions];
+        _provider.OnSilenceComplete += () => OnSilenceComplete?.Invoke();
+        _provider.OnToneStart += () => OnToneStart?.Invoke();
+        _provider.OnToneComplete += () => OnToneComplete?.Invoke();
+        _provider.OnBeforeSilenceEnd += RaiseBeforeSilenceEnd;
+        _provider.OnBecomeIdle += () => OnBecomeIdle?.Invoke();
+    }
+
+    public bool TimeDecisions { get; set; }
+
+    public bool IsSilent => _provider.IsSilent;
+
+    /// <summary>
+    /// Recorded decision times in <see cref="Timebase"/> ticks, in the order they were made.
+    /// </summary>
+    public ReadOnlySpan<long> DecisionTicks => _decisionTicks.AsSpan(0, _decisionCount);
+
+    public int Render(float[] buffer) => _provider.Read(buffer, 0, buffer.Length);
+
+    public void SetFrequency(int frequencyHz) => _provider.SetFrequency(frequencyHz);
+    public void SetVolume(int volumePercent) => _provider.SetVolume(Math.Clamp(volumePercent / 100.0f, 0.0f, 1.0f));
+    public void SetWpm(int wpm) => _provider.SetWpm(wpm);
+    public void Start() => _provider.StartIndefiniteTone();
+    public void Stop() => _provider.Stop();
+    public void StartTone(int durationMs) => _provider.StartTone(durationMs);
+    public void StartSilenceThenTone(int silenceMs, int toneMs) => _provider.StartSilenceThenTone(silenceMs, toneMs);
+    public void QueueSilence(int silenceMs, int? followingToneMs = null) => _provider.QueueSilence(silenceMs, followingToneMs);
+    public void Dispose() { }
+
+    private void RaiseBeforeSilenceEnd()
+    {
+        long start = Timebase.Now;
+        OnBeforeSilenceEnd?.Invoke();
+        if (TimeDecisions && _decisionCount < _decisionTicks.Length)
+            _decisionTicks[_decisionCount++] = Timebase.Now - start;
+    }
+}
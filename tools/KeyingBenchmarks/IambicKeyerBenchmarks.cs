@@ -0,0 +1,67 @@
+using BenchmarkDotNet.Attributes;
+using NetKeyer.Keying;
+
+namespace NetKeyer.Tools.KeyingBenchmarks;
+
+/// <summary>
+/// The iambic keyer's decisions, driven directly rather than by sidetone callbacks. The
+/// sidetone generator does nothing and the radio sink only counts key commands.
+/// </summary>
+[MemoryDiagnoser]
+public class IambicKeyerBenchmarks
+{
+    private IambicKeyer _keyer;
+    private int _keyCommands;
+    private bool _squeezed;
+
+    [GlobalSetup(Target = nameof(DetermineNextToneDuration))]
+    public void SetupSqueezed()
+    {
+        _squeezed = true;
+        Setup();
+    }
+
+    [GlobalSetup(Targets = new[] { nameof(UpdatePaddleState), nameof(ElementCycle) })]
+    public void Setup()
+    {
+        _keyer = new IambicKeyer(new NullSidetoneGenerator(), 0x4E4B0001, () => 0, (_, _, _) => _keyCommands++);
+        _keyer.SetWpm(25);
+
+        // The keyer stays idle (nothing renders the element), with both paddles held
+        if (_squeezed)
+            _keyer.UpdatePaddleState(true, true);
+    }
+
+    /// <summary>
+    /// A paddle press from idle, which decides and starts the first element, and the release.
+    /// </summary>
+    [Benchmark]
+    public void UpdatePaddleState()
+    {
+        _keyer.UpdatePaddleState(true, false);
+        _keyer.UpdatePaddleState(false, false);
+    }
+
+    /// <summary>
+    /// The element decision alone, with both paddles squeezed.
+    /// </summary>
+    [Benchmark]
+    public int? DetermineNextToneDuration()
+    {
+        return _keyer.DetermineNextToneDuration();
+    }
+
+    /// <summary>
+    /// One element from tone start to idle: key-down and key-up to the radio with computed
+    /// timestamps, and the end-of-silence decision.
+    /// </summary>
+    [Benchmark]
+    public int ElementCycle()
+    {
+        _keyer.HandleToneStart();
+        _keyer.HandleToneComplete();
+        _keyer.HandleBeforeSilenceEnd();
+        _keyer.HandleSilenceComplete();
+        return _keyCommands;
+    }
+}
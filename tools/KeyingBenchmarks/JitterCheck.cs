@@ -0,0 +1,179 @@
+using System;
+using System.Threading;
+using NetKeyer.Helpers;
+using NetKeyer.Realtime;
+
+namespace NetKeyer.Tools.KeyingBenchmarks;
+
+/// <summary>
+/// Measures what the real-time profile buys, run with <c>-- jitter [--seconds N] [--cores 2-3]
+/// [--isolate]</c>. A thread stands in for the audio callback: every 256 frames at 48 kHz it
+/// wakes and renders a sidetone buffer, while every core runs a thread that computes and
+/// allocates enough to keep the GC busy. The callback intervals are measured with the profile
+/// off and then on. Not pass/fail: the result depends on the machine and on whether this user
+/// may use SCHED_FIFO, so it prints both runs and the effective configuration side by side.
+/// </summary>
+public static class JitterCheck
+{
+    private const int SAMPLE_RATE = 48000;
+    private const int BUFFER_FRAMES = 256;
+    private const int DEFAULT_SECONDS = 10;
+
+    // An interval this much longer than the period is a glitch at typical WASAPI/ALSA buffering
+    private const double LATE_THRESHOLD_MS = 1.0;
+
+    // Sleep until this close to the deadline, then spin. Windows sleeps in 15.6 ms steps
+    // unless the timer resolution is raised, so there the callback thread only yields
+    private static readonly double SleepMarginMs = OperatingSystem.IsWindows() ? 16.0 : 2.0;
+
+    private static volatile bool _loadRunning;
+    private static long _loadChecksum;
+
+    public static int Run(string[] args)
+    {
+        int seconds = DEFAULT_SECONDS;
+        string cores = "";
+        bool isolate = false;
+        for (int i = 1; i < args.Length; i++)
+        {
+            switch (args[i])
+            {
+                case "--seconds" when i + 1 < args.Length && int.TryParse(args[i + 1], out seconds) && seconds > 0:
+                    i++;
+                    break;
+                case "--cores" when i + 1 < args.Length:
+                    cores = args[++i];
+                    break;
+                case "--isolate":
+                    isolate = true;
+                    break;
+                default:
+                    Console.WriteLine("usage: jitter [--seconds N] [--cores LIST] [--isolate]");
+                    return 1;
+            }
+        }
+
+        var load = StartLoad();
+        try
+        {
+            Console.WriteLine($"Callback every {BUFFER_FRAMES} frames at {SAMPLE_RATE} Hz ({PeriodMs:F3} ms), " +
+                              $"{load.Length} load threads, {seconds} s per run");
+
+            RealtimeProfile.Configure(false, null, false);
+            Report("Profile off", MeasureCallbacks(seconds));
+
+            try
+            {
+                RealtimeProfile.Configure(true, cores, isolate);
+            }
+            catch (ArgumentException ex)
+            {
+                Console.WriteLine(ex.Message);
+                return 1;
+            }
+            Report("Profile on ", MeasureCallbacks(seconds));
+            Console.WriteLine(RealtimeProfile.Describe());
+        }
+        finally
+        {
+            _loadRunning = false;
+            foreach (var thread in load)
+                thread.Join();
+        }
+        return 0;
+    }
+
+    private static double PeriodMs => BUFFER_FRAMES * 1000.0 / SAMPLE_RATE;
+
+    /// <summary>
+    /// One thread per core doing floating-point work and allocating short- and long-lived
+    /// arrays, so both the CPU and the GC compete with the callback thread.
+    /// </summary>
+    private static Thread[] StartLoad()
+    {
+        _loadRunning = true;
+        var threads = new Thread[Environment.ProcessorCount];
+        for (int i = 0; i < threads.Length; i++)
+        {
+            threads[i] = new Thread(() =>
+            {
+                var survivors = new byte[64][];
+                double x = 1.0;
+                long n = 0;
+                while (_loadRunning)
+                {
+                    for (int j = 0; j < 10_000; j++)
+                        x = Math.Sqrt(x * 1.000001 + j);
+                    var garbage = new byte[16 * 1024];
+                    survivors[n++ % survivors.Length] = garbage;
+                }
+                Interlocked.Add(ref _loadChecksum, (long)x);
+            }) { Name = $"jitter load {i}", IsBackground = true };
+            threads[i].Start();
+        }
+        return threads;
+    }
+
+    /// <summary>
+    /// Runs the stand-in callback thread for the given time and returns the interval between
+    /// successive wakeups, in ticks.
+    /// </summary>
+    private static long[] MeasureCallbacks(int seconds)
+    {
+        long periodTicks = Timebase.FramesToTicks(BUFFER_FRAMES, SAMPLE_RATE);
+        var intervals = new long[seconds * SAMPLE_RATE / BUFFER_FRAMES];
+
+        var thread = new Thread(() =>
+        {
+            var generator = new RenderingSidetoneGenerator();
+            generator.SetFrequency(600);
+            generator.Start();
+            var buffer = new float[BUFFER_FRAMES];
+
+            long deadline = Timebase.Now + periodTicks;
+            long last = 0;
+            for (int i = -1; i < intervals.Length; i++)
+            {
+                while (Timebase.ToMilliseconds(deadline - Timebase.Now) > SleepMarginMs)
+                    Thread.Sleep(1);
+                while (Timebase.Now < deadline)
+                    Thread.Yield();
+
+                long now = Timebase.Now;
+                if (i >= 0)
+                    intervals[i] = now - last;
+                last = now;
+
+                // The provider applies the profile to this thread, as it does for a real callback
+                generator.Render(buffer);
+                deadline += periodTicks;
+                if (deadline < now)
+                    deadline = now + periodTicks;
+            }
+        }) { Name = "jitter callback", IsBackground = true };
+        thread.Start();
+        thread.Join();
+        return intervals;
+    }
+
+    private static void Report(string name, long[] intervals)
+    {
+        double periodMs = PeriodMs;
+        var deviations = new double[intervals.Length];
+        int late = 0;
+        for (int i = 0; i < intervals.Length; i++)
+        {
+            double ms = Timebase.ToMilliseconds(intervals[i]);
+            deviations[i] = Math.Abs(ms - periodMs);
+            if (ms - periodMs > LATE_THRESHOLD_MS)
+                late++;
+        }
+        Array.Sort(deviations);
+
+        double p50 = deviations[deviations.Length / 2];
+        double p99 = deviations[(deviations.Length - 1) * 99 / 100];
+        double max = deviations[^1];
+        Console.WriteLine($"  {name}: jitter p50 {p50 * 1000:F0} us, p99 {p99 * 1000:F0} us, max {max * 1000:F0} us; " +
+                          $"{late} of {intervals.Length} callbacks over {LATE_THRESHOLD_MS:F0} ms late");
+    }
+}
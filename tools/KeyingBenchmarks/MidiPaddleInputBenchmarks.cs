@@ -0,0 +1,62 @@
+using System.Collections.Generic;
+using BenchmarkDotNet.Attributes;
+using NetKeyer.Helpers;
+using NetKeyer.Midi;
+using NetKeyer.Models;
+
+namespace NetKeyer.Tools.KeyingBenchmarks;
+
+/// <summary>
+/// A MIDI note through <see cref="MidiPaddleInput"/> to a PaddleState, as the libremidi
+/// callback delivers it, with the default mappings and with every note mapped.
+/// </summary>
+[MemoryDiagnoser]
+public class MidiPaddleInputBenchmarks
+{
+    private MidiPaddleInput _input;
+    private PaddleState _lastState;
+    private int _note;
+
+    [Params("default", "large")]
+    public string Mappings { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        _input = new MidiPaddleInput();
+        _input.PaddleStateChanged += state => _lastState = state;
+
+        if (Mappings == "default")
+        {
+            _input.SetNoteMappings(MidiNoteMapping.GetDefaultMappings());
+            _note = 20;
+        }
+        else
+        {
+            // All 128 notes, each listed twice as a long hand-edited list might
+            var mappings = new List<MidiNoteMapping>();
+            for (int pass = 0; pass < 2; pass++)
+            {
+                for (int note = 0; note < 128; note++)
+                    mappings.Add(new MidiNoteMapping(note, note % 2 == 0 ? MidiNoteFunction.LeftPaddle : MidiNoteFunction.RightPaddle));
+            }
+            _input.SetNoteMappings(mappings);
+            _note = 100;
+        }
+    }
+
+    [GlobalCleanup]
+    public void Cleanup()
+    {
+        _input.Dispose();
+    }
+
+    [Benchmark]
+    public byte NoteOnOff()
+    {
+        long timestamp = Timebase.Now;
+        _input.HandleNoteEvent(_note, true, timestamp);
+        _input.HandleNoteEvent(_note, false, timestamp);
+        return _lastState.Bits;
+    }
+}
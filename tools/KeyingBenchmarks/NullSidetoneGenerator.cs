@@ -0,0 +1,27 @@
+using System;
+using NetKeyer.Audio;
+
+namespace NetKeyer.Tools.KeyingBenchmarks;
+
+/// <summary>
+/// A sidetone generator with no audio behind it. Nothing is rendered, so no events fire;
+/// benchmarks call the keyer's handlers themselves.
+/// </summary>
+public sealed class NullSidetoneGenerator : ISidetoneGenerator
+{
+    public event Action OnSilenceComplete;
+    public event Action OnToneStart;
+    public event Action OnToneComplete;
+    public event Action OnBeforeSilenceEnd;
+    public event Action OnBecomeIdle;
+
+    public void SetFrequency(int frequencyHz) { }
+    public void SetVolume(int volumePercent) { }
+    public void SetWpm(int wpm) { }
+    public void Start() { }
+    public void Stop() { }
+    public void StartTone(int durationMs) { }
+    public void StartSilenceThenTone(int silenceMs, int toneMs) { }
+    public void QueueSilence(int silenceMs, int? followingToneMs = null) { }
+    public void Dispose() { }
+}
@@ -0,0 +1,29 @@
+using BenchmarkDotNet.Running;
+
+namespace NetKeyer.Tools.KeyingBenchmarks;
+
+/// <summary>
+/// Microbenchmarks of the keying hot paths, with allocations, as the baseline for
+/// performance changes. Runs anywhere, without audio or MIDI hardware or a radio:
+///
+///   dotnet run --project tools/KeyingBenchmarks -c Release -- --filter '*'
+///
+/// Any BenchmarkDotNet option works, e.g. <c>--filter '*SidetoneProvider*'</c> or
+/// <c>--job short</c> for a quick look. <c>-- check</c> runs <see cref="RealtimeChecks"/> instead,
+/// which fails (exit code 1) if a real-time path allocates or an element decision is too slow,
+/// and <c>-- jitter</c> runs <see cref="JitterCheck"/>, which compares callback timing under load
+/// with the real-time profile off and on.
+/// </summary>
+public static class Program
+{
+    public static int Main(string[] args)
+    {
+        if (args.Length > 0 && args[0] == "check")
+            return RealtimeChecks.Run();
+        if (args.Length > 0 && args[0] == "jitter")
+            return JitterCheck.Run(args);
+
+        BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args);
+        return 0;
+    }
+}
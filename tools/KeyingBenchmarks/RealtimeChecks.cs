@@ -0,0 +1,303 @@
+using System;
+using System.Threading;
+using NetKeyer.Evdev;
+using NetKeyer.Helpers;
+using NetKeyer.Keying;
+using NetKeyer.Midi;
+using NetKeyer.Models;
+using NetKeyer.Services;
+
+namespace NetKeyer.Tools.KeyingBenchmarks;
+
+/// <summary>
+/// Pass/fail limits for the real-time paths, run with <c>-- check</c>. Unlike the benchmarks
+/// these are hard limits: the exit code is non-zero if rendering keyed sidetone, decoding
+/// MIDI, delivering paddle edges to the keying core, reading evdev input or a disabled debug log
+/// call allocates at all, or if an element decision is slower than the limit, so LINQ, boxing
+/// or string formatting creeping back onto the audio thread fails the build.
+/// </summary>
+public static class RealtimeChecks
+{
+    private const int SAMPLE_RATE = 48000;
+    private const int BUFFER_FRAMES = 256;
+    private const int WARMUP_SECONDS = 2;
+    private const int RENDER_SECONDS = 10;
+    private const int PADDLE_PATTERN_MS = 150;
+    private const int MIDI_MESSAGES = 100_000;
+    private const int LOG_CALLS = 100_000;
+    private const int EVDEV_EDGES = 2000;
+    private const int EVDEV_EDGE_TIMEOUT_MS = 1000;
+
+    // Decisions take around a microsecond on a desktop; the limit leaves room for a shared CI
+    // runner while still catching an accidental O(n) or allocating path
+    private const double DECISION_P99_LIMIT_US = 50;
+
+    public static int Run()
+    {
+        // Debug logging formats on these paths, so it has to be off for the allocation checks
+        if (DebugCategory.Keyer.IsEnabled || DebugCategory.Sidetone.IsEnabled || DebugCategory.Midi.IsEnabled || DebugCategory.Input.IsEnabled)
+            Console.WriteLine("Warning: debug logging is enabled; the allocation checks will fail");
+
+        int failures = 0;
+        failures += CheckKeyedSidetone();
+        failures += CheckMidiDecode();
+        failures += CheckPaddleDelivery();
+        failures += CheckDisabledLogging();
+        failures += CheckEvdevInput();
+
+        Console.WriteLine(failures == 0 ? "All checks passed" : $"{failures} check(s) failed");
+        return failures == 0 ? 0 : 1;
+    }
+
+    /// <summary>
+    /// Renders keyed sidetone through the iambic keyer the way the audio callback does, with the
+    /// paddles cycling through dit, dah, squeeze and release, and times each end-of-silence
+    /// decision (the keyer deciding and queueing its next element).
+    /// </summary>
+    private static int CheckKeyedSidetone()
+    {
+        var generator = new RenderingSidetoneGenerator();
+        generator.SetFrequency(600);
+        generator.SetWpm(30);
+
+        // Sidetone-only (client handle 0): the radio path formats its command inside FlexLib,
+        // which allocates however the timestamp is passed in
+        var keyer = new IambicKeyer(generator, 0, () => 0, null);
+        keyer.SetWpm(30);
+
+        int decisionCount = 0;
+        var decisionTicks = new long[RENDER_SECONDS * 1000];
+        bool timing = false;
+
+        generator.OnToneStart += keyer.HandleToneStart;
+        generator.OnToneComplete += keyer.HandleToneComplete;
+        generator.OnSilenceComplete += keyer.HandleSilenceComplete;
+        generator.OnBeforeSilenceEnd += () =>
+        {
+            long start = Timebase.Now;
+            keyer.HandleBeforeSilenceEnd();
+            if (timing && decisionCount < decisionTicks.Length)
+                decisionTicks[decisionCount++] = Timebase.Now - start;
+        };
+
+        var buffer = new float[BUFFER_FRAMES];
+        long frame = 0;
+        int pattern = -1;
+
+        void RenderSeconds(int seconds)
+        {
+            long end = frame + (long)seconds * SAMPLE_RATE;
+            while (frame < end)
+            {
+                int next = (int)(frame * 1000 / SAMPLE_RATE / PADDLE_PATTERN_MS) % 4;
+                if (next != pattern)
+                {
+                    pattern = next;
+                    keyer.UpdatePaddleState(pattern == 0 || pattern == 2, pattern == 1 || pattern == 2);
+                }
+                generator.Render(buffer);
+                frame += BUFFER_FRAMES;
+            }
+        }
+
+        RenderSeconds(WARMUP_SECONDS);
+
+        timing = true;
+        long before = GC.GetAllocatedBytesForCurrentThread();
+        RenderSeconds(RENDER_SECONDS);
+        long allocated = GC.GetAllocatedBytesForCurrentThread() - before;
+
+        int failures = Report($"Keyed sidetone render, {RENDER_SECONDS} s in {BUFFER_FRAMES}-frame buffers", allocated, "bytes allocated", 0);
+
+        if (decisionCount == 0)
+        {
+            Console.WriteLine("  FAIL  Element decision: the keyer made no decisions");
+            return failures + 1;
+        }
+
+        Array.Sort(decisionTicks, 0, decisionCount);
+        double p50 = Timebase.ToNanoseconds(decisionTicks[decisionCount / 2]) / 1000.0;
+        double p99 = Timebase.ToNanoseconds(decisionTicks[(decisionCount - 1) * 99 / 100]) / 1000.0;
+        double max = Timebase.ToNanoseconds(decisionTicks[decisionCount - 1]) / 1000.0;
+        bool ok = p99 <= DECISION_P99_LIMIT_US;
+        Console.WriteLine($"  {(ok ? "ok  " : "FAIL")}  Element decision ({decisionCount}): p50 {p50:F2} us, p99 {p99:F2} us (limit {DECISION_P99_LIMIT_US} us), max {max:F2} us");
+        return failures + (ok ? 0 : 1);
+    }
+
+    /// <summary>
+    /// Feeds raw note on/off messages through <see cref="MidiPaddleInput"/> as the libremidi
+    /// callback delivers them, including unmapped notes and a note off without its note on.
+    /// </summary>
+    private static int CheckMidiDecode()
+    {
+        var input = new MidiPaddleInput();
+        input.SetNoteMappings(MidiNoteMapping.GetDefaultMappings());
+        int changes = 0;
+        input.PaddleStateChanged += _ => changes++;
+
+        ReadOnlySpan<byte> messages = stackalloc byte[]
+        {
+            0x90, 20, 0x7F,  0x80, 20, 0x00,   // left paddle
+            0x90, 21, 0x7F,  0x80, 21, 0x00,   // right paddle
+            0x81, 20, 0x00,                    // note off without note on
+            0x90, 99, 0x7F,  0x80, 99, 0x00,   // unmapped
+            0xB0, 20, 0x7F                     // control change
+        };
+
+        void Feed(ReadOnlySpan<byte> all, int count)
+        {
+            for (int sent = 0; sent < count;)
+            {
+                for (int i = 0; i < all.Length && sent < count; i += 3, sent++)
+                    input.OnMidiMessage(all.Slice(i, 3), Timebase.Now);
+            }
+        }
+
+        Feed(messages, MIDI_MESSAGES / 10);
+
+        long before = GC.GetAllocatedBytesForCurrentThread();
+        Feed(messages, MIDI_MESSAGES);
+        long allocated = GC.GetAllocatedBytesForCurrentThread() - before;
+
+        input.Dispose();
+        int failures = Report($"MIDI decode, {MIDI_MESSAGES} messages", allocated, "bytes allocated", 0);
+        if (changes == 0)
+        {
+            Console.WriteLine("  FAIL  MIDI decode: no paddle state changes");
+            failures++;
+        }
+        return failures;
+    }
+
+    /// <summary>
+    /// Delivers MIDI paddle edges the whole way the callback thread does: through
+    /// <see cref="InputDeviceManager"/> (grace period, swap, forwarding check) into
+    /// <see cref="KeyingController"/>'s input queue. Only this thread is measured; the keying
+    /// core drains the queue on its own thread.
+    /// </summary>
+    private static int CheckPaddleDelivery()
+    {
+        var controller = new KeyingController(new NullSidetoneGenerator());
+        var manager = new InputDeviceManager();
+        manager.SetSwapPaddles(true);
+        manager.PaddleStateChanged += controller.HandlePaddleStateChange;
+        int delivered = 0;
+        manager.PaddleStateChanged += _ => delivered++;
+        var input = manager.AttachMidiInput(MidiNoteMapping.GetDefaultMappings());
+
+        ReadOnlySpan<byte> messages = stackalloc byte[]
+        {
+            0x90, 20, 0x7F,  0x90, 21, 0x7F,   // squeeze
+            0x80, 20, 0x00,  0x80, 21, 0x00    // release
+        };
+
+        void Feed(ReadOnlySpan<byte> all, int count)
+        {
+            for (int sent = 0; sent < count;)
+            {
+                for (int i = 0; i < all.Length && sent < count; i += 3, sent++)
+                    input.OnMidiMessage(all.Slice(i, 3), Timebase.Now);
+            }
+        }
+
+        Feed(messages, MIDI_MESSAGES / 10);
+
+        long before = GC.GetAllocatedBytesForCurrentThread();
+        Feed(messages, MIDI_MESSAGES);
+        long allocated = GC.GetAllocatedBytesForCurrentThread() - before;
+
+        manager.Dispose();
+        controller.Dispose();
+        int failures = Report($"Paddle delivery to the keying core, {MIDI_MESSAGES} messages", allocated, "bytes allocated", 0);
+        if (delivered == 0)
+        {
+            Console.WriteLine("  FAIL  Paddle delivery: no paddle state changes");
+            failures++;
+        }
+        return failures;
+    }
+
+    /// <summary>
+    /// Interpolated <see cref="DebugLogger.Log(DebugCategory, ref DebugLogInterpolatedStringHandler)"/>
+    /// calls for a disabled category, as the input and keying paths make them without a guard.
+    /// </summary>
+    private static int CheckDisabledLogging()
+    {
+        if (DebugCategory.Input.IsEnabled)
+        {
+            Console.WriteLine("  skip  Disabled debug logging: the input category is enabled");
+            return 0;
+        }
+
+        var state = new PaddleState(true, false, true, true, Timebase.Now);
+        for (int i = 0; i < LOG_CALLS / 10; i++)
+            DebugLogger.Log(DebugCategory.Input, $"[RealtimeChecks] Received event {i}: {state}");
+
+        long before = GC.GetAllocatedBytesForCurrentThread();
+        for (int i = 0; i < LOG_CALLS; i++)
+            DebugLogger.Log(DebugCategory.Input, $"[RealtimeChecks] Received event {i}: {state}");
+        long allocated = GC.GetAllocatedBytesForCurrentThread() - before;
+
+        return Report($"Disabled debug logging, {LOG_CALLS} interpolated calls", allocated, "bytes allocated", 0);
+    }
+
+    /// <summary>
+    /// Types dit and dah key presses on a uinput keyboard and reads them back through
+    /// <see cref="EvdevPaddleInput"/>, measuring allocation on its read thread between the first
+    /// and last edge. Skipped where /dev/uinput isn't available, as on most CI runners.
+    /// </summary>
+    private static int CheckEvdevInput()
+    {
+        using var keyboard = UinputKeyboard.TryCreate("NetKeyer realtime check", new[] { (ushort)EvdevKeyMapping.KEY_LEFTCTRL, (ushort)EvdevKeyMapping.KEY_RIGHTCTRL }, out string reason);
+        if (keyboard == null)
+        {
+            Console.WriteLine($"  skip  Evdev input: {reason}");
+            return 0;
+        }
+
+        int delivered = 0;
+        long firstAllocated = 0, lastAllocated = 0;
+        using var input = new EvdevPaddleInput();
+        input.SetKeyMappings(EvdevKeyMapping.GetDefaultMappings());
+        input.PaddleStateChanged += _ =>
+        {
+            // The read thread delivers every edge, so its own counter covers them all
+            long allocatedNow = GC.GetAllocatedBytesForCurrentThread();
+            if (delivered == EVDEV_EDGES / 10)
+                firstAllocated = allocatedNow;
+            lastAllocated = allocatedNow;
+            Volatile.Write(ref delivered, delivered + 1);
+        };
+        input.Open(keyboard.DeviceName);
+
+        for (int i = 0; i < EVDEV_EDGES; i++)
+        {
+            // One edge at a time, so the small evdev buffer of a two-key device never overflows
+            ushort key = (ushort)((i / 2) % 2 == 0 ? EvdevKeyMapping.KEY_LEFTCTRL : EvdevKeyMapping.KEY_RIGHTCTRL);
+            long deadline = Environment.TickCount64 + EVDEV_EDGE_TIMEOUT_MS;
+            if (!keyboard.Send(key, i % 2 == 0))
+            {
+                Console.WriteLine("  FAIL  Evdev input: writing to the uinput device failed");
+                return 1;
+            }
+            while (Volatile.Read(ref delivered) <= i)
+            {
+                if (Environment.TickCount64 > deadline)
+                {
+                    Console.WriteLine($"  FAIL  Evdev input: edge {i} not delivered within {EVDEV_EDGE_TIMEOUT_MS} ms");
+                    return 1;
+                }
+                Thread.Yield();
+            }
+        }
+
+        return Report($"Evdev input, {EVDEV_EDGES} edges from uinput", lastAllocated - firstAllocated, "bytes allocated", 0);
+    }
+
+    private static int Report(string name, long value, string unit, long limit)
+    {
+        bool ok = value <= limit;
+        Console.WriteLine($"  {(ok ? "ok  " : "FAIL")}  {name}: {value} {unit} (limit {limit})");
+        return ok ? 0 : 1;
+    }
+}
@@ -0,0 +1,41 @@
+using System;
+using NetKeyer.Audio;
+
+namespace NetKeyer.Tools.KeyingBenchmarks;
+
+/// <summary>
+/// A sidetone generator over a <see cref="SidetoneProvider"/> with no audio device: the caller
+/// plays the part of the audio callback and calls <see cref="Render"/>, which raises the
+/// provider's events as the real generator does.
+/// </summary>
+public sealed class RenderingSidetoneGenerator : ISidetoneGenerator
+{
+    private readonly SidetoneProvider _provider = new SidetoneProvider();
+
+    public event Action OnSilenceComplete;
+    public event Action OnToneStart;
+    public event Action OnToneComplete;
+    public event Action OnBeforeSilenceEnd;
+    public event Action OnBecomeIdle;
+
+    public RenderingSidetoneGenerator()
+    {
+        _provider.OnSilenceComplete += () => OnSilenceComplete?.Invoke();
+        _provider.OnToneStart += () => OnToneStart?.Invoke();
+        _provider.OnToneComplete += () => OnToneComplete?.Invoke();
+        _provider.OnBeforeSilenceEnd += () => OnBeforeSilenceEnd?.Invoke();
+        _provider.OnBecomeIdle += () => OnBecomeIdle?.Invoke();
+    }
+
+    public int Render(float[] buffer) => _provider.Read(buffer, 0, buffer.Length);
+
+    public void SetFrequency(int frequencyHz) => _provider.SetFrequency(frequencyHz);
+    public void SetVolume(int volumePercent) => _provider.SetVolume(Math.Clamp(volumePercent / 100.0f, 0.0f, 1.0f));
+    public void SetWpm(int wpm) => _provider.SetWpm(wpm);
+    public void Start() => _provider.StartIndefiniteTone();
+    public void Stop() => _provider.Stop();
+    public void StartTone(int durationMs) => _provider.StartTone(durationMs);
+    public void StartSilenceThenTone(int silenceMs, int toneMs) => _provider.StartSilenceThenTone(silenceMs, toneMs);
+    public void QueueSilence(int silenceMs, int? followingToneMs = null) => _provider.QueueSilence(silenceMs, followingToneMs);
+    public void Dispose() { }
+}
@@ -0,0 +1,107 @@
+using BenchmarkDotNet.Attributes;
+using NetKeyer.Audio;
+
+namespace NetKeyer.Tools.KeyingBenchmarks;
+
+public enum PlaybackPhase
+{
+    Silent,
+    TimedSilence,
+    RampUp,
+    Sustain,
+    RampDown
+}
+
+/// <summary>
+/// The audio callback: one <see cref="SidetoneProvider.Read"/> per buffer size, starting in
+/// each playback state. RampUp and RampDown restart the ramp before every read, so those
+/// include the Start/Stop call that caused it.
+/// </summary>
+[MemoryDiagnoser]
+public class SidetoneProviderBenchmarks
+{
+    // Long enough that re-queueing it is rare; milliseconds times the sample rate must fit an int
+    private const int LONG_SILENCE_MS = 10 * 1000;
+
+    private SidetoneProvider _provider;
+    private float[] _buffer;
+    private bool _silenceEnded;
+
+    [Params(64, 256, 1024)]
+    public int Frames { get; set; }
+
+    [ParamsAllValues]
+    public PlaybackPhase Phase { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        _provider = new SidetoneProvider();
+        _provider.SetWpm(25);
+        _provider.SetFrequency(600);
+        _buffer = new float[Frames];
+        _provider.OnSilenceComplete += () => _silenceEnded = true;
+
+        switch (Phase)
+        {
+            case PlaybackPhase.TimedSilence:
+                _provider.QueueSilence(LONG_SILENCE_MS);
+                break;
+            case PlaybackPhase.Sustain:
+                // Render through the ramp-up; an indefinite tone then sustains forever
+                _provider.StartIndefiniteTone();
+                _provider.Read(new float[4800], 0, 4800);
+                break;
+        }
+    }
+
+    [Benchmark]
+    public int Read()
+    {
+        switch (Phase)
+        {
+            case PlaybackPhase.TimedSilence:
+                if (_silenceEnded)
+                {
+                    _silenceEnded = false;
+                    _provider.QueueSilence(LONG_SILENCE_MS);
+                }
+                break;
+            case PlaybackPhase.RampUp:
+                _provider.Stop();
+                _provider.StartIndefiniteTone();
+                break;
+            case PlaybackPhase.RampDown:
+                _provider.StartIndefiniteTone();
+                _provider.Stop();
+                break;
+        }
+        return _provider.Read(_buffer, 0, Frames);
+    }
+}
+
+/// <summary>
+/// Regenerating the sine and ramp patches, which every pitch, volume or speed change does
+/// under the audio lock. Ramps are 5 ms up to 24 WPM and a tenth of a dit above.
+/// </summary>
+[MemoryDiagnoser]
+public class SidetonePatchBenchmarks
+{
+    private SidetoneProvider _provider;
+
+    [Params(20, 40)]
+    public int Wpm { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        _provider = new SidetoneProvider();
+        _provider.SetWpm(Wpm);
+    }
+
+    [Benchmark]
+    public void RegeneratePatches()
+    {
+        _provider.SetFrequency(600);
+    }
+}
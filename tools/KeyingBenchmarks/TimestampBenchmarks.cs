@@ -0,0 +1,30 @@
+using BenchmarkDotNet.Attributes;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Tools.KeyingBenchmarks;
+
+/// <summary>
+/// Stamping a radio key command: reading the clock and converting to the radio's 16-bit
+/// millisecond domain, with and without formatting it as the command's hex text.
+/// </summary>
+[MemoryDiagnoser]
+public class TimestampBenchmarks
+{
+    [Benchmark(Baseline = true)]
+    public long Now()
+    {
+        return Timebase.Now;
+    }
+
+    [Benchmark]
+    public ushort ToRadioTimestamp()
+    {
+        return Timebase.ToRadioTimestamp(Timebase.Now);
+    }
+
+    [Benchmark]
+    public string FormatRadioTimestamp()
+    {
+        return Timebase.FormatRadioTimestamp(Timebase.Now);
+    }
+}
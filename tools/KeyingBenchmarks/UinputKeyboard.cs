@@ -0,0 +1,158 @@
+using System;
+using System.IO;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading;
+using NetKeyer.Evdev;
+
+namespace NetKeyer.Tools.KeyingBenchmarks;
+
+/// <summary>
+/// A virtual keyboard created through /dev/uinput, so the evdev input can be driven by real
+/// kernel input events without an adapter plugged in. Linux only, and needs write access to
+/// /dev/uinput (root, or a udev rule for the uinput group).
+/// </summary>
+public sealed unsafe partial class UinputKeyboard : IDisposable
+{
+    private const string UINPUT_PATH = "/dev/uinput";
+    private const int DEVICE_APPEAR_TIMEOUT_MS = 2000;
+
+    private const int O_WRONLY = 0x0001;
+    private const int O_NONBLOCK = 0x0800;
+    private const int O_CLOEXEC = 0x80000;
+
+    private const ushort EV_SYN = 0x00;
+    private const ushort EV_KEY = 0x01;
+    private const ushort SYN_REPORT = 0;
+    private const ushort BUS_VIRTUAL = 0x06;
+
+    // _IOW('U', 100, int), _IOW('U', 101, int), _IOW('U', 3, struct uinput_setup), _IO('U', 1), _IO('U', 2)
+    private const uint UI_SET_EVBIT = 0x40045564;
+    private const uint UI_SET_KEYBIT = 0x40045565;
+    private const uint UI_DEV_SETUP = 0x405C5503;
+    private const uint UI_DEV_CREATE = 0x5501;
+    private const uint UI_DEV_DESTROY = 0x5502;
+
+    [StructLayout(LayoutKind.Sequential)]
+    private struct UinputSetup
+    {
+        public ushort BusType;
+        public ushort Vendor;
+        public ushort Product;
+        public ushort Version;
+        public fixed byte Name[80];
+        public uint FfEffectsMax;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    private struct InputEvent
+    {
+        public nint Seconds;
+        public nint Microseconds;
+        public ushort Type;
+        public ushort Code;
+        public int Value;
+    }
+
+    private readonly int _fd;
+
+    private UinputKeyboard(int fd, string deviceName)
+    {
+        _fd = fd;
+        DeviceName = deviceName;
+    }
+
+    /// <summary>
+    /// The device as <see cref="EvdevPaddleInput.GetAvailableDevices"/> lists it.
+    /// </summary>
+    public string DeviceName { get; }
+
+    /// <summary>
+    /// Creates a keyboard named <paramref name="name"/> with the given key codes and waits
+    /// for its event node to appear. Returns null with the reason if that isn't possible here.
+    /// </summary>
+    public static UinputKeyboard TryCreate(string name, ushort[] keyCodes, out string reason)
+    {
+        reason = null;
+        if (!OperatingSystem.IsLinux())
+        {
+            reason = "not Linux";
+            return null;
+        }
+        if (!File.Exists(UINPUT_PATH))
+        {
+            reason = $"{UINPUT_PATH} not present";
+            return null;
+        }
+
+        int fd = open(UINPUT_PATH, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+        {
+            reason = $"{UINPUT_PATH} could not be opened (errno {Marshal.GetLastPInvokeError()})";
+            return null;
+        }
+
+        var setup = new UinputSetup { BusType = BUS_VIRTUAL, Vendor = 0x1209, Product = 0x0001, Version = 1 };
+        var nameBytes = Encoding.ASCII.GetBytes(name);
+        for (int i = 0; i < nameBytes.Length && i < 79; i++)
+            setup.Name[i] = nameBytes[i];
+
+        bool created = ioctl(fd, UI_SET_EVBIT, EV_KEY) == 0;
+        foreach (var code in keyCodes)
+            created &= ioctl(fd, UI_SET_KEYBIT, code) == 0;
+        created = created && ioctl(fd, UI_DEV_SETUP, (nint)(&setup)) == 0 && ioctl(fd, UI_DEV_CREATE, 0) == 0;
+        if (!created)
+        {
+            reason = $"uinput device could not be created (errno {Marshal.GetLastPInvokeError()})";
+            close(fd);
+            return null;
+        }
+
+        // udev creates the event node asynchronously
+        long deadline = Environment.TickCount64 + DEVICE_APPEAR_TIMEOUT_MS;
+        while (Environment.TickCount64 < deadline)
+        {
+            foreach (var device in EvdevPaddleInput.GetAvailableDevices())
+            {
+                if (device.StartsWith(name + " (event", StringComparison.Ordinal))
+                    return new UinputKeyboard(fd, device);
+            }
+            Thread.Sleep(10);
+        }
+
+        reason = "uinput device created but no event node appeared";
+        ioctl(fd, UI_DEV_DESTROY, 0);
+        close(fd);
+        return null;
+    }
+
+    /// <summary>
+    /// Presses (<paramref name="down"/>) or releases a key, followed by a sync report.
+    /// </summary>
+    public bool Send(ushort keyCode, bool down)
+    {
+        var events = stackalloc InputEvent[2];
+        events[0] = new InputEvent { Type = EV_KEY, Code = keyCode, Value = down ? 1 : 0 };
+        events[1] = new InputEvent { Type = EV_SYN, Code = SYN_REPORT, Value = 0 };
+        nint size = 2 * sizeof(InputEvent);
+        return write(_fd, events, size) == size;
+    }
+
+    public void Dispose()
+    {
+        ioctl(_fd, UI_DEV_DESTROY, 0);
+        close(_fd);
+    }
+
+    [LibraryImport("libc", SetLastError = true, StringMarshalling = StringMarshalling.Utf8)]
+    private static partial int open(string pathname, int flags);
+
+    [LibraryImport("libc", SetLastError = true)]
+    private static partial int close(int fd);
+
+    [LibraryImport("libc", SetLastError = true)]
+    private static partial nint write(int fd, void* buf, nint count);
+
+    [LibraryImport("libc", SetLastError = true)]
+    private static partial int ioctl(int fd, nuint request, nint arg);
+}
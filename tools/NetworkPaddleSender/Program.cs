@@ -0,0 +1,265 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+using NetKeyer.Helpers;
+using NetKeyer.Models;
+using NetKeyer.Network;
+
+namespace NetKeyer.Tools.NetworkPaddleSender;
+
+/// <summary>
+/// Sends straight key "PARIS " to a NetKeyer network input over a simulated bad link, to
+/// exercise the receiver's jitter buffer, loss recovery and reordering without a real one.
+///
+///   NetworkPaddleSender [--target host:port] [--bind address] [--wpm n] [--seconds n]
+///                       [--jitter-ms n] [--loss percent] [--reorder percent] [--seed n]
+///
+/// Datagrams are built as <see cref="UdpPaddleSender"/> builds them, heartbeats included, and
+/// stamped when they are built. Each is then dropped with the loss probability, delayed by up
+/// to the jitter, or held back and sent after the next one with the reorder probability. The
+/// receiver's link statistics (operating page, or the <c>network</c> debug category) should
+/// account for what this reports. <c>--bind</c> sends from a given local address, for checking
+/// the receiver's allowed sender list (on Linux any 127.x.x.x address works on loopback).
+/// </summary>
+public static class Program
+{
+    private const string PARIS = ".--. .- .-. .. ...";
+
+    private static Socket _socket;
+    private static Random _random;
+    private static double _lossPercent;
+    private static double _reorderPercent;
+    private static long _jitterTicks;
+
+    // Datagrams waiting for their simulated arrival, and one held back to go after the next
+    private static readonly PriorityQueue<byte[], long> _inFlight = new();
+    private static byte[] _held;
+
+    // Edge state, as UdpPaddleSender keeps it
+    private static uint _sequence;
+    private static byte _bits;
+    private static byte _previousBits;
+    private static long _timeUs;
+    private static long _previousTimeUs;
+
+    private static int _datagrams;
+    private static int _dropped;
+    private static int _reordered;
+    private static int _sent;
+
+    public static int Main(string[] args)
+    {
+        string target = $"127.0.0.1:{NetworkPaddleInput.DEFAULT_PORT}";
+        string bind = null;
+        int wpm = 20;
+        int seconds = 10;
+        int jitterMs = 0;
+        int seed = Environment.TickCount;
+        for (int i = 0; i < args.Length; i++)
+        {
+            string value = i + 1 < args.Length ? args[i + 1] : null;
+            switch (args[i])
+            {
+                case "--target" when value != null:
+                    target = value;
+                    break;
+                case "--bind" when value != null:
+                    bind = value;
+                    break;
+                case "--wpm" when value != null:
+                    wpm = int.Parse(value, CultureInfo.InvariantCulture);
+                    break;
+                case "--seconds" when value != null:
+                    seconds = int.Parse(value, CultureInfo.InvariantCulture);
+                    break;
+                case "--jitter-ms" when value != null:
+                    jitterMs = int.Parse(value, CultureInfo.InvariantCulture);
+                    break;
+                case "--loss" when value != null:
+                    _lossPercent = double.Parse(value, CultureInfo.InvariantCulture);
+                    break;
+                case "--reorder" when value != null:
+                    _reorderPercent = double.Parse(value, CultureInfo.InvariantCulture);
+                    break;
+                case "--seed" when value != null:
+                    seed = int.Parse(value, CultureInfo.InvariantCulture);
+                    break;
+                default:
+                    Console.WriteLine("Usage: NetworkPaddleSender [--target host:port] [--bind address] [--wpm n] [--seconds n]");
+                    Console.WriteLine("                           [--jitter-ms n] [--loss percent] [--reorder percent] [--seed n]");
+                    return 2;
+            }
+            i++;
+        }
+
+        int colon = target.LastIndexOf(':');
+        if (colon <= 0 || !int.TryParse(target.AsSpan(colon + 1), out int port))
+        {
+            Console.WriteLine($"Invalid target '{target}' (expected host:port)");
+            return 2;
+        }
+
+        string host = target[..colon].Trim('[', ']');
+        if (!IPAddress.TryParse(host, out var address))
+            address = Dns.GetHostAddresses(host)[0];
+
+        _random = new Random(seed);
+        _jitterTicks = Timebase.FromMilliseconds(jitterMs);
+        _socket = new Socket(address.AddressFamily, SocketType.Dgram, ProtocolType.Udp);
+        if (bind != null)
+            _socket.Bind(new IPEndPoint(IPAddress.Parse(bind), 0));
+        _socket.Connect(new IPEndPoint(address, port));
+
+        Console.WriteLine($"Straight key \"PARIS \" at {wpm} WPM for {seconds} s to {target} from {_socket.LocalEndPoint}");
+        Console.WriteLine($"Jitter up to {jitterMs} ms, {_lossPercent:F1}% loss, {_reorderPercent:F1}% reordered (seed {seed})");
+
+        Run(BuildParisSchedule(wpm, seconds));
+
+        Console.WriteLine();
+        Console.WriteLine($"Edges:     {_sequence}");
+        Console.WriteLine($"Datagrams: {_datagrams} built, {_sent} sent, {_dropped} dropped, {_reordered} sent after the next one");
+        _socket.Dispose();
+        return 0;
+    }
+
+    private static void Run(List<(long Offset, bool Down)> schedule)
+    {
+        long heartbeatTicks = Timebase.FromMilliseconds(UdpPaddleSender.HEARTBEAT_INTERVAL_MS);
+        long origin = Timebase.Now;
+        long nextHeartbeat = origin + heartbeatTicks;
+        _timeUs = _previousTimeUs = Timebase.ToMicroseconds(origin);
+        int next = 0;
+
+        while (next < schedule.Count || _inFlight.Count > 0 || _held != null)
+        {
+            long nextEdge = next < schedule.Count ? origin + schedule[next].Offset : long.MaxValue;
+            long nextArrival = _inFlight.TryPeek(out _, out long due) ? due : long.MaxValue;
+            long deadline = Math.Min(Math.Min(nextEdge, nextArrival), next < schedule.Count ? nextHeartbeat : long.MaxValue);
+            if (deadline == long.MaxValue)
+            {
+                // Nothing left to follow a held datagram: send it last
+                Send(_held);
+                _held = null;
+                break;
+            }
+
+            WaitUntil(deadline);
+            long now = Timebase.Now;
+
+            while (_inFlight.TryPeek(out var datagram, out due) && due <= now)
+            {
+                _inFlight.Dequeue();
+                Send(datagram);
+            }
+
+            if (now >= nextEdge)
+            {
+                var (_, down) = schedule[next++];
+                _previousBits = _bits;
+                _previousTimeUs = _timeUs;
+                _bits = down ? PaddleState.StraightKeyBit : (byte)0;
+                _timeUs = Timebase.ToMicroseconds(now);
+                _sequence++;
+                Transmit(0, now);
+            }
+            else if (now >= nextHeartbeat && next < schedule.Count)
+            {
+                Transmit(PaddlePacket.FlagHeartbeat, now);
+                nextHeartbeat += heartbeatTicks;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Builds a datagram for the current edge and puts it through the simulated link.
+    /// </summary>
+    private static void Transmit(byte flags, long now)
+    {
+        var datagram = new byte[PaddlePacket.Size];
+        new PaddlePacket(flags, _bits, _previousBits, _sequence, _timeUs, _previousTimeUs, Timebase.ToMicroseconds(now))
+            .Write(datagram);
+        _datagrams++;
+
+        if (_random.NextDouble() * 100 < _lossPercent)
+        {
+            _dropped++;
+            return;
+        }
+
+        long due = now + (long)(_random.NextDouble() * _jitterTicks);
+        if (_held != null)
+        {
+            // The held datagram goes straight after this one
+            _inFlight.Enqueue(datagram, due);
+            _inFlight.Enqueue(_held, due);
+            _held = null;
+        }
+        else if (_random.NextDouble() * 100 < _reorderPercent)
+        {
+            _held = datagram;
+            _reordered++;
+        }
+        else
+        {
+            _inFlight.Enqueue(datagram, due);
+        }
+    }
+
+    private static void Send(byte[] datagram)
+    {
+        try
+        {
+            _socket.Send(datagram, SocketFlags.None);
+            _sent++;
+        }
+        catch (SocketException ex)
+        {
+            // Receiver not listening (ICMP port unreachable): count it as lost and carry on
+            Console.WriteLine($"Send failed: {ex.SocketErrorCode}");
+        }
+    }
+
+    /// <summary>
+    /// Straight key edges for "PARIS " repeated for the requested duration, as offsets from
+    /// the start in Timebase ticks.
+    /// </summary>
+    private static List<(long Offset, bool Down)> BuildParisSchedule(int wpm, int seconds)
+    {
+        long unit = Timebase.FromMicroseconds(1_200_000 / wpm);
+        var schedule = new List<(long, bool)>();
+        long t = 0;
+        long end = Timebase.FromMilliseconds(seconds * 1000L);
+
+        while (t < end)
+        {
+            foreach (char c in PARIS)
+            {
+                if (c == ' ')
+                {
+                    t += 2 * unit; // 3-unit letter space, 1 already counted after the element
+                    continue;
+                }
+
+                schedule.Add((t, true));
+                t += (c == '.' ? 1 : 3) * unit;
+                schedule.Add((t, false));
+                t += unit;
+            }
+            t += 6 * unit; // 7-unit word space
+        }
+
+        return schedule;
+    }
+
+    private static void WaitUntil(long deadline)
+    {
+        long sleepMs = Timebase.ToMillisecondsLong(deadline - Timebase.Now) - 1;
+        if (sleepMs > 0)
+            Thread.Sleep((int)sleepMs);
+        while (Timebase.Now < deadline)
+            Thread.SpinWait(20);
+    }
+}
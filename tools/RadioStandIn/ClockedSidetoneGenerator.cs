@@ -0,0 +1,130 @@
+using System;
+using System.Threading;
+using NetKeyer.Audio;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Tools.RadioStandIn;
+
+/// <summary>
+/// Sidetone generator without an audio device: a thread pulls <see cref="SidetoneProvider"/>
+/// in fixed-size buffers on a <see cref="Timebase"/> schedule, the way the PortAudio callback
+/// does, so the iambic keyer runs on the same sample-accurate timing it gets in the app.
+/// </summary>
+public class ClockedSidetoneGenerator : ISidetoneGenerator
+{
+    private const int SAMPLE_RATE = 48000;
+    private const int BUFFER_SAMPLES = 256; // same period as SidetoneGenerator
+
+    private readonly SidetoneProvider _sidetoneProvider;
+    private readonly float[] _readBuffer = new float[BUFFER_SAMPLES];
+    private readonly object _lock = new object();
+    private readonly Thread _renderThread;
+    private volatile bool _running = true;
+
+    public event Action OnSilenceComplete;
+    public event Action OnToneStart;
+    public event Action OnToneComplete;
+    public event Action OnBeforeSilenceEnd;
+    public event Action OnBecomeIdle;
+
+    public ClockedSidetoneGenerator()
+    {
+        _sidetoneProvider = new SidetoneProvider();
+        _sidetoneProvider.OnSilenceComplete += () => OnSilenceComplete?.Invoke();
+        _sidetoneProvider.OnToneStart += () => OnToneStart?.Invoke();
+        _sidetoneProvider.OnToneComplete += () => OnToneComplete?.Invoke();
+        _sidetoneProvider.OnBeforeSilenceEnd += () => OnBeforeSilenceEnd?.Invoke();
+        _sidetoneProvider.OnBecomeIdle += () => OnBecomeIdle?.Invoke();
+
+        _renderThread = new Thread(RenderLoop)
+        {
+            Name = "clocked sidetone",
+            IsBackground = true,
+            Priority = ThreadPriority.Highest
+        };
+        _renderThread.Start();
+    }
+
+    /// <summary>
+    /// Number of buffers rendered later than one buffer period after their deadline.
+    /// </summary>
+    public long LateBuffers { get; private set; }
+
+    private void RenderLoop()
+    {
+        long period = Timebase.FramesToTicks(BUFFER_SAMPLES, SAMPLE_RATE);
+        long deadline = Timebase.Now;
+
+        while (_running)
+        {
+            lock (_lock)
+            {
+                _sidetoneProvider.Read(_readBuffer, 0, BUFFER_SAMPLES);
+            }
+
+            deadline += period;
+            long now = Timebase.Now;
+            if (now - deadline > period)
+            {
+                // Fell behind (GC, scheduler); resynchronize rather than burst to catch up
+                LateBuffers++;
+                deadline = now;
+                continue;
+            }
+
+            // Sleep most of the way, then spin for the last millisecond
+            long sleepMs = Timebase.ToMillisecondsLong(deadline - now) - 1;
+            if (sleepMs > 0)
+                Thread.Sleep((int)sleepMs);
+            while (Timebase.Now < deadline)
+                Thread.SpinWait(20);
+        }
+    }
+
+    public void SetFrequency(int frequencyHz)
+    {
+        _sidetoneProvider.SetFrequency(frequencyHz);
+    }
+
+    public void SetVolume(int volumePercent)
+    {
+        _sidetoneProvider.SetVolume(Math.Clamp(volumePercent / 100.0f, 0.0f, 1.0f));
+    }
+
+    public void SetWpm(int wpm)
+    {
+        _sidetoneProvider.SetWpm(wpm);
+    }
+
+    public void Start()
+    {
+        _sidetoneProvider.StartIndefiniteTone();
+    }
+
+    public void Stop()
+    {
+        _sidetoneProvider.Stop();
+    }
+
+    public void StartTone(int durationMs)
+    {
+        _sidetoneProvider.StartTone(durationMs);
+    }
+
+    public void StartSilenceThenTone(int silenceMs, int toneMs)
+    {
+        _sidetoneProvider.StartSilenceThenTone(silenceMs, toneMs);
+    }
+
+    public void QueueSilence(int silenceMs, int? followingToneMs = null)
+    {
+        _sidetoneProvider.QueueSilence(silenceMs, followingToneMs);
+    }
+
+    public void Dispose()
+    {
+        _running = false;
+        if (Thread.CurrentThread != _renderThread)
+            _renderThread.Join();
+    }
+}
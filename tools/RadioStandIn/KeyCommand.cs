@@ -0,0 +1,107 @@
+using System;
+using System.Globalization;
+
+namespace NetKeyer.Tools.RadioStandIn;
+
+/// <summary>
+/// One <c>cw key</c> command as received by the stand-in radio.
+/// </summary>
+public readonly struct KeyCommand
+{
+    /// <summary>
+    /// <see cref="NetKeyer.Helpers.Timebase"/> ticks when the command line was read off the socket.
+    /// </summary>
+    public long ArrivalTicks { get; init; }
+
+    public bool Down { get; init; }
+
+    /// <summary>
+    /// The client's 16-bit millisecond <c>time=</c> stamp, or null if the command had none.
+    /// </summary>
+    public ushort? RadioTime { get; init; }
+
+    /// <summary>
+    /// The client's <c>index=</c> sequence number, or -1 if the command had none.
+    /// </summary>
+    public int Index { get; init; }
+
+    public uint ClientHandle { get; init; }
+
+    /// <summary>
+    /// "tcp" or "udp" (the netcw VITA stream).
+    /// </summary>
+    public string Transport { get; init; }
+
+    /// <summary>
+    /// True if this index was already received on the other transport; the radio acts on the
+    /// first copy only.
+    /// </summary>
+    public bool Duplicate { get; init; }
+
+    /// <summary>
+    /// Parses "cw key 1 time=0x1A2B index=12 client_handle=0x40000001" (and the "cw key immediate"
+    /// form). Returns false for anything else.
+    /// </summary>
+    public static bool TryParse(string command, long arrivalTicks, string transport, out KeyCommand key)
+    {
+        key = default;
+
+        var parts = command.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+        if (parts.Length < 3 || parts[0] != "cw" || parts[1] != "key")
+            return false;
+
+        int i = 2;
+        if (parts[i] == "immediate")
+        {
+            if (parts.Length < 4)
+                return false;
+            i++;
+        }
+
+        bool down;
+        if (parts[i] == "1")
+            down = true;
+        else if (parts[i] == "0")
+            down = false;
+        else
+            return false;
+
+        ushort? radioTime = null;
+        int index = -1;
+        uint clientHandle = 0;
+        for (i++; i < parts.Length; i++)
+        {
+            var part = parts[i];
+            if (part.StartsWith("time=", StringComparison.Ordinal) && TryParseHex(part.AsSpan(5), out uint time))
+                radioTime = (ushort)time;
+            else if (part.StartsWith("index=", StringComparison.Ordinal))
+                int.TryParse(part.AsSpan(6), NumberStyles.Integer, CultureInfo.InvariantCulture, out index);
+            else if (part.StartsWith("client_handle=", StringComparison.Ordinal))
+                TryParseHex(part.AsSpan(14), out clientHandle);
+        }
+
+        key = new KeyCommand
+        {
+            ArrivalTicks = arrivalTicks,
+            Down = down,
+            RadioTime = radioTime,
+            Index = index,
+            ClientHandle = clientHandle,
+            Transport = transport
+        };
+        return true;
+    }
+
+    internal static bool TryParseHex(ReadOnlySpan<char> text, out uint value)
+    {
+        if (text.StartsWith("0x", StringComparison.OrdinalIgnoreCase))
+            text = text[2..];
+        return uint.TryParse(text, NumberStyles.HexNumber, CultureInfo.InvariantCulture, out value);
+    }
+
+    public override string ToString()
+    {
+        var time = RadioTime.HasValue ? $"0x{RadioTime.Value:X4}" : "-";
+        return $"cw key {(Down ? 1 : 0)} time={time} index={Index} handle=0x{ClientHandle:X8} via {Transport}{(Duplicate ? " (dup)" : "")}";
+    }
+}
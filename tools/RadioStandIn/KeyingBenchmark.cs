@@ -0,0 +1,763 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Net;
+using System.Security.Cryptography.X509Certificates;
+using System.Threading;
+using Avalonia.Threading;
+using Flex.Smoothlake.FlexLib;
+using NetKeyer.Helpers;
+using NetKeyer.Models;
+using NetKeyer.Services;
+
+namespace NetKeyer.Tools.RadioStandIn;
+
+public class BenchmarkOptions
+{
+    public int Wpm { get; set; } = 60;
+    public int Seconds { get; set; } = 10;
+
+    /// <summary>
+    /// Also connect through a stand-in SmartLink server. Trusts a temporary certificate in
+    /// the current user's root store while it runs.
+    /// </summary>
+    public bool Wan { get; set; }
+
+    public StandInOptions Radio { get; set; } = new StandInOptions();
+}
+
+/// <summary>
+/// Runs NetKeyer's radio path end to end against an in-process <see cref="StandInRadio"/>:
+/// direct connection to a remembered address, FlexLib discovery, Connect and station
+/// binding, the TransmitSliceMonitor and
+/// RadioSettingsSynchronizer round trips, then straight-key and iambic keying through
+/// KeyingController. Key latency is measured from the paddle edge's timestamp to the
+/// moment the first copy of the <c>cw key</c> command is read off the socket. With
+/// <see cref="BenchmarkOptions.Wan"/> it then connects again through a
+/// <see cref="StandInWanServer"/>, negotiating a hole punch and then using forwarded ports.
+/// </summary>
+public class KeyingBenchmark
+{
+    private const int DISCOVERY_TIMEOUT_MS = 10000;
+    private const int STATUS_TIMEOUT_MS = 5000;
+    private const int SETTLE_MS = 300;
+    private const int WAN_KEY_EDGES = 20;
+
+    private readonly BenchmarkOptions _options;
+    private readonly List<KeyCommand> _keys = new List<KeyCommand>();
+    private StandInRadio _standIn;
+    private List<Radio> _wanRadios;
+    private bool _failed;
+
+    public KeyingBenchmark(BenchmarkOptions options)
+    {
+        _options = options;
+    }
+
+    public int Run()
+    {
+        // RadioSettingsSynchronizer posts to the UI dispatcher; this thread becomes the UI
+        // thread and pumps it whenever it waits
+        _ = Dispatcher.UIThread;
+
+        _options.Radio.Verbose = false;
+        if (_options.Wan)
+            _options.Radio.WanCertificate = StandInWanServer.CreateCertificate();
+        _standIn = new StandInRadio(_options.Radio);
+        _standIn.KeyCommandReceived += key =>
+        {
+            if (!key.Duplicate)
+                lock (_keys) _keys.Add(key);
+        };
+        _standIn.Start();
+
+        Radio radio = null;
+        try
+        {
+            radio = ConnectAndBind();
+            if (radio == null)
+                return 1;
+
+            uint handle = _standIn.StationHandle;
+            var monitor = MeasureTransmitSliceMonitor(radio, handle);
+            var synchronizer = MeasureSettingsSynchronizer(radio);
+
+            var generator = new ClockedSidetoneGenerator();
+            var controller = new KeyingController(generator);
+            controller.Initialize(handle, () => Timebase.ToRadioTimestamp(Timebase.Now),
+                (state, timestamp, clientHandle) => radio.CWKey(state, Timebase.FormatRadioTimestamp(timestamp), clientHandle));
+            controller.SetRadio(new FlexKeyingRadio(radio));
+            synchronizer.SetKeyStateSource(() => controller.IsRadioKeyDown);
+            synchronizer.SetKeyerParameterSink(update => controller.UpdateParameters(update));
+            controller.SetTransmitMode(monitor.IsTransmitModeCW);
+            controller.SetSpeed(_options.Wpm);
+
+            MeasureRadioSpeedToKeyer(controller, synchronizer);
+            MeasureStraightKey(controller);
+            MeasureIambic(controller);
+
+            Console.WriteLine();
+            Console.WriteLine($"Key commands received: {_standIn.KeyCommands} ({_standIn.DuplicateKeyCommands} duplicate copies on the second transport)");
+            Console.WriteLine($"Dropped input edges: {controller.DroppedEdges}, late sidetone buffers: {generator.LateBuffers}");
+
+            controller.Stop();
+            controller.Dispose();
+            generator.Dispose();
+            monitor.Detach();
+            synchronizer.Dispose();
+
+            if (_options.Wan)
+            {
+                radio.Disconnect();
+                radio = null;
+                MeasureSmartLink();
+            }
+        }
+        finally
+        {
+            radio?.Disconnect();
+            API.CloseSession();
+            _standIn.Stop();
+        }
+
+        return _failed ? 1 : 0;
+    }
+
+    // ---- phases ----
+
+    private Radio ConnectAndBind()
+    {
+        Console.WriteLine($"Benchmark at {_options.Wpm} WPM, {_options.Seconds} s per keying phase");
+        Console.WriteLine();
+
+        API.ProgramName = "NetKeyer-bench";
+        if (!MeasureDirectConnect())
+            return null;
+
+        long start = Timebase.Now;
+        API.Init();
+
+        Radio radio = null;
+        if (!PumpUntil(() => (radio = FindStandIn()) != null, DISCOVERY_TIMEOUT_MS))
+            return Fail("stand-in radio was not discovered (is UDP 4992 in use?)");
+        PrintValue("discovery", Timebase.ElapsedMilliseconds(start));
+
+        start = Timebase.Now;
+        if (!radio.Connect())
+            return Fail("Radio.Connect() failed");
+        PrintValue("connect", Timebase.ElapsedMilliseconds(start));
+
+        GUIClient station = RadioConnector.WaitForGuiClient(radio, c => c.ClientHandle == _standIn.StationHandle, STATUS_TIMEOUT_MS);
+        if (station == null)
+            return Fail("station client_id never arrived");
+        PrintValue("connect to station client_id", Timebase.ElapsedMilliseconds(start));
+
+        radio.BindGUIClient(station.ClientID);
+
+        uint handle = _standIn.StationHandle;
+        if (!PumpUntil(() => radio.SliceList.Any(s => s.IsTransmitSlice && s.ClientHandle == handle), STATUS_TIMEOUT_MS))
+            return Fail("transmit slice status never arrived");
+        PrintValue("connect to transmit slice", Timebase.ElapsedMilliseconds(start));
+
+        return radio;
+    }
+
+    /// <summary>
+    /// The startup fast path: connect to the radio's remembered address and find the saved
+    /// station by name, without waiting for a discovery broadcast.
+    /// </summary>
+    private bool MeasureDirectConnect()
+    {
+        var options = _options.Radio;
+        long start = Timebase.Now;
+        var radio = RadioConnector.CreateRememberedRadio(options.Model, options.Serial, options.Nickname,
+            IPAddress.Loopback.ToString(), options.Version);
+        if (radio == null)
+        {
+            Fail("could not create a radio for the remembered address");
+            return false;
+        }
+
+        if (!radio.Connect())
+        {
+            Fail("direct Radio.Connect() failed");
+            return false;
+        }
+
+        var station = RadioConnector.WaitForGuiClient(radio, c => c.Station == options.Station, STATUS_TIMEOUT_MS);
+        radio.Disconnect();
+        if (station == null)
+        {
+            Fail("station client_id never arrived on the direct connection");
+            return false;
+        }
+
+        PrintValue("direct connect to station client_id", Timebase.ElapsedMilliseconds(start));
+        return true;
+    }
+
+    private TransmitSliceMonitor MeasureTransmitSliceMonitor(Radio radio, uint handle)
+    {
+        var monitor = new TransmitSliceMonitor();
+        monitor.AttachToRadio(radio, handle);
+        if (!monitor.IsTransmitModeCW)
+            Fail("TransmitSliceMonitor did not see the CW transmit slice");
+
+        long changedAt = 0;
+        monitor.TransmitModeChanged += (_, _) => Interlocked.Exchange(ref changedAt, Timebase.Now);
+
+        foreach (var mode in new[] { "USB", "CW" })
+        {
+            Interlocked.Exchange(ref changedAt, 0);
+            long start = Timebase.Now;
+            _standIn.SetSliceMode(mode);
+            if (PumpUntil(() => Interlocked.Read(ref changedAt) != 0, STATUS_TIMEOUT_MS))
+                PrintValue($"slice mode -> {mode} to TransmitModeChanged", Timebase.ToMilliseconds(changedAt - start));
+            else
+                Fail($"TransmitModeChanged not raised for {mode}");
+        }
+
+        return monitor;
+    }
+
+    private RadioSettingsSynchronizer MeasureSettingsSynchronizer(Radio radio)
+    {
+        var synchronizer = new RadioSettingsSynchronizer();
+        synchronizer.AttachToRadio(radio);
+
+        long changedAt = 0;
+        synchronizer.SettingChangedFromRadio += (_, e) =>
+        {
+            if (e.PropertyName == "CWSpeed")
+                Interlocked.Exchange(ref changedAt, Timebase.Now);
+        };
+
+        long start = Timebase.Now;
+        _standIn.SetCwSpeed(_options.Wpm);
+        if (PumpUntil(() => Interlocked.Read(ref changedAt) != 0, STATUS_TIMEOUT_MS))
+            PrintValue("radio speed status to UI thread", Timebase.ToMilliseconds(changedAt - start));
+        else
+            Fail("SettingChangedFromRadio not raised for CWSpeed");
+
+        long commandAt = 0;
+        Action<string, long> onCommand = (command, arrival) =>
+        {
+            if (command.StartsWith("cw pitch", StringComparison.Ordinal))
+                Interlocked.Exchange(ref commandAt, arrival);
+        };
+        _standIn.CommandReceived += onCommand;
+
+        start = Timebase.Now;
+        synchronizer.SyncCwPitchToRadio(radio.CWPitch + 10);
+        if (PumpUntil(() => Interlocked.Read(ref commandAt) != 0, STATUS_TIMEOUT_MS))
+            PrintValue("pitch change to command on the wire", Timebase.ToMilliseconds(commandAt - start));
+        else
+            Fail("cw pitch command never arrived");
+
+        _standIn.CommandReceived -= onCommand;
+
+        MeasureSettingsDrag(radio, synchronizer);
+        return synchronizer;
+    }
+
+    /// <summary>
+    /// A pitch slider dragged at 60 Hz, and a burst of speed changes from the radio side.
+    /// </summary>
+    private void MeasureSettingsDrag(Radio radio, RadioSettingsSynchronizer synchronizer)
+    {
+        const int ticks = 60;
+        int commands = 0;
+        long lastCommandAt = 0;
+        string finalCommand = null;
+        int pitch = radio.CWPitch;
+        string expectedFinal = $"cw pitch {pitch + ticks}";
+        Action<string, long> onCommand = (command, arrival) =>
+        {
+            if (!command.StartsWith("cw pitch", StringComparison.Ordinal))
+                return;
+            Interlocked.Increment(ref commands);
+            Interlocked.Exchange(ref lastCommandAt, arrival);
+            Volatile.Write(ref finalCommand, command);
+        };
+        _standIn.CommandReceived += onCommand;
+
+        long suppressedBefore = synchronizer.SuppressedCommands;
+        long lastChange = 0;
+        for (int i = 1; i <= ticks; i++)
+        {
+            lastChange = Timebase.Now;
+            synchronizer.SyncCwPitchToRadio(pitch + i);
+            Dispatcher.UIThread.RunJobs();
+            Thread.Sleep(16);
+        }
+
+        if (!PumpUntil(() => Volatile.Read(ref finalCommand) == expectedFinal, STATUS_TIMEOUT_MS))
+            Fail($"final pitch never reached the radio (last: {finalCommand})");
+        _standIn.CommandReceived -= onCommand;
+
+        Console.WriteLine($"  pitch drag, {ticks} changes at 60 Hz: {commands} commands sent, {synchronizer.SuppressedCommands - suppressedBefore} suppressed");
+        PrintValue("last pitch change to command on wire", Timebase.ToMilliseconds(Interlocked.Read(ref lastCommandAt) - lastChange));
+
+        long notificationsBefore = synchronizer.InboundNotifications;
+        long batchesBefore = synchronizer.InboundBatches;
+        int events = 0;
+        EventHandler<RadioSettingChangedEventArgs> onChanged = (_, _) => events++;
+        synchronizer.SettingChangedFromRadio += onChanged;
+        for (int i = 0; i < 20; i++)
+            _standIn.SetCwSpeed(20 + i);
+        PumpUntil(() => radio.CWSpeed == 39, STATUS_TIMEOUT_MS);
+        Thread.Sleep(50);
+        Dispatcher.UIThread.RunJobs();
+        synchronizer.SettingChangedFromRadio -= onChanged;
+        _standIn.SetCwSpeed(_options.Wpm);
+
+        Console.WriteLine($"  radio speed burst: {synchronizer.InboundNotifications - notificationsBefore} notifications, " +
+                          $"{synchronizer.InboundBatches - batchesBefore} UI batches, {events} UI events");
+    }
+
+    /// <summary>
+    /// A speed change made on the radio, timed to the keying core applying it and to the UI
+    /// thread hearing of it. The UI thread isn't pumped until the core has the new speed, as
+    /// if it were busy.
+    /// </summary>
+    private void MeasureRadioSpeedToKeyer(KeyingController controller, RadioSettingsSynchronizer synchronizer)
+    {
+        int wpm = _options.Wpm > 10 ? _options.Wpm - 5 : _options.Wpm + 5;
+        long changedAt = 0;
+        EventHandler<RadioSettingChangedEventArgs> onChanged = (_, e) =>
+        {
+            if (e.PropertyName == "CWSpeed")
+                Interlocked.Exchange(ref changedAt, Timebase.Now);
+        };
+        synchronizer.SettingChangedFromRadio += onChanged;
+
+        long start = Timebase.Now;
+        _standIn.SetCwSpeed(wpm);
+        long deadline = start + Timebase.FromMilliseconds(STATUS_TIMEOUT_MS);
+        while (controller.AppliedParameters.Wpm != wpm && Timebase.Now < deadline)
+            Thread.Yield();
+        long appliedAt = Timebase.Now;
+
+        if (controller.AppliedParameters.Wpm == wpm)
+            PrintValue("radio speed status to keying core", Timebase.ToMilliseconds(appliedAt - start));
+        else
+            Fail("keying core never applied the radio's speed");
+
+        if (PumpUntil(() => Interlocked.Read(ref changedAt) != 0, STATUS_TIMEOUT_MS))
+            PrintValue("radio speed status to UI thread", Timebase.ToMilliseconds(changedAt - start));
+        synchronizer.SettingChangedFromRadio -= onChanged;
+
+        _standIn.SetCwSpeed(_options.Wpm);
+        if (!PumpUntil(() => controller.AppliedParameters.Wpm == _options.Wpm, STATUS_TIMEOUT_MS))
+            Fail("keying core never returned to the benchmark speed");
+    }
+
+    private void MeasureStraightKey(KeyingController controller)
+    {
+        controller.SetKeyingMode(isIambic: false, isModeB: false);
+        var schedule = BuildParisSchedule(_options.Wpm, _options.Seconds);
+
+        // Leaving iambic mode sends a key-up; let it arrive before counting
+        Thread.Sleep(SETTLE_MS);
+        ClearKeys();
+        controller.Telemetry.Reset();
+
+        // Replay the schedule on absolute deadlines, stamping each edge when it is delivered
+        var edges = new long[schedule.Count];
+        long origin = Timebase.Now + Timebase.FromMilliseconds(50);
+        for (int i = 0; i < schedule.Count; i++)
+        {
+            WaitUntil(origin + schedule[i].Offset);
+            long now = Timebase.Now;
+            edges[i] = now;
+            controller.HandlePaddleStateChange(new PaddleState(schedule[i].Down ? PaddleState.StraightKeyBit : (byte)0, now));
+        }
+        Thread.Sleep(SETTLE_MS);
+
+        var keys = TakeKeys();
+        Console.WriteLine();
+        Console.WriteLine($"Straight key, \"PARIS \" at {_options.Wpm} WPM: {edges.Length} edges, {keys.Count} key commands");
+        if (keys.Count != edges.Length)
+            Fail($"expected one key command per edge, got {keys.Count} for {edges.Length}");
+
+        int count = Math.Min(keys.Count, edges.Length);
+        var latency = new List<double>(count);
+        var spacingError = new List<double>(count);
+        var stampError = new List<double>(count);
+        for (int i = 0; i < count; i++)
+        {
+            latency.Add(Timebase.ToMilliseconds(keys[i].ArrivalTicks - edges[i]));
+            if (i == 0)
+                continue;
+
+            double intended = Timebase.ToMilliseconds(edges[i] - edges[i - 1]);
+            spacingError.Add(Timebase.ToMilliseconds(keys[i].ArrivalTicks - keys[i - 1].ArrivalTicks) - intended);
+            if (keys[i].RadioTime.HasValue && keys[i - 1].RadioTime.HasValue)
+                stampError.Add((ushort)(keys[i].RadioTime.Value - keys[i - 1].RadioTime.Value) - intended);
+        }
+
+        PrintStats("edge to wire latency", latency);
+        PrintStats("element spacing error on wire", spacingError);
+        PrintStats("time= stamp spacing error", stampError);
+        PrintRate(keys);
+        PrintTelemetry(controller.Telemetry);
+    }
+
+    private void MeasureIambic(KeyingController controller)
+    {
+        controller.SetKeyingMode(isIambic: true, isModeB: true);
+        Thread.Sleep(SETTLE_MS);
+        ClearKeys();
+        controller.Telemetry.Reset();
+
+        long squeeze = Timebase.Now;
+        controller.HandlePaddleStateChange(new PaddleState(PaddleState.LeftPaddleBit | PaddleState.RightPaddleBit, squeeze));
+        Thread.Sleep(_options.Seconds * 1000);
+        controller.HandlePaddleStateChange(new PaddleState(0, Timebase.Now));
+        Thread.Sleep(SETTLE_MS);
+        controller.Stop();
+
+        var keys = TakeKeys();
+        Console.WriteLine();
+        Console.WriteLine($"Iambic B squeeze at {_options.Wpm} WPM: {keys.Count} key commands");
+        if (keys.Count == 0)
+        {
+            Fail("iambic keyer sent nothing");
+            return;
+        }
+
+        double unit = 1200.0 / _options.Wpm;
+        var toneError = new List<double>();
+        var periodError = new List<double>();
+        long lastDown = 0;
+        for (int i = 0; i < keys.Count; i++)
+        {
+            if (keys[i].Down)
+            {
+                // Element plus its space: 2 units for a dit, 4 for a dah
+                if (lastDown != 0)
+                    periodError.Add(NearestError(Timebase.ToMilliseconds(keys[i].ArrivalTicks - lastDown), unit, 2, 4));
+                lastDown = keys[i].ArrivalTicks;
+            }
+            else if (i > 0 && keys[i - 1].Down)
+            {
+                toneError.Add(NearestError(Timebase.ToMilliseconds(keys[i].ArrivalTicks - keys[i - 1].ArrivalTicks), unit, 1, 3));
+            }
+        }
+
+        PrintValue("squeeze to first key down on wire", Timebase.ToMilliseconds(keys[0].ArrivalTicks - squeeze));
+        PrintStats("element length error on wire", toneError);
+        PrintStats("element period error on wire", periodError);
+        PrintRate(keys);
+        PrintTelemetry(controller.Telemetry);
+    }
+
+    /// <summary>
+    /// SmartLink: server connect and registration, a hole punch negotiation for a radio
+    /// without forwarded ports, then a connection over forwarded ports that binds and keys.
+    /// </summary>
+    private void MeasureSmartLink()
+    {
+        Console.WriteLine();
+        Console.WriteLine("SmartLink");
+
+        var certificate = _options.Radio.WanCertificate;
+        using var trusted = new X509Certificate2(certificate.Export(X509ContentType.Cert));
+        using var store = new X509Store(StoreName.Root, StoreLocation.CurrentUser);
+        store.Open(OpenFlags.ReadWrite);
+        store.Add(trusted);
+
+        using var server = new StandInWanServer(_standIn, certificate);
+        Radio radio = null;
+        try
+        {
+            server.Start();
+            int offeredPort = -1;
+            server.ConnectRequested += (_, port) => Volatile.Write(ref offeredPort, port);
+
+            var connection = new SmartLinkServerConnection("localhost", server.Port);
+            connection.RadioListReceived += list => Volatile.Write(ref _wanRadios, list);
+
+            // Behind NAT: the client must offer a port, and FlexLib must be told to use it
+            server.ForwardedPorts = false;
+            var holePunchRadio = ConnectAndListWan(connection);
+            if (holePunchRadio == null)
+                return;
+            if (!holePunchRadio.RequiresHolePunch)
+            {
+                Fail("radio without public ports did not require a hole punch");
+                return;
+            }
+
+            long start = Timebase.Now;
+            var request = connection.RequestRadioConnectionAsync(holePunchRadio);
+            if (!PumpUntil(() => request.IsCompleted, STATUS_TIMEOUT_MS) || request.Result == null)
+            {
+                Fail("no connect_ready for the hole punch request");
+                return;
+            }
+            PrintValue("hole punch request to connect_ready", Timebase.ElapsedMilliseconds(start));
+            if (offeredPort <= 0 || offeredPort != holePunchRadio.NegotiatedHolePunchPort)
+                Fail($"hole punch port offered ({offeredPort}) is not the one FlexLib will use ({holePunchRadio.NegotiatedHolePunchPort})");
+
+            // Forwarded ports: connect over TLS and key over UDP to the public ports
+            connection.Disconnect();
+            server.ForwardedPorts = true;
+            radio = ConnectAndListWan(connection);
+            if (radio == null)
+                return;
+
+            start = Timebase.Now;
+            request = connection.RequestRadioConnectionAsync(radio);
+            if (!PumpUntil(() => request.IsCompleted, STATUS_TIMEOUT_MS) || request.Result == null)
+            {
+                Fail("no connect_ready for the forwarded port request");
+                return;
+            }
+            PrintValue("connect request to connect_ready", Timebase.ElapsedMilliseconds(start));
+
+            radio.WANConnectionHandle = request.Result;
+            start = Timebase.Now;
+            if (!radio.Connect())
+            {
+                Fail("SmartLink Radio.Connect() failed");
+                return;
+            }
+            GUIClient station = RadioConnector.WaitForGuiClient(radio, c => c.ClientHandle == _standIn.StationHandle, STATUS_TIMEOUT_MS);
+            if (station == null)
+            {
+                Fail("station client_id never arrived over SmartLink");
+                return;
+            }
+            PrintValue("connect to station client_id", Timebase.ElapsedMilliseconds(start));
+            if (_standIn.WanValidations != 1)
+                Fail("radio did not validate the SmartLink handle");
+
+            radio.BindGUIClient(station.ClientID);
+            MeasureWanKeying(radio);
+            connection.Disconnect();
+        }
+        finally
+        {
+            radio?.Disconnect();
+            server.Stop();
+            store.Remove(trusted);
+        }
+    }
+
+    private Radio ConnectAndListWan(SmartLinkServerConnection connection)
+    {
+        Volatile.Write(ref _wanRadios, null);
+        long start = Timebase.Now;
+        var connect = connection.ConnectAsync();
+        if (!PumpUntil(() => connect.IsCompleted, STATUS_TIMEOUT_MS) || !connect.Result)
+        {
+            Fail("could not connect to the stand-in SmartLink server");
+            return null;
+        }
+        PrintValue("server connect", Timebase.ElapsedMilliseconds(start));
+
+        start = Timebase.Now;
+        connection.Register(API.ProgramName, Environment.OSVersion.Platform.ToString(), "stand-in");
+        if (!PumpUntil(() => Volatile.Read(ref _wanRadios) != null, STATUS_TIMEOUT_MS))
+            return Fail("SmartLink radio list never arrived");
+        PrintValue("register to radio list", Timebase.ElapsedMilliseconds(start));
+
+        var radio = _wanRadios.FirstOrDefault(r => r.Serial == _options.Radio.Serial);
+        if (radio == null)
+            return Fail("stand-in radio missing from the SmartLink radio list");
+        return radio;
+    }
+
+    private void MeasureWanKeying(Radio radio)
+    {
+        uint handle = _standIn.StationHandle;
+        ClearKeys();
+
+        var latencies = new List<double>();
+        for (int i = 0; i < WAN_KEY_EDGES; i++)
+        {
+            bool down = i % 2 == 0;
+            int expected = i + 1;
+            long sent = Timebase.Now;
+            radio.CWKey(down, Timebase.FormatRadioTimestamp(sent), handle);
+            if (!PumpUntil(() => { lock (_keys) return _keys.Count >= expected; }, STATUS_TIMEOUT_MS))
+            {
+                Fail($"key command {expected} never arrived over SmartLink");
+                return;
+            }
+            lock (_keys)
+                latencies.Add(Timebase.ToMilliseconds(_keys[i].ArrivalTicks - sent));
+            Thread.Sleep(5);
+        }
+
+        PrintStats("CWKey to cw key on wire", latencies);
+        ClearKeys();
+    }
+
+    // ---- helpers ----
+
+    /// <summary>
+    /// Straight-key edges for "PARIS " repeated for the requested duration, as offsets
+    /// from the start in Timebase ticks.
+    /// </summary>
+    private static List<(long Offset, bool Down)> BuildParisSchedule(int wpm, int seconds)
+    {
+        const string paris = ".--. .- .-. .. ...";
+        long unit = Timebase.FromMicroseconds(1_200_000 / wpm);
+        var schedule = new List<(long, bool)>();
+        long t = 0;
+        long end = Timebase.FromMilliseconds(seconds * 1000L);
+
+        while (t < end)
+        {
+            foreach (char c in paris)
+            {
+                if (c == ' ')
+                {
+                    t += 2 * unit; // 3-unit letter space, 1 already counted after the element
+                    continue;
+                }
+
+                schedule.Add((t, true));
+                t += (c == '.' ? 1 : 3) * unit;
+                schedule.Add((t, false));
+                t += unit;
+            }
+            t += 6 * unit; // 7-unit word space
+        }
+
+        return schedule;
+    }
+
+    private static double NearestError(double measuredMs, double unitMs, int shortUnits, int longUnits)
+    {
+        double shortError = measuredMs - shortUnits * unitMs;
+        double longError = measuredMs - longUnits * unitMs;
+        return Math.Abs(shortError) <= Math.Abs(longError) ? shortError : longError;
+    }
+
+    private static void WaitUntil(long deadline)
+    {
+        long sleepMs = Timebase.ToMillisecondsLong(deadline - Timebase.Now) - 1;
+        if (sleepMs > 0)
+            Thread.Sleep((int)sleepMs);
+        while (Timebase.Now < deadline)
+            Thread.SpinWait(20);
+    }
+
+    private static bool PumpUntil(Func<bool> condition, int timeoutMs)
+    {
+        long deadline = Timebase.Now + Timebase.FromMilliseconds(timeoutMs);
+        while (!condition())
+        {
+            if (Timebase.Now > deadline)
+                return false;
+            Dispatcher.UIThread.RunJobs();
+            Thread.Sleep(1);
+        }
+        Dispatcher.UIThread.RunJobs();
+        return true;
+    }
+
+    private Radio FindStandIn()
+    {
+        try
+        {
+            return API.RadioList.ToArray().FirstOrDefault(r => r.Serial == _options.Radio.Serial);
+        }
+        catch (InvalidOperationException)
+        {
+            // Discovery modified the list while we copied it
+            return null;
+        }
+    }
+
+    private void ClearKeys()
+    {
+        lock (_keys) _keys.Clear();
+    }
+
+    private List<KeyCommand> TakeKeys()
+    {
+        lock (_keys)
+        {
+            var keys = _keys.OrderBy(k => k.ArrivalTicks).ToList();
+            _keys.Clear();
+            return keys;
+        }
+    }
+
+    private Radio Fail(string message)
+    {
+        Console.WriteLine($"FAIL: {message}");
+        _failed = true;
+        return null;
+    }
+
+    private static void PrintValue(string name, double ms)
+    {
+        Console.WriteLine($"  {name,-38} {ms,9:F3} ms");
+    }
+
+    private static void PrintStats(string name, List<double> samples)
+    {
+        if (samples.Count == 0)
+        {
+            Console.WriteLine($"  {name,-38} (no samples)");
+            return;
+        }
+
+        var sorted = samples.OrderBy(x => x).ToArray();
+        double mean = sorted.Average();
+        double stddev = Math.Sqrt(sorted.Sum(x => (x - mean) * (x - mean)) / sorted.Length);
+        Console.WriteLine($"  {name,-38} n={sorted.Length,-5} mean={mean,8:F3} sd={stddev,7:F3} " +
+                          $"p50={Percentile(sorted, 0.50),8:F3} p99={Percentile(sorted, 0.99),8:F3} " +
+                          $"min={sorted[0],8:F3} max={sorted[^1],8:F3} ms");
+    }
+
+    private static void PrintRate(List<KeyCommand> keys)
+    {
+        if (keys.Count < 2)
+            return;
+
+        double span = Timebase.ToMilliseconds(keys[^1].ArrivalTicks - keys[0].ArrivalTicks) / 1000.0;
+
+        // Busiest one-second window
+        long window = Timebase.Frequency;
+        int peak = 0;
+        for (int first = 0, last = 0; last < keys.Count; last++)
+        {
+            while (keys[last].ArrivalTicks - keys[first].ArrivalTicks >= window)
+                first++;
+            peak = Math.Max(peak, last - first + 1);
+        }
+
+        Console.WriteLine($"  {"key command rate",-38} {keys.Count / span,9:F1} /s average, {peak} in the busiest second");
+    }
+
+    /// <summary>
+    /// NetKeyer's own view of the same phase, from the telemetry the app records.
+    /// </summary>
+    private static void PrintTelemetry(RadioKeyTelemetry telemetry)
+    {
+        foreach (var histogram in new[] { telemetry.Queue, telemetry.Send, telemetry.Ack })
+        {
+            string name = $"telemetry: {histogram.Name}";
+            if (histogram.Count == 0)
+            {
+                Console.WriteLine($"  {name,-38} (no samples)");
+                continue;
+            }
+            Console.WriteLine($"  {name,-38} n={histogram.Count,-5} mean={histogram.MeanMilliseconds,8:F3} " +
+                              $"p50={histogram.PercentileMilliseconds(50),8:F3} p99={histogram.PercentileMilliseconds(99),8:F3} max={histogram.MaxMilliseconds,8:F3} ms");
+        }
+        Console.WriteLine($"  {"telemetry: unacknowledged key-downs",-38} {telemetry.UnacknowledgedKeyDowns,9}");
+    }
+
+    private static double Percentile(double[] sorted, double p)
+    {
+        int index = (int)Math.Ceiling(p * sorted.Length) - 1;
+        return sorted[Math.Clamp(index, 0, sorted.Length - 1)];
+    }
+}
@@ -0,0 +1,144 @@
+using System;
+using System.Globalization;
+using System.Net;
+using System.Threading;
+
+namespace NetKeyer.Tools.RadioStandIn;
+
+/// <summary>
+/// Local FlexRadio stand-in for testing NetKeyer without a radio on the LAN.
+///
+///   RadioStandIn serve [options]   Run the stand-in until Ctrl+C, logging every command.
+///                                  NetKeyer discovers it like any LAN radio.
+///   RadioStandIn bench [options]   Run the stand-in in-process and benchmark NetKeyer's
+///                                  radio path against it.
+/// </summary>
+public static class Program
+{
+    public static int Main(string[] args)
+    {
+        if (args.Length == 0 || args[0] is "-h" or "--help")
+            return Usage();
+
+        var radioOptions = new StandInOptions();
+        var benchOptions = new BenchmarkOptions { Radio = radioOptions };
+
+        for (int i = 1; i < args.Length; i++)
+        {
+            string value = i + 1 < args.Length ? args[i + 1] : null;
+            switch (args[i])
+            {
+                case "--port" when value != null:
+                    radioOptions.Port = int.Parse(value, CultureInfo.InvariantCulture);
+                    i++;
+                    break;
+                case "--model" when value != null:
+                    radioOptions.Model = value;
+                    i++;
+                    break;
+                case "--station" when value != null:
+                    radioOptions.Station = value;
+                    i++;
+                    break;
+                case "--announce" when value != null:
+                    radioOptions.AnnounceTo = IPAddress.Parse(value);
+                    i++;
+                    break;
+                case "--no-announce":
+                    radioOptions.AnnounceTo = null;
+                    break;
+                case "--quiet":
+                    radioOptions.Verbose = false;
+                    break;
+                case "--wpm" when value != null:
+                    benchOptions.Wpm = int.Parse(value, CultureInfo.InvariantCulture);
+                    i++;
+                    break;
+                case "--seconds" when value != null:
+                    benchOptions.Seconds = int.Parse(value, CultureInfo.InvariantCulture);
+                    i++;
+                    break;
+                case "--wan":
+                    benchOptions.Wan = true;
+                    break;
+                default:
+                    Console.WriteLine($"Unknown option: {args[i]}");
+                    return Usage();
+            }
+        }
+
+        switch (args[0])
+        {
+            case "serve":
+                return Serve(radioOptions);
+            case "bench":
+                return new KeyingBenchmark(benchOptions).Run();
+            default:
+                return Usage();
+        }
+    }
+
+    private static int Serve(StandInOptions options)
+    {
+        using var radio = new StandInRadio(options);
+        radio.Start();
+
+        Console.WriteLine("Commands: mode <CW|USB|...>, wpm <n>, pitch <n>, quit");
+
+        using var stop = new ManualResetEventSlim(false);
+        Console.CancelKeyPress += (_, e) =>
+        {
+            e.Cancel = true;
+            stop.Set();
+        };
+
+        var input = new Thread(() =>
+        {
+            string line;
+            while ((line = Console.ReadLine()) != null)
+            {
+                var parts = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+                if (parts.Length == 0)
+                    continue;
+
+                if (parts[0] == "quit")
+                {
+                    stop.Set();
+                    return;
+                }
+                else if (parts[0] == "mode" && parts.Length > 1)
+                    radio.SetSliceMode(parts[1]);
+                else if (parts[0] == "wpm" && parts.Length > 1 && int.TryParse(parts[1], out int wpm))
+                    radio.SetCwSpeed(wpm);
+                else if (parts[0] == "pitch" && parts.Length > 1 && int.TryParse(parts[1], out int pitch))
+                    radio.SetCwPitch(pitch);
+                else
+                    Console.WriteLine($"Unknown command: {line}");
+            }
+            // stdin closed (running detached): keep serving until Ctrl+C
+        })
+        { IsBackground = true };
+        input.Start();
+
+        stop.Wait();
+        Console.WriteLine($"{radio.KeyCommands} key commands received ({radio.DuplicateKeyCommands} duplicate copies)");
+        return 0;
+    }
+
+    private static int Usage()
+    {
+        Console.WriteLine("Usage: RadioStandIn serve|bench [options]");
+        Console.WriteLine();
+        Console.WriteLine("  --port <n>        TCP command port; UDP netcw uses port + 1 (default 4992)");
+        Console.WriteLine("  --model <name>    Model to report (default FLEX-6600)");
+        Console.WriteLine("  --station <name>  Name of the simulated SmartSDR station (default StandIn)");
+        Console.WriteLine("  --announce <ip>   Where to send discovery packets (default 127.0.0.1)");
+        Console.WriteLine("  --no-announce     Don't send discovery packets");
+        Console.WriteLine("  --quiet           Don't log each command (serve)");
+        Console.WriteLine("  --wpm <n>         Keying speed (bench, default 60)");
+        Console.WriteLine("  --seconds <n>     Length of each keying phase (bench, default 10)");
+        Console.WriteLine("  --wan             Also connect through a stand-in SmartLink server (bench; trusts");
+        Console.WriteLine("                    a temporary certificate in the current user's root store)");
+        return 2;
+    }
+}
@@ -0,0 +1,835 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Net;
+using System.Net.Security;
+using System.Net.Sockets;
+using System.Security.Authentication;
+using System.Security.Cryptography.X509Certificates;
+using System.Text;
+using System.Threading;
+using Flex.Smoothlake.Vita;
+using NetKeyer.Helpers;
+
+namespace NetKeyer.Tools.RadioStandIn;
+
+public class StandInOptions
+{
+    public int Port { get; set; } = StandInRadio.DEFAULT_PORT;
+    public string Model { get; set; } = "FLEX-6600";
+    public string Serial { get; set; } = "0000-0000-0000-0000";
+    public string Nickname { get; set; } = "StandIn";
+    public string Callsign { get; set; } = "N0CALL";
+    public string Version { get; set; } = "4.1.3.39644";
+    public string Station { get; set; } = "StandIn";
+
+    /// <summary>
+    /// Where to send discovery packets, or null to stay silent (the benchmark constructs its
+    /// Radio directly and doesn't need them).
+    /// </summary>
+    public IPAddress AnnounceTo { get; set; } = IPAddress.Loopback;
+
+    /// <summary>
+    /// Print every command and key event to the console.
+    /// </summary>
+    public bool Verbose { get; set; } = true;
+
+    /// <summary>
+    /// Certificate for the TLS command port (port + 2) that SmartLink clients connect to, or
+    /// null for LAN connections only.
+    /// </summary>
+    public X509Certificate2 WanCertificate { get; set; }
+}
+
+/// <summary>
+/// A loopback stand-in for a FlexRadio. Speaks enough of the SmartSDR API for FlexLib's
+/// Radio.Connect(), one simulated SmartSDR station (GUI client) with a CW transmit slice,
+/// the transmit CW settings NetKeyer synchronizes, and <c>cw key</c> receipt over both the
+/// TCP command channel and the UDP netcw stream. Every other command is acknowledged with
+/// an empty success reply. With a <see cref="StandInOptions.WanCertificate"/> it also takes
+/// SmartLink connections over TLS, validating the handle a <see cref="StandInWanServer"/>
+/// issued for them.
+///
+/// Each key command is stamped with <see cref="Timebase"/> as soon as it is read off the
+/// socket, so a benchmark running in the same process can measure edge-to-wire latency
+/// against the edge's own timestamp.
+/// </summary>
+public class StandInRadio : IDisposable
+{
+    public const int DEFAULT_PORT = 4992;
+    private const string API_VERSION = "1.4.0.0";
+    private const int ANNOUNCE_INTERVAL_MS = 1000;
+    private const uint NETCW_STREAM_ID = 0x84000000;
+    private const uint FLEX_INFORMATION_CLASS = 0x534C;
+    private const uint DISCOVERY_STREAM_ID = 0x800;
+    private const int BREAK_IN_DELAY_MS = 50;
+
+    private readonly StandInOptions _options;
+    private readonly object _stateLock = new object();
+    private readonly List<ClientSession> _sessions = new List<ClientSession>();
+    private readonly Dictionary<uint, int> _lastKeyIndex = new Dictionary<uint, int>();
+
+    private readonly HashSet<string> _wanHandles = new HashSet<string>();
+
+    private TcpListener _listener;
+    private TcpListener _tlsListener;
+    private UdpClient _netcwSocket;
+    private Thread _acceptThread;
+    private Thread _tlsAcceptThread;
+    private Thread _netcwThread;
+    private Thread _announceThread;
+    private volatile bool _running;
+
+    // Simulated radio state, guarded by _stateLock
+    private string _sliceMode = "CW";
+    private int _cwSpeed = 20;
+    private int _cwPitch = 600;
+    private int _monGainCw = 50;
+    private bool _iambic = true;
+    private bool _iambicModeB = true;
+    private bool _swapPaddles;
+    private bool _transmitting;
+
+    // CW break-in: the first key-down puts the interlock into TRANSMITTING, and it drops back
+    // to READY once the key has been up for the break-in delay
+    private readonly Timer _breakInTimer;
+    private bool _breakIn;
+    private long _breakInEnd = long.MaxValue;
+
+    private long _keyCommands;
+    private long _duplicateKeyCommands;
+    private long _wanValidations;
+
+    /// <summary>
+    /// Raised on the session or netcw thread for every key command, duplicates included.
+    /// </summary>
+    public event Action<KeyCommand> KeyCommandReceived;
+
+    /// <summary>
+    /// Raised on the session thread for every command line, with its arrival time.
+    /// </summary>
+    public event Action<string, long> CommandReceived;
+
+    public StandInRadio(StandInOptions options)
+    {
+        _options = options ?? new StandInOptions();
+        StationHandle = NewHandle();
+        StationClientId = Guid.NewGuid().ToString().ToUpperInvariant();
+        _breakInTimer = new Timer(_ => EndBreakIn());
+    }
+
+    public StandInOptions Options => _options;
+
+    /// <summary>
+    /// Client handle of the simulated SmartSDR station that owns the transmit slice.
+    /// NetKeyer binds to this station and keys on its behalf.
+    /// </summary>
+    public uint StationHandle { get; }
+
+    public string StationClientId { get; }
+
+    public long KeyCommands => Interlocked.Read(ref _keyCommands);
+    public long DuplicateKeyCommands => Interlocked.Read(ref _duplicateKeyCommands);
+
+    /// <summary>
+    /// SmartLink connections that presented a handle issued for them.
+    /// </summary>
+    public long WanValidations => Interlocked.Read(ref _wanValidations);
+
+    public int TlsPort => _options.Port + 2;
+
+    /// <summary>
+    /// Accepts <paramref name="handle"/> in one <c>wan validate</c> command, as the SmartLink
+    /// server tells the radio before sending the client connect_ready.
+    /// </summary>
+    public void ExpectWanConnection(string handle)
+    {
+        lock (_stateLock)
+            _wanHandles.Add(handle);
+    }
+
+    public void Start()
+    {
+        _listener = new TcpListener(IPAddress.Loopback, _options.Port);
+        _listener.Start();
+
+        _netcwSocket = new UdpClient(new IPEndPoint(IPAddress.Loopback, _options.Port + 1));
+
+        _running = true;
+        _acceptThread = new Thread(() => AcceptLoop(_listener, null)) { Name = "stand-in accept", IsBackground = true };
+        _acceptThread.Start();
+
+        if (_options.WanCertificate != null)
+        {
+            _tlsListener = new TcpListener(IPAddress.Loopback, TlsPort);
+            _tlsListener.Start();
+            _tlsAcceptThread = new Thread(() => AcceptLoop(_tlsListener, _options.WanCertificate)) { Name = "stand-in tls accept", IsBackground = true };
+            _tlsAcceptThread.Start();
+        }
+
+        _netcwThread = new Thread(NetCwLoop) { Name = "stand-in netcw", IsBackground = true, Priority = ThreadPriority.Highest };
+        _netcwThread.Start();
+
+        if (_options.AnnounceTo != null)
+        {
+            _announceThread = new Thread(AnnounceLoop) { Name = "stand-in discovery", IsBackground = true };
+            _announceThread.Start();
+        }
+
+        Console.WriteLine($"Stand-in {_options.Model} \"{_options.Nickname}\" listening on 127.0.0.1:{_options.Port} (tcp), :{_options.Port + 1} (udp netcw)");
+        if (_tlsListener != null)
+            Console.WriteLine($"SmartLink connections on 127.0.0.1:{TlsPort} (tls)");
+        Console.WriteLine($"Station \"{_options.Station}\" handle=0x{StationHandle:X8} client_id={StationClientId}");
+    }
+
+    public void Stop()
+    {
+        _running = false;
+
+        try { _listener?.Stop(); } catch { }
+        try { _tlsListener?.Stop(); } catch { }
+        try { _netcwSocket?.Close(); } catch { }
+
+        ClientSession[] sessions;
+        lock (_stateLock)
+        {
+            sessions = _sessions.ToArray();
+            _sessions.Clear();
+        }
+        foreach (var session in sessions)
+            session.Close();
+
+        _acceptThread?.Join();
+        _tlsAcceptThread?.Join();
+        _netcwThread?.Join();
+        _announceThread?.Join();
+        _acceptThread = _tlsAcceptThread = _netcwThread = _announceThread = null;
+        _tlsListener = null;
+    }
+
+    public void Dispose()
+    {
+        Stop();
+        _breakInTimer.Dispose();
+    }
+
+    // ---- radio-side changes, as if made from the SmartSDR station ----
+
+    public void SetSliceMode(string mode)
+    {
+        lock (_stateLock)
+            _sliceMode = mode.ToUpperInvariant();
+        Broadcast($"slice 0 mode={mode.ToUpperInvariant()}");
+    }
+
+    public void SetCwSpeed(int wpm)
+    {
+        lock (_stateLock)
+            _cwSpeed = wpm;
+        Broadcast($"transmit speed={wpm}");
+    }
+
+    public void SetCwPitch(int hz)
+    {
+        lock (_stateLock)
+            _cwPitch = hz;
+        Broadcast($"transmit pitch={hz}");
+    }
+
+    // ---- TCP command channel ----
+
+    private void AcceptLoop(TcpListener listener, X509Certificate2 certificate)
+    {
+        while (_running)
+        {
+            TcpClient client;
+            try
+            {
+                client = listener.AcceptTcpClient();
+            }
+            catch (SocketException)
+            {
+                break;
+            }
+            catch (ObjectDisposedException)
+            {
+                break;
+            }
+
+            client.NoDelay = true;
+            var thread = new Thread(() => SessionLoop(client, certificate))
+            {
+                Name = $"stand-in client {client.Client.RemoteEndPoint}",
+                IsBackground = true,
+                Priority = ThreadPriority.Highest
+            };
+            thread.Start();
+        }
+    }
+
+    private void SessionLoop(TcpClient client, X509Certificate2 certificate)
+    {
+        Stream stream = client.GetStream();
+        if (certificate != null)
+        {
+            // FlexLib accepts any certificate from a radio
+            var tls = new SslStream(stream);
+            try
+            {
+                tls.AuthenticateAsServer(certificate);
+            }
+            catch (Exception ex) when (ex is IOException or AuthenticationException)
+            {
+                Console.WriteLine($"TLS handshake with {client.Client.RemoteEndPoint} failed: {ex.Message}");
+                client.Close();
+                return;
+            }
+            stream = tls;
+        }
+
+        var session = new ClientSession(client, stream, NewHandle(), isWan: certificate != null);
+        lock (_stateLock)
+        {
+            _sessions.Add(session);
+            // A new connection starts its own index sequence
+            _lastKeyIndex.Clear();
+        }
+
+        Console.WriteLine($"Client 0x{session.Handle:X8} connected from {session.RemoteEndPoint}{(session.IsWan ? " (SmartLink)" : "")}");
+
+        try
+        {
+            session.Send($"V{API_VERSION}");
+            session.Send($"H{session.Handle:X8}");
+
+            string line;
+            while ((line = session.Reader.ReadLine()) != null)
+            {
+                long arrival = Timebase.Now;
+                HandleLine(session, line, arrival);
+            }
+        }
+        catch (IOException) { }
+        catch (ObjectDisposedException) { }
+
+        lock (_stateLock)
+            _sessions.Remove(session);
+        session.Close();
+
+        Console.WriteLine($"Client 0x{session.Handle:X8} ({session.Program ?? "unnamed"}) disconnected");
+    }
+
+    private void HandleLine(ClientSession session, string line, long arrival)
+    {
+        // C<seq>|<command>, or CD<seq>|<command> for commands the client wants echoed in logs
+        if (line.Length < 2 || line[0] != 'C')
+            return;
+
+        int start = line[1] == 'D' ? 2 : 1;
+        int bar = line.IndexOf('|');
+        if (bar < 0 || !uint.TryParse(line.AsSpan(start, bar - start), NumberStyles.Integer, CultureInfo.InvariantCulture, out uint seq))
+            return;
+
+        string command = line[(bar + 1)..].Trim();
+        CommandReceived?.Invoke(command, arrival);
+
+        if (KeyCommand.TryParse(command, arrival, "tcp", out var key))
+        {
+            RecordKey(key);
+            session.Reply(seq);
+            return;
+        }
+
+        if (_options.Verbose && !command.StartsWith("ping", StringComparison.Ordinal))
+            Console.WriteLine($"[{Timebase.ToMilliseconds(arrival),12:F3}] 0x{session.Handle:X8} > {command}");
+
+        string payload = ExecuteCommand(session, command, out Action afterReply);
+        session.Reply(seq, payload);
+        afterReply?.Invoke();
+    }
+
+    /// <summary>
+    /// Applies a command and returns the reply payload. Subscription statuses go out after
+    /// the reply, as they do from the radio.
+    /// </summary>
+    private string ExecuteCommand(ClientSession session, string command, out Action afterReply)
+    {
+        afterReply = null;
+        var parts = command.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+        if (parts.Length == 0)
+            return "";
+
+        switch (parts[0])
+        {
+            case "info":
+                return $"model=\"{_options.Model}\",chassis_serial=\"{_options.Serial}\",name=\"{_options.Nickname}\",callsign=\"{_options.Callsign}\"," +
+                       "gateway=\"127.0.0.1\",ip=\"127.0.0.1\",location=\"\",macaddr=\"00-1C-2D-00-00-00\",netmask=\"255.0.0.0\"," +
+                       "num_scu=2,num_slice=4,num_tx=1,options=\"None\",region=\"USA\",screensaver=\"model\",atu_present=0," +
+                       $"software_ver={_options.Version}";
+
+            case "version":
+                return $"SmartSDR-MB={_options.Version}#PSoC-MBTRX=3.0.19#PSoC-MBPA100=2.0.21#FPGA-MB=0.0.44.5";
+
+            case "client":
+                return ExecuteClientCommand(session, parts);
+
+            case "sub":
+                if (parts.Length > 1)
+                    afterReply = () => SendSubscriptionStatus(session, parts[1]);
+                return "";
+
+            case "stream":
+                if (parts.Length > 2 && parts[1] == "create" && parts[2] == "netcw")
+                    return NETCW_STREAM_ID.ToString("X8");
+                return "";
+
+            case "cw":
+                ExecuteCwCommand(parts);
+                return "";
+
+            case "transmit":
+                if (parts.Length > 2 && parts[1] == "set" && parts[2].StartsWith("mon_gain_cw=", StringComparison.Ordinal)
+                    && int.TryParse(parts[2].AsSpan(12), out int gain))
+                {
+                    lock (_stateLock)
+                        _monGainCw = gain;
+                    Broadcast($"transmit mon_gain_cw={gain}");
+                }
+                return "";
+
+            case "slice":
+                // slice set <index> mode=<mode>
+                if (parts.Length > 3 && parts[1] == "set" && parts[3].StartsWith("mode=", StringComparison.Ordinal))
+                    SetSliceMode(parts[3][5..]);
+                return "";
+
+            case "wan":
+                // wan validate handle=<handle>
+                if (parts.Length > 2 && parts[1] == "validate" && parts[2].StartsWith("handle=", StringComparison.Ordinal))
+                    ValidateWanConnection(session, parts[2][7..]);
+                return "";
+
+            case "xmit":
+                if (parts.Length > 1)
+                {
+                    bool transmitting = parts[1] == "1";
+                    lock (_stateLock)
+                        _transmitting = transmitting;
+                    Broadcast(InterlockStatus());
+                }
+                return "";
+
+            default:
+                return "";
+        }
+    }
+
+    private string ExecuteClientCommand(ClientSession session, string[] parts)
+    {
+        if (parts.Length < 2)
+            return "";
+
+        switch (parts[1])
+        {
+            case "gui":
+                session.ClientId ??= Guid.NewGuid().ToString().ToUpperInvariant();
+                return session.ClientId;
+
+            case "program":
+                session.Program = parts.Length > 2 ? string.Join(' ', parts, 2, parts.Length - 2) : null;
+                return "";
+
+            case "ip":
+                return session.RemoteEndPoint?.Address.ToString() ?? "127.0.0.1";
+
+            case "bind":
+                // Connect() sends an empty bind before the application picks a station
+                if (parts.Length > 2 && parts[2].StartsWith("client_id=", StringComparison.Ordinal) && parts[2].Length > 10)
+                {
+                    session.BoundClientId = parts[2][10..];
+                    bool known = string.Equals(session.BoundClientId, StationClientId, StringComparison.OrdinalIgnoreCase);
+                    Console.WriteLine($"Client 0x{session.Handle:X8} bound to {(known ? $"station \"{_options.Station}\"" : $"unknown client_id {session.BoundClientId}")}");
+                }
+                return "";
+
+            default:
+                return "";
+        }
+    }
+
+    private void ValidateWanConnection(ClientSession session, string handle)
+    {
+        bool known;
+        lock (_stateLock)
+            known = session.IsWan && _wanHandles.Remove(handle);
+
+        if (known)
+            Interlocked.Increment(ref _wanValidations);
+        Console.WriteLine($"Client 0x{session.Handle:X8} {(known ? "validated" : "presented unknown")} SmartLink handle {handle}");
+    }
+
+    private void ExecuteCwCommand(string[] parts)
+    {
+        if (parts.Length < 3)
+            return;
+
+        int.TryParse(parts[2], NumberStyles.Integer, CultureInfo.InvariantCulture, out int value);
+        string status = null;
+
+        lock (_stateLock)
+        {
+            switch (parts[1])
+            {
+                case "wpm":
+                    _cwSpeed = value;
+                    status = $"transmit speed={value}";
+                    break;
+                case "pitch":
+                    _cwPitch = value;
+                    status = $"transmit pitch={value}";
+                    break;
+                case "iambic":
+                    _iambic = value != 0;
+                    status = $"transmit iambic={value}";
+                    break;
+                case "mode":
+                    _iambicModeB = value != 0;
+                    status = $"transmit iambic_mode={value}";
+                    break;
+                case "swap":
+                    _swapPaddles = value != 0;
+                    status = $"transmit swap_paddles={value}";
+                    break;
+            }
+        }
+
+        if (status != null)
+            Broadcast(status);
+    }
+
+    private void SendSubscriptionStatus(ClientSession session, string topic)
+    {
+        switch (topic)
+        {
+            case "client":
+                session.SendStatus(StationHandle,
+                    $"client 0x{StationHandle:X8} connected local_ptt=1 client_id={StationClientId} program=SmartSDR-Win station={EncodeValue(_options.Station)}");
+                break;
+
+            case "slice":
+                lock (_stateLock)
+                {
+                    session.SendStatus(StationHandle,
+                        $"slice 0 in_use=1 RF_frequency=7.030000 client_handle=0x{StationHandle:X8} index_letter=A pan=0x40000000 " +
+                        $"mode={_sliceMode} rxant=ANT1 txant=ANT1 filter_lo=-250 filter_hi=250 tx=1 active=1");
+                }
+                break;
+
+            case "tx":
+                lock (_stateLock)
+                {
+                    session.SendStatus(StationHandle,
+                        $"transmit speed={_cwSpeed} pitch={_cwPitch} iambic={(_iambic ? 1 : 0)} iambic_mode={(_iambicModeB ? 1 : 0)} " +
+                        $"swap_paddles={(_swapPaddles ? 1 : 0)} mon_gain_cw={_monGainCw} break_in=1 sidetone=1");
+                }
+                session.SendStatus(StationHandle, InterlockStatus());
+                break;
+        }
+    }
+
+    private string InterlockStatus()
+    {
+        lock (_stateLock)
+            return _transmitting || _breakIn ? "interlock state=TRANSMITTING source=SW reason=" : "interlock state=READY source= reason=";
+    }
+
+    private void Broadcast(string status)
+    {
+        ClientSession[] sessions;
+        lock (_stateLock)
+            sessions = _sessions.ToArray();
+
+        foreach (var session in sessions)
+            session.SendStatus(StationHandle, status);
+
+        if (_options.Verbose)
+            Console.WriteLine($"[{Timebase.ToMilliseconds(Timebase.Now),12:F3}] status < {status}");
+    }
+
+    // ---- UDP netcw stream ----
+
+    private void NetCwLoop()
+    {
+        var remote = new IPEndPoint(IPAddress.Any, 0);
+        while (_running)
+        {
+            byte[] packet;
+            try
+            {
+                packet = _netcwSocket.Receive(ref remote);
+            }
+            catch (SocketException)
+            {
+                break;
+            }
+            catch (ObjectDisposedException)
+            {
+                break;
+            }
+
+            long arrival = Timebase.Now;
+            var payload = GetVitaPayload(packet);
+            if (payload == null)
+                continue;
+
+            // A packet may carry several newline-separated commands
+            foreach (var command in payload.Split('\n', StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries))
+            {
+                CommandReceived?.Invoke(command, arrival);
+                if (KeyCommand.TryParse(command, arrival, "udp", out var key))
+                    RecordKey(key);
+                else if (_options.Verbose)
+                    Console.WriteLine($"[{Timebase.ToMilliseconds(arrival),12:F3}] netcw > {command}");
+            }
+        }
+    }
+
+    /// <summary>
+    /// Extracts the text payload of a VITA-49 extension data packet.
+    /// </summary>
+    private static string GetVitaPayload(byte[] packet)
+    {
+        if (packet.Length < 4)
+            return null;
+
+        uint header = (uint)(packet[0] << 24 | packet[1] << 16 | packet[2] << 8 | packet[3]);
+        int packetType = (int)(header >> 28);
+        bool hasClassId = (header & (1u << 27)) != 0;
+        bool hasTrailer = (header & (1u << 26)) != 0;
+        int tsi = (int)(header >> 22) & 3;
+        int tsf = (int)(header >> 20) & 3;
+        int sizeBytes = (int)(header & 0xFFFF) * 4;
+
+        int offset = 4;
+        if (packetType == 1 || packetType == 3)
+            offset += 4; // stream id
+        if (hasClassId)
+            offset += 8;
+        if (tsi != 0)
+            offset += 4;
+        if (tsf != 0)
+            offset += 8;
+
+        int end = Math.Min(sizeBytes, packet.Length) - (hasTrailer ? 4 : 0);
+        if (end <= offset)
+            return null;
+
+        return Encoding.ASCII.GetString(packet, offset, end - offset).TrimEnd('\0', ' ');
+    }
+
+    // ---- discovery ----
+
+    private void AnnounceLoop()
+    {
+        using var socket = new UdpClient();
+        socket.EnableBroadcast = true;
+        var target = new IPEndPoint(_options.AnnounceTo, DEFAULT_PORT);
+
+        while (_running)
+        {
+            try
+            {
+                var bytes = BuildDiscoveryPacket();
+                socket.Send(bytes, bytes.Length, target);
+            }
+            catch (SocketException ex)
+            {
+                Console.WriteLine($"Discovery announce to {target} failed: {ex.Message}");
+                return;
+            }
+
+            for (int waited = 0; _running && waited < ANNOUNCE_INTERVAL_MS; waited += 100)
+                Thread.Sleep(100);
+        }
+    }
+
+    private byte[] BuildDiscoveryPacket()
+    {
+        int available;
+        lock (_stateLock)
+            available = Math.Max(0, 2 - _sessions.Count);
+
+        var payload =
+            $"discovery_protocol_version=3.0.0.2 model={_options.Model} serial={_options.Serial} version={_options.Version} " +
+            $"nickname={EncodeValue(_options.Nickname)} callsign={_options.Callsign} ip=127.0.0.1 port={_options.Port} status=Available " +
+            "inuse_ip= inuse_host= max_licensed_version=v4 radio_license_id=00-1C-2D-00-00-00 requires_additional_license=0 " +
+            $"fpc_mac= wan_connected=0 licensed_clients=2 available_clients={available} max_panadapters=4 available_panadapters=3 " +
+            "max_slices=4 available_slices=3 gui_client_ips=127.0.0.1 gui_client_hosts=stand-in gui_client_programs=SmartSDR-Win " +
+            $"gui_client_stations={EncodeValue(_options.Station)} gui_client_handles=0x{StationHandle:X8}";
+
+        var packet = new VitaDiscoveryPacket();
+        packet.header.pkt_type = VitaPacketType.ExtDataWithStream;
+        packet.header.c = true;
+        packet.header.t = false;
+        packet.header.tsi = VitaTimeStampIntegerType.Other;
+        packet.header.tsf = VitaTimeStampFractionalType.SampleCount;
+        packet.stream_id = DISCOVERY_STREAM_ID;
+        packet.class_id.OUI = VitaFlex.FLEX_OUI;
+        packet.class_id.InformationClassCode = (ushort)FLEX_INFORMATION_CLASS;
+        packet.class_id.PacketClassCode = VitaFlex.SL_VITA_DISCOVERY_CLASS;
+        packet.payload = payload;
+        return packet.ToBytes();
+    }
+
+    // ---- helpers ----
+
+    private void RecordKey(KeyCommand key)
+    {
+        bool duplicate = false;
+        if (key.Index >= 0)
+        {
+            lock (_stateLock)
+            {
+                if (_lastKeyIndex.TryGetValue(key.ClientHandle, out int last) && key.Index <= last)
+                    duplicate = true;
+                else
+                    _lastKeyIndex[key.ClientHandle] = key.Index;
+            }
+        }
+
+        key = new KeyCommand
+        {
+            ArrivalTicks = key.ArrivalTicks,
+            Down = key.Down,
+            RadioTime = key.RadioTime,
+            Index = key.Index,
+            ClientHandle = key.ClientHandle,
+            Transport = key.Transport,
+            Duplicate = duplicate
+        };
+
+        if (duplicate)
+            Interlocked.Increment(ref _duplicateKeyCommands);
+        else
+        {
+            Interlocked.Increment(ref _keyCommands);
+            UpdateBreakIn(key.Down);
+        }
+
+        if (_options.Verbose)
+            Console.WriteLine($"[{Timebase.ToMilliseconds(key.ArrivalTicks),12:F3}] {key}");
+
+        KeyCommandReceived?.Invoke(key);
+    }
+
+    private void UpdateBreakIn(bool down)
+    {
+        bool started = false;
+        lock (_stateLock)
+        {
+            if (down)
+            {
+                _breakInEnd = long.MaxValue;
+                started = !_breakIn;
+                _breakIn = true;
+            }
+            else if (_breakIn)
+            {
+                _breakInEnd = Timebase.Now + Timebase.FromMilliseconds(BREAK_IN_DELAY_MS);
+                _breakInTimer.Change(BREAK_IN_DELAY_MS, Timeout.Infinite);
+            }
+        }
+
+        if (started)
+            Broadcast(InterlockStatus());
+    }
+
+    private void EndBreakIn()
+    {
+        lock (_stateLock)
+        {
+            // A key-down since the timer was set keeps the transmitter on
+            if (!_breakIn || _breakInEnd == long.MaxValue)
+                return;
+
+            long remaining = _breakInEnd - Timebase.Now;
+            if (remaining > 0)
+            {
+                // Timer fired early; wait out the rest
+                _breakInTimer.Change(Math.Max(1, Timebase.ToMillisecondsLong(remaining)), Timeout.Infinite);
+                return;
+            }
+            _breakIn = false;
+        }
+        Broadcast(InterlockStatus());
+    }
+
+    private static uint NewHandle()
+    {
+        return (uint)Random.Shared.Next(0x10000000, int.MaxValue);
+    }
+
+    /// <summary>
+    /// The API can't carry spaces inside a value; the radio substitutes 0x7F.
+    /// </summary>
+    internal static string EncodeValue(string value)
+    {
+        return value.Replace(' ', '\u007f');
+    }
+
+    private class ClientSession
+    {
+        private readonly TcpClient _client;
+        private readonly StreamWriter _writer;
+        private readonly object _writeLock = new object();
+
+        public ClientSession(TcpClient client, Stream stream, uint handle, bool isWan)
+        {
+            _client = client;
+            Handle = handle;
+            IsWan = isWan;
+            RemoteEndPoint = client.Client.RemoteEndPoint as IPEndPoint;
+
+            Reader = new StreamReader(stream, Encoding.ASCII);
+            _writer = new StreamWriter(stream, Encoding.ASCII) { NewLine = "\n" };
+        }
+
+        public uint Handle { get; }
+        public bool IsWan { get; }
+        public IPEndPoint RemoteEndPoint { get; }
+        public StreamReader Reader { get; }
+        public string Program { get; set; }
+        public string ClientId { get; set; }
+        public string BoundClientId { get; set; }
+
+        public void Reply(uint seq, string payload = "")
+        {
+            Send($"R{seq}|0|{payload}");
+        }
+
+        public void SendStatus(uint sourceHandle, string status)
+        {
+            Send($"S{sourceHandle:X8}|{status}");
+        }
+
+        public void Send(string line)
+        {
+            lock (_writeLock)
+            {
+                try
+                {
+                    _writer.WriteLine(line);
+                    _writer.Flush();
+                }
+                catch (IOException) { }
+                catch (ObjectDisposedException) { }
+            }
+        }
+
+        public void Close()
+        {
+            try { _client.Close(); } catch { }
+        }
+    }
+}
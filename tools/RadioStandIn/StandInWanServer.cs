@@ -0,0 +1,219 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Net;
+using System.Net.Security;
+using System.Net.Sockets;
+using System.Security.Authentication;
+using System.Security.Cryptography;
+using System.Security.Cryptography.X509Certificates;
+using System.Text;
+using System.Threading;
+
+namespace NetKeyer.Tools.RadioStandIn;
+
+/// <summary>
+/// A loopback stand-in for the SmartLink server, advertising one <see cref="StandInRadio"/>.
+/// Speaks the line protocol FlexLib's WanServer uses: on <c>application register</c> it
+/// sends the client's public IP and the radio list, and on <c>application connect</c> it
+/// issues a connection handle, tells the radio to expect it and answers
+/// <c>radio connect_ready</c>. The token isn't checked.
+///
+/// With <see cref="ForwardedPorts"/> off the radio is advertised without public ports, as a
+/// radio behind NAT without UPnP or port forwarding, so clients must negotiate a hole punch.
+/// The stand-in records the port they offer but can't punch anything: on one host the radio
+/// and client would need the same port.
+/// </summary>
+public class StandInWanServer : IDisposable
+{
+    private readonly StandInRadio _radio;
+    private readonly X509Certificate2 _certificate;
+    private readonly object _sessionLock = new object();
+    private readonly List<TcpClient> _clients = new List<TcpClient>();
+
+    private TcpListener _listener;
+    private Thread _acceptThread;
+    private volatile bool _running;
+    private int _nextHandle = 0x1000;
+
+    /// <summary>
+    /// Raised on the session thread for every <c>application connect</c>, with the radio's
+    /// serial and the hole punch port the client offered (0 for none).
+    /// </summary>
+    public event Action<string, int> ConnectRequested;
+
+    public StandInWanServer(StandInRadio radio, X509Certificate2 certificate)
+    {
+        _radio = radio;
+        _certificate = certificate;
+    }
+
+    /// <summary>
+    /// TLS port the server listens on; chosen by the system at Start().
+    /// </summary>
+    public int Port { get; private set; }
+
+    /// <summary>
+    /// Advertise the radio's TLS and UDP ports as forwarded. Off, clients must hole punch.
+    /// </summary>
+    public bool ForwardedPorts { get; set; } = true;
+
+    /// <summary>
+    /// A self-signed certificate for <c>localhost</c>. FlexLib validates the SmartLink
+    /// server's certificate, so it has to be trusted for the duration of a test.
+    /// </summary>
+    public static X509Certificate2 CreateCertificate()
+    {
+        using var key = RSA.Create(2048);
+        var request = new CertificateRequest("CN=localhost", key, HashAlgorithmName.SHA256, RSASignaturePadding.Pkcs1);
+        var names = new SubjectAlternativeNameBuilder();
+        names.AddDnsName("localhost");
+        request.CertificateExtensions.Add(names.Build());
+        request.CertificateExtensions.Add(new X509EnhancedKeyUsageExtension(
+            new OidCollection { new Oid("1.3.6.1.5.5.7.3.1") }, critical: false));
+
+        using var certificate = request.CreateSelfSigned(DateTimeOffset.UtcNow.AddDays(-1), DateTimeOffset.UtcNow.AddDays(1));
+
+        // SslStream needs the private key in a form the platform can use as a server
+        return new X509Certificate2(certificate.Export(X509ContentType.Pfx));
+    }
+
+    public void Start()
+    {
+        _listener = new TcpListener(IPAddress.Loopback, 0);
+        _listener.Start();
+        Port = ((IPEndPoint)_listener.LocalEndpoint).Port;
+
+        _running = true;
+        _acceptThread = new Thread(AcceptLoop) { Name = "stand-in smartlink accept", IsBackground = true };
+        _acceptThread.Start();
+
+        Console.WriteLine($"Stand-in SmartLink server listening on localhost:{Port} (tls)");
+    }
+
+    public void Stop()
+    {
+        _running = false;
+        try { _listener?.Stop(); } catch { }
+
+        TcpClient[] clients;
+        lock (_sessionLock)
+        {
+            clients = _clients.ToArray();
+            _clients.Clear();
+        }
+        foreach (var client in clients)
+            client.Close();
+
+        _acceptThread?.Join();
+        _acceptThread = null;
+    }
+
+    public void Dispose()
+    {
+        Stop();
+    }
+
+    private void AcceptLoop()
+    {
+        while (_running)
+        {
+            TcpClient client;
+            try
+            {
+                client = _listener.AcceptTcpClient();
+            }
+            catch (SocketException)
+            {
+                break;
+            }
+            catch (ObjectDisposedException)
+            {
+                break;
+            }
+
+            lock (_sessionLock)
+                _clients.Add(client);
+            new Thread(() => SessionLoop(client)) { Name = "stand-in smartlink session", IsBackground = true }.Start();
+        }
+    }
+
+    private void SessionLoop(TcpClient client)
+    {
+        try
+        {
+            using var tls = new SslStream(client.GetStream());
+            tls.AuthenticateAsServer(_certificate);
+
+            var reader = new StreamReader(tls, Encoding.ASCII);
+            var writer = new StreamWriter(tls, Encoding.ASCII) { NewLine = "\n", AutoFlush = true };
+
+            string line;
+            while ((line = reader.ReadLine()) != null)
+            {
+                line = line.Trim();
+                if (line.Length == 0 || line.StartsWith("ping", StringComparison.Ordinal))
+                    continue;
+
+                if (_radio.Options.Verbose)
+                    Console.WriteLine($"SmartLink > {line}");
+
+                if (line.StartsWith("application register", StringComparison.Ordinal))
+                {
+                    writer.WriteLine("application info public_ip=127.0.0.1");
+                    writer.WriteLine(RadioList());
+                }
+                else if (line.StartsWith("application connect", StringComparison.Ordinal))
+                {
+                    var args = ParseArguments(line);
+                    args.TryGetValue("serial", out string serial);
+                    args.TryGetValue("hole_punch_port", out string portText);
+                    int.TryParse(portText, out int holePunchPort);
+
+                    string handle = Interlocked.Increment(ref _nextHandle).ToString("X8");
+                    _radio.ExpectWanConnection(handle);
+                    ConnectRequested?.Invoke(serial, holePunchPort);
+                    writer.WriteLine($"radio connect_ready handle={handle} serial={serial}");
+                }
+            }
+        }
+        catch (IOException) { }
+        catch (ObjectDisposedException) { }
+        catch (AuthenticationException ex)
+        {
+            Console.WriteLine($"SmartLink TLS handshake failed: {ex.Message}");
+        }
+        finally
+        {
+            lock (_sessionLock)
+                _clients.Remove(client);
+            client.Close();
+        }
+    }
+
+    private string RadioList()
+    {
+        var options = _radio.Options;
+        int tlsPort = ForwardedPorts ? _radio.TlsPort : -1;
+        int udpPort = ForwardedPorts ? options.Port + 1 : -1;
+
+        return $"radio list radio_name={StandInRadio.EncodeValue(options.Nickname)} callsign={options.Callsign} serial={options.Serial} " +
+               $"version={options.Version} model={options.Model} status=Available last_seen={DateTime.UtcNow:yyyy-MM-ddTHH:mm:ssZ} " +
+               "public_ip=127.0.0.1 gui_client_ips=127.0.0.1 gui_client_hosts=stand-in gui_client_programs=SmartSDR-Win " +
+               $"gui_client_stations={StandInRadio.EncodeValue(options.Station)} gui_client_handles=0x{_radio.StationHandle:X8} upnp_supported=0 " +
+               $"public_tls_port={tlsPort} public_udp_port={udpPort} public_upnp_tls_port=-1 public_upnp_udp_port=-1 " +
+               "licensed_clients=2 max_licensed_version=v3 requires_additional_license=0 radio_license_id=00-1C-2D-00-00-00";
+    }
+
+    private static Dictionary<string, string> ParseArguments(string line)
+    {
+        var args = new Dictionary<string, string>();
+        foreach (var word in line.Split(' ', StringSplitOptions.RemoveEmptyEntries))
+        {
+            int equals = word.IndexOf('=');
+            if (equals > 0)
+                args[word[..equals]] = word[(equals + 1)..];
+        }
+        return args;
+    }
+}
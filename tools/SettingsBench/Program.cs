@@ -0,0 +1,136 @@
+using System;
+using System.Globalization;
+using System.IO;
+using System.Text.Json;
+using System.Threading;
+using NetKeyer.Helpers;
+using NetKeyer.Models;
+
+namespace NetKeyer.Tools.SettingsBench;
+
+/// <summary>
+/// Measures the UI-thread cost of persisting a setting on every change, as when a slider or
+/// spinner is dragged, for the old synchronous save and the debounced settings writer.
+///
+///   SettingsBench [--ticks n] [--interval-ms n]
+///
+/// Each tick changes a setting and saves it, then waits one interval (default 200 ticks at
+/// 16 ms, a 60 Hz drag). Files go to a temporary directory; the real settings are untouched.
+/// </summary>
+public static class Program
+{
+    private const int WARMUP_TICKS = 20;
+
+    public static int Main(string[] args)
+    {
+        int ticks = 200;
+        int intervalMs = 16;
+        for (int i = 0; i < args.Length; i++)
+        {
+            string value = i + 1 < args.Length ? args[i + 1] : null;
+            switch (args[i])
+            {
+                case "--ticks" when value != null:
+                    ticks = int.Parse(value, CultureInfo.InvariantCulture);
+                    i++;
+                    break;
+                case "--interval-ms" when value != null:
+                    intervalMs = int.Parse(value, CultureInfo.InvariantCulture);
+                    i++;
+                    break;
+                default:
+                    Console.WriteLine("Usage: SettingsBench [--ticks n] [--interval-ms n]");
+                    return 2;
+            }
+        }
+
+        string directory = Path.Combine(Path.GetTempPath(), $"netkeyer-settingsbench-{Environment.ProcessId}");
+        Directory.CreateDirectory(directory);
+        try
+        {
+            var settings = new UserSettings
+            {
+                MidiNoteMappings = MidiNoteMapping.GetDefaultMappings(),
+                EvdevKeyMappings = EvdevKeyMapping.GetDefaultMappings()
+            };
+
+            Console.WriteLine($"{ticks} setting changes, {intervalMs} ms apart");
+            Console.WriteLine();
+
+            RunSynchronous(settings, Path.Combine(directory, "sync.json"), ticks, intervalMs);
+            RunDebounced(settings, Path.Combine(directory, "debounced.json"), ticks, intervalMs);
+        }
+        finally
+        {
+            Directory.Delete(directory, recursive: true);
+        }
+        return 0;
+    }
+
+    /// <summary>
+    /// What UserSettings.Save() used to do on the UI thread: reflection-based serialization
+    /// and a synchronous File.WriteAllText.
+    /// </summary>
+    private static void RunSynchronous(UserSettings settings, string path, int ticks, int intervalMs)
+    {
+        var options = new JsonSerializerOptions { WriteIndented = true };
+        int writes = 0;
+        void Save()
+        {
+            File.WriteAllText(path, JsonSerializer.Serialize(settings, options));
+            writes++;
+        }
+
+        var histogram = Measure("before: sync save", settings, Save, () => writes = 0, ticks, intervalMs);
+        Report(histogram, writes);
+    }
+
+    private static void RunDebounced(UserSettings settings, string path, int ticks, int intervalMs)
+    {
+        using var writer = new DebouncedFileWriter(path);
+        void Save()
+        {
+            // As UserSettings.Save() does: serialize on the calling thread, write in the background
+            writer.MarkDirty(JsonSerializer.SerializeToUtf8Bytes(settings, UserSettingsJsonContext.Default.UserSettings));
+        }
+
+        long warmupWrites = 0;
+        var histogram = Measure("after: debounced", settings, Save, () =>
+        {
+            writer.Flush();
+            warmupWrites = writer.Writes;
+        }, ticks, intervalMs);
+
+        // Let the idle delay expire, as it would once the drag ends
+        Thread.Sleep(1000);
+        Report(histogram, writer.Writes - warmupWrites);
+    }
+
+    private static LatencyHistogram Measure(string name, UserSettings settings, Action save, Action afterWarmup, int ticks, int intervalMs)
+    {
+        // JIT and first-write costs aren't what a drag pays
+        for (int i = 0; i < WARMUP_TICKS; i++)
+        {
+            settings.NetworkInputPort = 7000 + i;
+            save();
+        }
+        afterWarmup();
+
+        var histogram = new LatencyHistogram(name);
+        for (int i = 0; i < ticks; i++)
+        {
+            long start = Timebase.Now;
+            settings.NetworkInputPort = 7000 + i;
+            save();
+            histogram.Record(Timebase.Now - start);
+            Thread.Sleep(intervalMs);
+        }
+        return histogram;
+    }
+
+    private static void Report(LatencyHistogram histogram, long writes)
+    {
+        Console.WriteLine($"  {histogram}");
+        Console.WriteLine($"    {writes} file writes");
+    }
+}